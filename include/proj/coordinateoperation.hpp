@@ -2007,6 +2007,10 @@ class PROJ_GCC_DLL CoordinateOperationContext {
 
     PROJ_DLL bool getDiscardSuperseded() const;
 
+    PROJ_DLL void setThreadCount(int count);
+
+    PROJ_DLL int getThreadCount() const;
+
     /** Describe how grid availability is used. */
     enum class GridAvailabilityUse {
         /** Grid availability is only used for sorting results. Operations
@@ -2073,6 +2077,14 @@ class PROJ_GCC_DLL CoordinateOperationContext {
 
     PROJ_DLL CoordinateOperationContextNNPtr clone() const;
 
+    PROJ_PRIVATE :
+        //! @cond Doxygen_Suppress
+        PROJ_INTERNAL std::vector<CoordinateOperationContextNNPtr>
+        acquireWorkerContexts(size_t count) const;
+
+    PROJ_INTERNAL void releaseWorkerContexts() const;
+    //! @endcond
+
   protected:
     PROJ_INTERNAL CoordinateOperationContext();
     PROJ_INTERNAL
@@ -193,6 +193,11 @@ class Cache {
     }
 
     size_t getMaxSize() const { return maxSize_; }
+    void setMaxSize(size_t maxSize) {
+        Guard g(lock_);
+        maxSize_ = maxSize;
+        prune();
+    }
     size_t getElasticity() const { return elasticity_; }
     size_t getMaxAllowedSize() const { return maxSize_ + elasticity_; }
     template <typename F> void cwalk(F &f) const {
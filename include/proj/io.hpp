@@ -901,6 +901,12 @@ class PROJ_GCC_DLL DatabaseContext {
 
     PROJ_DLL static DatabaseContextNNPtr create(void *sqlite_handle);
 
+    PROJ_INTERNAL PJ_CONTEXT *getPROJContext() const;
+
+    PROJ_INTERNAL DatabaseContextPtr duplicate(PJ_CONTEXT *ctx) const;
+
+    PROJ_INTERNAL bool inInsertStatementsSession() const;
+
     PROJ_INTERNAL bool lookForGridAlternative(const std::string &officialName,
                                               std::string &projFilename,
                                               std::string &projFormat,
@@ -38,9 +38,16 @@
 #ifndef _MSC_VER
 #include <strings.h>
 #endif
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 
 #include <algorithm>
 #include <limits>
+#include <thread>
 
 #include "filemanager.hpp"
 #include "geodesic.h"
@@ -48,6 +55,7 @@
 #include "proj.h"
 #include "proj_experimental.h"
 #include "proj_internal.h"
+#include "quadtree.hpp"
 #include <cmath> /* for isnan */
 #include <math.h>
 
@@ -213,32 +221,221 @@ double proj_roundtrip(PJ *P, PJ_DIRECTION direction, int n, PJ_COORD *coord) {
     return proj_xyz_dist(org, t);
 }
 
+/**************************************************************************************/
+static double pj_normalize_longitude(double x)
+/**************************************************************************************/
+{
+    if (x > 180.0) {
+        x -= 360.0;
+        if (x > 180.0)
+            x = fmod(x + 180.0, 360.0) - 180.0;
+    } else if (x < -180.0) {
+        x += 360.0;
+        if (x < -180.0)
+            x = fmod(x + 180.0, 360.0) - 180.0;
+    }
+    return x;
+}
+
+//! @cond Doxygen_Suppress
+
+/** Spatial index over the areas of use of a list of PJCoordOperation, one
+ * for the source CRS (forward direction) and one for the target CRS
+ * (inverse direction).
+ *
+ * Searching it returns a superset of the operations whose area of use
+ * contains a point, sorted by increasing index, so that
+ * pj_get_suggested_operation() can apply its usual selection rules on
+ * that subset only and get the same result as with a full scan.
+ */
+struct PJCoordOperationIndex {
+    struct Side {
+        std::unique_ptr<NS_PROJ::QuadTree::QuadTree<int>> quadtree{};
+        // operations whose bounding box is not indexed (geocentric CRS,
+        // or non finite bounds), that must be always considered.
+        std::vector<int> alwaysCandidates{};
+        bool hasLonLatDegree = false;
+        bool hasLatLonDegree = false;
+        // bounding box of each operation, when it is indexed
+        std::vector<NS_PROJ::QuadTree::RectObj> rects{};
+        std::vector<bool> isIndexed{};
+        // for each indexed operation, sorted list of the operations that may
+        // match a point of its bounding box: itself, the ones whose bounding
+        // box overlaps it, and alwaysCandidates.
+        std::vector<std::vector<int>> neighbours{};
+
+        void build(const std::vector<PJCoordOperation> &opList, bool isSrc);
+        void search(PJ_COORD coord, double normalizedX, double normalizedY,
+                    std::vector<int> &candidates) const;
+        const std::vector<int> *searchFromHint(PJ_COORD coord,
+                                               double normalizedX,
+                                               double normalizedY,
+                                               int iHint) const;
+    };
+
+    Side src{};
+    Side dst{};
+};
+
+// Below that number of operations, a linear scan is as fast as using the
+// index.
+constexpr size_t MIN_OPERATIONS_FOR_INDEX = 8;
+
+// ---------------------------------------------------------------------------
+
+void PJCoordOperationIndex::Side::build(
+    const std::vector<PJCoordOperation> &opList, bool isSrc) {
+    NS_PROJ::QuadTree::RectObj globalBounds;
+    bool hasGlobalBounds = false;
+    const int nOperations = static_cast<int>(opList.size());
+    rects.resize(nOperations);
+    isIndexed.resize(nOperations);
+    for (int i = 0; i < nOperations; i++) {
+        const auto &alt = opList[i];
+        NS_PROJ::QuadTree::RectObj rect;
+        rect.minx = isSrc ? alt.minxSrc : alt.minxDst;
+        rect.miny = isSrc ? alt.minySrc : alt.minyDst;
+        rect.maxx = isSrc ? alt.maxxSrc : alt.maxxDst;
+        rect.maxy = isSrc ? alt.maxySrc : alt.maxyDst;
+        if (isSrc ? alt.srcIsLonLatDegree : alt.dstIsLonLatDegree)
+            hasLonLatDegree = true;
+        if (isSrc ? alt.srcIsLatLonDegree : alt.dstIsLatLonDegree)
+            hasLatLonDegree = true;
+        const PJ *pjGeocentricToLonLat =
+            isSrc ? alt.pjSrcGeocentricToLonLat : alt.pjDstGeocentricToLonLat;
+        if (pjGeocentricToLonLat || !std::isfinite(rect.minx) ||
+            !std::isfinite(rect.miny) || !std::isfinite(rect.maxx) ||
+            !std::isfinite(rect.maxy)) {
+            alwaysCandidates.push_back(i);
+            continue;
+        }
+        if (!hasGlobalBounds) {
+            hasGlobalBounds = true;
+            globalBounds = rect;
+        } else {
+            globalBounds.minx = std::min(globalBounds.minx, rect.minx);
+            globalBounds.miny = std::min(globalBounds.miny, rect.miny);
+            globalBounds.maxx = std::max(globalBounds.maxx, rect.maxx);
+            globalBounds.maxy = std::max(globalBounds.maxy, rect.maxy);
+        }
+        rects[i] = rect;
+        isIndexed[i] = true;
+    }
+    if (!hasGlobalBounds)
+        return;
+
+    quadtree.reset(new NS_PROJ::QuadTree::QuadTree<int>(globalBounds));
+    neighbours.resize(nOperations);
+    for (int i = 0; i < nOperations; i++) {
+        if (!isIndexed[i])
+            continue;
+        quadtree->insert(i, rects[i]);
+        auto &list = neighbours[i];
+        for (int j = 0; j < nOperations; j++) {
+            if (!isIndexed[j] || rects[i].overlaps(rects[j]))
+                list.push_back(j);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void PJCoordOperationIndex::Side::search(PJ_COORD coord, double normalizedX,
+                                         double normalizedY,
+                                         std::vector<int> &candidates) const {
+    candidates.clear();
+    if (quadtree) {
+        quadtree->search(coord.xyzt.x, coord.xyzt.y, candidates);
+        if (hasLonLatDegree && normalizedX != coord.xyzt.x) {
+            quadtree->search(normalizedX, coord.xyzt.y, candidates);
+        }
+        if (hasLatLonDegree && normalizedY != coord.xyzt.y) {
+            quadtree->search(coord.xyzt.x, normalizedY, candidates);
+        }
+    }
+    candidates.insert(candidates.end(), alwaysCandidates.begin(),
+                      alwaysCandidates.end());
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+}
+
+// ---------------------------------------------------------------------------
+
+// If the point is in the bounding box of operation iHint (typically the one
+// selected for the previous point), then the only operations that may match
+// it are the neighbours of iHint, which avoids a full search.
+const std::vector<int> *
+PJCoordOperationIndex::Side::searchFromHint(PJ_COORD coord, double normalizedX,
+                                            double normalizedY,
+                                            int iHint) const {
+    if (iHint < 0 || static_cast<size_t>(iHint) >= isIndexed.size() ||
+        !isIndexed[iHint]) {
+        return nullptr;
+    }
+    // Operations might match the point through its normalized longitude
+    // instead of through its raw coordinates, in which case they are not
+    // necessarily neighbours of iHint.
+    if ((hasLonLatDegree && normalizedX != coord.xyzt.x) ||
+        (hasLatLonDegree && normalizedY != coord.xyzt.y)) {
+        return nullptr;
+    }
+    if (!rects[iHint].contains(coord.xyzt.x, coord.xyzt.y))
+        return nullptr;
+    return &neighbours[iHint];
+}
+
+//! @endcond
+
+/**************************************************************************************/
+std::shared_ptr<const PJCoordOperationIndex>
+pj_create_coord_operation_index(const std::vector<PJCoordOperation> &opList)
+/**************************************************************************************/
+{
+    if (opList.size() < MIN_OPERATIONS_FOR_INDEX)
+        return nullptr;
+    auto index = std::make_shared<PJCoordOperationIndex>();
+    index->src.build(opList, true);
+    index->dst.build(opList, false);
+    return index;
+}
+
 /**************************************************************************************/
 int pj_get_suggested_operation(PJ_CONTEXT *,
                                const std::vector<PJCoordOperation> &opList,
-                               const int iExcluded[2], bool skipNonInstantiable,
+                               const PJCoordOperationIndex *opIndex,
+                               int iHint, const int iExcluded[2],
+                               bool skipNonInstantiable,
                                PJ_DIRECTION direction, PJ_COORD coord)
 /**************************************************************************************/
 {
-    const auto normalizeLongitude = [](double x) {
-        if (x > 180.0) {
-            x -= 360.0;
-            if (x > 180.0)
-                x = fmod(x + 180.0, 360.0) - 180.0;
-        } else if (x < -180.0) {
-            x += 360.0;
-            if (x < -180.0)
-                x = fmod(x + 180.0, 360.0) - 180.0;
-        }
-        return x;
-    };
+    const double normalizedX = pj_normalize_longitude(coord.xyzt.x);
+    const double normalizedY = pj_normalize_longitude(coord.xyzt.y);
+
+    // Restrict the search to the operations whose area of use may contain
+    // the point, when an index is available. Try first the neighbourhood of
+    // iHint, which is cheaper for spatially coherent input.
+    std::vector<int> candidates;
+    const std::vector<int> *pCandidates = nullptr;
+    if (opIndex) {
+        const auto &side = direction == PJ_FWD ? opIndex->src : opIndex->dst;
+        pCandidates =
+            side.searchFromHint(coord, normalizedX, normalizedY, iHint);
+        if (!pCandidates) {
+            side.search(coord, normalizedX, normalizedY, candidates);
+            pCandidates = &candidates;
+        }
+    }
 
     // Select the operations that match the area of use
     // and has the best accuracy.
     int iBest = -1;
     double bestAccuracy = std::numeric_limits<double>::max();
     const int nOperations = static_cast<int>(opList.size());
-    for (int i = 0; i < nOperations; i++) {
+    const int nIter =
+        pCandidates ? static_cast<int>(pCandidates->size()) : nOperations;
+    for (int iter = 0; iter < nIter; iter++) {
+        const int i = pCandidates ? (*pCandidates)[iter] : iter;
         if (i == iExcluded[0] || i == iExcluded[1]) {
             continue;
         }
@@ -266,14 +463,14 @@ int pj_get_suggested_operation(PJ_CONTEXT *,
                 spatialCriterionOK = true;
             } else if (alt.srcIsLonLatDegree && coord.xyzt.y >= alt.minySrc &&
                        coord.xyzt.y <= alt.maxySrc) {
-                const double normalizedLon = normalizeLongitude(coord.xyzt.x);
+                const double normalizedLon = normalizedX;
                 if (normalizedLon >= alt.minxSrc &&
                     normalizedLon <= alt.maxxSrc) {
                     spatialCriterionOK = true;
                 }
             } else if (alt.srcIsLatLonDegree && coord.xyzt.x >= alt.minxSrc &&
                        coord.xyzt.x <= alt.maxxSrc) {
-                const double normalizedLon = normalizeLongitude(coord.xyzt.y);
+                const double normalizedLon = normalizedY;
                 if (normalizedLon >= alt.minySrc &&
                     normalizedLon <= alt.maxySrc) {
                     spatialCriterionOK = true;
@@ -301,14 +498,14 @@ int pj_get_suggested_operation(PJ_CONTEXT *,
                 spatialCriterionOK = true;
             } else if (alt.dstIsLonLatDegree && coord.xyzt.y >= alt.minyDst &&
                        coord.xyzt.y <= alt.maxyDst) {
-                const double normalizedLon = normalizeLongitude(coord.xyzt.x);
+                const double normalizedLon = normalizedX;
                 if (normalizedLon >= alt.minxDst &&
                     normalizedLon <= alt.maxxDst) {
                     spatialCriterionOK = true;
                 }
             } else if (alt.dstIsLatLonDegree && coord.xyzt.x >= alt.minxDst &&
                        coord.xyzt.x <= alt.maxxDst) {
-                const double normalizedLon = normalizeLongitude(coord.xyzt.y);
+                const double normalizedLon = normalizedY;
                 if (normalizedLon >= alt.minyDst &&
                     normalizedLon <= alt.maxyDst) {
                     spatialCriterionOK = true;
@@ -346,6 +543,45 @@ int pj_get_suggested_operation(PJ_CONTEXT *,
 }
 
 //! @cond Doxygen_Suppress
+/**************************************************************************************/
+PJCoordOperation::PJCoordOperation(PJ_CONTEXT *ctx,
+                                   const PJCoordOperation &other)
+    /**************************************************************************************/
+    : idxInOriginalList(other.idxInOriginalList), minxSrc(other.minxSrc),
+      minySrc(other.minySrc), maxxSrc(other.maxxSrc), maxySrc(other.maxySrc),
+      minxDst(other.minxDst), minyDst(other.minyDst), maxxDst(other.maxxDst),
+      maxyDst(other.maxyDst),
+      // Keep the clone of a not yet instantiated operation uninstantiated
+      pj(other.isInstantiated
+             ? proj_clone(ctx, other.pj)
+             : pj_obj_create_uninstantiated(ctx,
+                                            NN_NO_CHECK(other.pj->iso_obj))),
+      name(other.name), accuracy(other.accuracy),
+      pseudoArea(other.pseudoArea), areaName(other.areaName),
+      isOffshore(other.isOffshore), isUnknownAreaName(other.isUnknownAreaName),
+      isPriorityOp(other.isPriorityOp),
+      srcIsLonLatDegree(other.srcIsLonLatDegree),
+      srcIsLatLonDegree(other.srcIsLatLonDegree),
+      dstIsLonLatDegree(other.dstIsLonLatDegree),
+      dstIsLatLonDegree(other.dstIsLatLonDegree),
+      pjSrcGeocentricToLonLat(
+          other.pjSrcGeocentricToLonLat
+              ? proj_clone(ctx, other.pjSrcGeocentricToLonLat)
+              : nullptr),
+      pjDstGeocentricToLonLat(
+          other.pjDstGeocentricToLonLat
+              ? proj_clone(ctx, other.pjDstGeocentricToLonLat)
+              : nullptr),
+      isInstantiated(other.isInstantiated) {
+    if (!isInstantiated && pj) {
+        pj->over = other.pj->over;
+        pj->errorIfBestTransformationNotAvailable =
+            other.pj->errorIfBestTransformationNotAvailable;
+        pj->warnIfBestTransformationNotAvailable =
+            other.pj->warnIfBestTransformationNotAvailable;
+    }
+}
+
 /**************************************************************************************/
 PJCoordOperation::~PJCoordOperation() {
     /**************************************************************************************/
@@ -361,6 +597,41 @@ bool PJCoordOperation::isInstantiable() const {
         isInstantiableCached = proj_coordoperation_is_instantiable(pj->ctx, pj);
     return (isInstantiableCached == 1);
 }
+
+/**************************************************************************************/
+PJ *PJCoordOperation::instantiate() {
+    /**************************************************************************************/
+    if (isInstantiated)
+        return pj;
+    isInstantiated = true;
+
+    PJ_CONTEXT *ctx = pj->ctx;
+    const int old_debug_level = ctx->debug_level;
+    const int old_errno = proj_context_errno(ctx);
+    if (pj->errorIfBestTransformationNotAvailable ||
+        pj->warnIfBestTransformationNotAvailable)
+        ctx->debug_level = PJ_LOG_NONE;
+    ctx->forceOver = pj->over != 0;
+    PJ *newPj = nullptr;
+    try {
+        newPj = pj_obj_create(ctx, NN_NO_CHECK(pj->iso_obj));
+    } catch (const std::exception &) {
+    }
+    ctx->forceOver = false;
+    ctx->debug_level = old_debug_level;
+    proj_context_errno_set(ctx, old_errno);
+
+    if (newPj) {
+        newPj->over = pj->over;
+        newPj->errorIfBestTransformationNotAvailable =
+            pj->errorIfBestTransformationNotAvailable;
+        newPj->warnIfBestTransformationNotAvailable =
+            pj->warnIfBestTransformationNotAvailable;
+        proj_destroy(pj);
+        pj = newPj;
+    }
+    return pj;
+}
 //! @endcond
 
 /**************************************************************************************/
@@ -398,6 +669,135 @@ static void warnAboutMissingGrid(PJ *P)
            msg.c_str());
 }
 
+/**************************************************************************************/
+static bool pj_skip_non_instantiable(const PJ *P) {
+    /**************************************************************************************/
+    return P->skipNonInstantiable && !P->warnIfBestTransformationNotAvailable &&
+           !P->errorIfBestTransformationNotAvailable;
+}
+
+/**************************************************************************************/
+static PJ_COORD pj_trans_alternatives(PJ *P, PJ_DIRECTION direction,
+                                      PJ_COORD coord) {
+    /***************************************************************************************
+    Apply the most appropriate of the alternative coordinate operations of P
+    to coord. direction must already take into account P->inverted.
+    ***************************************************************************************/
+    constexpr int N_MAX_RETRY = 2;
+    int iExcluded[N_MAX_RETRY] = {-1, -1};
+
+    bool skipNonInstantiable = pj_skip_non_instantiable(P);
+    const int nOperations =
+        static_cast<int>(P->alternativeCoordinateOperations.size());
+
+    // We may need several attempts. For example the point at
+    // long=-111.5 lat=45.26 falls into the bounding box of the Canadian
+    // ntv2_0.gsb grid, except that it is not in any of the subgrids, being
+    // in the US. We thus need another retry that will select the conus
+    // grid.
+    for (int iRetry = 0; iRetry <= N_MAX_RETRY; iRetry++) {
+        // Do a first pass and select the operations that match the area of
+        // use and has the best accuracy.
+        int iBest = pj_get_suggested_operation(
+            P->ctx, P->alternativeCoordinateOperations,
+            P->alternativeCoordinateOperationsIndex.get(), P->iCurCoordOp,
+            iExcluded, skipNonInstantiable, direction, coord);
+        if (iBest < 0) {
+            break;
+        }
+        if (iRetry > 0) {
+            const int oldErrno = proj_errno_reset(P);
+            if (proj_log_level(P->ctx, PJ_LOG_TELL) >= PJ_LOG_DEBUG) {
+                pj_log(P->ctx, PJ_LOG_DEBUG,
+                       proj_context_errno_string(P->ctx, oldErrno));
+            }
+            pj_log(P->ctx, PJ_LOG_DEBUG,
+                   "Did not result in valid result. "
+                   "Attempting a retry with another operation.");
+        }
+
+        auto &alt = P->alternativeCoordinateOperations[iBest];
+        if (P->iCurCoordOp != iBest) {
+            if (proj_log_level(P->ctx, PJ_LOG_TELL) >= PJ_LOG_DEBUG) {
+                std::string msg("Using coordinate operation ");
+                msg += alt.name;
+                pj_log(P->ctx, PJ_LOG_DEBUG, msg.c_str());
+            }
+            P->iCurCoordOp = iBest;
+        }
+        alt.instantiate();
+        PJ_COORD res = coord;
+        if (alt.pj->hasCoordinateEpoch)
+            coord.xyzt.t = alt.pj->coordinateEpoch;
+        if (direction == PJ_FWD)
+            pj_fwd4d(res, alt.pj);
+        else
+            pj_inv4d(res, alt.pj);
+        if (proj_errno(alt.pj) == PROJ_ERR_OTHER_NETWORK_ERROR) {
+            return proj_coord_error();
+        }
+        if (res.xyzt.x != HUGE_VAL) {
+            return res;
+        } else if (P->errorIfBestTransformationNotAvailable ||
+                   P->warnIfBestTransformationNotAvailable) {
+            warnAboutMissingGrid(alt.pj);
+            if (P->errorIfBestTransformationNotAvailable) {
+                proj_errno_set(P, PROJ_ERR_COORD_TRANSFM_NO_OPERATION);
+                return res;
+            }
+            P->warnIfBestTransformationNotAvailable = false;
+            skipNonInstantiable = true;
+        }
+        if (iRetry == N_MAX_RETRY) {
+            break;
+        }
+        iExcluded[iRetry] = iBest;
+    }
+
+    // In case we did not find an operation whose area of use is compatible
+    // with the input coordinate, then goes through again the list, and
+    // use the first operation that does not require grids.
+    NS_PROJ::io::DatabaseContextPtr dbContext;
+    try {
+        if (P->ctx->cpp_context) {
+            dbContext =
+                P->ctx->cpp_context->getDatabaseContext().as_nullable();
+        }
+    } catch (const std::exception &) {
+    }
+    for (int i = 0; i < nOperations; i++) {
+        auto &alt = P->alternativeCoordinateOperations[i];
+        auto coordOperation =
+            dynamic_cast<NS_PROJ::operation::CoordinateOperation *>(
+                alt.pj->iso_obj.get());
+        if (coordOperation) {
+            if (coordOperation->gridsNeeded(dbContext, true).empty()) {
+                if (P->iCurCoordOp != i) {
+                    if (proj_log_level(P->ctx, PJ_LOG_TELL) >=
+                        PJ_LOG_DEBUG) {
+                        std::string msg("Using coordinate operation ");
+                        msg += alt.name;
+                        msg += " as a fallback due to lack of more "
+                               "appropriate operations";
+                        pj_log(P->ctx, PJ_LOG_DEBUG, msg.c_str());
+                    }
+                    P->iCurCoordOp = i;
+                }
+                alt.instantiate();
+                if (direction == PJ_FWD) {
+                    pj_fwd4d(coord, alt.pj);
+                } else {
+                    pj_inv4d(coord, alt.pj);
+                }
+                return coord;
+            }
+        }
+    }
+
+    proj_errno_set(P, PROJ_ERR_COORD_TRANSFM_NO_OPERATION);
+    return proj_coord_error();
+}
+
 /**************************************************************************************/
 PJ_COORD proj_trans(PJ *P, PJ_DIRECTION direction, PJ_COORD coord) {
     /***************************************************************************************
@@ -418,120 +818,8 @@ PJ_COORD proj_trans(PJ *P, PJ_DIRECTION direction, PJ_COORD coord) {
         return proj_coord_error();
     }
 
-    if (!P->alternativeCoordinateOperations.empty()) {
-        constexpr int N_MAX_RETRY = 2;
-        int iExcluded[N_MAX_RETRY] = {-1, -1};
-
-        bool skipNonInstantiable = P->skipNonInstantiable &&
-                                   !P->warnIfBestTransformationNotAvailable &&
-                                   !P->errorIfBestTransformationNotAvailable;
-        const int nOperations =
-            static_cast<int>(P->alternativeCoordinateOperations.size());
-
-        // We may need several attempts. For example the point at
-        // long=-111.5 lat=45.26 falls into the bounding box of the Canadian
-        // ntv2_0.gsb grid, except that it is not in any of the subgrids, being
-        // in the US. We thus need another retry that will select the conus
-        // grid.
-        for (int iRetry = 0; iRetry <= N_MAX_RETRY; iRetry++) {
-            // Do a first pass and select the operations that match the area of
-            // use and has the best accuracy.
-            int iBest = pj_get_suggested_operation(
-                P->ctx, P->alternativeCoordinateOperations, iExcluded,
-                skipNonInstantiable, direction, coord);
-            if (iBest < 0) {
-                break;
-            }
-            if (iRetry > 0) {
-                const int oldErrno = proj_errno_reset(P);
-                if (proj_log_level(P->ctx, PJ_LOG_TELL) >= PJ_LOG_DEBUG) {
-                    pj_log(P->ctx, PJ_LOG_DEBUG,
-                           proj_context_errno_string(P->ctx, oldErrno));
-                }
-                pj_log(P->ctx, PJ_LOG_DEBUG,
-                       "Did not result in valid result. "
-                       "Attempting a retry with another operation.");
-            }
-
-            const auto &alt = P->alternativeCoordinateOperations[iBest];
-            if (P->iCurCoordOp != iBest) {
-                if (proj_log_level(P->ctx, PJ_LOG_TELL) >= PJ_LOG_DEBUG) {
-                    std::string msg("Using coordinate operation ");
-                    msg += alt.name;
-                    pj_log(P->ctx, PJ_LOG_DEBUG, msg.c_str());
-                }
-                P->iCurCoordOp = iBest;
-            }
-            PJ_COORD res = coord;
-            if (alt.pj->hasCoordinateEpoch)
-                coord.xyzt.t = alt.pj->coordinateEpoch;
-            if (direction == PJ_FWD)
-                pj_fwd4d(res, alt.pj);
-            else
-                pj_inv4d(res, alt.pj);
-            if (proj_errno(alt.pj) == PROJ_ERR_OTHER_NETWORK_ERROR) {
-                return proj_coord_error();
-            }
-            if (res.xyzt.x != HUGE_VAL) {
-                return res;
-            } else if (P->errorIfBestTransformationNotAvailable ||
-                       P->warnIfBestTransformationNotAvailable) {
-                warnAboutMissingGrid(alt.pj);
-                if (P->errorIfBestTransformationNotAvailable) {
-                    proj_errno_set(P, PROJ_ERR_COORD_TRANSFM_NO_OPERATION);
-                    return res;
-                }
-                P->warnIfBestTransformationNotAvailable = false;
-                skipNonInstantiable = true;
-            }
-            if (iRetry == N_MAX_RETRY) {
-                break;
-            }
-            iExcluded[iRetry] = iBest;
-        }
-
-        // In case we did not find an operation whose area of use is compatible
-        // with the input coordinate, then goes through again the list, and
-        // use the first operation that does not require grids.
-        NS_PROJ::io::DatabaseContextPtr dbContext;
-        try {
-            if (P->ctx->cpp_context) {
-                dbContext =
-                    P->ctx->cpp_context->getDatabaseContext().as_nullable();
-            }
-        } catch (const std::exception &) {
-        }
-        for (int i = 0; i < nOperations; i++) {
-            const auto &alt = P->alternativeCoordinateOperations[i];
-            auto coordOperation =
-                dynamic_cast<NS_PROJ::operation::CoordinateOperation *>(
-                    alt.pj->iso_obj.get());
-            if (coordOperation) {
-                if (coordOperation->gridsNeeded(dbContext, true).empty()) {
-                    if (P->iCurCoordOp != i) {
-                        if (proj_log_level(P->ctx, PJ_LOG_TELL) >=
-                            PJ_LOG_DEBUG) {
-                            std::string msg("Using coordinate operation ");
-                            msg += alt.name;
-                            msg += " as a fallback due to lack of more "
-                                   "appropriate operations";
-                            pj_log(P->ctx, PJ_LOG_DEBUG, msg.c_str());
-                        }
-                        P->iCurCoordOp = i;
-                    }
-                    if (direction == PJ_FWD) {
-                        pj_fwd4d(coord, alt.pj);
-                    } else {
-                        pj_inv4d(coord, alt.pj);
-                    }
-                    return coord;
-                }
-            }
-        }
-
-        proj_errno_set(P, PROJ_ERR_COORD_TRANSFM_NO_OPERATION);
-        return proj_coord_error();
-    }
+    if (!P->alternativeCoordinateOperations.empty())
+        return pj_trans_alternatives(P, direction, coord);
 
     P->iCurCoordOp =
         0; // dummy value, to be used by proj_trans_get_last_used_operation()
@@ -564,6 +852,281 @@ object must be freed with proj_destroy().
                       P->alternativeCoordinateOperations[P->iCurCoordOp].pj);
 }
 
+//! @cond Doxygen_Suppress
+namespace {
+/* Accumulates the errno of the individual points of a batch transformation */
+struct BatchErrno {
+    int retErrno = 0;
+    bool hasSetRetErrno = false;
+    bool sameRetErrno = true;
+
+    void add(int thisErrno) {
+        if (thisErrno != 0) {
+            if (!hasSetRetErrno) {
+                retErrno = thisErrno;
+                hasSetRetErrno = true;
+            } else if (sameRetErrno && retErrno != thisErrno) {
+                sameRetErrno = false;
+                retErrno = PROJ_ERR_COORD_TRANSFM;
+            }
+        }
+    }
+
+    // Accumulate the errno of another batch
+    void merge(const BatchErrno &other) {
+        add(other.retErrno);
+        if (!other.sameRetErrno) {
+            sameRetErrno = false;
+            retErrno = PROJ_ERR_COORD_TRANSFM;
+        }
+    }
+};
+} // namespace
+//! @endcond
+
+/* Maximum number of coordinates processed at once by the array operators */
+static constexpr size_t SPAN_SIZE = 256;
+
+/**************************************************************************************/
+static bool pj_trans_span(PJ *P, PJ_DIRECTION direction, size_t n,
+                          PJ_COORD *coord, bool *failed) {
+    /***************************************************************************************
+    Try to apply P to the n (<= SPAN_SIZE) coordinates of coord at once,
+    through its array operator, if it has one. The points that fail, that is
+    whose x is HUGE_VAL, are flagged in failed[] and get back their input
+    value, so that the caller can transform them again through the per-point
+    path, which reports errors point by point. The context errno is restored
+    to its input value.
+
+    false is returned, with all the coordinates restored, if the array
+    operator cannot be used, or if the context errno has been set while no
+    point has failed, as the error cannot then be attributed to a point.
+    ***************************************************************************************/
+    if ((direction == PJ_FWD ? P->fwd4d_n : P->inv4d_n) == nullptr)
+        return false;
+
+    // Nothing to amortize over a single point, and if it fails, it would be
+    // transformed twice (which, with grids, may mean reading them twice).
+    if (n < 2)
+        return false;
+
+    PJ_COORD org[SPAN_SIZE];
+    for (size_t i = 0; i < n; i++) {
+        if (coord_has_nans(coord[i]))
+            return false;
+        org[i] = coord[i];
+    }
+
+    const int last_errno = P->ctx->last_errno;
+    P->ctx->last_errno = 0;
+    if (direction == PJ_FWD)
+        pj_fwd4d_n(coord, n, P);
+    else
+        pj_inv4d_n(coord, n, P);
+    bool hasFailed = false;
+    for (size_t i = 0; i < n; i++) {
+        failed[i] = coord[i].xyzt.x == HUGE_VAL;
+        if (failed[i]) {
+            hasFailed = true;
+            coord[i] = org[i];
+        }
+    }
+    const bool ok = hasFailed || P->ctx->last_errno == 0;
+    P->ctx->last_errno = last_errno;
+
+    if (!ok)
+        std::copy(org, org + n, coord);
+    return ok;
+}
+
+/**************************************************************************************/
+static void pj_trans_batch_alternatives(PJ *P, PJ_DIRECTION direction,
+                                        size_t n, PJ_COORD *coord,
+                                        BatchErrno *batchErrno) {
+    /***************************************************************************************
+    Batch counterpart of pj_trans_alternatives(). The operation is selected
+    for each point, but is then applied to whole runs of consecutive points
+    sharing the same selection, without going again through the per-call
+    checks of proj_trans(), and with its array operator when possible.
+    Points for which the selected operation fails are handed over to
+    pj_trans_alternatives() so that its retry and fallback logic is applied
+    unchanged.
+    ***************************************************************************************/
+    const int iExcluded[2] = {-1, -1};
+    const auto suggest = [P, direction, iExcluded,
+                          batchErrno](const PJ_COORD &coo) {
+        if (batchErrno)
+            proj_context_errno_set(P->ctx, 0);
+        return pj_get_suggested_operation(
+            P->ctx, P->alternativeCoordinateOperations,
+            P->alternativeCoordinateOperationsIndex.get(), P->iCurCoordOp,
+            iExcluded, pj_skip_non_instantiable(P), direction, coo);
+    };
+
+    size_t i = 0;
+    int iBest = n > 0 ? suggest(coord[0]) : -1;
+    while (i < n) {
+        if (iBest < 0) {
+            coord[i] = pj_trans_alternatives(P, direction, coord[i]);
+            if (batchErrno)
+                batchErrno->add(proj_errno(P));
+            if (++i < n)
+                iBest = suggest(coord[i]);
+            continue;
+        }
+
+        auto &alt = P->alternativeCoordinateOperations[iBest];
+        if (P->iCurCoordOp != iBest) {
+            if (proj_log_level(P->ctx, PJ_LOG_TELL) >= PJ_LOG_DEBUG) {
+                std::string msg("Using coordinate operation ");
+                msg += alt.name;
+                pj_log(P->ctx, PJ_LOG_DEBUG, msg.c_str());
+            }
+            P->iCurCoordOp = iBest;
+        }
+        alt.instantiate();
+
+        // Find the run of points starting at i that share the same suggested
+        // operation, and try to transform it at once.
+        size_t j = i + 1;
+        int iNext = -1;
+        while (j < n) {
+            iNext = suggest(coord[j]);
+            if (iNext != iBest || j - i == SPAN_SIZE)
+                break;
+            ++j;
+        }
+        // Apply alt to coord[k], falling back to the other operations if it
+        // fails. Return whether the fallback has been used.
+        const auto transformPoint = [P, direction, &alt, coord](size_t k) {
+            const PJ_COORD org = coord[k];
+            const int orgErrno = proj_errno(P);
+            if (direction == PJ_FWD)
+                pj_fwd4d(coord[k], alt.pj);
+            else
+                pj_inv4d(coord[k], alt.pj);
+            if (proj_errno(alt.pj) == PROJ_ERR_OTHER_NETWORK_ERROR) {
+                coord[k] = proj_coord_error();
+            } else if (coord[k].xyzt.x == HUGE_VAL) {
+                proj_context_errno_set(P->ctx, orgErrno);
+                coord[k] = pj_trans_alternatives(P, direction, org);
+                return true;
+            }
+            return false;
+        };
+
+        if (batchErrno)
+            proj_context_errno_set(P->ctx, 0);
+        bool failed[SPAN_SIZE];
+        if (pj_trans_span(alt.pj, direction, j - i, coord + i, failed)) {
+            // Only the points that failed are transformed again. As the
+            // suggested operation does not depend on the previous one, the
+            // other ones keep the result of alt.
+            bool usedFallback = false;
+            for (size_t k = i; k < j; ++k) {
+                if (failed[k - i]) {
+                    if (batchErrno)
+                        proj_context_errno_set(P->ctx, 0);
+                    usedFallback = transformPoint(k);
+                    if (batchErrno)
+                        batchErrno->add(proj_errno(P));
+                } else {
+                    usedFallback = false;
+                }
+            }
+            // for proj_trans_get_last_used_operation()
+            if (!usedFallback)
+                P->iCurCoordOp = iBest;
+            i = j;
+            iBest = iNext;
+            continue;
+        }
+
+        // Otherwise apply alt point by point, as long as it remains the
+        // suggested operation.
+        while (true) {
+            const bool usedFallback = transformPoint(i);
+            if (batchErrno)
+                batchErrno->add(proj_errno(P));
+            if (++i == n)
+                break;
+            iNext = suggest(coord[i]);
+            if (usedFallback || iNext != iBest || i == j) {
+                iBest = iNext;
+                break;
+            }
+        }
+    }
+}
+
+/**************************************************************************************/
+static void pj_trans_batch(PJ *P, PJ_DIRECTION direction, size_t n,
+                           PJ_COORD *coord, BatchErrno *batchErrno) {
+    /***************************************************************************************
+    Apply the transformation P to the n coordinates of coord, with the same
+    result as n calls to proj_trans(), but doing the checks that do not depend
+    on the coordinate values only once.
+
+    If batchErrno is not null, the context errno is reset before each point
+    and accumulated in batchErrno after it, as documented for
+    proj_trans_array(). Otherwise, it evolves as with successive proj_trans()
+    calls.
+    ***************************************************************************************/
+    if (nullptr == P || direction == PJ_IDENT || n == 0)
+        return;
+    if (P->inverted)
+        direction = opposite_direction(direction);
+
+    if (P->iso_obj != nullptr && !P->iso_obj_is_coordinate_operation) {
+        pj_log(P->ctx, PJ_LOG_ERROR, "Object is not a coordinate operation");
+        for (size_t i = 0; i < n; i++) {
+            proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+            coord[i] = proj_coord_error();
+            if (batchErrno)
+                batchErrno->add(PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+        }
+        return;
+    }
+
+    if (!P->alternativeCoordinateOperations.empty()) {
+        pj_trans_batch_alternatives(P, direction, n, coord, batchErrno);
+        return;
+    }
+
+    P->iCurCoordOp =
+        0; // dummy value, to be used by proj_trans_get_last_used_operation()
+    const auto transform = direction == PJ_FWD ? pj_fwd4d : pj_inv4d;
+    for (size_t i = 0; i < n; i += SPAN_SIZE) {
+        const size_t nspan = std::min(SPAN_SIZE, n - i);
+        PJ_COORD *span = coord + i;
+        if (P->hasCoordinateEpoch) {
+            for (size_t j = 0; j < nspan; j++)
+                span[j].xyzt.t = P->coordinateEpoch;
+        }
+        if (batchErrno)
+            proj_context_errno_set(P->ctx, 0);
+        // Points that fail through the array operator, or all of them if
+        // it cannot be used, go through the per-point path.
+        bool failed[SPAN_SIZE];
+        const bool spanDone = pj_trans_span(P, direction, nspan, span, failed);
+
+        for (size_t j = 0; j < nspan; j++) {
+            if (spanDone && !failed[j])
+                continue;
+            PJ_COORD &coo = span[j];
+            if (batchErrno)
+                proj_context_errno_set(P->ctx, 0);
+            if (coord_has_nans(coo))
+                coo.v[0] = coo.v[1] = coo.v[2] = coo.v[3] =
+                    std::numeric_limits<double>::quiet_NaN();
+            else
+                transform(coo, P);
+            if (batchErrno)
+                batchErrno->add(proj_errno(P));
+        }
+    }
+}
+
 /*****************************************************************************/
 int proj_trans_array(PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord) {
     /******************************************************************************
@@ -580,29 +1143,40 @@ int proj_trans_array(PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord) {
         for the same reason, or a generic error code if they fail for different
         reasons.
     ******************************************************************************/
-    size_t i;
-    int retErrno = 0;
-    bool hasSetRetErrno = false;
-    bool sameRetErrno = true;
+    BatchErrno batchErrno;
+    pj_trans_batch(P, direction, n, coord, &batchErrno);
 
-    for (i = 0; i < n; i++) {
-        proj_context_errno_set(P->ctx, 0);
-        coord[i] = proj_trans(P, direction, coord[i]);
-        int thisErrno = proj_errno(P);
-        if (thisErrno != 0) {
-            if (!hasSetRetErrno) {
-                retErrno = thisErrno;
-                hasSetRetErrno = true;
-            } else if (sameRetErrno && retErrno != thisErrno) {
-                sameRetErrno = false;
-                retErrno = PROJ_ERR_COORD_TRANSFM;
-            }
-        }
-    }
+    proj_context_errno_set(P->ctx, batchErrno.retErrno);
 
-    proj_context_errno_set(P->ctx, retErrno);
+    return batchErrno.retErrno;
+}
 
-    return retErrno;
+/*************************************************************************************/
+static size_t generic_coord_count(size_t nx, size_t ny, size_t nz, size_t nt) {
+    /**************************************************************************************
+        Number of coordinates to transform by proj_trans_generic(), given the
+    lengths of its (non null) arrays, or 0 if there is nothing to do.
+    **************************************************************************************/
+    if (0 == nx + ny + nz + nt)
+        return 0;
+
+    /* arrays of length 1 are constants, which we broadcast along the longer
+     * arrays */
+    /* so we need to find the length of the shortest non-unity array to figure
+     * out
+     */
+    /* how many coordinate pairs we must transform */
+    size_t nmin =
+        (nx > 1) ? nx : (ny > 1) ? ny : (nz > 1) ? nz : (nt > 1) ? nt : 1;
+    if ((nx > 1) && (nx < nmin))
+        nmin = nx;
+    if ((ny > 1) && (ny < nmin))
+        nmin = ny;
+    if ((nz > 1) && (nz < nmin))
+        nmin = nz;
+    if ((nt > 1) && (nt < nmin))
+        nmin = nt;
+    return nmin;
 }
 
 /*************************************************************************************/
@@ -693,25 +1267,10 @@ size_t proj_trans_generic(PJ *P, PJ_DIRECTION direction, double *x, size_t sx,
         t = &invalid_time;
 
     /* nothing to do? */
-    if (0 == nx + ny + nz + nt)
+    nmin = generic_coord_count(nx, ny, nz, nt);
+    if (0 == nmin)
         return 0;
 
-    /* arrays of length 1 are constants, which we broadcast along the longer
-     * arrays */
-    /* so we need to find the length of the shortest non-unity array to figure
-     * out
-     */
-    /* how many coordinate pairs we must transform */
-    nmin = (nx > 1) ? nx : (ny > 1) ? ny : (nz > 1) ? nz : (nt > 1) ? nt : 1;
-    if ((nx > 1) && (nx < nmin))
-        nmin = nx;
-    if ((ny > 1) && (ny < nmin))
-        nmin = ny;
-    if ((nz > 1) && (nz < nmin))
-        nmin = nz;
-    if ((nt > 1) && (nt < nmin))
-        nmin = nt;
-
     /* Check validity of direction flag */
     switch (direction) {
     case PJ_FWD:
@@ -726,48 +1285,389 @@ size_t proj_trans_generic(PJ *P, PJ_DIRECTION direction, double *x, size_t sx,
     /* Arrays of length >1 are iterated over (for the first nmin values) */
     /* The slightly convolved incremental indexing is used due           */
     /* to the stride, which may be any size supported by the platform    */
-    for (i = 0; i < nmin; i++) {
-        coord.xyzt.x = *x;
-        coord.xyzt.y = *y;
-        coord.xyzt.z = *z;
-        coord.xyzt.t = *t;
+    /* Coordinates are gathered in chunks, so that the transformation    */
+    /* itself can be applied to contiguous batches of PJ_COORD.          */
+    PJ_COORD chunk[SPAN_SIZE];
+    for (i = 0; i < nmin; i += SPAN_SIZE) {
+        const size_t nchunk = std::min(SPAN_SIZE, nmin - i);
+        double *xr = x;
+        double *yr = y;
+        double *zr = z;
+        double *tr = t;
+        for (size_t j = 0; j < nchunk; j++) {
+            chunk[j].xyzt.x = *xr;
+            chunk[j].xyzt.y = *yr;
+            chunk[j].xyzt.z = *zr;
+            chunk[j].xyzt.t = *tr;
+            if (nx > 1)
+                xr = (double *)((void *)(((char *)xr) + sx));
+            if (ny > 1)
+                yr = (double *)((void *)(((char *)yr) + sy));
+            if (nz > 1)
+                zr = (double *)((void *)(((char *)zr) + sz));
+            if (nt > 1)
+                tr = (double *)((void *)(((char *)tr) + st));
+        }
+
+        pj_trans_batch(P, direction, nchunk, chunk, nullptr);
+        coord = chunk[nchunk - 1];
+
+        /* in all full length cases, we overwrite the input with the output,  */
+        /* and step on to the next element.                                   */
+        /* The casts are somewhat funky, but they compile down to no-ops and  */
+        /* they tell compilers and static analyzers that we know what we do   */
+        for (size_t j = 0; j < nchunk; j++) {
+            if (nx > 1) {
+                *x = chunk[j].xyzt.x;
+                x = (double *)((void *)(((char *)x) + sx));
+            }
+            if (ny > 1) {
+                *y = chunk[j].xyzt.y;
+                y = (double *)((void *)(((char *)y) + sy));
+            }
+            if (nz > 1) {
+                *z = chunk[j].xyzt.z;
+                z = (double *)((void *)(((char *)z) + sz));
+            }
+            if (nt > 1) {
+                *t = chunk[j].xyzt.t;
+                t = (double *)((void *)(((char *)t) + st));
+            }
+        }
+    }
+
+    /* Last time around, we update the length 1 cases with their transformed
+     * alter egos */
+    if (nx == 1)
+        *x = coord.xyzt.x;
+    if (ny == 1)
+        *y = coord.xyzt.y;
+    if (nz == 1)
+        *z = coord.xyzt.z;
+    if (nt == 1)
+        *t = coord.xyzt.t;
+
+    return nmin;
+}
+
+/*************************************************************************************/
+PJParallelWorkers::~PJParallelWorkers() {
+    for (const auto &worker : workers) {
+        proj_destroy(worker.second);
+        proj_context_destroy(worker.first);
+    }
+}
+
+/* Minimum number of coordinates for which a thread is worth being created */
+static constexpr size_t MIN_COORDS_PER_THREAD = 4 * SPAN_SIZE;
+
+/*************************************************************************************/
+static std::vector<PJ *> pj_get_parallel_workers(PJ *P, int thread_count,
+                                                 size_t n) {
+    /**************************************************************************************
+        Return the transformation objects to use to transform n coordinates
+    with thread_count threads (or as many threads as there are hardware
+    threads, if thread_count <= 0). The first one is P itself, and the other
+    ones are clones of P, each attached to its own context, so that they can
+    be used concurrently. The clones are kept in P so as to be reused by
+    subsequent calls, and are recreated if the context of P, or one of its
+    settings, has changed.
+
+        Less objects than requested threads are returned if there are too few
+    coordinates, or if cloning fails.
+    **************************************************************************************/
+    size_t count = thread_count > 0 ? static_cast<size_t>(thread_count)
+                                    : std::thread::hardware_concurrency();
+    count = std::min(count, n / MIN_COORDS_PER_THREAD);
+
+    std::vector<PJ *> res{P};
+    if (count <= 1)
+        return res;
+
+    if (P->parallelWorkers &&
+        P->parallelWorkers->srcCtxGeneration != P->ctx->settingsGeneration)
+        P->parallelWorkers.reset();
+    if (!P->parallelWorkers) {
+        P->parallelWorkers = make_unique<PJParallelWorkers>();
+        P->parallelWorkers->srcCtxGeneration = P->ctx->settingsGeneration;
+    }
+    auto &workers = P->parallelWorkers->workers;
+    while (workers.size() + 1 < count) {
+        PJ_CONTEXT *ctx = proj_context_clone(P->ctx);
+        if (!ctx)
+            break;
+        PJ *clone = proj_clone(ctx, P);
+        if (!clone) {
+            proj_context_destroy(ctx);
+            break;
+        }
+        workers.emplace_back(ctx, clone);
+    }
+    for (size_t i = 0; i < workers.size() && res.size() < count; i++)
+        res.push_back(workers[i].second);
+    return res;
+}
+
+/*************************************************************************************/
+static void pj_split_range(size_t n, size_t count, size_t i, size_t &begin,
+                           size_t &end) {
+    /**************************************************************************************
+        Compute the bounds of the i-th of count contiguous parts of [0, n).
+    **************************************************************************************/
+    const size_t partSize = n / count;
+    const size_t remainder = n % count;
+    begin = i * partSize + std::min(i, remainder);
+    end = begin + partSize + (i < remainder ? 1 : 0);
+}
+
+/*************************************************************************************/
+template <class Task> static void pj_run_parallel(size_t count, Task task) {
+    /**************************************************************************************
+        Run task(i) for i in [0, count), task(0) being run in the calling
+    thread, and the other ones in their own thread. If threads cannot be
+    created, the remaining tasks are run in the calling thread.
+    **************************************************************************************/
+    std::vector<std::thread> threads;
+    size_t i = 1;
+    try {
+        for (; i < count; ++i)
+            threads.emplace_back(task, i);
+    } catch (const std::exception &) {
+    }
+    task(0);
+    for (; i < count; ++i)
+        task(i);
+    for (auto &thread : threads)
+        thread.join();
+}
+
+/*************************************************************************************/
+int proj_trans_array_parallel(PJ *P, PJ_DIRECTION direction, size_t n,
+                              PJ_COORD *coord, int thread_count) {
+    /******************************************************************************
+        Same as proj_trans_array(), but transforming the coordinates with
+    several threads.
+    ******************************************************************************/
+    if (nullptr == P)
+        return PROJ_ERR_OTHER_API_MISUSE;
+
+    const auto workers = pj_get_parallel_workers(P, thread_count, n);
+    const size_t count = workers.size();
+    if (count <= 1)
+        return proj_trans_array(P, direction, n, coord);
+
+    std::vector<BatchErrno> batchErrnos(count);
+    pj_run_parallel(count, [&](size_t i) {
+        size_t begin, end;
+        pj_split_range(n, count, i, begin, end);
+        pj_trans_batch(workers[i], direction, end - begin, coord + begin,
+                       &batchErrnos[i]);
+    });
+
+    BatchErrno batchErrno;
+    for (const auto &partErrno : batchErrnos)
+        batchErrno.merge(partErrno);
+    // for proj_trans_get_last_used_operation()
+    P->iCurCoordOp = workers.back()->iCurCoordOp;
+
+    proj_context_errno_set(P->ctx, batchErrno.retErrno);
+
+    return batchErrno.retErrno;
+}
+
+/*************************************************************************************/
+size_t proj_trans_generic_parallel(PJ *P, PJ_DIRECTION direction, double *x,
+                                   size_t sx, size_t nx, double *y, size_t sy,
+                                   size_t ny, double *z, size_t sz, size_t nz,
+                                   double *t, size_t st, size_t nt,
+                                   int thread_count) {
+    /**************************************************************************************
+        Same as proj_trans_generic(), but transforming the coordinates with
+    several threads. Each thread is given a contiguous part of the arrays of
+    length > 1, and its own copy of the constants (arrays of length 1), since
+    proj_trans_generic() writes back the last transformed coordinate into
+    them.
+    **************************************************************************************/
+    if (nullptr == P)
+        return 0;
+
+    /* ignore lengths of null arrays */
+    if (nullptr == x)
+        nx = 0;
+    if (nullptr == y)
+        ny = 0;
+    if (nullptr == z)
+        nz = 0;
+    if (nullptr == t)
+        nt = 0;
+
+    const size_t nmin = generic_coord_count(nx, ny, nz, nt);
+    const auto workers = pj_get_parallel_workers(P, thread_count, nmin);
+    const size_t count = workers.size();
+    if (count <= 1 || direction == PJ_IDENT) {
+        return proj_trans_generic(P, direction, x, sx, nx, y, sy, ny, z, sz,
+                                  nz, t, st, nt);
+    }
+
+    /* The errno of P is the one of the first part in error, or 0 if all the */
+    /* parts succeed, whatever the order in which the threads complete.     */
+    proj_context_errno_set(P->ctx, 0);
+    std::vector<PJ_COORD> constants(count);
+    std::vector<int> partErrnos(count);
+    pj_run_parallel(count, [&](size_t i) {
+        size_t begin, end;
+        pj_split_range(nmin, count, i, begin, end);
+        const size_t npart = end - begin;
+        PJ_COORD &constant = constants[i];
+        const auto partArray = [begin, npart](double *array, size_t stride,
+                                              size_t len, double &cst,
+                                              size_t &partLen) {
+            if (len > 1) {
+                partLen = npart;
+                return (double *)((void *)(((char *)array) + begin * stride));
+            }
+            partLen = len;
+            if (len == 1) {
+                cst = *array;
+                return &cst;
+            }
+            return static_cast<double *>(nullptr);
+        };
+        size_t nxPart, nyPart, nzPart, ntPart;
+        double *xPart = partArray(x, sx, nx, constant.xyzt.x, nxPart);
+        double *yPart = partArray(y, sy, ny, constant.xyzt.y, nyPart);
+        double *zPart = partArray(z, sz, nz, constant.xyzt.z, nzPart);
+        double *tPart = partArray(t, st, nt, constant.xyzt.t, ntPart);
+
+        PJ *worker = workers[i];
+        proj_context_errno_set(worker->ctx, 0);
+        proj_trans_generic(worker, direction, xPart, sx, nxPart, yPart, sy,
+                           nyPart, zPart, sz, nzPart, tPart, st, ntPart);
+        partErrnos[i] = proj_errno(worker);
+    });
+
+    /* update the length 1 cases with the transformed value of the last
+     * coordinate */
+    const PJ_COORD &last = constants.back();
+    if (nx == 1)
+        *x = last.xyzt.x;
+    if (ny == 1)
+        *y = last.xyzt.y;
+    if (nz == 1)
+        *z = last.xyzt.z;
+    if (nt == 1)
+        *t = last.xyzt.t;
+
+    for (int partErrno : partErrnos) {
+        if (partErrno != 0) {
+            proj_context_errno_set(P->ctx, partErrno);
+            break;
+        }
+    }
+    // for proj_trans_get_last_used_operation()
+    P->iCurCoordOp = workers.back()->iCurCoordOp;
+
+    return nmin;
+}
+
+/*************************************************************************************/
+static bool pj_lon_ranges_intersect(double west1, double east1, double west2,
+                                    double east2) {
+    /**************************************************************************************
+        Whether two longitude ranges, in degrees, intersect. West may be
+    greater than east for a range crossing the antimeridian.
+    **************************************************************************************/
+    if (west1 > east1) {
+        return pj_lon_ranges_intersect(west1, 180, west2, east2) ||
+               pj_lon_ranges_intersect(-180, east1, west2, east2);
+    }
+    if (west2 > east2) {
+        return pj_lon_ranges_intersect(west1, east1, west2, 180) ||
+               pj_lon_ranges_intersect(west1, east1, -180, east2);
+    }
+    return west1 <= east2 && west2 <= east1;
+}
+
+/*************************************************************************************/
+static void pj_prepare_for_area(PJ *P, double west_lon_degree,
+                                double south_lat_degree, double east_lon_degree,
+                                double north_lat_degree) {
+    if (!P->prepare_for_area)
+        return;
+    const double south = south_lat_degree * DEG_TO_RAD;
+    const double north = north_lat_degree * DEG_TO_RAD;
+    if (west_lon_degree > east_lon_degree) {
+        P->prepare_for_area(P, west_lon_degree * DEG_TO_RAD, south, M_PI,
+                            north);
+        P->prepare_for_area(P, -M_PI, south, east_lon_degree * DEG_TO_RAD,
+                            north);
+    } else {
+        P->prepare_for_area(P, west_lon_degree * DEG_TO_RAD, south,
+                            east_lon_degree * DEG_TO_RAD, north);
+    }
+}
+
+/*************************************************************************************/
+int proj_prepare_for_area(PJ *P, double west_lon_degree,
+                          double south_lat_degree, double east_lon_degree,
+                          double north_lat_degree) {
+    /**************************************************************************************
+        Open the grids used by P within the specified extent, and load their
+    parts intersecting it in the grid caches, so that the first coordinates
+    transformed within that extent do not wait for them to be read,
+    downloaded or decompressed.
+
+    When P has alternative coordinate operations, as created by
+    proj_create_crs_to_crs(), only those whose area of use intersects the
+    extent are considered, and the grids that cannot be opened are ignored,
+    as they are when transforming coordinates.
+
+    Returns 1 on success, 0 on error.
+    **************************************************************************************/
+    if (nullptr == P) {
+        proj_log_error(P, _("NULL P object not allowed."));
+        proj_errno_set(P, PROJ_ERR_OTHER_API_MISUSE);
+        return 0;
+    }
+    if (!(south_lat_degree >= -90 && south_lat_degree <= north_lat_degree &&
+          north_lat_degree <= 90 && west_lon_degree >= -180 &&
+          west_lon_degree <= 180 && east_lon_degree >= -180 &&
+          east_lon_degree <= 180)) {
+        proj_log_error(P, _("Invalid extent."));
+        proj_errno_set(P, PROJ_ERR_OTHER_API_MISUSE);
+        return 0;
+    }
 
-        coord = proj_trans(P, direction, coord);
+    const int last_errno = proj_errno_reset(P);
+    if (P->alternativeCoordinateOperations.empty()) {
+        pj_prepare_for_area(P, west_lon_degree, south_lat_degree,
+                            east_lon_degree, north_lat_degree);
+        if (proj_errno(P))
+            return 0;
+        proj_errno_restore(P, last_errno);
+        return 1;
+    }
 
-        /* in all full length cases, we overwrite the input with the output,  */
-        /* and step on to the next element.                                   */
-        /* The casts are somewhat funky, but they compile down to no-ops and  */
-        /* they tell compilers and static analyzers that we know what we do   */
-        if (nx > 1) {
-            *x = coord.xyzt.x;
-            x = (double *)((void *)(((char *)x) + sx));
-        }
-        if (ny > 1) {
-            *y = coord.xyzt.y;
-            y = (double *)((void *)(((char *)y) + sy));
-        }
-        if (nz > 1) {
-            *z = coord.xyzt.z;
-            z = (double *)((void *)(((char *)z) + sz));
-        }
-        if (nt > 1) {
-            *t = coord.xyzt.t;
-            t = (double *)((void *)(((char *)t) + st));
+    for (auto &alt : P->alternativeCoordinateOperations) {
+        double west = 0;
+        double south = 0;
+        double east = 0;
+        double north = 0;
+        if (proj_get_area_of_use(P->ctx, alt.pj, &west, &south, &east,
+                                 &north, nullptr) &&
+            west != -1000 &&
+            !(south <= north_lat_degree && south_lat_degree <= north &&
+              pj_lon_ranges_intersect(west, east, west_lon_degree,
+                                      east_lon_degree))) {
+            continue;
         }
+        pj_prepare_for_area(alt.instantiate(), west_lon_degree,
+                            south_lat_degree, east_lon_degree,
+                            north_lat_degree);
+        proj_errno_reset(alt.pj);
     }
-
-    /* Last time around, we update the length 1 cases with their transformed
-     * alter egos */
-    if (nx == 1)
-        *x = coord.xyzt.x;
-    if (ny == 1)
-        *y = coord.xyzt.y;
-    if (nz == 1)
-        *z = coord.xyzt.z;
-    if (nt == 1)
-        *t = coord.xyzt.t;
-
-    return i;
+    proj_errno_restore(P, last_errno);
+    return 1;
 }
 
 /*************************************************************************************/
@@ -1126,6 +2026,7 @@ void proj_context_use_proj4_init_rules(PJ_CONTEXT *ctx, int enable) {
         ctx = pj_get_default_ctx();
     }
     ctx->use_proj4_init_rules = enable;
+    ctx->settingsChanged();
 }
 
 /************************************************************************/
@@ -1952,7 +2853,8 @@ PJ *proj_create_crs_to_crs(PJ_CONTEXT *ctx, const char *source_crs,
 /*****************************************************************************/
 std::vector<PJCoordOperation>
 pj_create_prepared_operations(PJ_CONTEXT *ctx, const PJ *source_crs,
-                              const PJ *target_crs, PJ_OBJ_LIST *op_list)
+                              const PJ *target_crs, PJ_OBJ_LIST *op_list,
+                              bool lazyInstantiation)
 /*****************************************************************************/
 {
     PJ *pjGeogToSrc = nullptr;
@@ -2002,9 +2904,15 @@ pj_create_prepared_operations(PJ_CONTEXT *ctx, const PJ *source_crs,
 
         // Iterate over source->target candidate transformations and reproject
         // their long-lat bounding box into the source CRS.
+        // When lazyInstantiation is set, only the ISO-19111 objects of the
+        // operations are created, and their PROJ pipeline (and grids) is
+        // only instantiated by PJCoordOperation::instantiate(), when they
+        // are first selected.
         const auto op_count = proj_list_get_count(op_list);
         for (int i = 0; i < op_count; i++) {
-            auto op = proj_list_get(ctx, op_list, i);
+            auto op = lazyInstantiation
+                          ? pj_list_get_uninstantiated(ctx, op_list, i)
+                          : proj_list_get(ctx, op_list, i);
             assert(op);
             double west_lon = 0.0;
             double south_lat = 0.0;
@@ -2026,7 +2934,10 @@ pj_create_prepared_operations(PJ_CONTEXT *ctx, const PJ *source_crs,
                     pjGeogToSrc, pjGeogToDst, pjSrcGeocentricToLonLat,
                     pjDstGeocentricToLonLat, areaName, preparedOpList);
             } else {
-                auto op_clone = proj_clone(ctx, op);
+                auto op_clone =
+                    lazyInstantiation
+                        ? pj_list_get_uninstantiated(ctx, op_list, i)
+                        : proj_clone(ctx, op);
 
                 op = add_coord_op_to_list(
                     i, op, west_lon, south_lat, 180, north_lat, pjGeogToSrc,
@@ -2041,6 +2952,10 @@ pj_create_prepared_operations(PJ_CONTEXT *ctx, const PJ *source_crs,
 
             proj_destroy(op);
         }
+        if (lazyInstantiation) {
+            for (auto &op : preparedOpList)
+                op.isInstantiated = false;
+        }
 
         proj_destroy(pjGeogToSrc);
         proj_destroy(pjGeogToDst);
@@ -2068,6 +2983,511 @@ static const char *getOptionValue(const char *option,
 }
 //! @endcond
 
+/*****************************************************************************/
+static PJ *
+pj_set_alternative_operations(PJ *P,
+                              std::vector<PJCoordOperation> &&preparedOpList,
+                              bool forceOver)
+/*****************************************************************************/
+{
+    P->alternativeCoordinateOperations = std::move(preparedOpList);
+    P->alternativeCoordinateOperationsIndex =
+        pj_create_coord_operation_index(P->alternativeCoordinateOperations);
+    // The returned P is rather dummy
+    P->descr = "Set of coordinate operations";
+    P->over = forceOver;
+    P->iso_obj = nullptr;
+    P->fwd = nullptr;
+    P->inv = nullptr;
+    P->fwd3d = nullptr;
+    P->inv3d = nullptr;
+    P->fwd4d = nullptr;
+    P->inv4d = nullptr;
+    P->fwd4d_n = nullptr;
+    P->inv4d_n = nullptr;
+
+    return P;
+}
+
+// ---------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+
+// Serialization of the results of proj_create_crs_to_crs_from_pj(), used by
+// its persistent cache, enabled with
+// proj_context_set_crs_to_crs_cache_enable(), and by proj_as_compiled(). It
+// holds the operations found for a given request, with the bounding boxes and
+// accuracies computed by pj_create_prepared_operations(), so that they can be
+// rebuilt without running the operation factory. The cache stores the
+// PROJJSON of the operations, so that their ISO-19111 objects (identifiers,
+// source and target CRS...) are rebuilt too, and compiled transformations only
+// their PROJ pipeline.
+//
+// Its first line is a magic string, and its second one the key of the
+// request in the cache, or the PROJ version in compiled transformations.
+
+static const char *const CRS_TO_CRS_CACHE_MAGIC = "PROJ crs_to_crs cache 2";
+static const char *const COMPILED_MAGIC = "PROJ compiled transformation 1";
+
+static std::string crs_to_crs_single_line(const std::string &str) {
+    std::string res(str);
+    std::replace(res.begin(), res.end(), '\n', ' ');
+    return res;
+}
+
+// Doubles are stored as their bit pattern, so that they are restored exactly
+static std::string crs_to_crs_encode_double(double val) {
+    uint64_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    char szBuffer[17];
+    snprintf(szBuffer, sizeof(szBuffer), "%016llx",
+             static_cast<unsigned long long>(bits));
+    return szBuffer;
+}
+
+static double crs_to_crs_decode_double(const std::string &str) {
+    const uint64_t bits =
+        static_cast<uint64_t>(strtoull(str.c_str(), nullptr, 16));
+    double val;
+    memcpy(&val, &bits, sizeof(val));
+    return val;
+}
+
+static std::string crs_to_crs_cache_file_version(PJ_CONTEXT *ctx,
+                                                 const std::string &path) {
+    auto file = NS_PROJ::FileManager::open(ctx, path.c_str(),
+                                           NS_PROJ::FileAccess::READ_ONLY);
+    return file ? file->versionKey() : std::string();
+}
+
+static std::string crs_to_crs_cache_directory(PJ_CONTEXT *ctx) {
+    std::string path(proj_context_get_user_writable_directory(ctx, true));
+    path += "/crs_to_crs_cache";
+    NS_PROJ::FileManager::mkdir(ctx, path.c_str());
+    return path;
+}
+
+/** Return the key of a request, or an empty string if it cannot be cached. */
+static std::string crs_to_crs_cache_key(PJ_CONTEXT *ctx, const PJ *source_crs,
+                                        const PJ *target_crs,
+                                        const PJ_AREA *area,
+                                        const char *const *options) {
+    const char *const wktOptions[] = {"MULTILINE=NO", nullptr};
+    const char *sourceWKT =
+        proj_as_wkt(ctx, source_crs, PJ_WKT2_2019, wktOptions);
+    const char *targetWKT =
+        proj_as_wkt(ctx, target_crs, PJ_WKT2_2019, wktOptions);
+    const char *dbPath = proj_context_get_database_path(ctx);
+    if (!sourceWKT || !targetWKT || !dbPath) {
+        return std::string();
+    }
+
+    std::string key(proj_info().version);
+    key += '|';
+    key += sourceWKT;
+    key += '|';
+    key += targetWKT;
+    key += '|';
+    if (area && area->bbox_set) {
+        key += toString(area->west_lon_degree, 17);
+        key += ',';
+        key += toString(area->south_lat_degree, 17);
+        key += ',';
+        key += toString(area->east_lon_degree, 17);
+        key += ',';
+        key += toString(area->north_lat_degree, 17);
+        key += ',';
+        key += area->name;
+    }
+    key += '|';
+    for (auto iter = options; iter && iter[0]; ++iter) {
+        // Does not change the operations found
+        if (ci_starts_with(*iter, "LAZY_INSTANTIATION=")) {
+            continue;
+        }
+        key += *iter;
+        key += ',';
+    }
+
+    // The operations depend on the content of the database...
+    std::vector<std::string> dbPaths{dbPath};
+    const auto &auxDbPaths = ctx->get_cpp_context()->getAuxDbPaths();
+    dbPaths.insert(dbPaths.end(), auxDbPaths.begin(), auxDbPaths.end());
+    for (const auto &path : dbPaths) {
+        const auto version = crs_to_crs_cache_file_version(ctx, path);
+        if (version.empty()) {
+            return std::string();
+        }
+        key += '|';
+        key += path;
+        key += '@';
+        key += version;
+    }
+    if (auxDbPaths.empty()) {
+        const char *auxDbStr = getenv("PROJ_AUX_DB");
+        if (auxDbStr) {
+            key += '|';
+            key += auxDbStr;
+        }
+    }
+
+    // ... and on the grids that are available locally when the network is
+    // disabled. The modification time of the directories where they are
+    // looked for changes when grids are added or removed.
+    key += '|';
+    if (proj_context_is_network_enabled(ctx)) {
+        key += "network:";
+        key += proj_context_get_url_endpoint(ctx);
+    } else {
+        // Created first, so that it does not change the modification time
+        // of the user writable directory afterwards.
+        crs_to_crs_cache_directory(ctx);
+        auto searchPaths = ctx->search_paths.empty()
+                               ? pj_get_default_searchpaths(ctx)
+                               : ctx->search_paths;
+        searchPaths.emplace_back(
+            proj_context_get_user_writable_directory(ctx, false));
+        for (const auto &path : searchPaths) {
+            key += '|';
+            key += path;
+            struct stat st;
+            if (stat(path.c_str(), &st) == 0) {
+                key += '@';
+                key +=
+                    std::to_string(static_cast<long long>(st.st_mtime));
+            }
+        }
+    }
+
+    return crs_to_crs_single_line(key);
+}
+
+static std::string crs_to_crs_cache_filename(PJ_CONTEXT *ctx,
+                                             const std::string &key) {
+    // FNV-1a hash of the key
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char ch : key) {
+        hash ^= static_cast<unsigned char>(ch);
+        hash *= 1099511628211ULL;
+    }
+    char hashStr[17];
+    snprintf(hashStr, sizeof(hashStr), "%016llx",
+             static_cast<unsigned long long>(hash));
+
+    std::string path(crs_to_crs_cache_directory(ctx));
+    path += '/';
+    path += hashStr;
+    path += ".txt";
+    return path;
+}
+
+static std::string crs_to_crs_pipeline(PJ_CONTEXT *ctx, const PJ *op) {
+    if (!op) {
+        return std::string();
+    }
+    const char *pipeline = proj_as_proj_string(ctx, op, PJ_PROJ_5, nullptr);
+    return pipeline ? crs_to_crs_single_line(pipeline) : std::string();
+}
+
+/** Return the definition of an operation: its PROJJSON if withISOObjects is
+ * set, and its PROJ pipeline otherwise. */
+static std::string crs_to_crs_definition(PJ_CONTEXT *ctx, const PJ *op,
+                                         bool withISOObjects) {
+    if (!withISOObjects) {
+        return crs_to_crs_pipeline(ctx, op);
+    }
+    // The PROJJSON of a conversion does not hold its source and target CRS,
+    // without which it could not be rebuilt as it was.
+    if (dynamic_cast<const NS_PROJ::operation::Conversion *>(
+            op->iso_obj.get())) {
+        return std::string();
+    }
+    const char *const options[] = {"MULTILINE=NO", nullptr};
+    const char *json = proj_as_projjson(ctx, op, options);
+    return json ? crs_to_crs_single_line(json) : std::string();
+}
+
+/** Append to content the serialization of the result of
+ * proj_create_crs_to_crs_from_pj(), which is either singleOp, or the list of
+ * alternative operations ops. Operations are stored as PROJJSON if
+ * withISOObjects is set, and as PROJ pipelines otherwise. */
+static bool crs_to_crs_serialize(PJ_CONTEXT *ctx, const PJ *singleOp,
+                                 const std::vector<PJCoordOperation> &ops,
+                                 bool withISOObjects, std::string &content) {
+    if (singleOp) {
+        const auto pipeline =
+            crs_to_crs_definition(ctx, singleOp, withISOObjects);
+        if (pipeline.empty()) {
+            return false;
+        }
+        content += "0\n";
+        content += pipeline;
+        content += '\n';
+    } else {
+        content += toString(static_cast<int>(ops.size()));
+        content += '\n';
+        for (const auto &op : ops) {
+            const auto pipeline =
+                crs_to_crs_definition(ctx, op.pj, withISOObjects);
+            if (pipeline.empty()) {
+                return false;
+            }
+            content += toString(op.idxInOriginalList);
+            for (const double val :
+                 {op.minxSrc, op.minySrc, op.maxxSrc, op.maxySrc, op.minxDst,
+                  op.minyDst, op.maxxDst, op.maxyDst, op.accuracy,
+                  op.pseudoArea}) {
+                content += ' ';
+                content += crs_to_crs_encode_double(val);
+            }
+            for (const bool flag :
+                 {op.srcIsLonLatDegree, op.srcIsLatLonDegree,
+                  op.dstIsLonLatDegree, op.dstIsLatLonDegree}) {
+                content += flag ? " 1" : " 0";
+            }
+            content += '\n';
+            content += crs_to_crs_single_line(op.name);
+            content += '\n';
+            content += crs_to_crs_single_line(op.areaName);
+            content += '\n';
+            content += pipeline;
+            content += '\n';
+            content +=
+                crs_to_crs_pipeline(ctx, op.pjSrcGeocentricToLonLat);
+            content += '\n';
+            content +=
+                crs_to_crs_pipeline(ctx, op.pjDstGeocentricToLonLat);
+            content += '\n';
+        }
+    }
+    return true;
+}
+
+/** Store the result of proj_create_crs_to_crs_from_pj(), which is either
+ * singleOp, or the list of alternative operations ops. */
+static void crs_to_crs_cache_put(PJ_CONTEXT *ctx, const std::string &key,
+                                 const PJ *singleOp,
+                                 const std::vector<PJCoordOperation> &ops) {
+    const int old_errno = proj_context_errno(ctx);
+    std::string content(CRS_TO_CRS_CACHE_MAGIC);
+    content += '\n';
+    content += key;
+    content += '\n';
+    const bool ok = crs_to_crs_serialize(ctx, singleOp, ops, true, content);
+    proj_context_errno_set(ctx, old_errno);
+    if (!ok) {
+        return;
+    }
+
+    // Write to a temporary file renamed afterwards, so that concurrent
+    // readers never see a partial file.
+    const auto filename = crs_to_crs_cache_filename(ctx, key);
+#ifdef _WIN32
+    const int nPID = _getpid();
+#else
+    const int nPID = getpid();
+#endif
+    char szUniqueSuffix[128];
+    snprintf(szUniqueSuffix, sizeof(szUniqueSuffix), ".%d_%p.tmp", nPID,
+             static_cast<const void *>(&content));
+    const auto tmpFilename(filename + szUniqueSuffix);
+    {
+        auto file = NS_PROJ::FileManager::open(ctx, tmpFilename.c_str(),
+                                               NS_PROJ::FileAccess::CREATE);
+        if (!file) {
+            proj_context_log_debug(ctx, "Cannot create %s",
+                                   tmpFilename.c_str());
+            return;
+        }
+        if (file->write(content.data(), content.size()) != content.size()) {
+            file.reset();
+            NS_PROJ::FileManager::unlink(ctx, tmpFilename.c_str());
+            return;
+        }
+    }
+    if (!NS_PROJ::FileManager::rename(ctx, tmpFilename.c_str(),
+                                      filename.c_str())) {
+        NS_PROJ::FileManager::unlink(ctx, tmpFilename.c_str());
+    }
+}
+
+static std::string compiled_header() {
+    std::string header(COMPILED_MAGIC);
+    header += "\nPROJ ";
+    header += proj_info().version;
+    header += '\n';
+    return header;
+}
+
+/** Create an operation from its definition, which is either a PROJ pipeline,
+ * or its PROJJSON if useISOObjects is set. */
+static PJ *crs_to_crs_create_op(PJ_CONTEXT *ctx, const std::string &pipeline,
+                                bool useISOObjects, bool lazyInstantiation) {
+    if (pipeline.empty()) {
+        return nullptr;
+    }
+    if (!useISOObjects) {
+        PJ *P = pj_create_internal(ctx, pipeline.c_str());
+        if (P) {
+            // So that it can be cloned without the ISO-19111 objects
+            P->lastCompiled = compiled_header() + "0\n" + pipeline + '\n';
+            P->createdFromCompiled = true;
+        }
+        return P;
+    }
+    try {
+        auto obj = pipeline[0] == '{'
+                       ? NS_PROJ::io::createFromUserInput(pipeline, ctx)
+                       : NS_PROJ::io::PROJStringParser()
+                             .attachContext(ctx)
+                             .createFromPROJString(pipeline);
+        return lazyInstantiation ? pj_obj_create_uninstantiated(ctx, obj)
+                                 : pj_obj_create(ctx, obj);
+    } catch (const std::exception &) {
+        return nullptr;
+    }
+}
+
+/** Rebuild the result of proj_create_crs_to_crs_from_pj() from the lines
+ * of its serialization. The objects of the ISO-19111 model of the operations
+ * are only rebuilt, from their PROJJSON, if useISOObjects is set. */
+static PJ *crs_to_crs_deserialize(PJ_CONTEXT *ctx,
+                                  const std::vector<std::string> &lines,
+                                  bool useISOObjects, bool lazyInstantiation,
+                                  bool forceOver,
+                                  bool warnIfBestTransformationNotAvailable) {
+    // Magic, key, count, and at least one operation
+    if (lines.size() < 4) {
+        return nullptr;
+    }
+    // Lazy instantiation requires the ISO-19111 objects
+    lazyInstantiation = lazyInstantiation && useISOObjects;
+    // A count of 0 means a single operation, stored as its definition.
+    // Otherwise each alternative operation is stored in LINES_PER_OP lines.
+    const int count = atoi(lines[2].c_str());
+    constexpr int LINES_PER_OP = 6;
+    if (count < 0 ||
+        lines.size() < 3 + (count == 0 ? 1
+                                       : static_cast<size_t>(count) *
+                                             LINES_PER_OP)) {
+        return nullptr;
+    }
+
+    ctx->forceOver = forceOver;
+    PJ *P = nullptr;
+    if (count == 0) {
+        P = crs_to_crs_create_op(ctx, lines[3], useISOObjects, false);
+    } else {
+        std::vector<PJCoordOperation> preparedOpList;
+        bool ok = true;
+        for (int i = 0; ok && i < count; ++i) {
+            const auto *opLines = &lines[3 + i * LINES_PER_OP];
+            const auto values = split(opLines[0], ' ');
+            if (values.size() != 15) {
+                ok = false;
+                break;
+            }
+            std::vector<double> dv;
+            for (size_t j = 1; j <= 10; ++j) {
+                dv.push_back(crs_to_crs_decode_double(values[j]));
+            }
+            auto pj = crs_to_crs_create_op(ctx, opLines[3], useISOObjects,
+                                           lazyInstantiation);
+            auto pjSrcGeocentricToLonLat =
+                crs_to_crs_create_op(ctx, opLines[4], useISOObjects, false);
+            auto pjDstGeocentricToLonLat =
+                crs_to_crs_create_op(ctx, opLines[5], useISOObjects, false);
+            if (!pj || (!opLines[4].empty() && !pjSrcGeocentricToLonLat) ||
+                (!opLines[5].empty() && !pjDstGeocentricToLonLat)) {
+                ok = false;
+                proj_destroy(pj);
+            } else {
+                preparedOpList.emplace_back(
+                    atoi(values[0].c_str()), dv[0], dv[1], dv[2], dv[3],
+                    dv[4], dv[5], dv[6], dv[7], pj, opLines[1], dv[8], dv[9],
+                    opLines[2].c_str(), pjSrcGeocentricToLonLat,
+                    pjDstGeocentricToLonLat);
+                auto &op = preparedOpList.back();
+                // The axis order of the CRS cannot be retrieved from the
+                // pipeline
+                op.srcIsLonLatDegree = values[11] == "1";
+                op.srcIsLatLonDegree = values[12] == "1";
+                op.dstIsLonLatDegree = values[13] == "1";
+                op.dstIsLatLonDegree = values[14] == "1";
+                op.isInstantiated = !lazyInstantiation;
+                op.pj->over = forceOver;
+                op.pj->warnIfBestTransformationNotAvailable =
+                    warnIfBestTransformationNotAvailable;
+            }
+            proj_destroy(pjSrcGeocentricToLonLat);
+            proj_destroy(pjDstGeocentricToLonLat);
+        }
+        if (ok) {
+            if (preparedOpList.size() == 1) {
+                P = preparedOpList[0].instantiate();
+                preparedOpList[0].pj = nullptr;
+            } else {
+                // First operation, like in
+                // proj_create_crs_to_crs_from_pj()
+                P = crs_to_crs_create_op(ctx, lines[3 + 3], useISOObjects,
+                                         false);
+                if (P) {
+                    P = pj_set_alternative_operations(
+                        P, std::move(preparedOpList), forceOver);
+                }
+            }
+        }
+    }
+    ctx->forceOver = false;
+
+    if (P) {
+        P->over = forceOver;
+        P->warnIfBestTransformationNotAvailable =
+            warnIfBestTransformationNotAvailable;
+        P->skipNonInstantiable = warnIfBestTransformationNotAvailable;
+    }
+    return P;
+}
+
+/** Return the result of proj_create_crs_to_crs_from_pj() stored for key,
+ * or nullptr. */
+static PJ *crs_to_crs_cache_get(PJ_CONTEXT *ctx, const std::string &key,
+                                bool lazyInstantiation, bool forceOver,
+                                bool warnIfBestTransformationNotAvailable) {
+    const auto filename = crs_to_crs_cache_filename(ctx, key);
+    auto file = NS_PROJ::FileManager::open(ctx, filename.c_str(),
+                                           NS_PROJ::FileAccess::READ_ONLY);
+    if (!file) {
+        return nullptr;
+    }
+    std::string content;
+    char buffer[4096];
+    size_t nRead;
+    while ((nRead = file->read(buffer, sizeof(buffer))) > 0) {
+        content.append(buffer, nRead);
+    }
+    file.reset();
+
+    const auto lines = split(content, '\n');
+    if (lines.size() < 2 || lines[0] != CRS_TO_CRS_CACHE_MAGIC ||
+        lines[1] != key) {
+        return nullptr;
+    }
+
+    const int old_errno = proj_context_errno(ctx);
+    const int old_debug_level = ctx->debug_level;
+    if (warnIfBestTransformationNotAvailable)
+        ctx->debug_level = PJ_LOG_NONE;
+    PJ *P = crs_to_crs_deserialize(ctx, lines, true, lazyInstantiation,
+                                   forceOver,
+                                   warnIfBestTransformationNotAvailable);
+    ctx->debug_level = old_debug_level;
+    proj_context_errno_set(ctx, old_errno);
+    return P;
+}
+
+//! @endcond
+
 /*****************************************************************************/
 PJ *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
                                    const PJ *target_crs, PJ_AREA *area,
@@ -2089,6 +3509,7 @@ PJ *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
     double accuracy = -1;
     bool allowBallparkTransformations = true;
     bool forceOver = false;
+    bool lazyInstantiation = false;
     bool warnIfBestTransformationNotAvailable =
         ctx->warnIfBestTransformationNotAvailableDefault;
     bool errorIfBestTransformationNotAvailable =
@@ -2124,6 +3545,16 @@ PJ *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
             if (ci_equal(value, "yes")) {
                 forceOver = true;
             }
+        } else if ((value = getOptionValue(*iter, "LAZY_INSTANTIATION="))) {
+            if (ci_equal(value, "yes"))
+                lazyInstantiation = true;
+            else if (ci_equal(value, "no"))
+                lazyInstantiation = false;
+            else {
+                ctx->logger(ctx->logger_app_data, PJ_LOG_ERROR,
+                            "Invalid value for LAZY_INSTANTIATION option.");
+                return nullptr;
+            }
         } else {
             std::string msg("Unknown option :");
             msg += *iter;
@@ -2132,6 +3563,23 @@ PJ *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
         }
     }
 
+    // Failures of ONLY_BEST=YES must be diagnosed each time, so its results
+    // are not cached.
+    std::string cacheKey;
+    if (ctx->crsToCrsCache && !errorIfBestTransformationNotAvailable) {
+        cacheKey =
+            crs_to_crs_cache_key(ctx, source_crs, target_crs, area, options);
+        if (!cacheKey.empty()) {
+            cacheKey += warnIfBestTransformationNotAvailable ? "|warn" : "";
+            PJ *P = crs_to_crs_cache_get(ctx, cacheKey, lazyInstantiation,
+                                         forceOver,
+                                         warnIfBestTransformationNotAvailable);
+            if (P) {
+                return P;
+            }
+        }
+    }
+
     auto operation_ctx = proj_create_operation_factory_context(ctx, authority);
     if (!operation_ctx) {
         return nullptr;
@@ -2234,6 +3682,12 @@ PJ *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
 
         if (P != nullptr) {
             P->over = forceOver;
+            // Operations with missing grids are not cached, so that the
+            // warning is emitted again.
+            if (!cacheKey.empty() && (!warnIfBestTransformationNotAvailable ||
+                                      singleOpIsInstanciable == 1)) {
+                crs_to_crs_cache_put(ctx, cacheKey, P, {});
+            }
         }
         return P;
     } else if (op_count == 1 && mayNeedToReRunWithDiscardMissing &&
@@ -2244,8 +3698,8 @@ PJ *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
     if (errorIfBestTransformationNotAvailable ||
         warnIfBestTransformationNotAvailable)
         ctx->debug_level = PJ_LOG_NONE;
-    auto preparedOpList =
-        pj_create_prepared_operations(ctx, source_crs, target_crs, op_list);
+    auto preparedOpList = pj_create_prepared_operations(
+        ctx, source_crs, target_crs, op_list, lazyInstantiation);
     ctx->debug_level = old_debug_level;
 
     ctx->forceOver = false;
@@ -2316,7 +3770,7 @@ PJ *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
                 ctx->forceOver = forceOver;
                 ctx->debug_level = PJ_LOG_NONE;
                 auto preparedOpList2 = pj_create_prepared_operations(
-                    ctx, source_crs, target_crs, op_list);
+                    ctx, source_crs, target_crs, op_list, lazyInstantiation);
                 ctx->debug_level = old_debug_level;
                 ctx->forceOver = false;
                 proj_list_destroy(op_list);
@@ -2363,26 +3817,186 @@ PJ *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
         }
     }
 
+    if (!cacheKey.empty()) {
+        crs_to_crs_cache_put(ctx, cacheKey, nullptr, preparedOpList);
+    }
+
     // If there's finally juste a single result, return it directly
     if (preparedOpList.size() == 1) {
-        auto retP = preparedOpList[0].pj;
+        auto retP = preparedOpList[0].instantiate();
         preparedOpList[0].pj = nullptr;
         proj_destroy(P);
         return retP;
     }
 
-    P->alternativeCoordinateOperations = std::move(preparedOpList);
-    // The returned P is rather dummy
-    P->descr = "Set of coordinate operations";
-    P->over = forceOver;
-    P->iso_obj = nullptr;
-    P->fwd = nullptr;
-    P->inv = nullptr;
-    P->fwd3d = nullptr;
-    P->inv3d = nullptr;
-    P->fwd4d = nullptr;
-    P->inv4d = nullptr;
+    return pj_set_alternative_operations(P, std::move(preparedOpList),
+                                         forceOver);
+}
+
+/*****************************************************************************/
+/** Set whether the operations found by proj_create_crs_to_crs() and
+ * proj_create_crs_to_crs_from_pj() are kept in a persistent cache.
+ *
+ * When enabled, the operations found between two CRS, in PROJJSON, with
+ * their area of use and accuracy, are stored in a file of the
+ * crs_to_crs_cache subdirectory of the user writable directory. Later calls
+ * with the same CRS, area and options, including by other processes, rebuild
+ * the transformation from that file instead of searching operations in the
+ * database, which is much faster for complex cases, such as between compound
+ * CRS. Those files are identified by the version of the database and the
+ * modification time of the directories where grids are searched, so that
+ * they are not used anymore when the database is updated or grids are
+ * installed. They can be removed at any time.
+ *
+ * Operations restored from the cache keep the metadata (identifiers, source
+ * and target CRS, etc.) of the original operations. Results including a
+ * conversion, whose PROJJSON does not hold its source and target CRS, are not
+ * cached. The cache is not used when ONLY_BEST=YES is set.
+ *
+ * This overrides the crs_to_crs_cache setting of proj.ini.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param enabled TRUE if the operations must be cached.
+ * @since 9.6
+ */
+void proj_context_set_crs_to_crs_cache_enable(PJ_CONTEXT *ctx, int enabled) {
+    if (!ctx) {
+        ctx = pj_get_default_ctx();
+    }
+    // Load ini file, now so as to override its settings
+    pj_load_ini(ctx);
+    ctx->crsToCrsCache = enabled != FALSE;
+    ctx->settingsChanged();
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Return a compiled form of a transformation, that can be loaded with
+ * proj_create_from_compiled().
+ *
+ * The compiled form holds the PROJ pipelines of the candidate operations of
+ * an object returned by proj_create_crs_to_crs() or
+ * proj_create_crs_to_crs_from_pj(), together with their areas of use and
+ * accuracies, or the PROJ pipeline of a single coordinate operation. Loading
+ * it does not need the database, nor the search of operations between the
+ * source and target CRS, which makes it suitable to start quickly processes
+ * that always use the same transformation. The grids used by the pipelines
+ * must still be available where it is loaded.
+ *
+ * The compiled form is a text string, which can only be loaded by PROJ
+ * versions that know its format. It does not hold the metadata of the
+ * operations (identifiers, remarks, etc.) apart from their names.
+ *
+ * The returned string is valid while obj is valid.
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param obj Object returned by proj_create_crs_to_crs(), or a coordinate
+ * operation (must not be NULL)
+ * @param options should be set to NULL. Reserved for future use.
+ * @return a string, or NULL in case of error.
+ * @since 9.6
+ */
+const char *proj_as_compiled(PJ_CONTEXT *ctx, const PJ *obj,
+                             const char *const *options) {
+    if (!ctx) {
+        ctx = pj_get_default_ctx();
+    }
+    if (!obj) {
+        proj_context_errno_set(ctx, PROJ_ERR_OTHER_API_MISUSE);
+        pj_log(ctx, PJ_LOG_ERROR,
+               "proj_as_compiled: missing required input");
+        return nullptr;
+    }
+    (void)options;
+    if (obj->lastCompiled.empty()) {
+        const PJ *singleOp = nullptr;
+        if (obj->alternativeCoordinateOperations.empty()) {
+            if (!obj->iso_obj_is_coordinate_operation) {
+                proj_context_errno_set(ctx, PROJ_ERR_OTHER_API_MISUSE);
+                pj_log(ctx, PJ_LOG_ERROR,
+                       "proj_as_compiled: Object is not a coordinate "
+                       "operation");
+                return nullptr;
+            }
+            singleOp = obj;
+        }
+        std::string content(compiled_header());
+        if (!crs_to_crs_serialize(ctx, singleOp,
+                                  obj->alternativeCoordinateOperations, false,
+                                  content)) {
+            pj_log(ctx, PJ_LOG_ERROR,
+                   "proj_as_compiled: Object cannot be compiled");
+            return nullptr;
+        }
+        obj->lastCompiled = std::move(content);
+    }
+    return obj->lastCompiled.c_str();
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Instantiate a transformation from its compiled form returned by
+ * proj_as_compiled().
+ *
+ * The returned object can be used with proj_trans() and related functions
+ * as the one it was compiled from. The database is not opened.
+ *
+ * The following options are supported:
+ * <ul>
+ * <li>FORCE_OVER=YES/NO: can be set to YES to force the +over flag on the
+ * returned transformation.</li>
+ * </ul>
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param compiled String returned by proj_as_compiled() (must not be NULL)
+ * @param options NULL-terminated list of options, or NULL.
+ * @return Object that must be unreferenced with proj_destroy(), or NULL in
+ * case of error.
+ * @since 9.6
+ */
+PJ *proj_create_from_compiled(PJ_CONTEXT *ctx, const char *compiled,
+                              const char *const *options) {
+    if (!ctx) {
+        ctx = pj_get_default_ctx();
+    }
+    if (!compiled) {
+        proj_context_errno_set(ctx, PROJ_ERR_OTHER_API_MISUSE);
+        pj_log(ctx, PJ_LOG_ERROR,
+               "proj_create_from_compiled: missing required input");
+        return nullptr;
+    }
+    bool forceOver = false;
+    for (auto iter = options; iter && iter[0]; ++iter) {
+        const char *value;
+        if ((value = getOptionValue(*iter, "FORCE_OVER="))) {
+            forceOver = ci_equal(value, "yes");
+        } else {
+            std::string msg("Unknown option :");
+            msg += *iter;
+            pj_log(ctx, PJ_LOG_ERROR, "proj_create_from_compiled: %s",
+                   msg.c_str());
+            return nullptr;
+        }
+    }
 
+    const auto lines = split(std::string(compiled), '\n');
+    if (lines.size() < 2 || lines[0] != COMPILED_MAGIC) {
+        proj_context_errno_set(ctx, PROJ_ERR_INVALID_OP_WRONG_SYNTAX);
+        pj_log(ctx, PJ_LOG_ERROR,
+               "proj_create_from_compiled: Not a compiled transformation");
+        return nullptr;
+    }
+    PJ *P = crs_to_crs_deserialize(ctx, lines, false, false, forceOver, false);
+    if (!P) {
+        if (proj_context_errno(ctx) == 0) {
+            proj_context_errno_set(ctx, PROJ_ERR_INVALID_OP_WRONG_SYNTAX);
+        }
+        pj_log(ctx, PJ_LOG_ERROR, "proj_create_from_compiled: "
+                                  "Cannot instantiate compiled transformation");
+        return nullptr;
+    }
+    P->lastCompiled = compiled;
+    P->createdFromCompiled = true;
     return P;
 }
 
@@ -2613,15 +4227,16 @@ PJ_PROJ_INFO proj_pj_info(PJ *P) {
     /* coordinate operation description */
     if (!P->alternativeCoordinateOperations.empty()) {
         if (P->iCurCoordOp >= 0) {
-            P = P->alternativeCoordinateOperations[P->iCurCoordOp].pj;
+            P = P->alternativeCoordinateOperations[P->iCurCoordOp]
+                    .instantiate();
         } else {
-            PJ *candidateOp = nullptr;
+            PJCoordOperation *candidateOp = nullptr;
             // If there's just a single coordinate operation which is
             // instanciable, use it.
-            for (const auto &op : P->alternativeCoordinateOperations) {
+            for (auto &op : P->alternativeCoordinateOperations) {
                 if (op.isInstantiable()) {
                     if (candidateOp == nullptr) {
-                        candidateOp = op.pj;
+                        candidateOp = &op;
                     } else {
                         candidateOp = nullptr;
                         break;
@@ -2629,7 +4244,7 @@ PJ_PROJ_INFO proj_pj_info(PJ *P) {
                 }
             }
             if (candidateOp) {
-                P = candidateOp;
+                P = candidateOp->instantiate();
             } else {
                 pjinfo.id = "unknown";
                 pjinfo.description = "unavailable until proj_trans is called";
@@ -3061,6 +4676,11 @@ PJCoordOperation::PJCoordOperation(
         }
     };
 
+    if (!pj->iso_obj) {
+        // Restored by proj_create_from_compiled()
+        return;
+    }
+
     const auto source = proj_get_source_crs(pj->ctx, pj);
     if (source) {
         IsLonLatOrLatLon(source, srcIsLonLatDegree, srcIsLatLonDegree);
@@ -267,19 +267,27 @@ PJ *PJ_CONVERSION(axisswap, 0) {
     if (n == 4) {
         P->fwd4d = pj_axisswap_forward_4d;
         P->inv4d = pj_axisswap_reverse_4d;
+        P->fwd4d_n = pj_operator_n_from_4d<pj_axisswap_forward_4d>;
+        P->inv4d_n = pj_operator_n_from_4d<pj_axisswap_reverse_4d>;
     }
     if (n == 3 && Q->axis[0] < 3 && Q->axis[1] < 3 && Q->axis[2] < 3) {
         P->fwd3d = pj_axisswap_forward_3d;
         P->inv3d = pj_axisswap_reverse_3d;
+        P->fwd4d_n = pj_operator_n_from_fwd3d<pj_axisswap_forward_3d>;
+        P->inv4d_n = pj_operator_n_from_inv3d<pj_axisswap_reverse_3d>;
     }
     if (n == 2) {
         if (Q->axis[0] == 1 && Q->sign[0] == 1 && Q->axis[1] == 0 &&
             Q->sign[1] == 1) {
             P->fwd4d = swap_xy_4d;
             P->inv4d = swap_xy_4d;
+            P->fwd4d_n = pj_operator_n_from_4d<swap_xy_4d>;
+            P->inv4d_n = pj_operator_n_from_4d<swap_xy_4d>;
         } else if (Q->axis[0] < 2 && Q->axis[1] < 2) {
             P->fwd = pj_axisswap_forward_2d;
             P->inv = pj_axisswap_reverse_2d;
+            P->fwd4d_n = pj_operator_n_from_fwd<pj_axisswap_forward_2d>;
+            P->inv4d_n = pj_operator_n_from_inv<pj_axisswap_reverse_2d>;
         }
     }
 
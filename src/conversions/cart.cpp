@@ -268,6 +268,8 @@ PJ *PJ_CONVERSION(cart, 1) {
     P->inv3d = geodetic;
     P->fwd = cart_forward;
     P->inv = cart_reverse;
+    P->fwd4d_n = pj_operator_n_from_fwd3d<cartesian>;
+    P->inv4d_n = pj_operator_n_from_inv3d<geodetic>;
     P->left = PJ_IO_UNITS_RADIANS;
     P->right = PJ_IO_UNITS_CARTESIAN;
     return P;
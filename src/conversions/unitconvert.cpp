@@ -458,6 +458,8 @@ PJ *PJ_CONVERSION(unitconvert, 0) {
     P->inv3d = reverse_3d;
     P->fwd = forward_2d;
     P->inv = reverse_2d;
+    P->fwd4d_n = pj_operator_n_from_4d<forward_4d>;
+    P->inv4d_n = pj_operator_n_from_4d<reverse_4d>;
 
     P->left = PJ_IO_UNITS_WHATEVER;
     P->right = PJ_IO_UNITS_WHATEVER;
@@ -32,6 +32,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <atomic>
 #include <new>
 
 #include "filemanager.hpp"
@@ -138,6 +139,7 @@ void pj_ctx::set_search_paths(const std::vector<std::string> &search_paths_in) {
             c_compat_paths[i] = search_paths[i].c_str();
         }
     }
+    settingsChanged();
 }
 
 /**************************************************************************/
@@ -146,6 +148,16 @@ void pj_ctx::set_search_paths(const std::vector<std::string> &search_paths_in) {
 
 void pj_ctx::set_ca_bundle_path(const std::string &ca_bundle_path_in) {
     ca_bundle_path = ca_bundle_path_in;
+    settingsChanged();
+}
+
+/**************************************************************************/
+/*                         newSettingsGeneration()                        */
+/**************************************************************************/
+
+unsigned long long pj_ctx::newSettingsGeneration() {
+    static std::atomic<unsigned long long> counter{0};
+    return ++counter;
 }
 
 /************************************************************************/
@@ -174,6 +186,12 @@ pj_ctx::pj_ctx(const pj_ctx &other)
       networking(other.networking), ca_bundle_path(other.ca_bundle_path),
       gridChunkCache(other.gridChunkCache),
       defaultTmercAlgo(other.defaultTmercAlgo),
+      loadGridsInMemory(other.loadGridsInMemory),
+      decodedGridCache(other.decodedGridCache),
+      objectCacheSize(other.objectCacheSize),
+      sharedObjectCacheSize(other.sharedObjectCacheSize),
+      crsToCrsCache(other.crsToCrsCache),
+      databaseOpenMode(other.databaseOpenMode),
       // END ini file settings
       projStringParserCreateFromPROJStringRecursionCounter(0),
       pipelineInitRecursiongCounter(0) {
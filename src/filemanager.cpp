@@ -45,6 +45,7 @@
 #include <string>
 
 #include "filemanager.hpp"
+#include "grids.hpp"
 #include "proj.h"
 #include "proj/internal/internal.hpp"
 #include "proj/internal/io_internal.hpp"
@@ -749,6 +750,8 @@ class FileStdio : public File {
     // We may lie, but the real use case is only for network files
     bool hasChanged() const override { return false; }
 
+    std::string versionKey() const override;
+
     static std::unique_ptr<File> open(PJ_CONTEXT *ctx, const char *filename,
                                       FileAccess access);
 };
@@ -759,6 +762,19 @@ FileStdio::~FileStdio() { fclose(m_fp); }
 
 // ---------------------------------------------------------------------------
 
+std::string FileStdio::versionKey() const {
+    struct stat st;
+    if (fstat(fileno(m_fp), &st) != 0)
+        return std::string();
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%lld-%lld",
+             static_cast<long long>(st.st_size),
+             static_cast<long long>(st.st_mtime));
+    return buffer;
+}
+
+// ---------------------------------------------------------------------------
+
 size_t FileStdio::read(void *buffer, size_t sizeBytes) {
     return fread(buffer, 1, sizeBytes, m_fp);
 }
@@ -1103,6 +1119,7 @@ int proj_context_set_fileapi(PJ_CONTEXT *ctx, const PROJ_FILE_API *fileapi,
     ctx->fileApi.unlink_cbk = fileapi->unlink_cbk;
     ctx->fileApi.rename_cbk = fileapi->rename_cbk;
     ctx->fileApi.user_data = user_data;
+    ctx->settingsChanged();
     return true;
 }
 
@@ -1126,6 +1143,7 @@ void proj_context_set_sqlite3_vfs_name(PJ_CONTEXT *ctx, const char *name) {
         ctx = pj_get_default_ctx();
     }
     ctx->custom_sqlite3_vfs_name = name ? name : std::string();
+    ctx->settingsChanged();
 }
 
 // ---------------------------------------------------------------------------
@@ -1240,6 +1258,7 @@ void proj_context_set_user_writable_directory(PJ_CONTEXT *ctx, const char *path,
     if (!ctx)
         ctx = pj_get_default_ctx();
     ctx->user_writable_directory = path ? path : "";
+    ctx->settingsChanged();
     if (!path || create) {
         proj_context_get_user_writable_directory(ctx, create);
     }
@@ -1799,6 +1818,25 @@ static std::string trim(const std::string &s) {
     return s.substr(first, last - first + 1);
 }
 
+/************************************************************************/
+/*                     pj_parse_database_open_mode()                    */
+/************************************************************************/
+
+bool pj_parse_database_open_mode(const char *value, DatabaseOpenMode &mode) {
+    if (ci_equal(value, "default")) {
+        mode = DatabaseOpenMode::DEFAULT;
+    } else if (ci_equal(value, "immutable")) {
+        mode = DatabaseOpenMode::IMMUTABLE;
+    } else if (ci_equal(value, "mmap")) {
+        mode = DatabaseOpenMode::MMAP;
+    } else if (ci_equal(value, "memory")) {
+        mode = DatabaseOpenMode::MEMORY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
 /************************************************************************/
 /*                            pj_load_ini()                             */
 /************************************************************************/
@@ -1850,6 +1888,7 @@ void pj_load_ini(PJ_CONTEXT *ctx) {
     }
 
     ctx->iniFileLoaded = true;
+    ctx->settingsChanged();
     auto file = std::unique_ptr<NS_PROJ::File>(
         reinterpret_cast<NS_PROJ::File *>(pj_open_lib_internal(
             ctx, "proj.ini", "rb", pj_open_file_with_manager, nullptr, 0)));
@@ -1894,6 +1933,43 @@ void pj_load_ini(PJ_CONTEXT *ctx) {
                     val > 0 ? static_cast<long long>(val) * 1024 * 1024 : -1;
             } else if (key == "cache_ttl_sec") {
                 ctx->gridChunkCache.ttl = atoi(value.c_str());
+            } else if (key == "cache_shared_memory_size_MB") {
+                const int val = atoi(value.c_str());
+                ctx->gridChunkCache.shared_memory_max_size =
+                    val > 0 ? static_cast<long long>(val) * 1024 * 1024 : 0;
+            } else if (key == "tiff_block_cache_size_MB") {
+                const int val = atoi(value.c_str());
+                if (val >= 0) {
+                    NS_PROJ::pj_set_tiff_block_cache_max_size_from_ini(
+                        static_cast<long long>(val) * 1024 * 1024);
+                }
+            } else if (key == "load_grids_in_memory") {
+                ctx->loadGridsInMemory = ci_equal(value, "ON") ||
+                                         ci_equal(value, "YES") ||
+                                         ci_equal(value, "TRUE");
+            } else if (key == "decoded_grid_cache") {
+                ctx->decodedGridCache = ci_equal(value, "ON") ||
+                                        ci_equal(value, "YES") ||
+                                        ci_equal(value, "TRUE");
+            } else if (key == "object_cache_size") {
+                const int val = atoi(value.c_str());
+                if (val > 0) {
+                    ctx->objectCacheSize = val;
+                }
+            } else if (key == "shared_object_cache_size") {
+                const int val = atoi(value.c_str());
+                ctx->sharedObjectCacheSize = val > 0 ? val : 0;
+            } else if (key == "crs_to_crs_cache") {
+                ctx->crsToCrsCache = ci_equal(value, "ON") ||
+                                     ci_equal(value, "YES") ||
+                                     ci_equal(value, "TRUE");
+            } else if (key == "database_open_mode") {
+                if (!pj_parse_database_open_mode(value.c_str(),
+                                                 ctx->databaseOpenMode)) {
+                    pj_log(
+                        ctx, PJ_LOG_ERROR,
+                        "pj_load_ini(): Invalid value for database_open_mode");
+                }
             } else if (key == "tmerc_default_algo") {
                 if (value == "auto") {
                     ctx->defaultTmercAlgo = TMercAlgo::AUTO;
@@ -1954,6 +2030,7 @@ void proj_context_set_file_finder(PJ_CONTEXT *ctx, proj_file_finder finder,
         return;
     ctx->file_finder = finder;
     ctx->file_finder_user_data = user_data;
+    ctx->settingsChanged();
 }
 
 /************************************************************************/
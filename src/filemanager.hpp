@@ -30,6 +30,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "proj.h"
@@ -90,6 +91,22 @@ class File {
     virtual unsigned long long tell() = 0;
     virtual void reassign_context(PJ_CONTEXT *ctx) = 0;
     virtual bool hasChanged() const = 0;
+
+    // Identifier of the version of the content of the file (such as its
+    // modification time), or empty if it cannot be determined.
+    virtual std::string versionKey() const { return std::string(); }
+
+    // Whether prefetch() can be used to speed-up later reads.
+    virtual bool supportsPrefetch() const { return false; }
+
+    // Hint that the specified (offset, size) byte ranges will be read soon,
+    // so that they can be fetched in advance with as few requests as
+    // possible.
+    virtual void
+    prefetch(const std::vector<std::pair<unsigned long long, size_t>> &ranges) {
+        (void)ranges;
+    }
+
     std::string PROJ_DLL read_line(size_t maxLen, bool &maxLenReached,
                                    bool &eofReached);
 
@@ -294,3 +294,42 @@ bool pj_fwd4d(PJ_COORD &coo, PJ *P) {
     P->ctx->last_errno = last_errno;
     return true;
 }
+
+void pj_fwd4d_n(PJ_COORD *coo, size_t n, PJ *P) {
+    /* Apply pj_fwd4d() to n coordinates. Points that fail are set to       */
+    /* HUGE_VAL, and are skipped by the next steps of an enclosing pipeline. */
+    /* The context errno is left set if any point failed.                    */
+    if (!P->fwd4d_n) {
+        for (size_t i = 0; i < n; i++) {
+            if (HUGE_VAL != coo[i].v[0])
+                pj_fwd4d(coo[i], P);
+        }
+        return;
+    }
+
+    const int last_errno = P->ctx->last_errno;
+    P->ctx->last_errno = 0;
+
+    if (!P->skip_fwd_prepare) {
+        for (size_t i = 0; i < n; i++) {
+            if (HUGE_VAL != coo[i].v[0])
+                fwd_prepare(P, coo[i]);
+            if (HUGE_VAL == coo[i].v[0])
+                coo[i] = proj_coord_error();
+        }
+    }
+
+    P->fwd4d_n(coo, n, P);
+
+    for (size_t i = 0; i < n; i++) {
+        if (HUGE_VAL == coo[i].v[0])
+            coo[i] = proj_coord_error();
+        else if (!P->skip_fwd_finalize)
+            fwd_finalize(P, coo[i]);
+    }
+
+    if (P->ctx->last_errno)
+        return;
+
+    P->ctx->last_errno = last_errno;
+}
@@ -36,15 +36,31 @@
 #include "proj/internal/internal.hpp"
 #include "proj/internal/lru_cache.hpp"
 #include "proj_internal.h"
+#include "quadtree.hpp"
 
 #ifdef TIFF_ENABLED
 #include "tiffio.h"
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 NS_PROJ_START
 
@@ -105,6 +121,94 @@ bool ExtentAndRes::intersects(const ExtentAndRes &other) const {
 
 // ---------------------------------------------------------------------------
 
+// Spatial index over the extents of a list of grids (the subgrids of a grid,
+// or the top-level grids of a grid set), so that the first grid of the list
+// containing a point can be found without testing all of them.
+class GridExtentIndex {
+    std::unique_ptr<QuadTree::QuadTree<int>> m_quadtree{};
+    // Null grids and grids covering all longitudes
+    std::vector<int> m_alwaysCandidates{};
+    bool m_hasGeographicExtents = false;
+
+  public:
+    // Below that number of grids, a linear scan is fast enough
+    static constexpr size_t MIN_GRIDS = 8;
+
+    template <class GridType>
+    static std::unique_ptr<GridExtentIndex>
+    build(const std::vector<std::unique_ptr<GridType>> &grids,
+          double relTolerance) {
+        if (grids.size() < MIN_GRIDS)
+            return nullptr;
+
+        auto index = internal::make_unique<GridExtentIndex>();
+        std::vector<QuadTree::RectObj> rects(grids.size());
+        QuadTree::RectObj globalBounds;
+        bool first = true;
+        for (size_t i = 0; i < grids.size(); ++i) {
+            const auto &grid = grids[i];
+            const auto &extent = grid->extentAndRes();
+            if (grid->isNullGrid() || extent.fullWorldLongitude()) {
+                index->m_alwaysCandidates.push_back(static_cast<int>(i));
+                continue;
+            }
+            if (extent.isGeographic)
+                index->m_hasGeographicExtents = true;
+            // Same tolerance as the one used by gridAt()
+            const double eps = (extent.resX + extent.resY) * relTolerance;
+            auto &rect = rects[i];
+            rect.minx = extent.west - eps;
+            rect.miny = extent.south - eps;
+            rect.maxx = extent.east + eps;
+            rect.maxy = extent.north + eps;
+            if (first) {
+                globalBounds = rect;
+                first = false;
+            } else {
+                globalBounds.minx = std::min(globalBounds.minx, rect.minx);
+                globalBounds.miny = std::min(globalBounds.miny, rect.miny);
+                globalBounds.maxx = std::max(globalBounds.maxx, rect.maxx);
+                globalBounds.maxy = std::max(globalBounds.maxy, rect.maxy);
+            }
+        }
+        index->m_quadtree =
+            internal::make_unique<QuadTree::QuadTree<int>>(globalBounds);
+        for (size_t i = 0; i < grids.size(); ++i) {
+            const auto &grid = grids[i];
+            if (!grid->isNullGrid() &&
+                !grid->extentAndRes().fullWorldLongitude()) {
+                index->m_quadtree->insert(static_cast<int>(i), rects[i]);
+            }
+        }
+        return index;
+    }
+
+    // Return the smallest index of the grids whose extent may contain (x, y)
+    // and for which accept(index) is true, or -1. The grid extents being
+    // only a pre-filter, accept() must do the same test as the linear scan.
+    template <class Accept> int find(double x, double y, Accept accept) const {
+        int best = -1;
+        auto visitor = [&best, &accept](int idx) {
+            if ((best < 0 || idx < best) && accept(idx))
+                best = idx;
+        };
+        for (int idx : m_alwaysCandidates) {
+            if (best >= 0 && idx > best)
+                break;
+            visitor(idx);
+        }
+        m_quadtree->visit(x, y, visitor);
+        if (m_hasGeographicExtents) {
+            // Longitudes are tested modulo 360 degrees
+            m_quadtree->visit(x + 2 * M_PI, y, visitor);
+            m_quadtree->visit(x - 2 * M_PI, y, visitor);
+        }
+        return best;
+    }
+};
+
+// ---------------------------------------------------------------------------
+
 Grid::Grid(const std::string &nameIn, int widthIn, int heightIn,
            const ExtentAndRes &extentIn)
     : m_name(nameIn), m_width(widthIn), m_height(heightIn), m_extent(extentIn) {
@@ -116,6 +220,76 @@ Grid::~Grid() = default;
 
 // ---------------------------------------------------------------------------
 
+void Grid::prefetch(double west, double south, double east, double north,
+                    bool decode) const {
+    if (isNullGrid())
+        return;
+    const auto &extent = m_extent;
+    if (!(south <= extent.north && north >= extent.south))
+        return;
+    const double ymin =
+        std::max(0.0, std::floor((south - extent.south) / extent.resY));
+    const double ymax =
+        std::min(static_cast<double>(m_height - 1),
+                 std::ceil((north - extent.south) / extent.resY));
+    // For geographic grids, also consider the extent shifted by one turn
+    const double shifts[] = {0.0, 2 * M_PI, -2 * M_PI};
+    for (const double shift : shifts) {
+        if (shift != 0.0 && !extent.isGeographic)
+            break;
+        const double w = west + shift;
+        const double e = east + shift;
+        if (!(w <= extent.east && e >= extent.west))
+            continue;
+        const double xmin =
+            std::max(0.0, std::floor((w - extent.west) / extent.resX));
+        const double xmax =
+            std::min(static_cast<double>(m_width - 1),
+                     std::ceil((e - extent.west) / extent.resX));
+        prefetchWindow(static_cast<int>(xmin), static_cast<int>(ymin),
+                       static_cast<int>(xmax), static_cast<int>(ymax), decode);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void Grid::prefetchPoints(
+    const std::vector<std::pair<double, double>> &points) const {
+    if (isNullGrid() || m_width < 2 || m_height < 2)
+        return;
+    const auto &extent = m_extent;
+    std::vector<std::pair<int, int>> nodes;
+    nodes.reserve(4 * points.size());
+    for (const auto &point : points) {
+        // Same normalization as done before interpolation
+        double x = point.first - extent.west;
+        if (extent.isGeographic) {
+            if (x < 0)
+                x += 2 * M_PI;
+            else if (x > extent.east - extent.west)
+                x -= 2 * M_PI;
+        }
+        const double col = std::floor(x / extent.resX);
+        const double row =
+            std::floor((point.second - extent.south) / extent.resY);
+        if (!(col >= -1 && col < m_width && row >= -1 && row < m_height))
+            continue;
+        // Nodes of the cell containing the point
+        const int x0 =
+            std::min(std::max(static_cast<int>(col), 0), m_width - 2);
+        const int y0 =
+            std::min(std::max(static_cast<int>(row), 0), m_height - 2);
+        nodes.emplace_back(x0, y0);
+        nodes.emplace_back(x0 + 1, y0);
+        nodes.emplace_back(x0, y0 + 1);
+        nodes.emplace_back(x0 + 1, y0 + 1);
+    }
+    if (!nodes.empty())
+        prefetchNodes(nodes);
+}
+
+// ---------------------------------------------------------------------------
+
 VerticalShiftGrid::VerticalShiftGrid(const std::string &nameIn, int widthIn,
                                      int heightIn, const ExtentAndRes &extentIn)
     : Grid(nameIn, widthIn, heightIn, extentIn) {}
@@ -126,6 +300,20 @@ VerticalShiftGrid::~VerticalShiftGrid() = default;
 
 // ---------------------------------------------------------------------------
 
+bool VerticalShiftGrid::valuesAt(int x_start, int y_start, int x_count,
+                                 int y_count, float *out) const {
+    for (int y = y_start; y < y_start + y_count; ++y) {
+        for (int x = x_start; x < x_start + x_count; ++x) {
+            if (!valueAt(x, y, *out))
+                return false;
+            ++out;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
 static ExtentAndRes globalExtent() {
     ExtentAndRes extent;
     extent.isGeographic = true;
@@ -167,6 +355,97 @@ bool NullVerticalShiftGrid::valueAt(int, int, float &out) const {
 
 // ---------------------------------------------------------------------------
 
+/** Process-wide registry of the read-only data of opened grids, such as
+ * their content when loaded in memory, so that the same grid used by several
+ * PJ objects, possibly of different contexts, shares it. Thread-safe.
+ *
+ * Entries are keyed by the resolved file name and the version of its
+ * content, and are only referenced weakly, so that they are released when
+ * the last grid using them is destroyed. File handles, and their cursor,
+ * remain owned by each grid.
+ */
+class SharedGridData {
+  public:
+    static SharedGridData &get() {
+        // Intentionally leaked, to avoid issues with the order of destruction
+        // of static objects
+        static SharedGridData *registry = new SharedGridData();
+        return *registry;
+    }
+
+    // Return the key identifying the data of a file, or an empty string if
+    // the version of its content is unknown, and thus cannot be shared.
+    static std::string key(const File *fp, const std::string &what) {
+        const std::string version = fp->versionKey();
+        if (version.empty())
+            return std::string();
+        return what + '\n' + fp->name() + '\n' + version;
+    }
+
+    // Return the data registered with key, or create it. Null data returned
+    // by create is not registered. An empty key disables sharing.
+    template <class T>
+    std::shared_ptr<T>
+    acquire(const std::string &key,
+            const std::function<std::shared_ptr<T>()> &create);
+
+  private:
+    std::mutex mutex_{};
+    std::map<std::string, std::weak_ptr<const void>> map_{};
+
+    SharedGridData() = default;
+
+    std::shared_ptr<const void> find(const std::string &key);
+};
+
+// ---------------------------------------------------------------------------
+
+// Must be called with mutex_ held. Also forgets about released entries.
+std::shared_ptr<const void> SharedGridData::find(const std::string &key) {
+    std::shared_ptr<const void> ret;
+    for (auto iter = map_.begin(); iter != map_.end();) {
+        auto data = iter->second.lock();
+        if (!data) {
+            iter = map_.erase(iter);
+            continue;
+        }
+        if (iter->first == key)
+            ret = std::move(data);
+        ++iter;
+    }
+    return ret;
+}
+
+// ---------------------------------------------------------------------------
+
+template <class T>
+std::shared_ptr<T>
+SharedGridData::acquire(const std::string &key,
+                        const std::function<std::shared_ptr<T>()> &create) {
+    if (key.empty())
+        return create();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto data = find(key);
+        if (data)
+            return std::static_pointer_cast<T>(
+                std::const_pointer_cast<void>(data));
+    }
+    // Created without holding the lock, as this may involve reading a whole
+    // grid. If another thread created it meanwhile, use its instance.
+    auto created = create();
+    if (!created)
+        return created;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto data = find(key);
+    if (data)
+        return std::static_pointer_cast<T>(std::const_pointer_cast<void>(data));
+    map_[key] = created;
+    return created;
+}
+
+// ---------------------------------------------------------------------------
+
 class FloatLineCache {
 
   private:
@@ -202,6 +481,10 @@ class GTXVerticalShiftGrid : public VerticalShiftGrid {
     std::unique_ptr<File> m_fp;
     std::unique_ptr<FloatLineCache> m_cache;
     mutable std::vector<float> m_buffer{};
+    // whole grid, if loaded in memory
+    std::shared_ptr<const std::vector<float>> m_data{};
+
+    const float *getLine(int y) const;
 
     GTXVerticalShiftGrid(const GTXVerticalShiftGrid &) = delete;
     GTXVerticalShiftGrid &operator=(const GTXVerticalShiftGrid &) = delete;
@@ -217,12 +500,16 @@ class GTXVerticalShiftGrid : public VerticalShiftGrid {
     ~GTXVerticalShiftGrid() override;
 
     bool valueAt(int x, int y, float &out) const override;
+    bool valuesAt(int x_start, int y_start, int x_count, int y_count,
+                  float *out) const override;
     bool isNodata(float val, double multiplier) const override;
 
     const std::string &metadataItem(const std::string &, int) const override {
         return emptyString;
     }
 
+    bool loadInMemory();
+
     static GTXVerticalShiftGrid *open(PJ_CONTEXT *ctx, std::unique_ptr<File> fp,
                                       const std::string &name);
 
@@ -307,47 +594,117 @@ GTXVerticalShiftGrid *GTXVerticalShiftGrid::open(PJ_CONTEXT *ctx,
     // Cache up to 1 megapixel per GTX file
     const int maxLinesInCache = 1024 * 1024 / columns;
     auto cache = internal::make_unique<FloatLineCache>(maxLinesInCache);
-    return new GTXVerticalShiftGrid(ctx, std::move(fp), name, columns, rows,
-                                    extent, std::move(cache));
+    auto grid = internal::make_unique<GTXVerticalShiftGrid>(
+        ctx, std::move(fp), name, columns, rows, extent, std::move(cache));
+    if (ctx->loadGridsInMemory && !grid->loadInMemory())
+        return nullptr;
+    return grid.release();
 }
 
 // ---------------------------------------------------------------------------
 
-bool GTXVerticalShiftGrid::valueAt(int x, int y, float &out) const {
-    assert(x >= 0 && y >= 0 && x < m_width && y < m_height);
-
-    const std::vector<float> *pBuffer = m_cache->get(0, y);
-    if (pBuffer == nullptr) {
+// Load the whole grid in memory, in native endianness, or share it with
+// other openings of the same file. In case of memory allocation error, the
+// grid stays read line by line from the file.
+bool GTXVerticalShiftGrid::loadInMemory() {
+    bool ok = true;
+    const std::function<std::shared_ptr<const std::vector<float>>()> load =
+        [this, &ok]() -> std::shared_ptr<const std::vector<float>> {
+        const size_t nValues = static_cast<size_t>(m_width) * m_height;
+        std::shared_ptr<std::vector<float>> data;
         try {
-            m_buffer.resize(m_width);
+            data = std::make_shared<std::vector<float>>(nValues);
         } catch (const std::exception &e) {
-            pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-            return false;
+            pj_log(m_ctx, PJ_LOG_DEBUG, "Cannot load %s in memory: %s",
+                   m_name.c_str(), e.what());
+            return nullptr;
         }
-
-        const size_t nLineSizeInBytes = sizeof(float) * m_width;
-        m_fp->seek(40 + nLineSizeInBytes * static_cast<unsigned long long>(y));
-        if (m_fp->read(&m_buffer[0], nLineSizeInBytes) != nLineSizeInBytes) {
+        m_fp->seek(40);
+        if (m_fp->read(data->data(), nValues * sizeof(float)) !=
+            nValues * sizeof(float)) {
             proj_context_errno_set(
                 m_ctx, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
-            return false;
+            ok = false;
+            return nullptr;
         }
-
         if (IS_LSB) {
-            swap_words(&m_buffer[0], sizeof(float), m_width);
+            swap_words(data->data(), sizeof(float), nValues);
         }
+        return data;
+    };
+    m_data = SharedGridData::get().acquire(
+        SharedGridData::key(m_fp.get(), "gtx"), load);
+    return ok;
+}
 
-        out = m_buffer[x];
-        try {
-            m_cache->insert(0, y, m_buffer);
-        } catch (const std::exception &e) {
-            // Should normally not happen
-            pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-        }
-    } else {
-        out = (*pBuffer)[x];
+// ---------------------------------------------------------------------------
+
+// Return line y of the grid, in native endianness, or nullptr in case of
+// error. The returned pointer is valid until the next call.
+const float *GTXVerticalShiftGrid::getLine(int y) const {
+    if (m_data) {
+        return &(*m_data)[static_cast<size_t>(y) * m_width];
+    }
+
+    const std::vector<float> *pBuffer = m_cache->get(0, y);
+    if (pBuffer != nullptr) {
+        return pBuffer->data();
     }
 
+    try {
+        m_buffer.resize(m_width);
+    } catch (const std::exception &e) {
+        pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
+        return nullptr;
+    }
+
+    const size_t nLineSizeInBytes = sizeof(float) * m_width;
+    m_fp->seek(40 + nLineSizeInBytes * static_cast<unsigned long long>(y));
+    if (m_fp->read(&m_buffer[0], nLineSizeInBytes) != nLineSizeInBytes) {
+        proj_context_errno_set(m_ctx,
+                               PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
+        return nullptr;
+    }
+
+    if (IS_LSB) {
+        swap_words(&m_buffer[0], sizeof(float), m_width);
+    }
+
+    try {
+        m_cache->insert(0, y, m_buffer);
+    } catch (const std::exception &e) {
+        // Should normally not happen
+        pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
+    }
+    return m_buffer.data();
+}
+
+// ---------------------------------------------------------------------------
+
+bool GTXVerticalShiftGrid::valueAt(int x, int y, float &out) const {
+    assert(x >= 0 && y >= 0 && x < m_width && y < m_height);
+
+    const float *line = getLine(y);
+    if (line == nullptr)
+        return false;
+    out = line[x];
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+bool GTXVerticalShiftGrid::valuesAt(int x_start, int y_start, int x_count,
+                                    int y_count, float *out) const {
+    assert(x_start >= 0 && y_start >= 0 && x_start + x_count <= m_width &&
+           y_start + y_count <= m_height);
+
+    for (int y = y_start; y < y_start + y_count; ++y) {
+        const float *line = getLine(y);
+        if (line == nullptr)
+            return false;
+        memcpy(out, line + x_start, x_count * sizeof(float));
+        out += x_count;
+    }
     return true;
 }
 
@@ -382,6 +739,184 @@ static bool IsTIFF(size_t header_size, const unsigned char *header) {
                                  (header[3] == 0x2B && header[2] == 0)));
 }
 
+// ---------------------------------------------------------------------------
+
+/** Process-wide cache of decoded GeoTIFF blocks, shared by all opened
+ * GeoTIFF datasets of all contexts, and bounded by the cumulated size of
+ * the blocks it holds. Thread-safe.
+ *
+ * Blocks are handed out as shared pointers, so that a block that is
+ * evicted while a grid still reads from it remains valid.
+ */
+class SharedBlockCache {
+  public:
+    typedef std::shared_ptr<const std::vector<unsigned char>> BlockPtr;
+
+    static constexpr long long DEFAULT_MAX_SIZE = 64 * 1024 * 1024;
+
+    static SharedBlockCache &get() {
+        // Intentionally leaked, to avoid issues with the order of destruction
+        // of static objects
+        static SharedBlockCache *cache = new SharedBlockCache();
+        return *cache;
+    }
+
+    static uint64_t newDatasetId() {
+        static std::atomic<uint64_t> counter{0};
+        return ++counter;
+    }
+
+    BlockPtr get(uint64_t datasetId, uint64_t blockKey);
+    void insert(uint64_t datasetId, uint64_t blockKey, const BlockPtr &block);
+
+    void clear(uint64_t datasetId);
+    void setMaxSize(long long maxSize, bool fromIni);
+    void resetMaxSize();
+    long long maxSize();
+    void getStats(unsigned long long &hits, unsigned long long &misses);
+
+  private:
+    struct Key {
+        uint64_t datasetId;
+        uint64_t blockKey;
+
+        bool operator==(const Key &other) const {
+            return datasetId == other.datasetId && blockKey == other.blockKey;
+        }
+    };
+
+    struct KeyHasher {
+        size_t operator()(const Key &k) const {
+            return std::hash<uint64_t>()(k.datasetId * 0x9E3779B97F4A7C15ULL ^
+                                         k.blockKey);
+        }
+    };
+
+    typedef std::list<std::pair<Key, BlockPtr>> ListType;
+
+    std::mutex mutex_{};
+    ListType lru_{}; // most recently used first
+    std::unordered_map<Key, ListType::iterator, KeyHasher> map_{};
+    size_t curSize_ = 0;
+    long long maxSize_ = DEFAULT_MAX_SIZE;
+    long long iniMaxSize_ = DEFAULT_MAX_SIZE;
+    bool maxSizeSetByAPI_ = false;
+    unsigned long long hits_ = 0;
+    unsigned long long misses_ = 0;
+
+    SharedBlockCache() = default;
+
+    void evict();
+};
+
+// ---------------------------------------------------------------------------
+
+SharedBlockCache::BlockPtr SharedBlockCache::get(uint64_t datasetId,
+                                                 uint64_t blockKey) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = map_.find(Key{datasetId, blockKey});
+    if (iter == map_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+    ++hits_;
+    lru_.splice(lru_.begin(), lru_, iter->second);
+    return iter->second->second;
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedBlockCache::insert(uint64_t datasetId, uint64_t blockKey,
+                              const BlockPtr &block) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (static_cast<long long>(block->size()) > maxSize_)
+        return;
+    const Key key{datasetId, blockKey};
+    auto iter = map_.find(key);
+    if (iter != map_.end()) {
+        curSize_ -= iter->second->second->size();
+        lru_.erase(iter->second);
+        map_.erase(iter);
+    }
+    lru_.emplace_front(key, block);
+    map_[key] = lru_.begin();
+    curSize_ += block->size();
+    evict();
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedBlockCache::evict() {
+    while (static_cast<long long>(curSize_) > maxSize_ && !lru_.empty()) {
+        const auto &last = lru_.back();
+        curSize_ -= last.second->size();
+        map_.erase(last.first);
+        lru_.pop_back();
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedBlockCache::clear(uint64_t datasetId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto iter = lru_.begin(); iter != lru_.end();) {
+        if (iter->first.datasetId == datasetId) {
+            curSize_ -= iter->second->size();
+            map_.erase(iter->first);
+            iter = lru_.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedBlockCache::setMaxSize(long long maxSize, bool fromIni) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Settings done through the API have precedence over proj.ini
+    if (fromIni) {
+        iniMaxSize_ = maxSize;
+        if (maxSizeSetByAPI_)
+            return;
+    } else {
+        maxSizeSetByAPI_ = true;
+    }
+    maxSize_ = maxSize;
+    evict();
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedBlockCache::resetMaxSize() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxSizeSetByAPI_ = false;
+    maxSize_ = iniMaxSize_;
+    evict();
+}
+
+// ---------------------------------------------------------------------------
+
+long long SharedBlockCache::maxSize() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return maxSize_;
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedBlockCache::getStats(unsigned long long &hits,
+                                unsigned long long &misses) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hits = hits_;
+    misses = misses_;
+}
+
+// ---------------------------------------------------------------------------
+
+void pj_set_tiff_block_cache_max_size_from_ini(long long max_size) {
+    SharedBlockCache::get().setMaxSize(max_size, /* fromIni = */ true);
+}
+
 #ifdef TIFF_ENABLED
 
 // ---------------------------------------------------------------------------
@@ -404,38 +939,324 @@ constexpr uint16_t TIFFTAG_GDAL_NODATA = 42113;
 
 // ---------------------------------------------------------------------------
 
+/** Handle to the blocks of a GTiffDataset in the SharedBlockCache.
+ *
+ * GTiffDataset of the same file share their blocks, through an identifier
+ * registered in SharedGridData, whose blocks are removed from the
+ * SharedBlockCache once the last dataset using it is destroyed.
+ */
 class BlockCache {
   public:
-    void insert(uint32_t ifdIdx, uint32_t blockNumber,
-                const std::vector<unsigned char> &data);
-    const std::vector<unsigned char> *get(uint32_t ifdIdx,
-                                          uint32_t blockNumber);
+    typedef SharedBlockCache::BlockPtr BlockPtr;
+
+    // sharedKey as returned by SharedGridData::key()
+    explicit BlockCache(const std::string &sharedKey);
+
+    BlockCache(const BlockCache &) = delete;
+    BlockCache &operator=(const BlockCache &) = delete;
+
+    void insert(uint32_t ifdIdx, uint32_t blockNumber, const BlockPtr &data);
+    BlockPtr get(uint32_t ifdIdx, uint32_t blockNumber);
 
   private:
-    typedef uint64_t Key;
+    struct DatasetId {
+        const uint64_t id = SharedBlockCache::newDatasetId();
+        ~DatasetId() { SharedBlockCache::get().clear(id); }
+    };
+
+    std::shared_ptr<const DatasetId> datasetId_;
 
-    static constexpr int NUM_BLOCKS_AT_CROSSING_TILES = 4;
-    static constexpr int MAX_SAMPLE_COUNT = 3;
-    lru11::Cache<Key, std::vector<unsigned char>, lru11::NullLock> cache_{
-        NUM_BLOCKS_AT_CROSSING_TILES * MAX_SAMPLE_COUNT};
+    static std::shared_ptr<const DatasetId>
+    acquireDatasetId(const std::string &sharedKey);
 };
 
 // ---------------------------------------------------------------------------
 
+BlockCache::BlockCache(const std::string &sharedKey)
+    : datasetId_(acquireDatasetId(sharedKey)) {}
+
+// ---------------------------------------------------------------------------
+
+std::shared_ptr<const BlockCache::DatasetId>
+BlockCache::acquireDatasetId(const std::string &sharedKey) {
+    const std::function<std::shared_ptr<const DatasetId>()> create = []() {
+        return std::make_shared<const DatasetId>();
+    };
+    return SharedGridData::get().acquire(sharedKey, create);
+}
+
+// ---------------------------------------------------------------------------
+
 void BlockCache::insert(uint32_t ifdIdx, uint32_t blockNumber,
-                        const std::vector<unsigned char> &data) {
-    cache_.insert((static_cast<uint64_t>(ifdIdx) << 32) | blockNumber, data);
+                        const BlockPtr &data) {
+    SharedBlockCache::get().insert(
+        datasetId_->id, (static_cast<uint64_t>(ifdIdx) << 32) | blockNumber,
+        data);
 }
 
 // ---------------------------------------------------------------------------
 
-const std::vector<unsigned char> *BlockCache::get(uint32_t ifdIdx,
-                                                  uint32_t blockNumber) {
-    return cache_.getPtr((static_cast<uint64_t>(ifdIdx) << 32) | blockNumber);
+BlockCache::BlockPtr BlockCache::get(uint32_t ifdIdx, uint32_t blockNumber) {
+    return SharedBlockCache::get().get(
+        datasetId_->id, (static_cast<uint64_t>(ifdIdx) << 32) | blockNumber);
 }
 
 // ---------------------------------------------------------------------------
 
+#ifndef _WIN32
+
+/** Sidecar file, in the user writable directory, holding the decoded content
+ * of the blocks of a compressed GeoTIFF IFD, so that each block is
+ * decompressed once, and later read from a memory mapping, including by
+ * other processes and later runs.
+ *
+ * The file is named after a hash of the grid name, of the version of its
+ * content (etag or modification time), of the IFD and of its block layout,
+ * so that an updated grid never uses a stale sidecar. Blocks are filled
+ * lazily, as they are decoded. The file is sparse and made of a header of
+ * HEADER_SIZE bytes, one presence flag per block, and the blocks at
+ * DATA_ALIGNMENT aligned offsets.
+ */
+class DecodedBlockFile {
+  public:
+    // gridKey identifies the grid, and versionKey the version of its
+    // content. Files of other versions of the same grid are removed when a
+    // new one is created.
+    static std::unique_ptr<DecodedBlockFile>
+    open(PJ_CONTEXT *ctx, const std::string &gridKey,
+         const std::string &versionKey, const std::string &baseName,
+         uint32_t blockCount, size_t blockSize);
+
+    ~DecodedBlockFile();
+
+    // Copy the content of a block into out, if it is present.
+    bool get(uint32_t blockId, unsigned char *out) const;
+
+    // Store the decoded content of a block.
+    void put(uint32_t blockId, const unsigned char *data);
+
+  private:
+    static constexpr char MAGIC[] = "PROJDBF";
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 64;
+    static constexpr size_t DATA_ALIGNMENT = 4096;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t blockCount;
+        uint64_t blockSize;
+        uint64_t keyHash1;
+        uint64_t keyHash2;
+    };
+    static_assert(sizeof(Header) <= HEADER_SIZE, "Header too large");
+
+    int m_fd;
+    unsigned char *m_map;
+    size_t m_mapSize;
+    uint32_t m_blockCount;
+    size_t m_blockSize;
+    size_t m_dataOffset;
+
+    DecodedBlockFile(int fd, unsigned char *map, size_t mapSize,
+                     uint32_t blockCount, size_t blockSize, size_t dataOffset)
+        : m_fd(fd), m_map(map), m_mapSize(mapSize), m_blockCount(blockCount),
+          m_blockSize(blockSize), m_dataOffset(dataOffset) {}
+
+    DecodedBlockFile(const DecodedBlockFile &) = delete;
+    DecodedBlockFile &operator=(const DecodedBlockFile &) = delete;
+
+    std::atomic<unsigned char> *flag(uint32_t blockId) const {
+        return reinterpret_cast<std::atomic<unsigned char> *>(
+            m_map + HEADER_SIZE + blockId);
+    }
+
+    static uint64_t hash(const std::string &key, uint64_t seed);
+
+    static void removeOtherVersions(PJ_CONTEXT *ctx, const std::string &dir,
+                                    const std::string &prefix,
+                                    const std::string &filename);
+};
+
+constexpr char DecodedBlockFile::MAGIC[];
+
+// ---------------------------------------------------------------------------
+
+uint64_t DecodedBlockFile::hash(const std::string &key, uint64_t seed) {
+    uint64_t h = seed;
+    for (const char ch : key) {
+        h ^= static_cast<unsigned char>(ch);
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<DecodedBlockFile>
+DecodedBlockFile::open(PJ_CONTEXT *ctx, const std::string &gridKey,
+                       const std::string &versionKey,
+                       const std::string &baseName, uint32_t blockCount,
+                       size_t blockSize) {
+    static_assert(sizeof(std::atomic<unsigned char>) == 1,
+                  "unexpected size of std::atomic<unsigned char>");
+    if (blockCount == 0 || blockSize == 0)
+        return nullptr;
+
+    const std::string key = gridKey + '\n' + versionKey;
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.blockCount = blockCount;
+    header.blockSize = blockSize;
+    header.keyHash1 = hash(key, 0xCBF29CE484222325ULL);
+    header.keyHash2 = hash(key, 0x84222325CBF29CE4ULL);
+
+    const uint64_t dataOffset =
+        (HEADER_SIZE + blockCount + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT *
+        DATA_ALIGNMENT;
+    const uint64_t fileSize =
+        dataOffset + static_cast<uint64_t>(blockCount) * blockSize;
+    if (fileSize > std::numeric_limits<size_t>::max() ||
+        fileSize > static_cast<uint64_t>(std::numeric_limits<off_t>::max())) {
+        return nullptr;
+    }
+
+    std::string dir(proj_context_get_user_writable_directory(ctx, true));
+    dir += "/decoded_grids";
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        pj_log(ctx, PJ_LOG_DEBUG, "Cannot create %s", dir.c_str());
+        return nullptr;
+    }
+    // Named after the grid, and then its version
+    char hashStr[17];
+    snprintf(hashStr, sizeof(hashStr), "%016llx",
+             static_cast<unsigned long long>(
+                 hash(gridKey, 0xCBF29CE484222325ULL)));
+    const std::string prefix = baseName + '.' + hashStr + '.';
+    snprintf(hashStr, sizeof(hashStr), "%016llx",
+             static_cast<unsigned long long>(header.keyHash1));
+    const std::string filename = prefix + hashStr + ".decoded";
+    const std::string path = dir + '/' + filename;
+
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        pj_log(ctx, PJ_LOG_DEBUG, "Cannot open %s", path.c_str());
+        return nullptr;
+    }
+
+    // Initialize the file, or check that it matches our layout, under an
+    // exclusive lock, so that concurrent processes do not both initialize it.
+    bool ok = false;
+    bool created = false;
+    if (flock(fd, LOCK_EX) == 0) {
+        struct stat st;
+        Header existing;
+        if (fstat(fd, &st) == 0) {
+            if (static_cast<uint64_t>(st.st_size) == fileSize &&
+                pread(fd, &existing, sizeof(existing), 0) ==
+                    static_cast<ssize_t>(sizeof(existing))) {
+                ok = memcmp(&existing, &header, sizeof(header)) == 0;
+            } else if (st.st_size == 0) {
+                // The presence flags are written rather than left sparse, so
+                // that setting them through the mapping cannot fail.
+                std::vector<unsigned char> start(HEADER_SIZE + blockCount);
+                memcpy(start.data(), &header, sizeof(header));
+                ok = pwrite(fd, start.data(), start.size(), 0) ==
+                         static_cast<ssize_t>(start.size()) &&
+                     ftruncate(fd, static_cast<off_t>(fileSize)) == 0;
+                created = ok;
+            }
+        }
+        flock(fd, LOCK_UN);
+    }
+    if (!ok) {
+        pj_log(ctx, PJ_LOG_DEBUG, "Cannot use %s", path.c_str());
+        ::close(fd);
+        return nullptr;
+    }
+    if (created) {
+        removeOtherVersions(ctx, dir, prefix, filename);
+    }
+
+    void *map = mmap(nullptr, static_cast<size_t>(fileSize),
+                     PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        ::close(fd);
+        return nullptr;
+    }
+    return std::unique_ptr<DecodedBlockFile>(new DecodedBlockFile(
+        fd, static_cast<unsigned char *>(map), static_cast<size_t>(fileSize),
+        blockCount, blockSize, static_cast<size_t>(dataOffset)));
+}
+
+// ---------------------------------------------------------------------------
+
+// Remove the files of the directory starting with prefix, other than filename,
+// that is the files of previous versions of the grid. Processes still using
+// one of them keep their mapping of it.
+void DecodedBlockFile::removeOtherVersions(PJ_CONTEXT *ctx,
+                                           const std::string &dir,
+                                           const std::string &prefix,
+                                           const std::string &filename) {
+    DIR *d = opendir(dir.c_str());
+    if (!d)
+        return;
+    while (const struct dirent *entry = readdir(d)) {
+        const std::string name(entry->d_name);
+        if (name != filename && starts_with(name, prefix) &&
+            ends_with(name, ".decoded")) {
+            const std::string path = dir + '/' + name;
+            if (unlink(path.c_str()) == 0) {
+                pj_log(ctx, PJ_LOG_DEBUG, "Removed %s", path.c_str());
+            }
+        }
+    }
+    closedir(d);
+}
+
+// ---------------------------------------------------------------------------
+
+DecodedBlockFile::~DecodedBlockFile() {
+    munmap(m_map, m_mapSize);
+    ::close(m_fd);
+}
+
+// ---------------------------------------------------------------------------
+
+bool DecodedBlockFile::get(uint32_t blockId, unsigned char *out) const {
+    if (blockId >= m_blockCount ||
+        flag(blockId)->load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    memcpy(out,
+           m_map + m_dataOffset + static_cast<size_t>(blockId) * m_blockSize,
+           m_blockSize);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+void DecodedBlockFile::put(uint32_t blockId, const unsigned char *data) {
+    if (blockId >= m_blockCount)
+        return;
+    // Write the block with pwrite() rather than through the mapping, so that
+    // running out of disk space is reported as an error rather than SIGBUS,
+    // and only flag it as present once it is fully written.
+    const off_t offset = static_cast<off_t>(
+        m_dataOffset + static_cast<size_t>(blockId) * m_blockSize);
+    if (pwrite(m_fd, data, m_blockSize, offset) ==
+        static_cast<ssize_t>(m_blockSize)) {
+        flag(blockId)->store(1, std::memory_order_release);
+    }
+}
+
+#endif // _WIN32
+
+// ---------------------------------------------------------------------------
+
 class GTiffGrid : public Grid {
     PJ_CONTEXT *m_ctx;   // owned by the belonging GTiffDataset
     TIFF *m_hTIFF;       // owned by the belonging GTiffDataset
@@ -450,8 +1271,10 @@ class GTiffGrid : public Grid {
     bool m_tiled;
     uint32_t m_blockWidth = 0;
     uint32_t m_blockHeight = 0;
-    mutable std::vector<unsigned char> m_buffer{};
-    mutable uint32_t m_bufferBlockId = std::numeric_limits<uint32_t>::max();
+    mutable BlockCache::BlockPtr m_block{}; // last accessed block
+    mutable uint32_t m_blockId = std::numeric_limits<uint32_t>::max();
+    // ids of the blocks of the last prefetchNodes() call
+    mutable std::vector<uint32_t> m_lastPrefetchedBlockIds{};
     unsigned m_blocksPerRow = 0;
     unsigned m_blocksPerCol = 0;
     unsigned m_blocks = 0;
@@ -463,6 +1286,9 @@ class GTiffGrid : public Grid {
     bool m_isSingleBlock = false;
     float m_noData = 0.0f;
     uint32_t m_subfileType = 0;
+#ifndef _WIN32
+    std::unique_ptr<DecodedBlockFile> m_decodedFile{};
+#endif
 
     GTiffGrid(const GTiffGrid &) = delete;
     GTiffGrid &operator=(const GTiffGrid &) = delete;
@@ -471,6 +1297,17 @@ class GTiffGrid : public Grid {
     float readValue(const std::vector<unsigned char> &buffer,
                     uint32_t offsetInBlock, uint16_t sample) const;
 
+    const std::vector<unsigned char> *getBlock(uint32_t blockId) const;
+
+    // Return the ids of the blocks intersecting the specified window, in
+    // their first plane.
+    std::vector<uint32_t> blocksOfWindow(int xmin, int ymin, int xmax,
+                                         int ymax) const;
+
+    void downloadWindow(int xmin, int ymin, int xmax, int ymax) const;
+    void downloadBlocks(const std::vector<uint32_t> &blockIds) const;
+    void decodeWindow(int xmin, int ymin, int xmax, int ymax) const;
+
   public:
     GTiffGrid(PJ_CONTEXT *ctx, TIFF *hTIFF, BlockCache &cache, File *fp,
               uint32_t ifdIdx, const std::string &nameIn, int widthIn,
@@ -495,9 +1332,17 @@ class GTiffGrid : public Grid {
 
     uint32_t subfileType() const { return m_subfileType; }
 
+    void prefetchWindow(int xmin, int ymin, int xmax, int ymax,
+                        bool decode) const override;
+
+    void
+    prefetchNodes(const std::vector<std::pair<int, int>> &nodes) const override;
+
     void reassign_context(PJ_CONTEXT *ctx) { m_ctx = ctx; }
 
     bool hasChanged() const override { return m_fp->hasChanged(); }
+
+    void openDecodedBlockFile();
 };
 
 // ---------------------------------------------------------------------------
@@ -653,6 +1498,225 @@ float GTiffGrid::readValue(const std::vector<unsigned char> &buffer,
 
 // ---------------------------------------------------------------------------
 
+// Return the decoded content of a block, from the last accessed block, the
+// shared block cache, the decoded block file, or by decoding it.
+const std::vector<unsigned char> *GTiffGrid::getBlock(uint32_t blockId) const {
+    if (blockId == m_blockId && m_block)
+        return m_block.get();
+
+    auto block = m_cache.get(m_ifdIdx, blockId);
+    if (!block) {
+        if (TIFFCurrentDirOffset(m_hTIFF) != m_dirOffset &&
+            !TIFFSetSubDirectory(m_hTIFF, m_dirOffset)) {
+            return nullptr;
+        }
+        std::shared_ptr<std::vector<unsigned char>> buffer;
+        try {
+            const auto blockSize = static_cast<size_t>(
+                m_tiled ? TIFFTileSize64(m_hTIFF) : TIFFStripSize64(m_hTIFF));
+            buffer = std::make_shared<std::vector<unsigned char>>(blockSize);
+        } catch (const std::exception &e) {
+            pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
+            return nullptr;
+        }
+
+        bool decoded = false;
+#ifndef _WIN32
+        decoded = m_decodedFile && m_decodedFile->get(blockId, buffer->data());
+#endif
+        if (!decoded) {
+            if (m_tiled) {
+                if (TIFFReadEncodedTile(m_hTIFF, blockId, buffer->data(),
+                                        buffer->size()) == -1) {
+                    return nullptr;
+                }
+            } else {
+                if (TIFFReadEncodedStrip(m_hTIFF, blockId, buffer->data(),
+                                         buffer->size()) == -1) {
+                    return nullptr;
+                }
+            }
+#ifndef _WIN32
+            if (m_decodedFile)
+                m_decodedFile->put(blockId, buffer->data());
+#endif
+        }
+
+        block = std::move(buffer);
+        try {
+            m_cache.insert(m_ifdIdx, blockId, block);
+        } catch (const std::exception &e) {
+            // Should normally not happen
+            pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
+        }
+    }
+
+    m_block = std::move(block);
+    m_blockId = blockId;
+    return m_block.get();
+}
+
+// ---------------------------------------------------------------------------
+
+// Attach the sidecar file of decoded blocks of this grid, when the version of
+// the content of the file can be identified. Must be called while the IFD of
+// the grid is the current one.
+void GTiffGrid::openDecodedBlockFile() {
+#ifndef _WIN32
+    const std::string version = m_fp->versionKey();
+    if (version.empty())
+        return;
+    const auto blockSize = static_cast<size_t>(
+        m_tiled ? TIFFTileSize64(m_hTIFF) : TIFFStripSize64(m_hTIFF));
+    const uint32_t nPlanes =
+        m_planarConfig == PLANARCONFIG_SEPARATE ? m_samplesPerPixel : 1;
+    const std::string &fileName = m_fp->name();
+    const auto pos = fileName.find_last_of("/\\");
+    const std::string baseName =
+        pos == std::string::npos ? fileName : fileName.substr(pos + 1);
+    const std::string gridKey =
+        fileName + '\n' + toString(static_cast<int>(m_ifdIdx));
+    m_decodedFile = DecodedBlockFile::open(m_ctx, gridKey, version, baseName,
+                                           nPlanes * m_blocks, blockSize);
+#endif
+}
+
+// ---------------------------------------------------------------------------
+
+std::vector<uint32_t> GTiffGrid::blocksOfWindow(int xmin, int ymin, int xmax,
+                                                int ymax) const {
+    const int yTIFFMin = m_bottomUp ? ymin : m_height - 1 - ymax;
+    const int yTIFFMax = m_bottomUp ? ymax : m_height - 1 - ymin;
+    const uint32_t blockXMin = static_cast<uint32_t>(xmin) / m_blockWidth;
+    const uint32_t blockXMax = static_cast<uint32_t>(xmax) / m_blockWidth;
+    const uint32_t blockYMin = static_cast<uint32_t>(yTIFFMin) / m_blockHeight;
+    const uint32_t blockYMax = static_cast<uint32_t>(yTIFFMax) / m_blockHeight;
+    std::vector<uint32_t> blockIds;
+    for (uint32_t blockY = blockYMin; blockY <= blockYMax; ++blockY) {
+        for (uint32_t blockX = blockXMin; blockX <= blockXMax; ++blockX) {
+            blockIds.push_back(blockY * m_blocksPerRow + blockX);
+        }
+    }
+    return blockIds;
+}
+
+// ---------------------------------------------------------------------------
+
+void GTiffGrid::prefetchWindow(int xmin, int ymin, int xmax, int ymax,
+                               bool decode) const {
+    downloadWindow(xmin, ymin, xmax, ymax);
+    if (decode)
+        decodeWindow(xmin, ymin, xmax, ymax);
+}
+
+// ---------------------------------------------------------------------------
+
+// Maximum number of blocks whose download is requested by a single
+// GTiffGrid::downloadBlocks() call.
+constexpr size_t MAX_PREFETCHED_BLOCKS = 64;
+
+// Ask the underlying file, when it supports it (network files), to fetch the
+// encoded blocks intersecting the specified window which are not already
+// decoded in the block cache, so that they are downloaded with a few range
+// requests rather than one per block.
+void GTiffGrid::downloadWindow(int xmin, int ymin, int xmax, int ymax) const {
+    if (!m_fp->supportsPrefetch())
+        return;
+    downloadBlocks(blocksOfWindow(xmin, ymin, xmax, ymax));
+}
+
+// ---------------------------------------------------------------------------
+
+// Same as downloadWindow(), for the blocks containing the specified nodes.
+// Consecutive calls on the same blocks, typical of spatially coherent
+// batches of coordinates, only check the block cache the first time.
+void GTiffGrid::prefetchNodes(
+    const std::vector<std::pair<int, int>> &nodes) const {
+    if (!m_fp->supportsPrefetch())
+        return;
+    std::vector<uint32_t> blockIds;
+    blockIds.reserve(nodes.size());
+    for (const auto &node : nodes) {
+        const int yTIFF = m_bottomUp ? node.second : m_height - 1 - node.second;
+        blockIds.push_back(
+            (static_cast<uint32_t>(yTIFF) / m_blockHeight) * m_blocksPerRow +
+            static_cast<uint32_t>(node.first) / m_blockWidth);
+    }
+    std::sort(blockIds.begin(), blockIds.end());
+    blockIds.erase(std::unique(blockIds.begin(), blockIds.end()),
+                   blockIds.end());
+    if (blockIds == m_lastPrefetchedBlockIds)
+        return;
+    downloadBlocks(blockIds);
+    m_lastPrefetchedBlockIds = std::move(blockIds);
+}
+
+// ---------------------------------------------------------------------------
+
+// Ask the underlying file to fetch the encoded blocks of the specified ids, in
+// their first plane, which are not already decoded in the block cache.
+void GTiffGrid::downloadBlocks(const std::vector<uint32_t> &blockIds) const {
+#if TIFFLIB_VERSION > 20191103
+    const uint32_t nPlanes =
+        m_planarConfig == PLANARCONFIG_SEPARATE ? m_samplesPerPixel : 1;
+
+    std::vector<std::pair<unsigned long long, size_t>> ranges;
+    bool dirSet = false;
+    for (uint32_t plane = 0; plane < nPlanes; ++plane) {
+        for (const uint32_t blockIdInPlane : blockIds) {
+            const uint32_t blockId = plane * m_blocks + blockIdInPlane;
+            if (m_cache.get(m_ifdIdx, blockId))
+                continue;
+            if (!dirSet) {
+                if (TIFFCurrentDirOffset(m_hTIFF) != m_dirOffset &&
+                    !TIFFSetSubDirectory(m_hTIFF, m_dirOffset)) {
+                    return;
+                }
+                dirSet = true;
+            }
+            const auto offset = TIFFGetStrileOffset(m_hTIFF, blockId);
+            const auto size = TIFFGetStrileByteCount(m_hTIFF, blockId);
+            if (offset == 0 || size == 0)
+                continue;
+            ranges.emplace_back(offset, static_cast<size_t>(size));
+            if (ranges.size() == MAX_PREFETCHED_BLOCKS) {
+                m_fp->prefetch(ranges);
+                return;
+            }
+        }
+    }
+    if (!ranges.empty())
+        m_fp->prefetch(ranges);
+#else
+    (void)blockIds;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+
+// Decode the blocks intersecting the specified window in the block cache.
+// Stop once they fill half of it, so that they do not evict each other, nor
+// all the blocks of other grids.
+void GTiffGrid::decodeWindow(int xmin, int ymin, int xmax, int ymax) const {
+    const auto blockIds = blocksOfWindow(xmin, ymin, xmax, ymax);
+    const uint32_t nPlanes =
+        m_planarConfig == PLANARCONFIG_SEPARATE ? m_samplesPerPixel : 1;
+    const long long maxDecodedSize = SharedBlockCache::get().maxSize() / 2;
+    long long decodedSize = 0;
+    for (uint32_t plane = 0; plane < nPlanes; ++plane) {
+        for (const uint32_t blockIdInPlane : blockIds) {
+            const auto block = getBlock(plane * m_blocks + blockIdInPlane);
+            if (!block)
+                return;
+            decodedSize += static_cast<long long>(block->size());
+            if (decodedSize >= maxDecodedSize)
+                return;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 bool GTiffGrid::valueAt(uint16_t sample, int x, int yFromBottom,
                         float &out) const {
     assert(x >= 0 && yFromBottom >= 0 && x < m_width && yFromBottom < m_height);
@@ -691,45 +1755,9 @@ bool GTiffGrid::valueAt(uint16_t sample, int x, int yFromBottom,
         blockId += sample * m_blocks;
     }
 
-    const std::vector<unsigned char> *pBuffer =
-        blockId == m_bufferBlockId ? &m_buffer : m_cache.get(m_ifdIdx, blockId);
-    if (pBuffer == nullptr) {
-        if (TIFFCurrentDirOffset(m_hTIFF) != m_dirOffset &&
-            !TIFFSetSubDirectory(m_hTIFF, m_dirOffset)) {
-            return false;
-        }
-        if (m_buffer.empty()) {
-            const auto blockSize = static_cast<size_t>(
-                m_tiled ? TIFFTileSize64(m_hTIFF) : TIFFStripSize64(m_hTIFF));
-            try {
-                m_buffer.resize(blockSize);
-            } catch (const std::exception &e) {
-                pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-                return false;
-            }
-        }
-
-        if (m_tiled) {
-            if (TIFFReadEncodedTile(m_hTIFF, blockId, m_buffer.data(),
-                                    m_buffer.size()) == -1) {
-                return false;
-            }
-        } else {
-            if (TIFFReadEncodedStrip(m_hTIFF, blockId, m_buffer.data(),
-                                     m_buffer.size()) == -1) {
-                return false;
-            }
-        }
-
-        pBuffer = &m_buffer;
-        try {
-            m_cache.insert(m_ifdIdx, blockId, m_buffer);
-            m_bufferBlockId = blockId;
-        } catch (const std::exception &e) {
-            // Should normally not happen
-            pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-        }
-    }
+    const std::vector<unsigned char> *pBuffer = getBlock(blockId);
+    if (pBuffer == nullptr)
+        return false;
 
     uint32_t offsetInBlock;
     if (m_blockIs256Pixel)
@@ -796,47 +1824,9 @@ bool GTiffGrid::valuesAt(int x_start, int y_start, int x_count, int y_count,
         blockYOff = yTIFF % 256;
         blockId = blockY * m_blocksPerRow + blockX;
 
-        const std::vector<unsigned char> *pBuffer =
-            blockId == m_bufferBlockId ? &m_buffer
-                                       : m_cache.get(m_ifdIdx, blockId);
-        if (pBuffer == nullptr) {
-            if (TIFFCurrentDirOffset(m_hTIFF) != m_dirOffset &&
-                !TIFFSetSubDirectory(m_hTIFF, m_dirOffset)) {
-                return false;
-            }
-            if (m_buffer.empty()) {
-                const auto blockSize =
-                    static_cast<size_t>(m_tiled ? TIFFTileSize64(m_hTIFF)
-                                                : TIFFStripSize64(m_hTIFF));
-                try {
-                    m_buffer.resize(blockSize);
-                } catch (const std::exception &e) {
-                    pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-                    return false;
-                }
-            }
-
-            if (m_tiled) {
-                if (TIFFReadEncodedTile(m_hTIFF, blockId, m_buffer.data(),
-                                        m_buffer.size()) == -1) {
-                    return false;
-                }
-            } else {
-                if (TIFFReadEncodedStrip(m_hTIFF, blockId, m_buffer.data(),
-                                         m_buffer.size()) == -1) {
-                    return false;
-                }
-            }
-
-            pBuffer = &m_buffer;
-            try {
-                m_cache.insert(m_ifdIdx, blockId, m_buffer);
-                m_bufferBlockId = blockId;
-            } catch (const std::exception &e) {
-                // Should normally not happen
-                pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-            }
-        }
+        const std::vector<unsigned char> *pBuffer = getBlock(blockId);
+        if (pBuffer == nullptr)
+            return false;
 
         uint32_t offsetInBlockStart = blockXOff + blockYOff * 256U;
 
@@ -955,7 +1945,7 @@ class GTiffDataset {
     uint32_t m_ifdIdx = 0;
     toff_t m_nextDirOffset = 0;
     std::string m_filename{};
-    BlockCache m_cache{};
+    BlockCache m_cache;
 
     GTiffDataset(const GTiffDataset &) = delete;
     GTiffDataset &operator=(const GTiffDataset &) = delete;
@@ -999,7 +1989,8 @@ class GTiffDataset {
 
   public:
     GTiffDataset(PJ_CONTEXT *ctx, std::unique_ptr<File> &&fp)
-        : m_ctx(ctx), m_fp(std::move(fp)) {}
+        : m_ctx(ctx), m_fp(std::move(fp)),
+          m_cache(SharedGridData::key(m_fp.get(), "gtiff")) {}
     virtual ~GTiffDataset();
 
     bool openTIFF(const std::string &filename);
@@ -1317,6 +2308,8 @@ std::unique_ptr<GTiffGrid> GTiffDataset::nextGrid() {
     auto ret = std::unique_ptr<GTiffGrid>(new GTiffGrid(
         m_ctx, m_hTIFF, m_cache, m_fp.get(), m_ifdIdx, m_filename, width,
         height, extent, dt, samplesPerPixel, planarConfig, vRes < 0));
+    if (compression != COMPRESSION_NONE && m_ctx->decodedGridCache)
+        ret->openDecodedBlockFile();
     m_ifdIdx++;
     m_hasNextGrid = TIFFReadDirectory(m_hTIFF) != 0;
     m_nextDirOffset = TIFFCurrentDirOffset(m_hTIFF);
@@ -1350,6 +2343,7 @@ class GTiffVGridShiftSet : public VerticalShiftGridSet {
         pj_log(ctx, PJ_LOG_DEBUG, "Grid %s has changed. Re-loading it",
                m_name.c_str());
         m_grids.clear();
+        m_gridsIndex.reset();
         m_GTiffDataset.reset();
         auto fp = FileManager::open_resource_file(ctx, m_name.c_str());
         if (!fp) {
@@ -1358,6 +2352,7 @@ class GTiffVGridShiftSet : public VerticalShiftGridSet {
         auto newGS = open(ctx, std::move(fp), m_name);
         if (newGS) {
             m_grids = std::move(newGS->m_grids);
+            m_gridsIndex = std::move(newGS->m_gridsIndex);
             m_GTiffDataset = std::move(newGS->m_GTiffDataset);
         }
         return !m_grids.empty();
@@ -1449,6 +2444,14 @@ class GTiffVGrid : public VerticalShiftGrid {
         return m_grid->valueAt(m_idxSample, x, y, out);
     }
 
+    bool valuesAt(int x_start, int y_start, int x_count, int y_count,
+                  float *out) const override {
+        const int sampleIdx = m_idxSample;
+        bool nodataFound = false;
+        return m_grid->valuesAt(x_start, y_start, x_count, y_count, 1,
+                                &sampleIdx, out, nodataFound);
+    }
+
     bool isNodata(float val, double /* multiplier */) const override {
         return m_grid->isNodata(val);
     }
@@ -1465,6 +2468,17 @@ class GTiffVGrid : public VerticalShiftGrid {
     }
 
     bool hasChanged() const override { return m_grid->hasChanged(); }
+
+  protected:
+    void prefetchWindow(int xmin, int ymin, int xmax, int ymax,
+                        bool decode) const override {
+        m_grid->prefetchWindow(xmin, ymin, xmax, ymax, decode);
+    }
+
+    void prefetchNodes(
+        const std::vector<std::pair<int, int>> &nodes) const override {
+        m_grid->prefetchNodes(nodes);
+    }
 };
 
 // ---------------------------------------------------------------------------
@@ -1594,6 +2608,7 @@ GTiffVGridShiftSet::open(PJ_CONTEXT *ctx, std::unique_ptr<File> fp,
         insertIntoHierarchy(ctx, std::move(vgrid), gridName, parentName,
                             set->m_grids, mapGrids);
     }
+    set->buildIndex();
     return set;
 }
 #endif // TIFF_ENABLED
@@ -1668,8 +2683,10 @@ bool VerticalShiftGridSet::reopen(PJ_CONTEXT *ctx) {
            m_name.c_str());
     auto newGS = open(ctx, m_name);
     m_grids.clear();
+    m_gridsIndex.reset();
     if (newGS) {
         m_grids = std::move(newGS->m_grids);
+        m_gridsIndex = std::move(newGS->m_gridsIndex);
     }
     return !m_grids.empty();
 }
@@ -1697,6 +2714,14 @@ static bool isPointInExtent(double x, double y, const ExtentAndRes &extent,
 
 const VerticalShiftGrid *VerticalShiftGrid::gridAt(double longitude,
                                                    double lat) const {
+    if (m_childrenIndex) {
+        const int idx = m_childrenIndex->find(
+            longitude, lat, [this, longitude, lat](int i) {
+                return isPointInExtent(longitude, lat,
+                                       m_children[i]->extentAndRes());
+            });
+        return idx >= 0 ? m_children[idx]->gridAt(longitude, lat) : this;
+    }
     for (const auto &child : m_children) {
         const auto &extentChild = child->extentAndRes();
         if (isPointInExtent(longitude, lat, extentChild)) {
@@ -1705,10 +2730,60 @@ const VerticalShiftGrid *VerticalShiftGrid::gridAt(double longitude,
     }
     return this;
 }
+
+// ---------------------------------------------------------------------------
+
+void VerticalShiftGrid::buildIndex() {
+    for (const auto &child : m_children) {
+        child->buildIndex();
+    }
+    m_childrenIndex = GridExtentIndex::build(m_children, 0);
+}
+
+// ---------------------------------------------------------------------------
+
+void VerticalShiftGrid::prefetch(double west, double south, double east,
+                                 double north, bool decode) const {
+    Grid::prefetch(west, south, east, north, decode);
+    for (const auto &child : m_children) {
+        child->prefetch(west, south, east, north, decode);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void VerticalShiftGridSet::buildIndex() {
+    for (const auto &grid : m_grids) {
+        grid->buildIndex();
+    }
+    m_gridsIndex = GridExtentIndex::build(m_grids, 0);
+}
+
+// ---------------------------------------------------------------------------
+
+void VerticalShiftGridSet::prefetch(double west, double south, double east,
+                                    double north, bool decode) const {
+    for (const auto &grid : m_grids) {
+        grid->prefetch(west, south, east, north, decode);
+    }
+}
+
 // ---------------------------------------------------------------------------
 
 const VerticalShiftGrid *VerticalShiftGridSet::gridAt(double longitude,
                                                       double lat) const {
+    if (m_gridsIndex) {
+        const int idx = m_gridsIndex->find(
+            longitude, lat, [this, longitude, lat](int i) {
+                return m_grids[i]->isNullGrid() ||
+                       isPointInExtent(longitude, lat,
+                                       m_grids[i]->extentAndRes());
+            });
+        if (idx < 0)
+            return nullptr;
+        const auto &grid = m_grids[idx];
+        return grid->isNullGrid() ? grid.get() : grid->gridAt(longitude, lat);
+    }
     for (const auto &grid : m_grids) {
         if (grid->isNullGrid()) {
             return grid.get();
@@ -1742,6 +2817,22 @@ HorizontalShiftGrid::~HorizontalShiftGrid() = default;
 
 // ---------------------------------------------------------------------------
 
+bool HorizontalShiftGrid::valuesAt(int x_start, int y_start, int x_count,
+                                   int y_count, bool compensateNTConvention,
+                                   float *longShift, float *latShift) const {
+    for (int y = y_start; y < y_start + y_count; ++y) {
+        for (int x = x_start; x < x_start + x_count; ++x) {
+            if (!valueAt(x, y, compensateNTConvention, *longShift, *latShift))
+                return false;
+            ++longShift;
+            ++latShift;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
 HorizontalShiftGridSet::HorizontalShiftGridSet() = default;
 
 // ---------------------------------------------------------------------------
@@ -1926,6 +3017,8 @@ bool NTv1Grid::valueAt(int x, int y, bool compensateNTConvention,
 class CTable2Grid : public HorizontalShiftGrid {
     PJ_CONTEXT *m_ctx;
     std::unique_ptr<File> m_fp;
+    // whole grid, if loaded in memory
+    std::shared_ptr<const std::vector<float>> m_data{};
 
     CTable2Grid(const CTable2Grid &) = delete;
     CTable2Grid &operator=(const CTable2Grid &) = delete;
@@ -1942,6 +3035,8 @@ class CTable2Grid : public HorizontalShiftGrid {
     bool valueAt(int, int, bool, float &longShift,
                  float &latShift) const override;
 
+    bool loadInMemory();
+
     static CTable2Grid *open(PJ_CONTEXT *ctx, std::unique_ptr<File> fp,
                              const std::string &filename);
 
@@ -2015,7 +3110,47 @@ CTable2Grid *CTable2Grid::open(PJ_CONTEXT *ctx, std::unique_ptr<File> fp,
     extent.north = extent.south + (height - 1) * extent.resX;
     extent.computeInvRes();
 
-    return new CTable2Grid(ctx, std::move(fp), filename, width, height, extent);
+    auto grid = internal::make_unique<CTable2Grid>(ctx, std::move(fp), filename,
+                                                  width, height, extent);
+    if (ctx->loadGridsInMemory && !grid->loadInMemory())
+        return nullptr;
+    return grid.release();
+}
+
+// ---------------------------------------------------------------------------
+
+// Load the whole grid in memory, in native endianness, or share it with
+// other openings of the same file. In case of memory allocation error, the
+// grid stays read from the file.
+bool CTable2Grid::loadInMemory() {
+    bool ok = true;
+    const std::function<std::shared_ptr<const std::vector<float>>()> load =
+        [this, &ok]() -> std::shared_ptr<const std::vector<float>> {
+        const size_t nValues = 2 * static_cast<size_t>(m_width) * m_height;
+        std::shared_ptr<std::vector<float>> data;
+        try {
+            data = std::make_shared<std::vector<float>>(nValues);
+        } catch (const std::exception &e) {
+            pj_log(m_ctx, PJ_LOG_DEBUG, "Cannot load %s in memory: %s",
+                   m_name.c_str(), e.what());
+            return nullptr;
+        }
+        m_fp->seek(160);
+        if (m_fp->read(data->data(), nValues * sizeof(float)) !=
+            nValues * sizeof(float)) {
+            proj_context_errno_set(
+                m_ctx, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
+            ok = false;
+            return nullptr;
+        }
+        if (!IS_LSB) {
+            swap_words(data->data(), sizeof(float), nValues);
+        }
+        return data;
+    };
+    m_data = SharedGridData::get().acquire(
+        SharedGridData::key(m_fp.get(), "ctable2"), load);
+    return ok;
 }
 
 // ---------------------------------------------------------------------------
@@ -2024,6 +3159,15 @@ bool CTable2Grid::valueAt(int x, int y, bool compensateNTConvention,
                           float &longShift, float &latShift) const {
     assert(x >= 0 && y >= 0 && x < m_width && y < m_height);
 
+    if (m_data) {
+        const float *two_floats =
+            &(*m_data)[2 * (static_cast<size_t>(y) * m_width + x)];
+        latShift = two_floats[1];
+        // west longitude positive convention !
+        longShift = (compensateNTConvention ? -1 : 1) * two_floats[0];
+        return true;
+    }
+
     float two_floats[2];
     m_fp->seek(160 + 2 * sizeof(float) * (y * m_width + x));
     if (m_fp->read(&two_floats[0], sizeof(two_floats)) != sizeof(two_floats)) {
@@ -2078,10 +3222,15 @@ class NTv2Grid : public HorizontalShiftGrid {
     unsigned long long m_offset;
     bool m_mustSwap;
     mutable std::vector<float> m_buffer{};
+    // whole grid, if loaded in memory, as (lat shift, long shift) in radians
+    std::shared_ptr<const std::vector<float>> m_data{};
 
     NTv2Grid(const NTv2Grid &) = delete;
     NTv2Grid &operator=(const NTv2Grid &) = delete;
 
+    bool readLine(int y, std::vector<float> &buffer) const;
+    const float *getLine(int y) const;
+
   public:
     NTv2Grid(const std::string &nameIn, PJ_CONTEXT *ctx, File *fp,
              uint32_t gridIdx, unsigned long long offsetIn, bool mustSwapIn,
@@ -2093,12 +3242,18 @@ class NTv2Grid : public HorizontalShiftGrid {
     bool valueAt(int, int, bool, float &longShift,
                  float &latShift) const override;
 
+    bool valuesAt(int x_start, int y_start, int x_count, int y_count,
+                  bool compensateNTConvention, float *longShift,
+                  float *latShift) const override;
+
     const std::string &metadataItem(const std::string &, int) const override {
         return emptyString;
     }
 
     void setCache(FloatLineCache *cache) { m_cache = cache; }
 
+    bool loadInMemory();
+
     void reassign_context(PJ_CONTEXT *ctx) override {
         m_ctx = ctx;
         m_fp->reassign_context(ctx);
@@ -2109,58 +3264,144 @@ class NTv2Grid : public HorizontalShiftGrid {
 
 // ---------------------------------------------------------------------------
 
-bool NTv2Grid::valueAt(int x, int y, bool compensateNTConvention,
-                       float &longShift, float &latShift) const {
-    assert(x >= 0 && y >= 0 && x < m_width && y < m_height);
+// Read line y of the grid, as (lat shift, long shift) pairs in arc-seconds,
+// from west to east.
+bool NTv2Grid::readLine(int y, std::vector<float> &buffer) const {
+    try {
+        buffer.resize(4 * m_width);
+    } catch (const std::exception &e) {
+        pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
+        return false;
+    }
 
-    const std::vector<float> *pBuffer = m_cache->get(m_gridIdx, y);
-    if (pBuffer == nullptr) {
-        try {
-            m_buffer.resize(4 * m_width);
-        } catch (const std::exception &e) {
-            pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-            return false;
-        }
+    const size_t nLineSizeInBytes = 4 * sizeof(float) * m_width;
+    // there are 4 components: lat shift, long shift, lat error, long error
+    m_fp->seek(m_offset +
+               nLineSizeInBytes * static_cast<unsigned long long>(y));
+    if (m_fp->read(&buffer[0], nLineSizeInBytes) != nLineSizeInBytes) {
+        proj_context_errno_set(m_ctx,
+                               PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
+        return false;
+    }
+    // Remove lat and long error
+    for (int i = 1; i < m_width; ++i) {
+        buffer[2 * i] = buffer[4 * i];
+        buffer[2 * i + 1] = buffer[4 * i + 1];
+    }
+    buffer.resize(2 * m_width);
+    if (m_mustSwap) {
+        swap_words(&buffer[0], sizeof(float), 2 * m_width);
+    }
+    // NTv2 is organized from east to west !
+    for (int i = 0; i < m_width / 2; ++i) {
+        std::swap(buffer[2 * i], buffer[2 * (m_width - 1 - i)]);
+        std::swap(buffer[2 * i + 1], buffer[2 * (m_width - 1 - i) + 1]);
+    }
+    return true;
+}
 
-        const size_t nLineSizeInBytes = 4 * sizeof(float) * m_width;
-        // there are 4 components: lat shift, long shift, lat error, long error
-        m_fp->seek(m_offset +
-                   nLineSizeInBytes * static_cast<unsigned long long>(y));
-        if (m_fp->read(&m_buffer[0], nLineSizeInBytes) != nLineSizeInBytes) {
-            proj_context_errno_set(
-                m_ctx, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
-            return false;
-        }
-        // Remove lat and long error
-        for (int i = 1; i < m_width; ++i) {
-            m_buffer[2 * i] = m_buffer[4 * i];
-            m_buffer[2 * i + 1] = m_buffer[4 * i + 1];
-        }
-        m_buffer.resize(2 * m_width);
-        if (m_mustSwap) {
-            swap_words(&m_buffer[0], sizeof(float), 2 * m_width);
-        }
-        // NTv2 is organized from east to west !
-        for (int i = 0; i < m_width / 2; ++i) {
-            std::swap(m_buffer[2 * i], m_buffer[2 * (m_width - 1 - i)]);
-            std::swap(m_buffer[2 * i + 1], m_buffer[2 * (m_width - 1 - i) + 1]);
-        }
+// ---------------------------------------------------------------------------
 
+// Load the whole grid in memory, with shifts converted to radians, or share
+// it with other openings of the same file. In case of memory allocation
+// error, the grid stays read line by line from the file.
+bool NTv2Grid::loadInMemory() {
+    bool ok = true;
+    const std::function<std::shared_ptr<const std::vector<float>>()> load =
+        [this, &ok]() -> std::shared_ptr<const std::vector<float>> {
+        std::shared_ptr<std::vector<float>> data;
         try {
-            m_cache->insert(m_gridIdx, y, m_buffer);
+            data = std::make_shared<std::vector<float>>(
+                2 * static_cast<size_t>(m_width) * m_height);
         } catch (const std::exception &e) {
-            // Should normally not happen
-            pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
+            pj_log(m_ctx, PJ_LOG_DEBUG, "Cannot load %s in memory: %s",
+                   m_name.c_str(), e.what());
+            return nullptr;
+        }
+        std::vector<float> buffer;
+        for (int y = 0; y < m_height; ++y) {
+            if (!readLine(y, buffer)) {
+                ok = false;
+                return nullptr;
+            }
+            float *out = &(*data)[2 * static_cast<size_t>(y) * m_width];
+            for (int i = 0; i < 2 * m_width; ++i) {
+                /* convert seconds to radians */
+                out[i] =
+                    static_cast<float>(buffer[i] * ((M_PI / 180.0) / 3600.0));
+            }
         }
+        return data;
+    };
+    const std::string key = SharedGridData::key(
+        m_fp, "ntv2:" + toString(static_cast<int>(m_gridIdx)));
+    m_data = SharedGridData::get().acquire(key, load);
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+
+// Return line y of the grid, as (lat shift, long shift) pairs in
+// arc-seconds, or nullptr in case of error. The returned pointer is valid
+// until the next call.
+const float *NTv2Grid::getLine(int y) const {
+    const std::vector<float> *pBuffer = m_cache->get(m_gridIdx, y);
+    if (pBuffer != nullptr) {
+        return pBuffer->data();
     }
-    const std::vector<float> &buffer = pBuffer ? *pBuffer : m_buffer;
+    if (!readLine(y, m_buffer))
+        return nullptr;
+    try {
+        m_cache->insert(m_gridIdx, y, m_buffer);
+    } catch (const std::exception &e) {
+        // Should normally not happen
+        pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
+    }
+    return m_buffer.data();
+}
+
+// ---------------------------------------------------------------------------
+
+bool NTv2Grid::valueAt(int x, int y, bool compensateNTConvention,
+                       float &longShift, float &latShift) const {
+    return valuesAt(x, y, 1, 1, compensateNTConvention, &longShift,
+                    &latShift);
+}
+
+// ---------------------------------------------------------------------------
+
+bool NTv2Grid::valuesAt(int x_start, int y_start, int x_count, int y_count,
+                        bool compensateNTConvention, float *longShift,
+                        float *latShift) const {
+    assert(x_start >= 0 && y_start >= 0 && x_start + x_count <= m_width &&
+           y_start + y_count <= m_height);
 
-    /* convert seconds to radians */
-    latShift = static_cast<float>(buffer[2 * x] * ((M_PI / 180.0) / 3600.0));
     // west longitude positive convention !
-    longShift =
-        (compensateNTConvention ? -1 : 1) *
-        static_cast<float>(buffer[2 * x + 1] * ((M_PI / 180.0) / 3600.0));
+    const float longSign = compensateNTConvention ? -1.0f : 1.0f;
+    for (int y = y_start; y < y_start + y_count; ++y) {
+        if (m_data) {
+            const float *two_floats =
+                &(*m_data)[2 * (static_cast<size_t>(y) * m_width + x_start)];
+            for (int x = 0; x < x_count; ++x) {
+                *latShift++ = two_floats[2 * x];
+                *longShift++ = longSign * two_floats[2 * x + 1];
+            }
+            continue;
+        }
+
+        const float *line = getLine(y);
+        if (line == nullptr)
+            return false;
+        const float *two_floats = line + 2 * x_start;
+        for (int x = 0; x < x_count; ++x) {
+            /* convert seconds to radians */
+            *latShift++ = static_cast<float>(two_floats[2 * x] *
+                                             ((M_PI / 180.0) / 3600.0));
+            *longShift++ =
+                longSign * static_cast<float>(two_floats[2 * x + 1] *
+                                              ((M_PI / 180.0) / 3600.0));
+        }
+    }
     return true;
 }
 
@@ -2327,8 +3568,11 @@ std::unique_ptr<NTv2GridSet> NTv2GridSet::open(PJ_CONTEXT *ctx,
     set->m_cache = internal::make_unique<FloatLineCache>(maxLinesInCache);
     for (const auto &kv : mapGrids) {
         kv.second->setCache(set->m_cache.get());
+        if (ctx->loadGridsInMemory && !kv.second->loadInMemory())
+            return nullptr;
     }
 
+    set->buildIndex();
     return set;
 }
 
@@ -2361,6 +3605,7 @@ class GTiffHGridShiftSet : public HorizontalShiftGridSet {
         pj_log(ctx, PJ_LOG_DEBUG, "Grid %s has changed. Re-loading it",
                m_name.c_str());
         m_grids.clear();
+        m_gridsIndex.reset();
         m_GTiffDataset.reset();
         auto fp = FileManager::open_resource_file(ctx, m_name.c_str());
         if (!fp) {
@@ -2369,6 +3614,7 @@ class GTiffHGridShiftSet : public HorizontalShiftGridSet {
         auto newGS = open(ctx, std::move(fp), m_name);
         if (newGS) {
             m_grids = std::move(newGS->m_grids);
+            m_gridsIndex = std::move(newGS->m_gridsIndex);
             m_GTiffDataset = std::move(newGS->m_GTiffDataset);
         }
         return !m_grids.empty();
@@ -2389,6 +3635,7 @@ class GTiffHGrid : public HorizontalShiftGrid {
     uint16_t m_idxLongShift;
     double m_convFactorToRadian;
     bool m_positiveEast;
+    mutable std::vector<float> m_buffer{};
 
   public:
     GTiffHGrid(std::unique_ptr<GTiffGrid> &&grid, uint16_t idxLatShift,
@@ -2400,6 +3647,9 @@ class GTiffHGrid : public HorizontalShiftGrid {
     bool valueAt(int x, int y, bool, float &longShift,
                  float &latShift) const override;
 
+    bool valuesAt(int x_start, int y_start, int x_count, int y_count, bool,
+                  float *longShift, float *latShift) const override;
+
     const std::string &metadataItem(const std::string &key,
                                     int sample = -1) const override {
         return m_grid->metadataItem(key, sample);
@@ -2412,6 +3662,17 @@ class GTiffHGrid : public HorizontalShiftGrid {
     }
 
     bool hasChanged() const override { return m_grid->hasChanged(); }
+
+  protected:
+    void prefetchWindow(int xmin, int ymin, int xmax, int ymax,
+                        bool decode) const override {
+        m_grid->prefetchWindow(xmin, ymin, xmax, ymax, decode);
+    }
+
+    void prefetchNodes(
+        const std::vector<std::pair<int, int>> &nodes) const override {
+        m_grid->prefetchNodes(nodes);
+    }
 };
 
 // ---------------------------------------------------------------------------
@@ -2452,6 +3713,38 @@ bool GTiffHGrid::valueAt(int x, int y, bool, float &longShift,
 
 // ---------------------------------------------------------------------------
 
+bool GTiffHGrid::valuesAt(int x_start, int y_start, int x_count, int y_count,
+                          bool, float *longShift, float *latShift) const {
+    const int nValues = x_count * y_count;
+    try {
+        m_buffer.resize(2 * nValues);
+    } catch (const std::exception &) {
+        return HorizontalShiftGrid::valuesAt(x_start, y_start, x_count,
+                                             y_count, false, longShift,
+                                             latShift);
+    }
+    // Fetch both samples at once, so that the block is looked up only once
+    const int sampleIdx[] = {m_idxLatShift, m_idxLongShift};
+    bool nodataFound = false;
+    if (!m_grid->valuesAt(x_start, y_start, x_count, y_count, 2, sampleIdx,
+                          m_buffer.data(), nodataFound)) {
+        return false;
+    }
+    for (int i = 0; i < nValues; ++i) {
+        // From arc-seconds to radians
+        latShift[i] =
+            static_cast<float>(m_buffer[2 * i] * m_convFactorToRadian);
+        longShift[i] =
+            static_cast<float>(m_buffer[2 * i + 1] * m_convFactorToRadian);
+        if (!m_positiveEast) {
+            longShift[i] = -longShift[i];
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
 void GTiffHGrid::insertGrid(PJ_CONTEXT *ctx,
                             std::unique_ptr<GTiffHGrid> &&subgrid) {
     bool gridInserted = false;
@@ -2640,6 +3933,7 @@ GTiffHGridShiftSet::open(PJ_CONTEXT *ctx, std::unique_ptr<File> fp,
         insertIntoHierarchy(ctx, std::move(hgrid), gridName, parentName,
                             set->m_grids, mapGrids);
     }
+    set->buildIndex();
     return set;
 }
 #endif // TIFF_ENABLED
@@ -2738,8 +4032,10 @@ bool HorizontalShiftGridSet::reopen(PJ_CONTEXT *ctx) {
            m_name.c_str());
     auto newGS = open(ctx, m_name);
     m_grids.clear();
+    m_gridsIndex.reset();
     if (newGS) {
         m_grids = std::move(newGS->m_grids);
+        m_gridsIndex = std::move(newGS->m_gridsIndex);
     }
     return !m_grids.empty();
 }
@@ -2748,13 +4044,27 @@ bool HorizontalShiftGridSet::reopen(PJ_CONTEXT *ctx) {
 
 #define REL_TOLERANCE_HGRIDSHIFT 1e-5
 
+static bool isPointInHGridExtent(double longitude, double lat,
+                                 const ExtentAndRes &extent) {
+    const double epsilon =
+        (extent.resX + extent.resY) * REL_TOLERANCE_HGRIDSHIFT;
+    return isPointInExtent(longitude, lat, extent, epsilon);
+}
+
+// ---------------------------------------------------------------------------
+
 const HorizontalShiftGrid *HorizontalShiftGrid::gridAt(double longitude,
                                                        double lat) const {
+    if (m_childrenIndex) {
+        const int idx = m_childrenIndex->find(
+            longitude, lat, [this, longitude, lat](int i) {
+                return isPointInHGridExtent(longitude, lat,
+                                            m_children[i]->extentAndRes());
+            });
+        return idx >= 0 ? m_children[idx]->gridAt(longitude, lat) : this;
+    }
     for (const auto &child : m_children) {
-        const auto &extentChild = child->extentAndRes();
-        const double epsilon =
-            (extentChild.resX + extentChild.resY) * REL_TOLERANCE_HGRIDSHIFT;
-        if (isPointInExtent(longitude, lat, extentChild, epsilon)) {
+        if (isPointInHGridExtent(longitude, lat, child->extentAndRes())) {
             return child->gridAt(longitude, lat);
         }
     }
@@ -2762,16 +4072,63 @@ const HorizontalShiftGrid *HorizontalShiftGrid::gridAt(double longitude,
 }
 // ---------------------------------------------------------------------------
 
+void HorizontalShiftGrid::buildIndex() {
+    for (const auto &child : m_children) {
+        child->buildIndex();
+    }
+    m_childrenIndex =
+        GridExtentIndex::build(m_children, REL_TOLERANCE_HGRIDSHIFT);
+}
+
+// ---------------------------------------------------------------------------
+
+void HorizontalShiftGrid::prefetch(double west, double south, double east,
+                                   double north, bool decode) const {
+    Grid::prefetch(west, south, east, north, decode);
+    for (const auto &child : m_children) {
+        child->prefetch(west, south, east, north, decode);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void HorizontalShiftGridSet::buildIndex() {
+    for (const auto &grid : m_grids) {
+        grid->buildIndex();
+    }
+    m_gridsIndex = GridExtentIndex::build(m_grids, REL_TOLERANCE_HGRIDSHIFT);
+}
+
+// ---------------------------------------------------------------------------
+
+void HorizontalShiftGridSet::prefetch(double west, double south, double east,
+                                      double north, bool decode) const {
+    for (const auto &grid : m_grids) {
+        grid->prefetch(west, south, east, north, decode);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 const HorizontalShiftGrid *HorizontalShiftGridSet::gridAt(double longitude,
                                                           double lat) const {
+    if (m_gridsIndex) {
+        const int idx = m_gridsIndex->find(
+            longitude, lat, [this, longitude, lat](int i) {
+                return m_grids[i]->isNullGrid() ||
+                       isPointInHGridExtent(longitude, lat,
+                                            m_grids[i]->extentAndRes());
+            });
+        if (idx < 0)
+            return nullptr;
+        const auto &grid = m_grids[idx];
+        return grid->isNullGrid() ? grid.get() : grid->gridAt(longitude, lat);
+    }
     for (const auto &grid : m_grids) {
         if (grid->isNullGrid()) {
             return grid.get();
         }
-        const auto &extent = grid->extentAndRes();
-        const double epsilon =
-            (extent.resX + extent.resY) * REL_TOLERANCE_HGRIDSHIFT;
-        if (isPointInExtent(longitude, lat, extent, epsilon)) {
+        if (isPointInHGridExtent(longitude, lat, grid->extentAndRes())) {
             return grid->gridAt(longitude, lat);
         }
     }
@@ -2814,6 +4171,7 @@ class GTiffGenericGridShiftSet : public GenericShiftGridSet {
         pj_log(ctx, PJ_LOG_DEBUG, "Grid %s has changed. Re-loading it",
                m_name.c_str());
         m_grids.clear();
+        m_gridsIndex.reset();
         m_GTiffDataset.reset();
         auto fp = FileManager::open_resource_file(ctx, m_name.c_str());
         if (!fp) {
@@ -2822,6 +4180,7 @@ class GTiffGenericGridShiftSet : public GenericShiftGridSet {
         auto newGS = open(ctx, std::move(fp), m_name);
         if (newGS) {
             m_grids = std::move(newGS->m_grids);
+            m_gridsIndex = std::move(newGS->m_gridsIndex);
             m_GTiffDataset = std::move(newGS->m_GTiffDataset);
         }
         return !m_grids.empty();
@@ -2893,6 +4252,17 @@ class GTiffGenericGrid final : public GenericShiftGrid {
 
     bool hasChanged() const override { return m_grid->hasChanged(); }
 
+  protected:
+    void prefetchWindow(int xmin, int ymin, int xmax, int ymax,
+                        bool decode) const override {
+        m_grid->prefetchWindow(xmin, ymin, xmax, ymax, decode);
+    }
+
+    void prefetchNodes(
+        const std::vector<std::pair<int, int>> &nodes) const override {
+        m_grid->prefetchNodes(nodes);
+    }
+
   private:
     GTiffGenericGrid(const GTiffGenericGrid &) = delete;
     GTiffGenericGrid &operator=(const GTiffGenericGrid &) = delete;
@@ -3039,6 +4409,7 @@ GTiffGenericGridShiftSet::open(PJ_CONTEXT *ctx, std::unique_ptr<File> fp,
         insertIntoHierarchy(ctx, std::move(ggrid), gridName, parentName,
                             set->m_grids, mapGrids);
     }
+    set->buildIndex();
     return set;
 }
 #endif // TIFF_ENABLED
@@ -3055,6 +4426,16 @@ GenericShiftGrid::~GenericShiftGrid() = default;
 
 // ---------------------------------------------------------------------------
 
+void GenericShiftGrid::prefetch(double west, double south, double east,
+                                double north, bool decode) const {
+    Grid::prefetch(west, south, east, north, decode);
+    for (const auto &child : m_children) {
+        child->prefetch(west, south, east, north, decode);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 bool GenericShiftGrid::valuesAt(int x_start, int y_start, int x_count,
                                 int y_count, int sample_count,
                                 const int *sample_idx, float *out,
@@ -3138,8 +4519,10 @@ bool GenericShiftGridSet::reopen(PJ_CONTEXT *ctx) {
            m_name.c_str());
     auto newGS = open(ctx, m_name);
     m_grids.clear();
+    m_gridsIndex.reset();
     if (newGS) {
         m_grids = std::move(newGS->m_grids);
+        m_gridsIndex = std::move(newGS->m_gridsIndex);
     }
     return !m_grids.empty();
 }
@@ -3147,6 +4530,12 @@ bool GenericShiftGridSet::reopen(PJ_CONTEXT *ctx) {
 // ---------------------------------------------------------------------------
 
 const GenericShiftGrid *GenericShiftGrid::gridAt(double x, double y) const {
+    if (m_childrenIndex) {
+        const int idx = m_childrenIndex->find(x, y, [this, x, y](int i) {
+            return isPointInExtent(x, y, m_children[i]->extentAndRes());
+        });
+        return idx >= 0 ? m_children[idx]->gridAt(x, y) : this;
+    }
     for (const auto &child : m_children) {
         const auto &extentChild = child->extentAndRes();
         if (isPointInExtent(x, y, extentChild)) {
@@ -3158,7 +4547,44 @@ const GenericShiftGrid *GenericShiftGrid::gridAt(double x, double y) const {
 
 // ---------------------------------------------------------------------------
 
+void GenericShiftGrid::buildIndex() {
+    for (const auto &child : m_children) {
+        child->buildIndex();
+    }
+    m_childrenIndex = GridExtentIndex::build(m_children, 0);
+}
+
+// ---------------------------------------------------------------------------
+
+void GenericShiftGridSet::buildIndex() {
+    for (const auto &grid : m_grids) {
+        grid->buildIndex();
+    }
+    m_gridsIndex = GridExtentIndex::build(m_grids, 0);
+}
+
+// ---------------------------------------------------------------------------
+
+void GenericShiftGridSet::prefetch(double west, double south, double east,
+                                   double north, bool decode) const {
+    for (const auto &grid : m_grids) {
+        grid->prefetch(west, south, east, north, decode);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 const GenericShiftGrid *GenericShiftGridSet::gridAt(double x, double y) const {
+    if (m_gridsIndex) {
+        const int idx = m_gridsIndex->find(x, y, [this, x, y](int i) {
+            return m_grids[i]->isNullGrid() ||
+                   isPointInExtent(x, y, m_grids[i]->extentAndRes());
+        });
+        if (idx < 0)
+            return nullptr;
+        const auto &grid = m_grids[idx];
+        return grid->isNullGrid() ? grid.get() : grid->gridAt(x, y);
+    }
     for (const auto &grid : m_grids) {
         if (grid->isNullGrid()) {
             return grid.get();
@@ -3175,6 +4601,18 @@ const GenericShiftGrid *GenericShiftGridSet::gridAt(double x, double y) const {
 
 const GenericShiftGrid *GenericShiftGridSet::gridAt(const std::string &type,
                                                     double x, double y) const {
+    if (m_gridsIndex) {
+        const int idx = m_gridsIndex->find(x, y, [this, &type, x, y](int i) {
+            const auto &grid = m_grids[i];
+            return grid->isNullGrid() ||
+                   (grid->type() == type &&
+                    isPointInExtent(x, y, grid->extentAndRes()));
+        });
+        if (idx < 0)
+            return nullptr;
+        const auto &grid = m_grids[idx];
+        return grid->isNullGrid() ? grid.get() : grid->gridAt(x, y);
+    }
     for (const auto &grid : m_grids) {
         if (grid->isNullGrid()) {
             return grid.get();
@@ -3311,9 +4749,25 @@ typedef struct {
     int32_t lam, phi;
 } ILP;
 
+namespace {
+// Values of the 4 nodes of the grid cell last used by pj_hgrid_interpolate(),
+// so that they are not fetched again for the following points falling in the
+// same cell.
+struct HGridCell {
+    const HorizontalShiftGrid *grid = nullptr;
+    bool compensateNTConvention = false;
+    int x = 0;
+    int y = 0;
+    // nodes (x, y), (x + 1, y), (x, y + 1) and (x + 1, y + 1)
+    float longShift[4] = {0, 0, 0, 0};
+    float latShift[4] = {0, 0, 0, 0};
+};
+} // namespace
+
 // Apply bilinear interpolation for horizontal shift grids
 static PJ_LP pj_hgrid_interpolate(PJ_LP t, const HorizontalShiftGrid *grid,
-                                  bool compensateNTConvention) {
+                                  bool compensateNTConvention,
+                                  HGridCell &cell) {
     PJ_LP val, frct;
     ILP indx;
     int in;
@@ -3354,20 +4808,22 @@ static PJ_LP pj_hgrid_interpolate(PJ_LP t, const HorizontalShiftGrid *grid,
             return val;
     }
 
-    float f00Long = 0, f00Lat = 0;
-    float f10Long = 0, f10Lat = 0;
-    float f01Long = 0, f01Lat = 0;
-    float f11Long = 0, f11Lat = 0;
-    if (!grid->valueAt(indx.lam, indx.phi, compensateNTConvention, f00Long,
-                       f00Lat) ||
-        !grid->valueAt(indx.lam + 1, indx.phi, compensateNTConvention, f10Long,
-                       f10Lat) ||
-        !grid->valueAt(indx.lam, indx.phi + 1, compensateNTConvention, f01Long,
-                       f01Lat) ||
-        !grid->valueAt(indx.lam + 1, indx.phi + 1, compensateNTConvention,
-                       f11Long, f11Lat)) {
-        return val;
+    if (cell.grid != grid || cell.x != indx.lam || cell.y != indx.phi ||
+        cell.compensateNTConvention != compensateNTConvention) {
+        if (!grid->valuesAt(indx.lam, indx.phi, 2, 2, compensateNTConvention,
+                            cell.longShift, cell.latShift)) {
+            cell.grid = nullptr;
+            return val;
+        }
+        cell.grid = grid;
+        cell.compensateNTConvention = compensateNTConvention;
+        cell.x = indx.lam;
+        cell.y = indx.phi;
     }
+    const float f00Long = cell.longShift[0], f00Lat = cell.latShift[0];
+    const float f10Long = cell.longShift[1], f10Lat = cell.latShift[1];
+    const float f01Long = cell.longShift[2], f01Lat = cell.latShift[2];
+    const float f11Long = cell.longShift[3], f11Lat = cell.latShift[3];
 
     double m10 = frct.lam;
     double m11 = m10;
@@ -3393,7 +4849,7 @@ static PJ_LP pj_hgrid_apply_internal(PJ_CONTEXT *ctx, PJ_LP in,
                                      const HorizontalShiftGrid *grid,
                                      HorizontalShiftGridSet *gridset,
                                      const ListOfHGrids &grids,
-                                     bool &shouldRetry) {
+                                     HGridCell &cell, bool &shouldRetry) {
     PJ_LP t, tb, del, dif;
     int i = MAX_ITERATIONS;
     const double toltol = TOL * TOL;
@@ -3414,8 +4870,9 @@ static PJ_LP pj_hgrid_apply_internal(PJ_CONTEXT *ctx, PJ_LP in,
         tb.lam -= 2 * M_PI;
     tb.phi -= extent->south;
 
-    t = pj_hgrid_interpolate(tb, grid, true);
+    t = pj_hgrid_interpolate(tb, grid, true, cell);
     if (grid->hasChanged()) {
+        cell.grid = nullptr;
         shouldRetry = gridset->reopen(ctx);
         return t;
     }
@@ -3432,8 +4889,9 @@ static PJ_LP pj_hgrid_apply_internal(PJ_CONTEXT *ctx, PJ_LP in,
     t.phi = tb.phi - t.phi;
 
     do {
-        del = pj_hgrid_interpolate(t, grid, true);
+        del = pj_hgrid_interpolate(t, grid, true, cell);
         if (grid->hasChanged()) {
+            cell.grid = nullptr;
             shouldRetry = gridset->reopen(ctx);
             return t;
         }
@@ -3495,8 +4953,9 @@ static PJ_LP pj_hgrid_apply_internal(PJ_CONTEXT *ctx, PJ_LP in,
 
 // ---------------------------------------------------------------------------
 
-PJ_LP pj_hgrid_apply(PJ_CONTEXT *ctx, const ListOfHGrids &grids, PJ_LP lp,
-                     PJ_DIRECTION direction) {
+static PJ_LP pj_hgrid_apply(PJ_CONTEXT *ctx, const ListOfHGrids &grids,
+                            PJ_LP lp, PJ_DIRECTION direction,
+                            HGridCell &cell) {
     PJ_LP out;
 
     out.lam = HUGE_VAL;
@@ -3515,7 +4974,7 @@ PJ_LP pj_hgrid_apply(PJ_CONTEXT *ctx, const ListOfHGrids &grids, PJ_LP lp,
 
         bool shouldRetry = false;
         out = pj_hgrid_apply_internal(ctx, lp, direction, grid, gridset, grids,
-                                      shouldRetry);
+                                      cell, shouldRetry);
         if (!shouldRetry) {
             break;
         }
@@ -3527,6 +4986,107 @@ PJ_LP pj_hgrid_apply(PJ_CONTEXT *ctx, const ListOfHGrids &grids, PJ_LP lp,
     return out;
 }
 
+// ---------------------------------------------------------------------------
+
+PJ_LP pj_hgrid_apply(PJ_CONTEXT *ctx, const ListOfHGrids &grids, PJ_LP lp,
+                     PJ_DIRECTION direction) {
+    HGridCell cell;
+    return pj_hgrid_apply(ctx, grids, lp, direction, cell);
+}
+
+// ---------------------------------------------------------------------------
+
+// Hint the grids that nodes around the lp component of the n coordinates will
+// be read soon, so that network grids fetch the blocks containing them with a
+// few range requests rather than one per block. Points whose x component is
+// HUGE_VAL are skipped. Each point is only attributed to the grid used to
+// transform it.
+template <class ListOfGridSets>
+static void prefetchGrids(const ListOfGridSets &grids, const PJ_COORD *coo,
+                          size_t n) {
+    // Points of the batch, grouped by grid
+    std::vector<std::pair<const Grid *, std::vector<std::pair<double, double>>>>
+        pointsOfGrids;
+    size_t nValid = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (coo[i].xyzt.x == HUGE_VAL)
+            continue;
+        ++nValid;
+        const PJ_LP lp = coo[i].lp;
+        const Grid *grid = nullptr;
+        for (const auto &gridset : grids) {
+            grid = gridset->gridAt(lp.lam, lp.phi);
+            if (grid)
+                break;
+        }
+        if (!grid || grid->isNullGrid())
+            continue;
+        size_t idx = 0;
+        while (idx < pointsOfGrids.size() && pointsOfGrids[idx].first != grid)
+            ++idx;
+        if (idx == pointsOfGrids.size()) {
+            pointsOfGrids.emplace_back(
+                grid, std::vector<std::pair<double, double>>());
+        }
+        pointsOfGrids[idx].second.emplace_back(lp.lam, lp.phi);
+    }
+    if (nValid < 2)
+        return;
+    for (const auto &entry : pointsOfGrids) {
+        entry.first->prefetchPoints(entry.second);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+// Load in the caches the blocks of the geographic grids intersecting the
+// specified extent, in radians. Grids in other CRS are skipped, as the extent
+// cannot be expressed in their units.
+template <class ListOfGridSets>
+static void prepareGridsForArea(const ListOfGridSets &grids, double west,
+                                double south, double east, double north) {
+    for (const auto &gridset : grids) {
+        for (const auto &grid : gridset->grids()) {
+            if (grid->extentAndRes().isGeographic) {
+                grid->prefetch(west, south, east, north, /* decode = */ true);
+            }
+        }
+    }
+}
+
+void pj_prepare_grids_for_area(const ListOfHGrids &grids, double west,
+                               double south, double east, double north) {
+    prepareGridsForArea(grids, west, south, east, north);
+}
+
+void pj_prepare_grids_for_area(const ListOfVGrids &grids, double west,
+                               double south, double east, double north) {
+    prepareGridsForArea(grids, west, south, east, north);
+}
+
+void pj_prepare_grids_for_area(const ListOfGenericGrids &grids, double west,
+                               double south, double east, double north) {
+    prepareGridsForArea(grids, west, south, east, north);
+}
+
+// ---------------------------------------------------------------------------
+
+// Array version of pj_hgrid_apply(), applied in-place to the lp component of
+// the n coordinates. Points whose x component is HUGE_VAL are skipped. The
+// grid cell is kept from one point to the next, so that spatially coherent
+// points do not fetch the same grid nodes again.
+void pj_hgrid_apply_n(PJ_CONTEXT *ctx, const ListOfHGrids &grids,
+                      PJ_COORD *coo, size_t n, PJ_DIRECTION direction) {
+    prefetchGrids(grids, coo, n);
+    HGridCell cell;
+    for (size_t i = 0; i < n; i++) {
+        if (coo[i].xyzt.x == HUGE_VAL)
+            continue;
+        const auto lp = pj_hgrid_apply(ctx, grids, coo[i].lp, direction, cell);
+        coo[i].lp = lp;
+    }
+}
+
 /********************************************/
 /*           proj_hgrid_value()             */
 /*                                          */
@@ -3561,7 +5121,8 @@ PJ_LP pj_hgrid_value(PJ *P, const ListOfHGrids &grids, PJ_LP lp) {
         lp.lam -= 2 * M_PI;
     lp.phi -= extent.south;
 
-    out = pj_hgrid_interpolate(lp, grid, false);
+    HGridCell cell;
+    out = pj_hgrid_interpolate(lp, grid, false, cell);
     if (grid->hasChanged()) {
         if (gridset->reopen(P->ctx)) {
             return pj_hgrid_value(P, grids, lp);
@@ -3579,8 +5140,24 @@ PJ_LP pj_hgrid_value(PJ *P, const ListOfHGrids &grids, PJ_LP lp) {
 
 // ---------------------------------------------------------------------------
 
+namespace {
+// Values of the 4 nodes of the grid cell last used by read_vgrid_value(), so
+// that they are not fetched again for the following points falling in the
+// same cell.
+struct VGridCell {
+    const VerticalShiftGrid *grid = nullptr;
+    int ix = 0;
+    int iy = 0;
+    int ix2 = 0;
+    int iy2 = 0;
+    // nodes (ix, iy), (ix2, iy), (ix, iy2) and (ix2, iy2)
+    float values[4] = {0, 0, 0, 0};
+};
+} // namespace
+
 static double read_vgrid_value(PJ_CONTEXT *ctx, const ListOfVGrids &grids,
-                               const PJ_LP &input, const double vmultiplier) {
+                               const PJ_LP &input, const double vmultiplier,
+                               VGridCell &cell) {
 
     /* do not deal with NaN coordinates */
     /* cppcheck-suppress duplicateExpression */
@@ -3662,17 +5239,29 @@ static double read_vgrid_value(PJ_CONTEXT *ctx, const ListOfVGrids &grids,
     if (grid_iy2 >= grid->height())
         grid_iy2 = grid->height() - 1;
 
-    float value_a = 0;
-    float value_b = 0;
-    float value_c = 0;
-    float value_d = 0;
-    bool error = (!grid->valueAt(grid_ix, grid_iy, value_a) ||
-                  !grid->valueAt(grid_ix2, grid_iy, value_b) ||
-                  !grid->valueAt(grid_ix, grid_iy2, value_c) ||
-                  !grid->valueAt(grid_ix2, grid_iy2, value_d));
+    bool error = false;
+    if (cell.grid != grid || cell.ix != grid_ix || cell.iy != grid_iy ||
+        cell.ix2 != grid_ix2 || cell.iy2 != grid_iy2) {
+        float *values = cell.values;
+        if (grid_ix2 == grid_ix + 1 && grid_iy2 == grid_iy + 1) {
+            error = !grid->valuesAt(grid_ix, grid_iy, 2, 2, values);
+        } else {
+            // Wrap-around in longitude, or last column or line of the grid
+            error = (!grid->valueAt(grid_ix, grid_iy, values[0]) ||
+                     !grid->valueAt(grid_ix2, grid_iy, values[1]) ||
+                     !grid->valueAt(grid_ix, grid_iy2, values[2]) ||
+                     !grid->valueAt(grid_ix2, grid_iy2, values[3]));
+        }
+        cell.grid = error ? nullptr : grid;
+        cell.ix = grid_ix;
+        cell.iy = grid_iy;
+        cell.ix2 = grid_ix2;
+        cell.iy2 = grid_iy2;
+    }
     if (grid->hasChanged()) {
+        cell.grid = nullptr;
         if (curGridset->reopen(ctx)) {
-            return read_vgrid_value(ctx, grids, input, vmultiplier);
+            return read_vgrid_value(ctx, grids, input, vmultiplier, cell);
         }
         error = true;
     }
@@ -3681,6 +5270,10 @@ static double read_vgrid_value(PJ_CONTEXT *ctx, const ListOfVGrids &grids,
         return HUGE_VAL;
     }
 
+    const float value_a = cell.values[0];
+    const float value_b = cell.values[1];
+    const float value_c = cell.values[2];
+    const float value_d = cell.values[3];
     double value = 0.0;
 
     const double grid_x_y = grid_x * grid_y;
@@ -3803,7 +5396,8 @@ double pj_vgrid_value(PJ *P, const ListOfVGrids &grids, PJ_LP lp,
 
     double value;
 
-    value = read_vgrid_value(P->ctx, grids, lp, vmultiplier);
+    VGridCell cell;
+    value = read_vgrid_value(P->ctx, grids, lp, vmultiplier, cell);
     if (pj_log_active(P->ctx, PJ_LOG_TRACE)) {
         proj_log_trace(P, "proj_vgrid_value: (%f, %f) = %f",
                        lp.lam * RAD_TO_DEG, lp.phi * RAD_TO_DEG, value);
@@ -3814,6 +5408,35 @@ double pj_vgrid_value(PJ *P, const ListOfVGrids &grids, PJ_LP lp,
 
 // ---------------------------------------------------------------------------
 
+// Add (forward direction) or subtract (inverse direction) the grid value at
+// the lp component of the n coordinates to their z component. Points whose x
+// component is HUGE_VAL are skipped. The grid cell is kept from one point to
+// the next, so that spatially coherent points do not fetch the same grid
+// nodes again.
+void pj_vgrid_apply_n(PJ *P, const ListOfVGrids &grids, PJ_COORD *coo,
+                      size_t n, double vmultiplier, PJ_DIRECTION direction) {
+    prefetchGrids(grids, coo, n);
+    const bool logTrace = pj_log_active(P->ctx, PJ_LOG_TRACE);
+    VGridCell cell;
+    for (size_t i = 0; i < n; i++) {
+        if (coo[i].xyzt.x == HUGE_VAL)
+            continue;
+        const PJ_LP lp = coo[i].lp;
+        const double value =
+            read_vgrid_value(P->ctx, grids, lp, vmultiplier, cell);
+        if (logTrace) {
+            proj_log_trace(P, "proj_vgrid_value: (%f, %f) = %f",
+                           lp.lam * RAD_TO_DEG, lp.phi * RAD_TO_DEG, value);
+        }
+        if (direction == PJ_FWD)
+            coo[i].xyz.z += value;
+        else
+            coo[i].xyz.z -= value;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 const GenericShiftGrid *pj_find_generic_grid(const ListOfGenericGrids &grids,
                                              const PJ_LP &input,
                                              GenericShiftGridSet *&gridSetOut) {
@@ -3912,3 +5535,131 @@ bool pj_bilinear_interpolation_three_samples(
 }
 
 NS_PROJ_END
+
+/************************************************************************/
+/*             proj_context_set_tiff_block_cache_max_size()             */
+/************************************************************************/
+
+/** Set the maximum size of the in-memory cache of decoded blocks of GeoTIFF
+ * grids.
+ *
+ * This cache is shared by all contexts of the process, so this setting
+ * affects all of them. It overrides the tiff_block_cache_size_MB setting of
+ * proj.ini.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param max_size_MB Maximum size, in mega-bytes (1024*1024 bytes). 0 disables
+ *                    the cache (only the last accessed block of each grid is
+ *                    then kept). A negative value cancels a previous call,
+ *                    and restores the size of proj.ini, or the default size.
+ * @since 9.6
+ */
+void proj_context_set_tiff_block_cache_max_size(PJ_CONTEXT *ctx,
+                                                int max_size_MB) {
+    if (ctx == nullptr) {
+        ctx = pj_get_default_ctx();
+    }
+    // Load ini file, now so as to override its settings
+    pj_load_ini(ctx);
+    if (max_size_MB < 0) {
+        NS_PROJ::SharedBlockCache::get().resetMaxSize();
+    } else {
+        NS_PROJ::SharedBlockCache::get().setMaxSize(
+            static_cast<long long>(max_size_MB) * 1024 * 1024,
+            /* fromIni = */ false);
+    }
+}
+
+/************************************************************************/
+/*               proj_context_get_tiff_block_cache_stats()              */
+/************************************************************************/
+
+/** Return the number of hits and misses of the in-memory cache of decoded
+ * blocks of GeoTIFF grids, since the start of the process.
+ *
+ * This cache is shared by all contexts of the process.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param out_hits Pointer to the number of hits, or NULL
+ * @param out_misses Pointer to the number of misses, or NULL
+ * @since 9.6
+ */
+void proj_context_get_tiff_block_cache_stats(PJ_CONTEXT *ctx,
+                                             unsigned long long *out_hits,
+                                             unsigned long long *out_misses) {
+    (void)ctx;
+    unsigned long long hits = 0;
+    unsigned long long misses = 0;
+    NS_PROJ::SharedBlockCache::get().getStats(hits, misses);
+    if (out_hits)
+        *out_hits = hits;
+    if (out_misses)
+        *out_misses = misses;
+}
+
+/************************************************************************/
+/*                proj_context_set_load_grids_in_memory()               */
+/************************************************************************/
+
+/** Set whether NTv2, GTX and CTable2 grids are entirely loaded in memory when
+ * opened.
+ *
+ * By default, those grids are read line by line from the file, with a
+ * limited cache of recently accessed lines. When enabled, the whole content
+ * of the grid is read at opening, which avoids later file accesses. This
+ * is mostly interesting for workloads that transform many points over the
+ * extent of a grid. This setting does not affect GeoTIFF grids.
+ *
+ * This overrides the load_grids_in_memory setting of proj.ini.
+ * Only grids opened after this call are affected.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param enabled TRUE if grids must be loaded in memory.
+ * @since 9.6
+ */
+void proj_context_set_load_grids_in_memory(PJ_CONTEXT *ctx, int enabled) {
+    if (ctx == nullptr) {
+        ctx = pj_get_default_ctx();
+    }
+    // Load ini file, now so as to override its settings
+    pj_load_ini(ctx);
+    ctx->loadGridsInMemory = enabled != FALSE;
+    ctx->settingsChanged();
+}
+
+/************************************************************************/
+/*              proj_context_set_decoded_grid_cache_enable()            */
+/************************************************************************/
+
+/** Set whether the decoded content of compressed GeoTIFF grids is kept in
+ * files of the user writable directory.
+ *
+ * When enabled, each block of a compressed GeoTIFF grid is decompressed
+ * once, and stored uncompressed in a file of the decoded_grids subdirectory
+ * of the user writable directory, which is memory-mapped, so that later
+ * accesses, including by other processes or later runs, do not need to
+ * decompress it again. Those files are identified by the modification time
+ * (or the ETag for remote grids) of the grid, so that an updated grid is
+ * decoded again, and the file of its previous version is then removed.
+ * They can be removed at any time.
+ *
+ * This is only available on POSIX systems, and for grids read through the
+ * default file API or the network.
+ *
+ * This overrides the decoded_grid_cache setting of proj.ini.
+ * Only grids opened after this call are affected.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param enabled TRUE if the decoded content of grids must be kept in files.
+ * @since 9.6
+ */
+void proj_context_set_decoded_grid_cache_enable(PJ_CONTEXT *ctx,
+                                                int enabled) {
+    if (ctx == nullptr) {
+        ctx = pj_get_default_ctx();
+    }
+    // Load ini file, now so as to override its settings
+    pj_load_ini(ctx);
+    ctx->decodedGridCache = enabled != FALSE;
+    ctx->settingsChanged();
+}
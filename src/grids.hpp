@@ -29,6 +29,7 @@
 #define GRIDS_HPP_INCLUDED
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "proj.h"
@@ -57,6 +58,10 @@ struct ExtentAndRes {
 
 // ---------------------------------------------------------------------------
 
+class GridExtentIndex;
+
+// ---------------------------------------------------------------------------
+
 class PROJ_GCC_DLL Grid {
   protected:
     std::string m_name;
@@ -80,6 +85,30 @@ class PROJ_GCC_DLL Grid {
 
     PROJ_FOR_TEST virtual bool isNullGrid() const { return false; }
     PROJ_FOR_TEST virtual bool hasChanged() const = 0;
+
+    // Hint that nodes within the specified extent, expressed in the same
+    // units as extentAndRes(), will be read soon. If decode is true, the
+    // corresponding blocks are also loaded in the block cache, and not only
+    // downloaded.
+    PROJ_FOR_TEST virtual void prefetch(double west, double south, double east,
+                                        double north, bool decode) const;
+
+    // Hint that the nodes surrounding the specified (x, y) points, expressed
+    // in the same units as extentAndRes(), will be read soon. Only the blocks
+    // containing those nodes are downloaded.
+    PROJ_FOR_TEST void
+    prefetchPoints(const std::vector<std::pair<double, double>> &points) const;
+
+  protected:
+    // Hint that the specified (x, y) nodes will be read soon.
+    // y = 0 is the southern-most line.
+    virtual void
+    prefetchNodes(const std::vector<std::pair<int, int>> & /*nodes*/) const {}
+
+    // Hint that nodes of the specified window will be read soon.
+    // y = 0 is the southern-most line. Bounds are inclusive.
+    virtual void prefetchWindow(int /*xmin*/, int /*ymin*/, int /*xmax*/,
+                                int /*ymax*/, bool /*decode*/) const {}
 };
 
 // ---------------------------------------------------------------------------
@@ -87,6 +116,8 @@ class PROJ_GCC_DLL Grid {
 class PROJ_GCC_DLL VerticalShiftGrid : public Grid {
   protected:
     std::vector<std::unique_ptr<VerticalShiftGrid>> m_children{};
+    // spatial index of m_children, when there are many of them
+    std::unique_ptr<GridExtentIndex> m_childrenIndex{};
 
   public:
     PROJ_FOR_TEST VerticalShiftGrid(const std::string &nameIn, int widthIn,
@@ -96,12 +127,23 @@ class PROJ_GCC_DLL VerticalShiftGrid : public Grid {
     PROJ_FOR_TEST const VerticalShiftGrid *gridAt(double longitude,
                                                   double lat) const;
 
+    // Build the spatial index of the subgrids, once the hierarchy is complete
+    void buildIndex();
+
+    PROJ_FOR_TEST void prefetch(double west, double south, double east,
+                                double north, bool decode) const override;
+
     PROJ_FOR_TEST virtual bool isNodata(float /*val*/,
                                         double /* multiplier */) const = 0;
 
     // x = 0 is western-most column, y = 0 is southern-most line
     PROJ_FOR_TEST virtual bool valueAt(int x, int y, float &out) const = 0;
 
+    // Values of the x_count * y_count nodes starting at (x_start, y_start),
+    // line by line, from south to north
+    PROJ_FOR_TEST virtual bool valuesAt(int x_start, int y_start, int x_count,
+                                        int y_count, float *out) const;
+
     PROJ_FOR_TEST virtual void reassign_context(PJ_CONTEXT *ctx) = 0;
 };
 
@@ -115,6 +157,10 @@ class PROJ_GCC_DLL VerticalShiftGridSet {
 
     VerticalShiftGridSet();
 
+    // spatial index of m_grids, when there are many of them
+    std::unique_ptr<GridExtentIndex> m_gridsIndex{};
+    void buildIndex();
+
   public:
     PROJ_FOR_TEST virtual ~VerticalShiftGridSet();
 
@@ -130,6 +176,10 @@ class PROJ_GCC_DLL VerticalShiftGridSet {
     PROJ_FOR_TEST const VerticalShiftGrid *gridAt(double longitude,
                                                   double lat) const;
 
+    // Hint that nodes within the specified extent will be read soon
+    PROJ_FOR_TEST void prefetch(double west, double south, double east,
+                                double north, bool decode) const;
+
     PROJ_FOR_TEST virtual void reassign_context(PJ_CONTEXT *ctx);
     PROJ_FOR_TEST virtual bool reopen(PJ_CONTEXT *ctx);
 };
@@ -139,6 +189,8 @@ class PROJ_GCC_DLL VerticalShiftGridSet {
 class PROJ_GCC_DLL HorizontalShiftGrid : public Grid {
   protected:
     std::vector<std::unique_ptr<HorizontalShiftGrid>> m_children{};
+    // spatial index of m_children, when there are many of them
+    std::unique_ptr<GridExtentIndex> m_childrenIndex{};
 
   public:
     PROJ_FOR_TEST HorizontalShiftGrid(const std::string &nameIn, int widthIn,
@@ -149,12 +201,26 @@ class PROJ_GCC_DLL HorizontalShiftGrid : public Grid {
     PROJ_FOR_TEST const HorizontalShiftGrid *gridAt(double longitude,
                                                     double lat) const;
 
+    // Build the spatial index of the subgrids, once the hierarchy is complete
+    void buildIndex();
+
+    PROJ_FOR_TEST void prefetch(double west, double south, double east,
+                                double north, bool decode) const override;
+
     // x = 0 is western-most column, y = 0 is southern-most line
     PROJ_FOR_TEST virtual bool valueAt(int x, int y,
                                        bool compensateNTConvention,
                                        float &longShift,
                                        float &latShift) const = 0;
 
+    // Values of the x_count * y_count nodes starting at (x_start, y_start),
+    // line by line, from south to north
+    PROJ_FOR_TEST virtual bool valuesAt(int x_start, int y_start, int x_count,
+                                        int y_count,
+                                        bool compensateNTConvention,
+                                        float *longShift,
+                                        float *latShift) const;
+
     PROJ_FOR_TEST virtual void reassign_context(PJ_CONTEXT *ctx) = 0;
 };
 
@@ -168,6 +234,10 @@ class PROJ_GCC_DLL HorizontalShiftGridSet {
 
     HorizontalShiftGridSet();
 
+    // spatial index of m_grids, when there are many of them
+    std::unique_ptr<GridExtentIndex> m_gridsIndex{};
+    void buildIndex();
+
   public:
     PROJ_FOR_TEST virtual ~HorizontalShiftGridSet();
 
@@ -183,6 +253,10 @@ class PROJ_GCC_DLL HorizontalShiftGridSet {
     PROJ_FOR_TEST const HorizontalShiftGrid *gridAt(double longitude,
                                                     double lat) const;
 
+    // Hint that nodes within the specified extent will be read soon
+    PROJ_FOR_TEST void prefetch(double west, double south, double east,
+                                double north, bool decode) const;
+
     PROJ_FOR_TEST virtual void reassign_context(PJ_CONTEXT *ctx);
     PROJ_FOR_TEST virtual bool reopen(PJ_CONTEXT *ctx);
 };
@@ -192,6 +266,8 @@ class PROJ_GCC_DLL HorizontalShiftGridSet {
 class PROJ_GCC_DLL GenericShiftGrid : public Grid {
   protected:
     std::vector<std::unique_ptr<GenericShiftGrid>> m_children{};
+    // spatial index of m_children, when there are many of them
+    std::unique_ptr<GridExtentIndex> m_childrenIndex{};
 
   public:
     PROJ_FOR_TEST GenericShiftGrid(const std::string &nameIn, int widthIn,
@@ -201,6 +277,12 @@ class PROJ_GCC_DLL GenericShiftGrid : public Grid {
 
     PROJ_FOR_TEST const GenericShiftGrid *gridAt(double x, double y) const;
 
+    // Build the spatial index of the subgrids, once the hierarchy is complete
+    void buildIndex();
+
+    PROJ_FOR_TEST void prefetch(double west, double south, double east,
+                                double north, bool decode) const override;
+
     virtual const std::string &type() const = 0;
 
     PROJ_FOR_TEST virtual std::string unit(int sample) const = 0;
@@ -231,6 +313,10 @@ class PROJ_GCC_DLL GenericShiftGridSet {
 
     GenericShiftGridSet();
 
+    // spatial index of m_grids, when there are many of them
+    std::unique_ptr<GridExtentIndex> m_gridsIndex{};
+    void buildIndex();
+
   public:
     PROJ_FOR_TEST virtual ~GenericShiftGridSet();
 
@@ -247,6 +333,10 @@ class PROJ_GCC_DLL GenericShiftGridSet {
     PROJ_FOR_TEST const GenericShiftGrid *gridAt(const std::string &type,
                                                  double x, double y) const;
 
+    // Hint that nodes within the specified extent will be read soon
+    PROJ_FOR_TEST void prefetch(double west, double south, double east,
+                                double north, bool decode) const;
+
     PROJ_FOR_TEST virtual void reassign_context(PJ_CONTEXT *ctx);
     PROJ_FOR_TEST virtual bool reopen(PJ_CONTEXT *ctx);
 };
@@ -266,6 +356,19 @@ double pj_vgrid_value(PJ *P, const ListOfVGrids &, PJ_LP lp,
                       double vmultiplier);
 PJ_LP pj_hgrid_apply(PJ_CONTEXT *ctx, const ListOfHGrids &grids, PJ_LP lp,
                      PJ_DIRECTION direction);
+void pj_hgrid_apply_n(PJ_CONTEXT *ctx, const ListOfHGrids &grids,
+                      PJ_COORD *coo, size_t n, PJ_DIRECTION direction);
+void pj_vgrid_apply_n(PJ *P, const ListOfVGrids &grids, PJ_COORD *coo,
+                      size_t n, double vmultiplier, PJ_DIRECTION direction);
+
+// Download and decode the blocks of the geographic grids intersecting the
+// specified extent, expressed in radians.
+void pj_prepare_grids_for_area(const ListOfHGrids &grids, double west,
+                               double south, double east, double north);
+void pj_prepare_grids_for_area(const ListOfVGrids &grids, double west,
+                               double south, double east, double north);
+void pj_prepare_grids_for_area(const ListOfGenericGrids &grids, double west,
+                               double south, double east, double north);
 
 const GenericShiftGrid *pj_find_generic_grid(const ListOfGenericGrids &grids,
                                              const PJ_LP &input,
@@ -274,6 +377,8 @@ bool pj_bilinear_interpolation_three_samples(
     PJ_CONTEXT *ctx, const GenericShiftGrid *grid, const PJ_LP &lp, int idx1,
     int idx2, int idx3, double &v1, double &v2, double &v3, bool &must_retry);
 
+void pj_set_tiff_block_cache_max_size_from_ini(long long max_size);
+
 NS_PROJ_END
 
 #endif // GRIDS_HPP_INCLUDED
@@ -52,6 +52,7 @@ paralist *pj_clone_paralist(const paralist *list) {
 
         newitem->used = 0;
         newitem->next = nullptr;
+        newitem->key_hash = list->key_hash;
         strcpy(newitem->param, list->param);
 
         if (next_copy)
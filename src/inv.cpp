@@ -262,3 +262,42 @@ bool pj_inv4d(PJ_COORD &coo, PJ *P) {
     P->ctx->last_errno = last_errno;
     return true;
 }
+
+void pj_inv4d_n(PJ_COORD *coo, size_t n, PJ *P) {
+    /* Apply pj_inv4d() to n coordinates. Points that fail are set to       */
+    /* HUGE_VAL, and are skipped by the next steps of an enclosing pipeline. */
+    /* The context errno is left set if any point failed.                    */
+    if (!P->inv4d_n) {
+        for (size_t i = 0; i < n; i++) {
+            if (HUGE_VAL != coo[i].v[0])
+                pj_inv4d(coo[i], P);
+        }
+        return;
+    }
+
+    const int last_errno = P->ctx->last_errno;
+    P->ctx->last_errno = 0;
+
+    if (!P->skip_inv_prepare) {
+        for (size_t i = 0; i < n; i++) {
+            if (HUGE_VAL != coo[i].v[0])
+                inv_prepare(P, coo[i]);
+            if (HUGE_VAL == coo[i].v[0])
+                coo[i] = proj_coord_error();
+        }
+    }
+
+    P->inv4d_n(coo, n, P);
+
+    for (size_t i = 0; i < n; i++) {
+        if (HUGE_VAL == coo[i].v[0])
+            coo[i] = proj_coord_error();
+        else if (!P->skip_inv_finalize)
+            inv_finalize(P, coo[i]);
+    }
+
+    if (P->ctx->last_errno)
+        return;
+
+    P->ctx->last_errno = last_errno;
+}
@@ -279,6 +279,27 @@ PJ *pj_obj_create(PJ_CONTEXT *ctx, const BaseObjectNNPtr &objIn) {
     }
     return pj;
 }
+
+// ---------------------------------------------------------------------------
+
+/* Same as pj_obj_create(), except that the PROJ pipeline of a coordinate
+ * operation is not instantiated: the returned object only holds the
+ * ISO-19111 object, which is enough to query its metadata, and must go
+ * through pj_obj_create() before being used to transform coordinates. */
+PJ *pj_obj_create_uninstantiated(PJ_CONTEXT *ctx,
+                                 const BaseObjectNNPtr &objIn) {
+    if (!dynamic_cast<const CoordinateOperation *>(objIn.get())) {
+        return pj_obj_create(ctx, objIn);
+    }
+    auto pj = pj_new();
+    if (pj) {
+        pj->ctx = ctx;
+        pj->descr = "ISO-19111 object";
+        pj->iso_obj = objIn;
+        pj->iso_obj_is_coordinate_operation = true;
+    }
+    return pj;
+}
 //! @endcond
 
 // ---------------------------------------------------------------------------
@@ -367,6 +388,7 @@ int proj_context_set_database_path(PJ_CONTEXT *ctx, const char *dbPath,
         ctx->cpp_context = new projCppContext(
             ctx, dbPath, projCppContext::toVector(auxDbPaths));
         ctx->cpp_context->getDatabaseContext();
+        ctx->settingsChanged();
         return true;
     } catch (const std::exception &e) {
         proj_log_error(ctx, __FUNCTION__, e.what());
@@ -403,6 +425,120 @@ const char *proj_context_get_database_path(PJ_CONTEXT *ctx) {
 
 // ---------------------------------------------------------------------------
 
+/** \brief Set the number of objects of each type (CRS, datum, ellipsoid,
+ * list of operations between two CRS, etc.) built from the database that are
+ * cached by the context.
+ *
+ * This overrides the object_cache_size setting of proj.ini, whose default
+ * value is 128. The database of the context is reopened at its next use so
+ * that the new size is taken into account.
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param size Number of objects of each type. Must be strictly positive.
+ * @since 9.6
+ */
+void proj_context_set_object_cache_size(PJ_CONTEXT *ctx, int size) {
+    SANITIZE_CTX(ctx);
+    if (size <= 0) {
+        proj_context_errno_set(ctx, PROJ_ERR_OTHER_API_MISUSE);
+        proj_log_error(ctx, __FUNCTION__, "invalid cache size");
+        return;
+    }
+    // Load ini file, now so as to override its settings
+    pj_load_ini(ctx);
+    ctx->objectCacheSize = size;
+    ctx->settingsChanged();
+    if (ctx->cpp_context) {
+        ctx->cpp_context->closeDb();
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Set the number of objects built from the database that are cached
+ * for the whole process.
+ *
+ * When enabled, CRS, datums, lists of operations between two CRS and the
+ * other objects built from the database by a context are shared with the
+ * other contexts of the process using the same database files, which avoids
+ * each of them to build them again. The database files are identified by
+ * their path and their modification time, so that an updated database is not
+ * served stale objects. Contexts using a file API set with
+ * proj_context_set_fileapi() do not use this cache.
+ *
+ * The cache is common to all contexts, and its size is the largest size
+ * requested by one of them.
+ *
+ * This overrides the shared_object_cache_size setting of proj.ini.
+ * The database of the context is reopened at its next use so that the
+ * setting is taken into account.
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param size Number of objects, or 0 to disable the use of the cache by the
+ * context (default).
+ * @since 9.6
+ */
+void proj_context_set_shared_object_cache_size(PJ_CONTEXT *ctx, int size) {
+    SANITIZE_CTX(ctx);
+    // Load ini file, now so as to override its settings
+    pj_load_ini(ctx);
+    ctx->sharedObjectCacheSize = size > 0 ? size : 0;
+    ctx->settingsChanged();
+    if (ctx->cpp_context) {
+        ctx->cpp_context->closeDb();
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Set how the database is opened.
+ *
+ * Possible values are:
+ * <ul>
+ * <li>DEFAULT: regular read-only access to the files.</li>
+ * <li>IMMUTABLE: the files are assumed not to be modified while they are
+ * opened, which avoids file locking and the checks for changes made by
+ * SQLite3 before each query.</li>
+ * <li>MMAP: like IMMUTABLE, and the files are accessed through a memory
+ * mapping instead of read calls.</li>
+ * <li>MEMORY: the whole content of the main database is loaded in memory when
+ * it is first opened. Auxiliary databases are opened as with MMAP.</li>
+ * </ul>
+ *
+ * The non-default modes are mostly useful when the database is on a network
+ * file system or on a slow storage, where the many small reads done by the
+ * first queries are costly. The main database is opened once per process and
+ * open mode, and shared by all the contexts using it.
+ *
+ * This overrides the database_open_mode setting of proj.ini.
+ * The database of the context is reopened at its next use so that the
+ * setting is taken into account.
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param mode Open mode (case insensitive).
+ * @return TRUE in case of success
+ * @since 9.6
+ */
+int proj_context_set_database_open_mode(PJ_CONTEXT *ctx, const char *mode) {
+    SANITIZE_CTX(ctx);
+    DatabaseOpenMode openMode = DatabaseOpenMode::DEFAULT;
+    if (!mode || !pj_parse_database_open_mode(mode, openMode)) {
+        proj_context_errno_set(ctx, PROJ_ERR_OTHER_API_MISUSE);
+        proj_log_error(ctx, __FUNCTION__, "invalid database open mode");
+        return false;
+    }
+    // Load ini file, now so as to override its settings
+    pj_load_ini(ctx);
+    ctx->databaseOpenMode = openMode;
+    ctx->settingsChanged();
+    if (ctx->cpp_context) {
+        ctx->cpp_context->closeDb();
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
 /** \brief Return a metadata from the database.
  *
  * The returned pointer remains valid while ctx is valid, and until
@@ -521,6 +657,19 @@ static const char *getOptionValue(const char *option,
     }
     return nullptr;
 }
+
+// ---------------------------------------------------------------------------
+
+// Copy to a clone the settings of the original object that are not part of
+// its definition, so that both transform coordinates the same way.
+static void copyTransformationSettings(PJ *clone, const PJ *obj) {
+    clone->over = obj->over;
+    clone->errorIfBestTransformationNotAvailable =
+        obj->errorIfBestTransformationNotAvailable;
+    clone->warnIfBestTransformationNotAvailable =
+        obj->warnIfBestTransformationNotAvailable;
+    clone->skipNonInstantiable = obj->skipNonInstantiable;
+}
 //! @endcond
 
 // ---------------------------------------------------------------------------
@@ -549,29 +698,45 @@ PJ *proj_clone(PJ_CONTEXT *ctx, const PJ *obj) {
         return nullptr;
     }
     if (!obj->iso_obj) {
+        if (obj->createdFromCompiled) {
+            const char *const options[] = {
+                obj->over ? "FORCE_OVER=YES" : "FORCE_OVER=NO", nullptr};
+            return proj_create_from_compiled(ctx, obj->lastCompiled.c_str(),
+                                             options);
+        }
         if (!obj->alternativeCoordinateOperations.empty()) {
             auto newPj = pj_new();
             if (newPj) {
                 newPj->descr = "Set of coordinate operations";
                 newPj->ctx = ctx;
+                copyTransformationSettings(newPj, obj);
                 const int old_debug_level = ctx->debug_level;
                 ctx->debug_level = PJ_LOG_NONE;
                 for (const auto &altOp : obj->alternativeCoordinateOperations) {
                     newPj->alternativeCoordinateOperations.emplace_back(
                         PJCoordOperation(ctx, altOp));
                 }
+                newPj->alternativeCoordinateOperationsIndex =
+                    obj->alternativeCoordinateOperationsIndex;
                 ctx->debug_level = old_debug_level;
             }
             return newPj;
         }
         return nullptr;
     }
+    // So that +over is set on the steps of the clone, as on the ones of obj
+    const bool oldForceOver = ctx->forceOver;
+    ctx->forceOver = obj->over != 0;
+    PJ *newPj = nullptr;
     try {
-        return pj_obj_create(ctx, NN_NO_CHECK(obj->iso_obj));
+        newPj = pj_obj_create(ctx, NN_NO_CHECK(obj->iso_obj));
+        if (newPj)
+            copyTransformationSettings(newPj, obj);
     } catch (const std::exception &e) {
         proj_log_error(ctx, __FUNCTION__, e.what());
     }
-    return nullptr;
+    ctx->forceOver = oldForceOver;
+    return newPj;
 }
 
 // ---------------------------------------------------------------------------
@@ -8445,6 +8610,41 @@ void proj_operation_factory_context_set_allow_ballpark_transformations(
 
 // ---------------------------------------------------------------------------
 
+/** \brief Set the maximum number of threads used to evaluate the candidate
+ * operations.
+ *
+ * The searches through pivot CRS, the independent searches of CompoundCRS
+ * to CompoundCRS operations, the checks of the availability of the grids
+ * and the computation of the criteria used to sort the candidate operations
+ * are distributed between threads, taken from a pool shared by the process.
+ * The other threads use their own database context, with a clone of the
+ * PROJ context of the operation factory context, so the logging function of
+ * ctx may be called by them. The results are the same, and in the same
+ * order, whatever the number of threads.
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param factory_ctx Operation factory context. must not be NULL
+ * @param count maximum number of threads. 0 means the number of hardware
+ * threads. Default is 1.
+ * @since 9.6
+ */
+void proj_operation_factory_context_set_thread_count(
+    PJ_CONTEXT *ctx, PJ_OPERATION_FACTORY_CONTEXT *factory_ctx, int count) {
+    SANITIZE_CTX(ctx);
+    if (!factory_ctx || count < 0) {
+        proj_context_errno_set(ctx, PROJ_ERR_OTHER_API_MISUSE);
+        proj_log_error(ctx, __FUNCTION__, "missing required input");
+        return;
+    }
+    try {
+        factory_ctx->operationContext->setThreadCount(count);
+    } catch (const std::exception &e) {
+        proj_log_error(ctx, __FUNCTION__, e.what());
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 //! @cond Doxygen_Suppress
 /** \brief Opaque object representing a set of operation results. */
 struct PJ_OPERATION_LIST : PJ_OBJ_LIST {
@@ -8453,6 +8653,7 @@ struct PJ_OPERATION_LIST : PJ_OBJ_LIST {
     PJ *target_crs;
     bool hasPreparedOperation = false;
     std::vector<PJCoordOperation> preparedOperations{};
+    std::shared_ptr<const PJCoordOperationIndex> preparedOperationsIndex{};
 
     explicit PJ_OPERATION_LIST(PJ_CONTEXT *ctx, const PJ *source_crsIn,
                                const PJ *target_crsIn,
@@ -8491,8 +8692,11 @@ const std::vector<PJCoordOperation> &
 PJ_OPERATION_LIST::getPreparedOperations(PJ_CONTEXT *ctx) {
     if (!hasPreparedOperation) {
         hasPreparedOperation = true;
-        preparedOperations =
-            pj_create_prepared_operations(ctx, source_crs, target_crs, this);
+        // Only used to select an operation: no need to instantiate them
+        preparedOperations = pj_create_prepared_operations(
+            ctx, source_crs, target_crs, this, /* lazyInstantiation = */ true);
+        preparedOperationsIndex =
+            pj_create_coord_operation_index(preparedOperations);
     }
     return preparedOperations;
 }
@@ -8636,9 +8840,10 @@ int proj_get_suggested_operation(PJ_CONTEXT *ctx, PJ_OBJ_LIST *operations,
 
     int iExcluded[2] = {-1, -1};
     const auto &preparedOps = opList->getPreparedOperations(ctx);
-    int idx = pj_get_suggested_operation(ctx, preparedOps, iExcluded,
-                                         /* skipNonInstantiable= */ false,
-                                         direction, coord);
+    int idx = pj_get_suggested_operation(
+        ctx, preparedOps, opList->preparedOperationsIndex.get(),
+        /* iHint= */ -1, iExcluded,
+        /* skipNonInstantiable= */ false, direction, coord);
     if (idx >= 0) {
         idx = preparedOps[idx].idxInOriginalList;
     }
@@ -8689,6 +8894,19 @@ PJ *proj_list_get(PJ_CONTEXT *ctx, const PJ_OBJ_LIST *result, int index) {
 
 // ---------------------------------------------------------------------------
 
+//! @cond Doxygen_Suppress
+/* Same as proj_list_get(), but with pj_obj_create_uninstantiated() */
+PJ *pj_list_get_uninstantiated(PJ_CONTEXT *ctx, const PJ_OBJ_LIST *result,
+                               int index) {
+    if (!result || index < 0 || index >= proj_list_get_count(result)) {
+        return proj_list_get(ctx, result, index);
+    }
+    return pj_obj_create_uninstantiated(ctx, result->objects[index]);
+}
+//! @endcond
+
+// ---------------------------------------------------------------------------
+
 /** \brief Drops a reference on the result set.
  *
  * This method should be called one and exactly one for each function
@@ -9221,10 +9439,20 @@ PJ *proj_normalize_for_visualization(PJ_CONTEXT *ctx, const PJ *obj) {
                             std::swap(maxxDst, maxyDst);
                         }
                     }
+                    // Operations not instantiated yet (LAZY_INSTANTIATION
+                    // option) are only instantiated when first selected.
                     ctx->forceOver = alt.pj->over != 0;
                     auto pjNormalized =
-                        pj_obj_create(ctx, co->normalizeForVisualization());
+                        alt.isInstantiated
+                            ? pj_obj_create(ctx,
+                                            co->normalizeForVisualization())
+                            : pj_obj_create_uninstantiated(
+                                  ctx, co->normalizeForVisualization());
                     pjNormalized->over = alt.pj->over;
+                    pjNormalized->errorIfBestTransformationNotAvailable =
+                        alt.pj->errorIfBestTransformationNotAvailable;
+                    pjNormalized->warnIfBestTransformationNotAvailable =
+                        alt.pj->warnIfBestTransformationNotAvailable;
                     ctx->forceOver = false;
                     pjNew->alternativeCoordinateOperations.emplace_back(
                         alt.idxInOriginalList, minxSrc, minySrc, maxxSrc,
@@ -9233,8 +9461,13 @@ PJ *proj_normalize_for_visualization(PJ_CONTEXT *ctx, const PJ *obj) {
                         alt.pseudoArea, alt.areaName.c_str(),
                         alt.pjSrcGeocentricToLonLat,
                         alt.pjDstGeocentricToLonLat);
+                    pjNew->alternativeCoordinateOperations.back()
+                        .isInstantiated = alt.isInstantiated;
                 }
             }
+            pjNew->alternativeCoordinateOperationsIndex =
+                pj_create_coord_operation_index(
+                    pjNew->alternativeCoordinateOperations);
             return pjNew.release();
         } catch (const std::exception &e) {
             ctx->forceOver = false;
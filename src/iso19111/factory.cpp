@@ -237,6 +237,45 @@ static void PROJ_SQLITE_intersects_bbox(sqlite3_context *pContext,
 
 // ---------------------------------------------------------------------------
 
+// Return the name to pass to sqlite3_open_v2() or ATTACH DATABASE to open
+// path with the specified mode.
+static std::string getDatabaseURI(const std::string &path,
+                                  DatabaseOpenMode mode) {
+    if (mode == DatabaseOpenMode::DEFAULT || starts_with(path, "file:")) {
+        // Default mode, or URI set by the user, which is left untouched
+        return path;
+    }
+    std::string uri("file:");
+    for (char ch : path) {
+#ifdef _WIN32
+        if (ch == '\\') {
+            uri += '/';
+            continue;
+        }
+#endif
+        if (ch == '%' || ch == '?' || ch == '#') {
+            static const char hexDigits[] = "0123456789ABCDEF";
+            uri += '%';
+            uri += hexDigits[static_cast<unsigned char>(ch) >> 4];
+            uri += hexDigits[static_cast<unsigned char>(ch) & 0xF];
+        } else {
+            uri += ch;
+        }
+    }
+    // immutable=1 disables file locking and change detection
+    uri += "?immutable=1";
+    return uri;
+}
+
+// ---------------------------------------------------------------------------
+
+// Maximum size of the memory mapping used for the MMAP open mode. SQLite3
+// caps it to its compile-time SQLITE_MAX_MMAP_SIZE, which is 0 on platforms
+// where memory mapped I/O is not supported.
+constexpr const char *MMAP_SIZE_VALUE = "2147418112";
+
+// ---------------------------------------------------------------------------
+
 class SQLiteHandle {
     sqlite3 *sqlite_handle_ = nullptr;
     bool close_handle_ = true;
@@ -336,10 +375,11 @@ std::shared_ptr<SQLiteHandle> SQLiteHandle::open(PJ_CONTEXT *ctx,
     {
         vfsName = ctx->custom_sqlite3_vfs_name;
     }
+    const auto openMode = ctx->databaseOpenMode;
     sqlite3 *sqlite_handle = nullptr;
     // SQLITE_OPEN_FULLMUTEX as this will be used from concurrent threads
     if (sqlite3_open_v2(
-            path.c_str(), &sqlite_handle,
+            getDatabaseURI(path, openMode).c_str(), &sqlite_handle,
             SQLITE_OPEN_READONLY | SQLITE_OPEN_FULLMUTEX | SQLITE_OPEN_URI,
             vfsName.empty() ? nullptr : vfsName.c_str()) != SQLITE_OK ||
         !sqlite_handle) {
@@ -348,6 +388,44 @@ std::shared_ptr<SQLiteHandle> SQLiteHandle::open(PJ_CONTEXT *ctx,
         }
         throw FactoryException("Open of " + path + " failed");
     }
+
+    if (openMode == DatabaseOpenMode::MEMORY) {
+        // Copy the whole database into an in-memory one, and close the file
+        sqlite3 *memory_handle = nullptr;
+        if (sqlite3_open_v2(":memory:", &memory_handle,
+                            SQLITE_OPEN_READWRITE | SQLITE_OPEN_FULLMUTEX,
+                            nullptr) != SQLITE_OK ||
+            !memory_handle) {
+            if (memory_handle != nullptr) {
+                sqlite3_close(memory_handle);
+            }
+            sqlite3_close(sqlite_handle);
+            throw FactoryException("cannot create in memory database");
+        }
+        auto backup =
+            sqlite3_backup_init(memory_handle, "main", sqlite_handle, "main");
+        const bool ok = backup != nullptr &&
+                        sqlite3_backup_step(backup, -1) == SQLITE_DONE;
+        if (backup) {
+            sqlite3_backup_finish(backup);
+        }
+        sqlite3_close(sqlite_handle);
+        if (!ok) {
+            sqlite3_close(memory_handle);
+            throw FactoryException("Loading of " + path +
+                                   " in memory failed");
+        }
+        sqlite_handle = memory_handle;
+#ifdef ENABLE_CUSTOM_LOCKLESS_VFS
+        vfs.reset();
+#endif
+    } else if (openMode == DatabaseOpenMode::MMAP) {
+        sqlite3_exec(sqlite_handle,
+                     (std::string("PRAGMA mmap_size = ") + MMAP_SIZE_VALUE)
+                         .c_str(),
+                     nullptr, nullptr, nullptr);
+    }
+
     auto handle =
         std::shared_ptr<SQLiteHandle>(new SQLiteHandle(sqlite_handle, true));
 #ifdef ENABLE_CUSTOM_LOCKLESS_VFS
@@ -646,6 +724,8 @@ SQLiteHandleCache::getHandle(const std::string &path, PJ_CONTEXT *ctx) {
 
     std::shared_ptr<SQLiteHandle> handle;
     std::string key = path + ctx->custom_sqlite3_vfs_name;
+    key += '|';
+    key += toString(static_cast<int>(ctx->databaseOpenMode));
     if (!cache_.tryGet(key, handle)) {
         handle = SQLiteHandle::open(ctx, path);
         cache_.insert(key, handle);
@@ -668,6 +748,98 @@ void SQLiteHandleCache::invalidateHandles() {
 
 // ---------------------------------------------------------------------------
 
+// Process-wide cache of the objects built from the database, shared by the
+// database contexts opened on the same files. Those objects are immutable,
+// so they can be used concurrently by several threads.
+class SharedObjectCache {
+    std::mutex sMutex_{};
+
+    // Keys are prefixed with DatabaseContext::Private::sharedCacheKey_
+    lru11::Cache<std::string, util::BaseObjectPtr> cacheObjects_{0};
+    lru11::Cache<std::string, std::vector<operation::CoordinateOperationNNPtr>>
+        cacheCRSToCrsCoordOp_{0};
+
+  public:
+    static SharedObjectCache &get();
+
+    void reserve(size_t maxSize);
+
+    bool tryGet(const std::string &key, util::BaseObjectPtr &obj);
+    void insert(const std::string &key, const util::BaseObjectPtr &obj);
+
+    bool tryGet(const std::string &key,
+                std::vector<operation::CoordinateOperationNNPtr> &list);
+    void insert(const std::string &key,
+                const std::vector<operation::CoordinateOperationNNPtr> &list);
+
+    void clear();
+};
+
+// ---------------------------------------------------------------------------
+
+SharedObjectCache &SharedObjectCache::get() {
+    // Global cache
+    static SharedObjectCache gSharedObjectCache;
+    return gSharedObjectCache;
+}
+
+// ---------------------------------------------------------------------------
+
+/** Make sure the cache can hold at least maxSize objects. */
+void SharedObjectCache::reserve(size_t maxSize) {
+    std::lock_guard<std::mutex> lock(sMutex_);
+    // A maximum size of 0 means unbounded for lru11::Cache
+    if (cacheObjects_.getMaxSize() == 0 ||
+        maxSize > cacheObjects_.getMaxSize()) {
+        cacheObjects_.setMaxSize(maxSize);
+        cacheCRSToCrsCoordOp_.setMaxSize(maxSize);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+bool SharedObjectCache::tryGet(const std::string &key,
+                               util::BaseObjectPtr &obj) {
+    std::lock_guard<std::mutex> lock(sMutex_);
+    return cacheObjects_.tryGet(key, obj);
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedObjectCache::insert(const std::string &key,
+                               const util::BaseObjectPtr &obj) {
+    std::lock_guard<std::mutex> lock(sMutex_);
+    cacheObjects_.insert(key, obj);
+}
+
+// ---------------------------------------------------------------------------
+
+bool SharedObjectCache::tryGet(
+    const std::string &key,
+    std::vector<operation::CoordinateOperationNNPtr> &list) {
+    std::lock_guard<std::mutex> lock(sMutex_);
+    return cacheCRSToCrsCoordOp_.tryGet(key, list);
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedObjectCache::insert(
+    const std::string &key,
+    const std::vector<operation::CoordinateOperationNNPtr> &list) {
+    std::lock_guard<std::mutex> lock(sMutex_);
+    cacheCRSToCrsCoordOp_.insert(key, list);
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedObjectCache::clear() {
+    std::lock_guard<std::mutex> lock(sMutex_);
+    cacheObjects_.clear();
+    cacheCRSToCrsCoordOp_.clear();
+}
+
+// ---------------------------------------------------------------------------
+
 struct DatabaseContext::Private {
     Private();
     ~Private();
@@ -692,6 +864,8 @@ struct DatabaseContext::Private {
     void attachExtraDatabases(
         const std::vector<std::string> &auxiliaryDatabasePaths);
 
+    void initSharedCache();
+
     // Mechanism to detect recursion in calls from
     // AuthorityFactory::createXXX() -> createFromUserInput() ->
     // AuthorityFactory::createXXX()
@@ -763,13 +937,17 @@ struct DatabaseContext::Private {
     // cppcheck-suppress functionStatic
     void cache(const std::string &code, const metadata::ExtentNNPtr &extent);
 
+    // shareable must be false if the list depends on the grids available
+    // to the context.
     // cppcheck-suppress functionStatic
     bool getCRSToCRSCoordOpFromCache(
         const std::string &code,
-        std::vector<operation::CoordinateOperationNNPtr> &list);
+        std::vector<operation::CoordinateOperationNNPtr> &list,
+        bool shareable);
     // cppcheck-suppress functionStatic
     void cache(const std::string &code,
-               const std::vector<operation::CoordinateOperationNNPtr> &list);
+               const std::vector<operation::CoordinateOperationNNPtr> &list,
+               bool shareable);
 
     struct GridInfoCache {
         std::string fullFilename{};
@@ -817,6 +995,7 @@ struct DatabaseContext::Private {
 
     using LRUCacheOfObjects = lru11::Cache<std::string, util::BaseObjectPtr>;
 
+    // Default size, overridden by pj_ctx::objectCacheSize
     static constexpr size_t CACHE_SIZE = 128;
     LRUCacheOfObjects cacheUOM_{CACHE_SIZE};
     LRUCacheOfObjects cacheCRS_{CACHE_SIZE};
@@ -837,12 +1016,19 @@ struct DatabaseContext::Private {
 
     std::vector<VersionedAuthName> cacheAuthNameWithVersion_{};
 
-    static void insertIntoCache(LRUCacheOfObjects &cache,
-                                const std::string &code,
-                                const util::BaseObjectPtr &obj);
+    // Identifies the database files in SharedObjectCache. Empty if the shared
+    // cache is not used.
+    std::string sharedCacheKey_{};
+
+    std::string sharedCacheKey(const char *cacheName,
+                               const std::string &code) const;
 
-    static void getFromCache(LRUCacheOfObjects &cache, const std::string &code,
-                             util::BaseObjectPtr &obj);
+    void insertIntoCache(LRUCacheOfObjects &cache, const char *cacheName,
+                         const std::string &code,
+                         const util::BaseObjectPtr &obj);
+
+    void getFromCache(LRUCacheOfObjects &cache, const char *cacheName,
+                      const std::string &code, util::BaseObjectPtr &obj);
 
     void closeDB() noexcept;
 
@@ -1018,41 +1204,91 @@ const std::shared_ptr<SQLiteHandle> &DatabaseContext::Private::handle() {
 
 // ---------------------------------------------------------------------------
 
+/** Return the key of an object in SharedObjectCache, or an empty string if
+ * it must not be shared. */
+std::string
+DatabaseContext::Private::sharedCacheKey(const char *cacheName,
+                                         const std::string &code) const {
+    // Objects built during an insertion session may come from the temporary
+    // database
+    if (sharedCacheKey_.empty() || memoryDbHandle_) {
+        return std::string();
+    }
+    std::string key(sharedCacheKey_);
+    key += cacheName;
+    key += ':';
+    key += code;
+    return key;
+}
+
+// ---------------------------------------------------------------------------
+
 void DatabaseContext::Private::insertIntoCache(LRUCacheOfObjects &cache,
+                                               const char *cacheName,
                                                const std::string &code,
                                                const util::BaseObjectPtr &obj) {
     cache.insert(code, obj);
+    const auto key = sharedCacheKey(cacheName, code);
+    if (!key.empty()) {
+        SharedObjectCache::get().insert(key, obj);
+    }
 }
 
 // ---------------------------------------------------------------------------
 
 void DatabaseContext::Private::getFromCache(LRUCacheOfObjects &cache,
+                                            const char *cacheName,
                                             const std::string &code,
                                             util::BaseObjectPtr &obj) {
-    cache.tryGet(code, obj);
+    if (cache.tryGet(code, obj)) {
+        return;
+    }
+    const auto key = sharedCacheKey(cacheName, code);
+    if (!key.empty() && SharedObjectCache::get().tryGet(key, obj)) {
+        cache.insert(code, obj);
+    }
 }
 
 // ---------------------------------------------------------------------------
 
 bool DatabaseContext::Private::getCRSToCRSCoordOpFromCache(
     const std::string &code,
-    std::vector<operation::CoordinateOperationNNPtr> &list) {
-    return cacheCRSToCrsCoordOp_.tryGet(code, list);
+    std::vector<operation::CoordinateOperationNNPtr> &list, bool shareable) {
+    if (cacheCRSToCrsCoordOp_.tryGet(code, list)) {
+        return true;
+    }
+    if (!shareable) {
+        return false;
+    }
+    const auto key = sharedCacheKey("coordop", code);
+    if (!key.empty() && SharedObjectCache::get().tryGet(key, list)) {
+        cacheCRSToCrsCoordOp_.insert(code, list);
+        return true;
+    }
+    return false;
 }
 
 // ---------------------------------------------------------------------------
 
 void DatabaseContext::Private::cache(
     const std::string &code,
-    const std::vector<operation::CoordinateOperationNNPtr> &list) {
+    const std::vector<operation::CoordinateOperationNNPtr> &list,
+    bool shareable) {
     cacheCRSToCrsCoordOp_.insert(code, list);
+    if (!shareable) {
+        return;
+    }
+    const auto key = sharedCacheKey("coordop", code);
+    if (!key.empty()) {
+        SharedObjectCache::get().insert(key, list);
+    }
 }
 
 // ---------------------------------------------------------------------------
 
 crs::CRSPtr DatabaseContext::Private::getCRSFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheCRS_, code, obj);
+    getFromCache(cacheCRS_, "crs", code, obj);
     return std::static_pointer_cast<crs::CRS>(obj);
 }
 
@@ -1060,7 +1296,7 @@ crs::CRSPtr DatabaseContext::Private::getCRSFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const crs::CRSNNPtr &crs) {
-    insertIntoCache(cacheCRS_, code, crs.as_nullable());
+    insertIntoCache(cacheCRS_, "crs", code, crs.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1068,7 +1304,7 @@ void DatabaseContext::Private::cache(const std::string &code,
 common::UnitOfMeasurePtr
 DatabaseContext::Private::getUOMFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheUOM_, code, obj);
+    getFromCache(cacheUOM_, "uom", code, obj);
     return std::static_pointer_cast<common::UnitOfMeasure>(obj);
 }
 
@@ -1076,7 +1312,7 @@ DatabaseContext::Private::getUOMFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const common::UnitOfMeasureNNPtr &uom) {
-    insertIntoCache(cacheUOM_, code, uom.as_nullable());
+    insertIntoCache(cacheUOM_, "uom", code, uom.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1084,7 +1320,7 @@ void DatabaseContext::Private::cache(const std::string &code,
 datum::GeodeticReferenceFramePtr
 DatabaseContext::Private::getGeodeticDatumFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheGeodeticDatum_, code, obj);
+    getFromCache(cacheGeodeticDatum_, "datum", code, obj);
     return std::static_pointer_cast<datum::GeodeticReferenceFrame>(obj);
 }
 
@@ -1092,7 +1328,7 @@ DatabaseContext::Private::getGeodeticDatumFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(
     const std::string &code, const datum::GeodeticReferenceFrameNNPtr &datum) {
-    insertIntoCache(cacheGeodeticDatum_, code, datum.as_nullable());
+    insertIntoCache(cacheGeodeticDatum_, "datum", code, datum.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1100,7 +1336,7 @@ void DatabaseContext::Private::cache(
 datum::DatumEnsemblePtr
 DatabaseContext::Private::getDatumEnsembleFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheDatumEnsemble_, code, obj);
+    getFromCache(cacheDatumEnsemble_, "ensemble", code, obj);
     return std::static_pointer_cast<datum::DatumEnsemble>(obj);
 }
 
@@ -1108,7 +1344,8 @@ DatabaseContext::Private::getDatumEnsembleFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(
     const std::string &code, const datum::DatumEnsembleNNPtr &datumEnsemble) {
-    insertIntoCache(cacheDatumEnsemble_, code, datumEnsemble.as_nullable());
+    insertIntoCache(cacheDatumEnsemble_, "ensemble", code,
+                    datumEnsemble.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1116,7 +1353,7 @@ void DatabaseContext::Private::cache(
 datum::EllipsoidPtr
 DatabaseContext::Private::getEllipsoidFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheEllipsoid_, code, obj);
+    getFromCache(cacheEllipsoid_, "ellipsoid", code, obj);
     return std::static_pointer_cast<datum::Ellipsoid>(obj);
 }
 
@@ -1124,7 +1361,7 @@ DatabaseContext::Private::getEllipsoidFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const datum::EllipsoidNNPtr &ellps) {
-    insertIntoCache(cacheEllipsoid_, code, ellps.as_nullable());
+    insertIntoCache(cacheEllipsoid_, "ellipsoid", code, ellps.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1132,7 +1369,7 @@ void DatabaseContext::Private::cache(const std::string &code,
 datum::PrimeMeridianPtr
 DatabaseContext::Private::getPrimeMeridianFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cachePrimeMeridian_, code, obj);
+    getFromCache(cachePrimeMeridian_, "pm", code, obj);
     return std::static_pointer_cast<datum::PrimeMeridian>(obj);
 }
 
@@ -1140,7 +1377,7 @@ DatabaseContext::Private::getPrimeMeridianFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const datum::PrimeMeridianNNPtr &pm) {
-    insertIntoCache(cachePrimeMeridian_, code, pm.as_nullable());
+    insertIntoCache(cachePrimeMeridian_, "pm", code, pm.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1148,7 +1385,7 @@ void DatabaseContext::Private::cache(const std::string &code,
 cs::CoordinateSystemPtr DatabaseContext::Private::getCoordinateSystemFromCache(
     const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheCS_, code, obj);
+    getFromCache(cacheCS_, "cs", code, obj);
     return std::static_pointer_cast<cs::CoordinateSystem>(obj);
 }
 
@@ -1156,7 +1393,7 @@ cs::CoordinateSystemPtr DatabaseContext::Private::getCoordinateSystemFromCache(
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const cs::CoordinateSystemNNPtr &cs) {
-    insertIntoCache(cacheCS_, code, cs.as_nullable());
+    insertIntoCache(cacheCS_, "cs", code, cs.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1164,7 +1401,7 @@ void DatabaseContext::Private::cache(const std::string &code,
 metadata::ExtentPtr
 DatabaseContext::Private::getExtentFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheExtent_, code, obj);
+    getFromCache(cacheExtent_, "extent", code, obj);
     return std::static_pointer_cast<metadata::Extent>(obj);
 }
 
@@ -1172,7 +1409,7 @@ DatabaseContext::Private::getExtentFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const metadata::ExtentNNPtr &extent) {
-    insertIntoCache(cacheExtent_, code, extent.as_nullable());
+    insertIntoCache(cacheExtent_, "extent", code, extent.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1212,6 +1449,51 @@ void DatabaseContext::Private::open(const std::string &databasePath,
     sqlite_handle_ = SQLiteHandleCache::get().getHandle(path, ctx);
 
     databasePath_ = std::move(path);
+
+    pj_load_ini(ctx);
+    const auto cacheSize = static_cast<size_t>(ctx->objectCacheSize);
+    for (auto *cache : {&cacheUOM_, &cacheCRS_, &cacheEllipsoid_,
+                        &cacheGeodeticDatum_, &cacheDatumEnsemble_,
+                        &cachePrimeMeridian_, &cacheCS_, &cacheExtent_}) {
+        cache->setMaxSize(cacheSize);
+    }
+    cacheCRSToCrsCoordOp_.setMaxSize(cacheSize);
+    cacheGridInfo_.setMaxSize(cacheSize);
+    cacheAliasNames_.setMaxSize(cacheSize);
+}
+
+// ---------------------------------------------------------------------------
+
+/** Enable the use of SharedObjectCache if requested by the context, and if the
+ * version of all the database files can be determined. */
+void DatabaseContext::Private::initSharedCache() {
+    sharedCacheKey_.clear();
+    if (pjCtxt_->sharedObjectCacheSize <= 0) {
+        return;
+    }
+
+    std::string key;
+    std::vector<std::string> paths{databasePath_};
+    paths.insert(paths.end(), auxiliaryDatabasePaths_.begin(),
+                 auxiliaryDatabasePaths_.end());
+    for (const auto &path : paths) {
+        auto file =
+            FileManager::open(pjCtxt_, path.c_str(), FileAccess::READ_ONLY);
+        const std::string version(file ? file->versionKey() : std::string());
+        if (version.empty()) {
+            return;
+        }
+        key += path;
+        key += '@';
+        key += version;
+        key += '|';
+    }
+    key += pjCtxt_->custom_sqlite3_vfs_name;
+    key += '|';
+
+    SharedObjectCache::get().reserve(
+        static_cast<size_t>(pjCtxt_->sharedObjectCacheSize));
+    sharedCacheKey_ = std::move(key);
 }
 
 // ---------------------------------------------------------------------------
@@ -1294,15 +1576,26 @@ void DatabaseContext::Private::attachExtraDatabases(
         sqlite_handle, true, nLayoutVersionMajor, nLayoutVersionMinor);
     l_handle = sqlite_handle_;
 
-    run("ATTACH DATABASE ? AS db_0", {databasePath_});
+    // The in-memory copy of the MEMORY mode is not shared with attached
+    // databases, which are accessed through a memory mapping instead.
+    const auto openMode = pjCtxt()->databaseOpenMode;
+    const auto attach = [this, openMode](const std::string &dbPath,
+                                         const std::string &dbName) {
+        run("ATTACH DATABASE ? AS " + dbName,
+            {getDatabaseURI(dbPath, openMode)});
+        if (openMode == DatabaseOpenMode::MMAP ||
+            openMode == DatabaseOpenMode::MEMORY) {
+            run("PRAGMA " + dbName + ".mmap_size = " + MMAP_SIZE_VALUE);
+        }
+    };
+
+    attach(databasePath_, "db_0");
     detach_ = true;
     int count = 1;
     for (const auto &otherDbPath : auxiliaryDatabasePaths) {
         const auto attachedDbName("db_" + toString(static_cast<int>(count)));
-        std::string sql = "ATTACH DATABASE ? AS ";
-        sql += attachedDbName;
         count++;
-        run(sql, {otherDbPath});
+        attach(otherDbPath, attachedDbName);
 
         l_handle->checkDatabaseLayout(databasePath_, otherDbPath,
                                       attachedDbName + '.');
@@ -2930,6 +3223,7 @@ DatabaseContext::create(const std::string &databasePath,
         dbCtxPrivate->attachExtraDatabases(auxDbs);
         dbCtxPrivate->auxiliaryDatabasePaths_ = std::move(auxDbs);
     }
+    dbCtxPrivate->initSharedCache();
     dbCtxPrivate->self_ = dbCtx.as_nullable();
     return dbCtx;
 }
@@ -3274,6 +3568,29 @@ void *DatabaseContext::getSqliteHandle() const { return d->handle()->handle(); }
 
 // ---------------------------------------------------------------------------
 
+PJ_CONTEXT *DatabaseContext::getPROJContext() const { return d->pjCtxt(); }
+
+// ---------------------------------------------------------------------------
+
+/** Return a new database context on the same database files, using ctx, so
+ * that both can be used by different threads. Return null if that is not
+ * possible, that is if this context was created from a SQLite handle or if an
+ * insertion session is in progress. */
+DatabaseContextPtr DatabaseContext::duplicate(PJ_CONTEXT *ctx) const {
+    if (d->getPath().empty() || inInsertStatementsSession()) {
+        return nullptr;
+    }
+    return create(d->getPath(), d->auxiliaryDatabasePaths_, ctx).as_nullable();
+}
+
+// ---------------------------------------------------------------------------
+
+bool DatabaseContext::inInsertStatementsSession() const {
+    return d->memoryDbHandle_ != nullptr;
+}
+
+// ---------------------------------------------------------------------------
+
 bool DatabaseContext::lookForGridAlternative(const std::string &officialName,
                                              std::string &projFilename,
                                              std::string &projFormat,
@@ -6807,8 +7124,12 @@ AuthorityFactory::createFromCoordinateReferenceSystemCodes(
     }
 
     std::vector<operation::CoordinateOperationNNPtr> list;
+    // When missing grids are discarded, the result depends on the grids
+    // available to this context, and must not be shared with other ones.
+    const bool shareable = !discardIfMissingGrid;
 
-    if (d->context()->d->getCRSToCRSCoordOpFromCache(cacheKey, list)) {
+    if (d->context()->d->getCRSToCRSCoordOpFromCache(cacheKey, list,
+                                                     shareable)) {
         return list;
     }
 
@@ -6850,7 +7171,7 @@ AuthorityFactory::createFromCoordinateReferenceSystemCodes(
                 }
                 if (ok) {
                     list.emplace_back(conv);
-                    d->context()->d->cache(cacheKey, list);
+                    d->context()->d->cache(cacheKey, list, shareable);
                     return list;
                 }
             }
@@ -7104,7 +7425,7 @@ AuthorityFactory::createFromCoordinateReferenceSystemCodes(
             }
         }
     }
-    d->context()->d->cache(cacheKey, list);
+    d->context()->d->cache(cacheKey, list, shareable);
     return list;
 }
 
@@ -10049,4 +10370,7 @@ NS_PROJ_END
 
 // ---------------------------------------------------------------------------
 
-void pj_clear_sqlite_cache() { NS_PROJ::io::SQLiteHandleCache::get().clear(); }
+void pj_clear_sqlite_cache() {
+    NS_PROJ::io::SQLiteHandleCache::get().clear();
+    NS_PROJ::io::SharedObjectCache::get().clear();
+}
@@ -55,12 +55,19 @@
 #include "proj_constants.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 // #define TRACE_CREATE_OPERATIONS
@@ -163,6 +170,36 @@ static double getPseudoArea(const metadata::ExtentPtr &extent) {
 // ---------------------------------------------------------------------------
 
 //! @cond Doxygen_Suppress
+
+// Resources of a thread evaluating candidate operations on behalf of a
+// CoordinateOperationContext. A database context cannot be used by several
+// threads, so each thread has its own one, on the same database files, with a
+// clone of the PROJ context of the database context of the caller.
+struct OperationWorker {
+    PJ_CONTEXT *pjCtxt = nullptr;
+    io::AuthorityFactoryPtr authorityFactory{};
+
+    OperationWorker() = default;
+    OperationWorker(const OperationWorker &) = delete;
+    OperationWorker &operator=(const OperationWorker &) = delete;
+
+    ~OperationWorker() {
+        // The database context must be released before its PROJ context
+        authorityFactory.reset();
+        if (pjCtxt) {
+            proj_context_destroy(pjCtxt);
+        }
+    }
+};
+
+struct OperationWorkers {
+    std::vector<std::unique_ptr<OperationWorker>> workers{};
+    // pj_ctx::settingsGeneration of the PROJ context of the caller when the
+    // workers were created.
+    unsigned long long ctxGeneration = 0;
+    bool inUse = false;
+};
+
 struct CoordinateOperationContext::Private {
     io::AuthorityFactoryPtr authorityFactory_{};
     metadata::ExtentPtr extent_{};
@@ -180,6 +217,10 @@ struct CoordinateOperationContext::Private {
         intermediateCRSAuthCodes_{};
     bool discardSuperseded_ = true;
     bool allowBallpark_ = true;
+    int threadCount_ = 1;
+    // Not shared with clones of the context, which may be used by other
+    // threads.
+    std::shared_ptr<OperationWorkers> workers_{};
     std::shared_ptr<util::optional<common::DataEpoch>> sourceCoordinateEpoch_{
         std::make_shared<util::optional<common::DataEpoch>>()};
     std::shared_ptr<util::optional<common::DataEpoch>> targetCoordinateEpoch_{
@@ -205,7 +246,9 @@ CoordinateOperationContext::CoordinateOperationContext()
 
 CoordinateOperationContext::CoordinateOperationContext(
     const CoordinateOperationContext &other)
-    : d(internal::make_unique<Private>(*(other.d))) {}
+    : d(internal::make_unique<Private>(*(other.d))) {
+    d->workers_.reset();
+}
 
 // ---------------------------------------------------------------------------
 
@@ -370,6 +413,54 @@ void CoordinateOperationContext::setDiscardSuperseded(bool discard) {
 
 // ---------------------------------------------------------------------------
 
+/** \brief Set the maximum number of threads used to evaluate the candidate
+ * operations.
+ *
+ * The following steps are distributed between several threads:
+ * <ul>
+ * <li>the searches through the candidate pivot CRS of the source and
+ * target datums, which are evaluated speculatively by groups of as many
+ * pairs of candidates as threads, and merged in the order of the
+ * candidates.</li>
+ * <li>the independent searches between a CompoundCRS and intermediate
+ * geographic or hub CRS.</li>
+ * <li>the checks of the availability of the grids needed by the candidate
+ * operations, and the computation of the criteria used to sort them.</li>
+ * </ul>
+ *
+ * As a database context cannot be used by several threads, the other threads
+ * use their own database context on the same database files, with a clone of
+ * the PROJ context of the authority factory. Those are kept with this
+ * coordinate operation context for its next uses. When the database context
+ * has been created from a SQLite handle, or is in an insertion session, only
+ * the computation of the sorting criteria uses several threads. The threads
+ * are taken from a pool shared by the whole process.
+ *
+ * The results are the same, and in the same order, as with a single thread.
+ *
+ * The default is 1. A value of 0 means the number of hardware threads.
+ *
+ * @since 9.6
+ */
+void CoordinateOperationContext::setThreadCount(int count) {
+    d->threadCount_ = std::max(count, 0);
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Return the maximum number of threads used to evaluate the
+ * candidate operations.
+ *
+ * The default is 1. A value of 0 means the number of hardware threads.
+ *
+ * @since 9.6
+ */
+int CoordinateOperationContext::getThreadCount() const {
+    return d->threadCount_;
+}
+
+// ---------------------------------------------------------------------------
+
 /** \brief Set how grid availability is used.
  *
  * The default is USE_FOR_SORTING.
@@ -543,6 +634,84 @@ CoordinateOperationContextNNPtr CoordinateOperationContext::clone() const {
 
 // ---------------------------------------------------------------------------
 
+//! @cond Doxygen_Suppress
+
+// Return up to count contexts with the same settings as this one, that can be
+// used by other threads than the one using this context until
+// releaseWorkerContexts() is called. An empty list is returned if another
+// thread cannot use the database context of the authority factory, or if the
+// contexts are already in use by an enclosing parallel section.
+std::vector<CoordinateOperationContextNNPtr>
+CoordinateOperationContext::acquireWorkerContexts(size_t count) const {
+    std::vector<CoordinateOperationContextNNPtr> res;
+    if (!d->workers_) {
+        d->workers_ = std::make_shared<OperationWorkers>();
+    }
+    auto &workers = *(d->workers_);
+    if (workers.inUse) {
+        return res;
+    }
+
+    const auto &authFactory = d->authorityFactory_;
+    if (authFactory) {
+        const auto &dbContext = authFactory->databaseContext();
+        if (dbContext->inInsertStatementsSession()) {
+            return res;
+        }
+        auto pjCtxt = dbContext->getPROJContext();
+        if (workers.ctxGeneration != pjCtxt->settingsGeneration) {
+            workers.workers.clear();
+            workers.ctxGeneration = pjCtxt->settingsGeneration;
+        }
+        while (workers.workers.size() < count) {
+            auto worker = internal::make_unique<OperationWorker>();
+            worker->pjCtxt = proj_context_clone(pjCtxt);
+            if (!worker->pjCtxt) {
+                break;
+            }
+            try {
+                auto workerDbContext = dbContext->duplicate(worker->pjCtxt);
+                if (!workerDbContext) {
+                    break;
+                }
+                worker->authorityFactory =
+                    io::AuthorityFactory::create(NN_NO_CHECK(workerDbContext),
+                                                 authFactory->getAuthority())
+                        .as_nullable();
+            } catch (const std::exception &) {
+                break;
+            }
+            workers.workers.emplace_back(std::move(worker));
+        }
+    } else {
+        while (workers.workers.size() < count) {
+            workers.workers.emplace_back(
+                internal::make_unique<OperationWorker>());
+        }
+    }
+
+    for (size_t i = 0; i < count && i < workers.workers.size(); ++i) {
+        auto ctxt = clone();
+        ctxt->d->authorityFactory_ = workers.workers[i]->authorityFactory;
+        ctxt->d->threadCount_ = 1;
+        res.emplace_back(std::move(ctxt));
+    }
+    workers.inUse = !res.empty();
+    return res;
+}
+
+// ---------------------------------------------------------------------------
+
+void CoordinateOperationContext::releaseWorkerContexts() const {
+    if (d->workers_) {
+        d->workers_->inUse = false;
+    }
+}
+
+//! @endcond
+
+// ---------------------------------------------------------------------------
+
 //! @cond Doxygen_Suppress
 struct CoordinateOperationFactory::Private {
 
@@ -577,8 +746,27 @@ struct CoordinateOperationFactory::Private {
                 const metadata::ExtentPtr &extent2In,
                 const CoordinateOperationContextNNPtr &contextIn)
             : extent1(extent1In), extent2(extent2In), context(contextIn) {}
+
+        // Copy of the state of other, to be used by another thread with
+        // contextIn.
+        Context(const Context &other,
+                const CoordinateOperationContextNNPtr &contextIn)
+            : extent1(other.extent1), extent2(other.extent2),
+              context(contextIn),
+              inCreateOperationsWithDatumPivotAntiRecursion(
+                  other.inCreateOperationsWithDatumPivotAntiRecursion),
+              inCreateOperationsGeogToVertWithAlternativeGeog(
+                  other.inCreateOperationsGeogToVertWithAlternativeGeog),
+              inCreateOperationsGeogToVertWithIntermediateVert(
+                  other.inCreateOperationsGeogToVertWithIntermediateVert),
+              skipHorizontalTransformation(other.skipHorizontalTransformation),
+              nRecLevelCreateOperations(other.nRecLevelCreateOperations),
+              cacheNameToCRS(other.cacheNameToCRS),
+              geogCRSOfVertCRSStack(other.geogCRSOfVertCRSStack) {}
     };
 
+    class ThreadContexts;
+
     static std::vector<CoordinateOperationNNPtr>
     createOperations(const crs::CRSNNPtr &sourceCRS,
                      const util::optional<common::DataEpoch> &sourceEpoch,
@@ -589,6 +777,17 @@ struct CoordinateOperationFactory::Private {
   private:
     static constexpr bool disallowEmptyIntersection = true;
 
+    struct OperationRequest {
+        const crs::CRSNNPtr &sourceCRS;
+        const util::optional<common::DataEpoch> &sourceEpoch;
+        const crs::CRSNNPtr &targetCRS;
+        const util::optional<common::DataEpoch> &targetEpoch;
+    };
+
+    static std::vector<std::vector<CoordinateOperationNNPtr>>
+    createOperationsConcurrently(const std::vector<OperationRequest> &requests,
+                                 Context &context);
+
     static void
     buildCRSIds(const crs::CRSNNPtr &crs, Private::Context &context,
                 std::list<std::pair<std::string, std::string>> &ids);
@@ -1126,6 +1325,232 @@ static bool isNullTransformation(const std::string &name) {
 
 // ---------------------------------------------------------------------------
 
+// Process-wide pool of the threads used by runTasks(), so that they are not
+// created again by each request.
+class TaskThreadPool {
+  public:
+    static TaskThreadPool &get() {
+        static TaskThreadPool pool;
+        return pool;
+    }
+
+    // Queue a job, after having created threads so that there are at least
+    // nThreads of them. Return false if there is no thread to run it.
+    bool submit(std::function<void()> &&job, size_t nThreads) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            while (threads_.size() < nThreads) {
+                try {
+                    threads_.emplace_back([this]() { loop(); });
+                } catch (const std::exception &) {
+                    break;
+                }
+            }
+            if (threads_.empty()) {
+                return false;
+            }
+            jobs_.emplace_back(std::move(job));
+        }
+        cv_.notify_one();
+        return true;
+    }
+
+    ~TaskThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto &thread : threads_) {
+            thread.join();
+        }
+    }
+
+  private:
+    std::mutex mutex_{};
+    std::condition_variable cv_{};
+    std::deque<std::function<void()>> jobs_{};
+    std::vector<std::thread> threads_{};
+    bool stop_ = false;
+
+    TaskThreadPool() = default;
+
+    void loop() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+                if (jobs_.empty()) {
+                    return;
+                }
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            job();
+        }
+    }
+};
+
+// ---------------------------------------------------------------------------
+
+// Return the number of threads to use for count tasks, each thread running at
+// least minTasksPerThread of them.
+static size_t getThreadCount(const CoordinateOperationContextNNPtr &context,
+                             size_t count, size_t minTasksPerThread) {
+    const int threadCount = context->getThreadCount();
+    const size_t nThreads =
+        threadCount > 0 ? static_cast<size_t>(threadCount)
+                        : std::max(1U, std::thread::hardware_concurrency());
+    return std::max<size_t>(1,
+                            std::min(nThreads, count / minTasksPerThread));
+}
+
+// ---------------------------------------------------------------------------
+
+// Run task(slot, i) for i in [0, count), using up to nThreads threads,
+// including the calling one whose slot is 0, the other ones being numbered
+// from 1 to nThreads - 1. Exceptions thrown by a task are rethrown in the
+// calling thread.
+static void runTasks(size_t count, size_t nThreads,
+                     const std::function<void(size_t, size_t)> &task) {
+    nThreads = std::min(nThreads, count);
+    if (nThreads <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            task(0, i);
+        }
+        return;
+    }
+
+    struct Batch {
+        std::mutex mutex{};
+        std::condition_variable cv{};
+        std::atomic<size_t> nextTask{0};
+        std::exception_ptr exception{};
+        size_t nextSlot = 1;
+        size_t running = 0;
+        bool closed = false;
+    };
+    auto batch = std::make_shared<Batch>();
+
+    const auto runFrom = [count, &task](Batch &b, size_t slot) {
+        try {
+            for (size_t i = b.nextTask++; i < count; i = b.nextTask++) {
+                task(slot, i);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(b.mutex);
+            if (!b.exception) {
+                b.exception = std::current_exception();
+            }
+            b.nextTask = count;
+        }
+    };
+
+    auto &pool = TaskThreadPool::get();
+    for (size_t i = 1; i < nThreads; ++i) {
+        // A job starting after the calling thread is done returns without
+        // using runFrom, which is then out of scope.
+        const bool submitted = pool.submit(
+            [batch, &runFrom]() {
+                size_t slot;
+                {
+                    std::lock_guard<std::mutex> lock(batch->mutex);
+                    if (batch->closed) {
+                        return;
+                    }
+                    slot = batch->nextSlot++;
+                    ++batch->running;
+                }
+                runFrom(*batch, slot);
+                {
+                    std::lock_guard<std::mutex> lock(batch->mutex);
+                    --batch->running;
+                }
+                batch->cv.notify_all();
+            },
+            nThreads - 1);
+        if (!submitted) {
+            break;
+        }
+    }
+
+    runFrom(*batch, 0);
+    {
+        std::unique_lock<std::mutex> lock(batch->mutex);
+        batch->closed = true;
+        batch->cv.wait(lock, [&batch]() { return batch->running == 0; });
+    }
+    if (batch->exception) {
+        std::rethrow_exception(batch->exception);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+// Contexts of the threads of a parallel section: the one of the calling
+// thread, in slot 0, and the ones returned by
+// CoordinateOperationContext::acquireWorkerContexts() for the other threads.
+class WorkerContexts {
+  public:
+    WorkerContexts(const CoordinateOperationContextNNPtr &context,
+                   size_t nThreads)
+        : context_(context),
+          others_(nThreads > 1
+                      ? context->acquireWorkerContexts(nThreads - 1)
+                      : std::vector<CoordinateOperationContextNNPtr>()) {}
+
+    ~WorkerContexts() {
+        if (!others_.empty()) {
+            context_->releaseWorkerContexts();
+        }
+    }
+
+    WorkerContexts(const WorkerContexts &) = delete;
+    WorkerContexts &operator=(const WorkerContexts &) = delete;
+
+    size_t size() const { return 1 + others_.size(); }
+
+    const CoordinateOperationContextNNPtr &operator[](size_t slot) const {
+        return slot == 0 ? context_ : others_[slot - 1];
+    }
+
+  private:
+    const CoordinateOperationContextNNPtr &context_;
+    std::vector<CoordinateOperationContextNNPtr> others_;
+};
+
+// ---------------------------------------------------------------------------
+
+// Contexts of the threads of a parallel section, with the state of the
+// Context of the calling thread, which is in slot 0.
+class CoordinateOperationFactory::Private::ThreadContexts {
+  public:
+    ThreadContexts(Context &context, size_t nThreads)
+        : context_(context), workerContexts_(context.context, nThreads) {
+        for (size_t slot = 1; slot < workerContexts_.size(); ++slot) {
+            contexts_.emplace_back(internal::make_unique<Context>(
+                context, workerContexts_[slot]));
+        }
+    }
+
+    ThreadContexts(const ThreadContexts &) = delete;
+    ThreadContexts &operator=(const ThreadContexts &) = delete;
+
+    size_t size() const { return workerContexts_.size(); }
+
+    Context &operator[](size_t slot) {
+        return slot == 0 ? context_ : *(contexts_[slot - 1]);
+    }
+
+  private:
+    Context &context_;
+    WorkerContexts workerContexts_;
+    std::vector<std::unique_ptr<Context>> contexts_{};
+};
+
+// ---------------------------------------------------------------------------
+
 struct FilterResults {
 
     FilterResults(const std::vector<CoordinateOperationNNPtr> &sourceListIn,
@@ -1363,9 +1788,56 @@ struct FilterResults {
 
         // Precompute a number of parameters for each operation that will be
         // useful for the sorting.
-        std::map<CoordinateOperation *, PrecomputedOpCharacteristics> map;
+        std::vector<PrecomputedOpCharacteristics> characteristics(res.size());
+
+        // Grid lookups use the database context, so each thread uses the
+        // one of its own context.
+        constexpr size_t MIN_TASKS_PER_THREAD = 4;
         const auto gridAvailabilityUse = context->getGridAvailabilityUse();
-        for (const auto &op : res) {
+        const WorkerContexts workerContexts(
+            context, context->getAuthorityFactory()
+                         ? getThreadCount(context, res.size(),
+                                          MIN_TASKS_PER_THREAD)
+                         : 1);
+        const auto checkGrids = [this, &characteristics, &workerContexts,
+                                 gridAvailabilityUse](size_t slot, size_t i) {
+            const auto &op = res[i];
+            const auto &authFactory =
+                workerContexts[slot]->getAuthorityFactory();
+            bool hasGrids = false;
+            bool gridsAvailable = true;
+            bool gridsKnown = true;
+            if (authFactory) {
+                const auto gridsNeeded = op->gridsNeeded(
+                    authFactory->databaseContext(),
+                    gridAvailabilityUse ==
+                        CoordinateOperationContext::GridAvailabilityUse::
+                            KNOWN_AVAILABLE);
+                for (const auto &gridDesc : gridsNeeded) {
+                    hasGrids = true;
+                    if (gridAvailabilityUse ==
+                            CoordinateOperationContext::GridAvailabilityUse::
+                                USE_FOR_SORTING &&
+                        !gridDesc.available) {
+                        gridsAvailable = false;
+                    }
+                    if (gridDesc.packageName.empty() &&
+                        !(!gridDesc.url.empty() && gridDesc.openLicense) &&
+                        !gridDesc.available) {
+                        gridsKnown = false;
+                    }
+                }
+            }
+            characteristics[i].hasGrids_ = hasGrids;
+            characteristics[i].gridsAvailable_ = gridsAvailable;
+            characteristics[i].gridsKnown_ = gridsKnown;
+        };
+        runTasks(res.size(), workerContexts.size(), checkGrids);
+
+        // The other parameters only depend on the operations.
+        const auto computeCharacteristics = [this, &characteristics](size_t,
+                                                                     size_t i) {
+            const auto &op = res[i];
             bool dummy = false;
             auto extentOp = getExtent(op, true, dummy);
             double area = 0.0;
@@ -1391,30 +1863,9 @@ struct FilterResults {
                 }
             }
 
-            bool hasGrids = false;
-            bool gridsAvailable = true;
-            bool gridsKnown = true;
-            if (context->getAuthorityFactory()) {
-                const auto gridsNeeded = op->gridsNeeded(
-                    context->getAuthorityFactory()->databaseContext(),
-                    gridAvailabilityUse ==
-                        CoordinateOperationContext::GridAvailabilityUse::
-                            KNOWN_AVAILABLE);
-                for (const auto &gridDesc : gridsNeeded) {
-                    hasGrids = true;
-                    if (gridAvailabilityUse ==
-                            CoordinateOperationContext::GridAvailabilityUse::
-                                USE_FOR_SORTING &&
-                        !gridDesc.available) {
-                        gridsAvailable = false;
-                    }
-                    if (gridDesc.packageName.empty() &&
-                        !(!gridDesc.url.empty() && gridDesc.openLicense) &&
-                        !gridDesc.available) {
-                        gridsKnown = false;
-                    }
-                }
-            }
+            const bool hasGrids = characteristics[i].hasGrids_;
+            const bool gridsAvailable = characteristics[i].gridsAvailable_;
+            const bool gridsKnown = characteristics[i].gridsKnown_;
 
             const auto stepCount = getStepCount(op);
 
@@ -1457,13 +1908,21 @@ struct FilterResults {
                       << " ";
             std::cerr << std::endl;
 #endif
-            map[op.get()] = PrecomputedOpCharacteristics(
+            characteristics[i] = PrecomputedOpCharacteristics(
                 area, getAccuracy(op), isPROJExportable, hasGrids,
                 gridsAvailable, gridsKnown, stepCount, projStepCount,
                 op->hasBallparkTransformation(),
                 op->nameStr().find(BALLPARK_VERTICAL_TRANSFORMATION) !=
                     std::string::npos,
                 isNullTransformation(op->nameStr()));
+        };
+        runTasks(res.size(),
+                 getThreadCount(context, res.size(), MIN_TASKS_PER_THREAD),
+                 computeCharacteristics);
+
+        std::map<CoordinateOperation *, PrecomputedOpCharacteristics> map;
+        for (size_t i = 0; i < res.size(); ++i) {
+            map[res[i].get()] = characteristics[i];
         }
 
         // Sort !
@@ -3070,21 +3529,32 @@ void CoordinateOperationFactory::Private::createOperationsWithDatumPivot(
     const auto &authFactory = context.context->getAuthorityFactory();
     const auto &dbContext = authFactory->databaseContext();
 
-    const auto candidatesSrcGeod(findCandidateGeodCRSForDatum(
+    const auto candidatesSrcGeodList(findCandidateGeodCRSForDatum(
         authFactory, geodSrc, geodSrc->datumNonNull(dbContext.as_nullable())));
-    const auto candidatesDstGeod(findCandidateGeodCRSForDatum(
+    const auto candidatesDstGeodList(findCandidateGeodCRSForDatum(
         authFactory, geodDst, geodDst->datumNonNull(dbContext.as_nullable())));
+    const std::vector<crs::GeodeticCRSNNPtr> candidatesSrcGeod(
+        candidatesSrcGeodList.begin(), candidatesSrcGeodList.end());
+    const std::vector<crs::GeodeticCRSNNPtr> candidatesDstGeod(
+        candidatesDstGeodList.begin(), candidatesDstGeodList.end());
 
     const bool sourceAndTargetAre3D =
         geodSrc->coordinateSystem()->axisList().size() == 3 &&
         geodDst->coordinateSystem()->axisList().size() == 3;
 
-    auto createTransformations = [&](const crs::CRSNNPtr &candidateSrcGeod,
+    // Append to resPair the operations through candidateSrcGeod and
+    // candidateDstGeod, using the database context of threadContext.
+    auto createTransformations = [&](Context &threadContext,
+                                     const crs::CRSNNPtr &candidateSrcGeod,
                                      const crs::CRSNNPtr &candidateDstGeod,
                                      const CoordinateOperationNNPtr &opFirst,
                                      bool isNullFirst,
-                                     bool useOnlyDirectRegistryOp) {
+                                     bool useOnlyDirectRegistryOp,
+                                     std::vector<CoordinateOperationNNPtr>
+                                         &resPair) {
         bool resNonEmptyBeforeFiltering;
+        const auto &threadDbContext =
+            threadContext.context->getAuthorityFactory()->databaseContext();
 
         // Deal with potential epoch change
         std::vector<CoordinateOperationNNPtr> opsEpochChangeSrc;
@@ -3093,7 +3563,7 @@ void CoordinateOperationFactory::Private::createOperationsWithDatumPivot(
             !sourceEpoch->coordinateEpoch()._isEquivalentTo(
                 targetEpoch->coordinateEpoch())) {
             const auto pmoSrc =
-                context.context->getAuthorityFactory()
+                threadContext.context->getAuthorityFactory()
                     ->getPointMotionOperationsFor(
                         NN_NO_CHECK(
                             util::nn_dynamic_pointer_cast<crs::GeodeticCRS>(
@@ -3102,10 +3572,10 @@ void CoordinateOperationFactory::Private::createOperationsWithDatumPivot(
             if (!pmoSrc.empty()) {
                 opsEpochChangeSrc =
                     createOperations(candidateSrcGeod, sourceEpoch,
-                                     candidateSrcGeod, targetEpoch, context);
+                                     candidateSrcGeod, targetEpoch, threadContext);
             } else {
                 const auto pmoDst =
-                    context.context->getAuthorityFactory()
+                    threadContext.context->getAuthorityFactory()
                         ->getPointMotionOperationsFor(
                             NN_NO_CHECK(
                                 util::nn_dynamic_pointer_cast<crs::GeodeticCRS>(
@@ -3114,7 +3584,7 @@ void CoordinateOperationFactory::Private::createOperationsWithDatumPivot(
                 if (!pmoDst.empty()) {
                     opsEpochChangeDst = createOperations(
                         candidateDstGeod, sourceEpoch, candidateDstGeod,
-                        targetEpoch, context);
+                        targetEpoch, threadContext);
                 }
             }
         }
@@ -3122,14 +3592,14 @@ void CoordinateOperationFactory::Private::createOperationsWithDatumPivot(
         const std::vector<CoordinateOperationNNPtr> opsSecond(
             useOnlyDirectRegistryOp
                 ? findOpsInRegistryDirect(candidateSrcGeod, candidateDstGeod,
-                                          context, resNonEmptyBeforeFiltering)
+                                          threadContext, resNonEmptyBeforeFiltering)
                 : createOperations(candidateSrcGeod, targetEpoch,
-                                   candidateDstGeod, targetEpoch, context));
+                                   candidateDstGeod, targetEpoch, threadContext));
         const auto opsThird = createOperations(
             sourceAndTargetAre3D
-                ? candidateDstGeod->promoteTo3D(std::string(), dbContext)
+                ? candidateDstGeod->promoteTo3D(std::string(), threadDbContext)
                 : candidateDstGeod,
-            targetEpoch, targetCRS, targetEpoch, context);
+            targetEpoch, targetCRS, targetEpoch, threadContext);
         assert(!opsThird.empty());
         const CoordinateOperationNNPtr &opThird(opsThird[0]);
 
@@ -3195,9 +3665,9 @@ void CoordinateOperationFactory::Private::createOperationsWithDatumPivot(
                             auto newStep = step->shallowClone();
                             setCRSs(newStep.get(),
                                     newStep->sourceCRS()->promoteTo3D(
-                                        std::string(), dbContext),
+                                        std::string(), threadDbContext),
                                     newStep->targetCRS()->promoteTo3D(
-                                        std::string(), dbContext));
+                                        std::string(), threadDbContext));
                             newSteps.emplace_back(newStep);
                         }
                         opSecondCloned =
@@ -3206,9 +3676,9 @@ void CoordinateOperationFactory::Private::createOperationsWithDatumPivot(
                     } else {
                         setCRSs(opSecondCloned.get(),
                                 opSecondCloned->sourceCRS()->promoteTo3D(
-                                    std::string(), dbContext),
+                                    std::string(), threadDbContext),
                                 opSecondCloned->targetCRS()->promoteTo3D(
-                                    std::string(), dbContext));
+                                    std::string(), threadDbContext));
                     }
                 }
                 if (!isNullFirst) {
@@ -3250,7 +3720,7 @@ void CoordinateOperationFactory::Private::createOperationsWithDatumPivot(
                 logTrace("transformation " + debugStr);
 #endif
                 try {
-                    res.emplace_back(
+                    resPair.emplace_back(
                         ConcatenatedOperation::createComputeMetadata(
                             subOps, disallowEmptyIntersection));
                 } catch (const InvalidOperationEmptyIntersection &) {
@@ -3312,17 +3782,94 @@ void CoordinateOperationFactory::Private::createOperationsWithDatumPivot(
         return 2;
     };
 
+    // The pairs of candidates are evaluated in the order of the sequential
+    // search below, by groups of as many pairs as threads, each thread using
+    // its own Context. Their results are then merged in that order, stopping
+    // as soon as the sequential search would have, so that the results do not
+    // depend on the number of threads.
+    struct CandidatePair {
+        size_t iSrc;
+        size_t iDst;
+    };
+    const auto nThreads = getThreadCount(context.context, SIZE_MAX, 1);
+    std::unique_ptr<ThreadContexts> threadContexts;
+    // Operations from sourceCRS to the candidates of candidatesSrcGeod,
+    // computed by each thread.
+    std::vector<std::map<size_t, CoordinateOperationNNPtr>> opsFirstCache(
+        nThreads);
+    // Return true if the search is over
+    const auto evaluatePairs =
+        [&](const std::vector<CandidatePair> &pairs,
+            bool useOnlyDirectRegistryOp) {
+            for (size_t iPair = 0; iPair < pairs.size();) {
+                const size_t nPairs = std::min(nThreads, pairs.size() - iPair);
+                if (nPairs > 1 && !threadContexts) {
+                    threadContexts.reset(new ThreadContexts(context, nThreads));
+                }
+                const size_t nPairThreads =
+                    threadContexts ? std::min(nPairs, threadContexts->size())
+                                   : 1;
+                std::vector<std::vector<CoordinateOperationNNPtr>> resPairs(
+                    nPairThreads);
+                runTasks(nPairThreads, nPairThreads, [&](size_t slot,
+                                                          size_t i) {
+                    Context &threadContext =
+                        threadContexts ? (*threadContexts)[slot] : context;
+                    const auto &pair = pairs[iPair + i];
+                    const auto &candidateSrcGeod = candidatesSrcGeod[pair.iSrc];
+                    const auto &candidateDstGeod = candidatesDstGeod[pair.iDst];
+#ifdef TRACE_CREATE_OPERATIONS
+                    ENTER_BLOCK("try " + objectAsStr(sourceCRS.get()) + "->" +
+                                objectAsStr(candidateSrcGeod.get()) + "->" +
+                                objectAsStr(candidateDstGeod.get()) + "->" +
+                                objectAsStr(targetCRS.get()) + ")");
+#endif
+                    auto &cache = opsFirstCache[slot];
+                    auto iter = cache.find(pair.iSrc);
+                    if (iter == cache.end()) {
+                        const auto &threadDbContext =
+                            threadContext.context->getAuthorityFactory()
+                                ->databaseContext();
+                        auto sourceSrcGeodModified(
+                            sourceAndTargetAre3D
+                                ? candidateSrcGeod->promoteTo3D(
+                                      std::string(), threadDbContext)
+                                : candidateSrcGeod);
+                        const auto opsFirst = createOperations(
+                            sourceCRS, sourceEpoch, sourceSrcGeodModified,
+                            sourceEpoch, threadContext);
+                        assert(!opsFirst.empty());
+                        iter = cache.emplace(pair.iSrc, opsFirst[0]).first;
+                    }
+                    const auto &opFirst = iter->second;
+                    createTransformations(
+                        threadContext, candidateSrcGeod, candidateDstGeod,
+                        opFirst, isNullTransformation(opFirst->nameStr()),
+                        useOnlyDirectRegistryOp, resPairs[i]);
+                });
+                for (auto &resPair : resPairs) {
+                    res.insert(res.end(), resPair.begin(), resPair.end());
+                    if (!res.empty() &&
+                        !hasResultSetOnlyResultsWithPROJStep(res)) {
+                        return true;
+                    }
+                }
+                iPair += nPairThreads;
+            }
+            return false;
+        };
+
     for (int iter = 0; iter < nIters; ++iter) {
         const bool useOnlyDirectRegistryOp = (iter == 0 && nIters == 3);
-        for (const auto &candidateSrcGeod : candidatesSrcGeod) {
+        std::vector<CandidatePair> pairs;
+        for (size_t iSrc = 0; iSrc < candidatesSrcGeod.size(); ++iSrc) {
+            const auto &candidateSrcGeod = candidatesSrcGeod[iSrc];
             if (candidateSrcGeod->nameStr() == sourceCRS->nameStr()) {
                 const auto typeSource =
                     (iter >= 1) ? getType(candidateSrcGeod) : -1;
-                auto sourceSrcGeodModified(sourceAndTargetAre3D
-                                               ? candidateSrcGeod->promoteTo3D(
-                                                     std::string(), dbContext)
-                                               : candidateSrcGeod);
-                for (const auto &candidateDstGeod : candidatesDstGeod) {
+                for (size_t iDst = 0; iDst < candidatesDstGeod.size();
+                     ++iDst) {
+                    const auto &candidateDstGeod = candidatesDstGeod[iDst];
                     if (candidateDstGeod->nameStr() == targetCRS->nameStr()) {
                         if (iter == 1) {
                             if (typeSource != getType(candidateDstGeod)) {
@@ -3333,70 +3880,30 @@ void CoordinateOperationFactory::Private::createOperationsWithDatumPivot(
                                 continue;
                             }
                         }
-#ifdef TRACE_CREATE_OPERATIONS
-                        ENTER_BLOCK("iter=" + toString(iter) + ", try " +
-                                    objectAsStr(sourceCRS.get()) + "->" +
-                                    objectAsStr(candidateSrcGeod.get()) + "->" +
-                                    objectAsStr(candidateDstGeod.get()) + "->" +
-                                    objectAsStr(targetCRS.get()) + ")");
-#endif
-                        const auto opsFirst = createOperations(
-                            sourceCRS, sourceEpoch, sourceSrcGeodModified,
-                            sourceEpoch, context);
-                        assert(!opsFirst.empty());
-                        const bool isNullFirst =
-                            isNullTransformation(opsFirst[0]->nameStr());
-                        createTransformations(
-                            candidateSrcGeod, candidateDstGeod, opsFirst[0],
-                            isNullFirst, useOnlyDirectRegistryOp);
-                        if (!res.empty()) {
-                            if (hasResultSetOnlyResultsWithPROJStep(res)) {
-                                continue;
-                            }
-                            return;
-                        }
+                        pairs.push_back(CandidatePair{iSrc, iDst});
                     }
                 }
             }
         }
+        if (evaluatePairs(pairs, useOnlyDirectRegistryOp)) {
+            return;
+        }
 
-        for (const auto &candidateSrcGeod : candidatesSrcGeod) {
+        pairs.clear();
+        for (size_t iSrc = 0; iSrc < candidatesSrcGeod.size(); ++iSrc) {
             const bool bSameSrcName =
-                candidateSrcGeod->nameStr() == sourceCRS->nameStr();
-#ifdef TRACE_CREATE_OPERATIONS
-            ENTER_BLOCK("");
-#endif
-            auto sourceSrcGeodModified(
-                sourceAndTargetAre3D
-                    ? candidateSrcGeod->promoteTo3D(std::string(), dbContext)
-                    : candidateSrcGeod);
-            const auto opsFirst =
-                createOperations(sourceCRS, sourceEpoch, sourceSrcGeodModified,
-                                 sourceEpoch, context);
-            assert(!opsFirst.empty());
-            const bool isNullFirst =
-                isNullTransformation(opsFirst[0]->nameStr());
-
-            for (const auto &candidateDstGeod : candidatesDstGeod) {
+                candidatesSrcGeod[iSrc]->nameStr() == sourceCRS->nameStr();
+            for (size_t iDst = 0; iDst < candidatesDstGeod.size(); ++iDst) {
                 if (bSameSrcName &&
-                    candidateDstGeod->nameStr() == targetCRS->nameStr()) {
+                    candidatesDstGeod[iDst]->nameStr() == targetCRS->nameStr()) {
                     continue;
                 }
-
-#ifdef TRACE_CREATE_OPERATIONS
-                ENTER_BLOCK("try " + objectAsStr(sourceCRS.get()) + "->" +
-                            objectAsStr(candidateSrcGeod.get()) + "->" +
-                            objectAsStr(candidateDstGeod.get()) + "->" +
-                            objectAsStr(targetCRS.get()) + ")");
-#endif
-                createTransformations(candidateSrcGeod, candidateDstGeod,
-                                      opsFirst[0], isNullFirst,
-                                      useOnlyDirectRegistryOp);
-                if (!res.empty() && !hasResultSetOnlyResultsWithPROJStep(res)) {
-                    return;
-                }
+                pairs.push_back(CandidatePair{iSrc, iDst});
             }
         }
+        if (evaluatePairs(pairs, useOnlyDirectRegistryOp)) {
+            return;
+        }
     }
 }
 
@@ -6389,6 +6896,30 @@ void CoordinateOperationFactory::Private::createOperationsToGeod(
 
 // ---------------------------------------------------------------------------
 
+// Return the operations of independent requests, in their order, computed by
+// several threads if allowed by the context.
+std::vector<std::vector<CoordinateOperationNNPtr>>
+CoordinateOperationFactory::Private::createOperationsConcurrently(
+    const std::vector<OperationRequest> &requests, Context &context) {
+    std::vector<std::vector<CoordinateOperationNNPtr>> res(requests.size());
+    const auto nThreads = getThreadCount(context.context, requests.size(), 1);
+    std::unique_ptr<ThreadContexts> threadContexts;
+    if (nThreads > 1) {
+        threadContexts.reset(new ThreadContexts(context, nThreads));
+    }
+    runTasks(requests.size(), threadContexts ? threadContexts->size() : 1,
+             [&](size_t slot, size_t i) {
+                 const auto &request = requests[i];
+                 res[i] = createOperations(
+                     request.sourceCRS, request.sourceEpoch, request.targetCRS,
+                     request.targetEpoch,
+                     threadContexts ? (*threadContexts)[slot] : context);
+             });
+    return res;
+}
+
+// ---------------------------------------------------------------------------
+
 void CoordinateOperationFactory::Private::createOperationsCompoundToCompound(
     const crs::CRSNNPtr &sourceCRS,
     const util::optional<common::DataEpoch> &sourceEpoch,
@@ -6424,12 +6955,14 @@ void CoordinateOperationFactory::Private::createOperationsCompoundToCompound(
         if (!pmoSrc.empty()) {
             auto geog3D = srcGeog->promoteTo3D(
                 std::string(), authFactory->databaseContext().as_nullable());
-            auto opsFirst = createOperations(sourceCRS, sourceEpoch, geog3D,
-                                             sourceEpoch, context);
-            auto pmoOps = createOperations(geog3D, sourceEpoch, geog3D,
-                                           targetEpoch, context);
-            auto opsLast = createOperations(geog3D, targetEpoch, targetCRS,
-                                            targetEpoch, context);
+            const auto ops = createOperationsConcurrently(
+                {{sourceCRS, sourceEpoch, geog3D, sourceEpoch},
+                 {geog3D, sourceEpoch, geog3D, targetEpoch},
+                 {geog3D, targetEpoch, targetCRS, targetEpoch}},
+                context);
+            const auto &opsFirst = ops[0];
+            const auto &pmoOps = ops[1];
+            const auto &opsLast = ops[2];
             for (const auto &opFirst : opsFirst) {
                 if (!opFirst->hasBallparkTransformation()) {
                     for (const auto &opMiddle : pmoOps) {
@@ -6476,10 +7009,12 @@ void CoordinateOperationFactory::Private::createOperationsCompoundToCompound(
                 comp1DstBound, util::IComparable::Criterion::EQUIVALENT)) {
             auto hub3D =
                 comp0SrcBound->hubCRS()->promoteTo3D(std::string(), dbContext);
-            const auto ops1 = createOperations(sourceCRS, sourceEpoch, hub3D,
-                                               sourceEpoch, context);
-            const auto ops2 = createOperations(hub3D, targetEpoch, targetCRS,
-                                               targetEpoch, context);
+            const auto ops = createOperationsConcurrently(
+                {{sourceCRS, sourceEpoch, hub3D, sourceEpoch},
+                 {hub3D, targetEpoch, targetCRS, targetEpoch}},
+                context);
+            const auto &ops1 = ops[0];
+            const auto &ops2 = ops[1];
             for (const auto &op1 : ops1) {
                 for (const auto &op2 : ops2) {
                     try {
@@ -6555,10 +7090,12 @@ void CoordinateOperationFactory::Private::createOperationsCompoundToCompound(
         const auto createWithIntermediateCRS =
             [&sourceCRS, &sourceEpoch, &targetCRS, &targetEpoch, &context,
              &res](const crs::CRSNNPtr &intermCRS) {
-                const auto ops1 = createOperations(
-                    sourceCRS, sourceEpoch, intermCRS, sourceEpoch, context);
-                const auto ops2 = createOperations(
-                    intermCRS, targetEpoch, targetCRS, targetEpoch, context);
+                const auto ops = createOperationsConcurrently(
+                    {{sourceCRS, sourceEpoch, intermCRS, sourceEpoch},
+                     {intermCRS, targetEpoch, targetCRS, targetEpoch}},
+                    context);
+                const auto &ops1 = ops[0];
+                const auto &ops2 = ops[1];
                 for (const auto &op1 : ops1) {
                     for (const auto &op2 : ops2) {
                         try {
@@ -6612,10 +7149,12 @@ void CoordinateOperationFactory::Private::createOperationsCompoundToCompound(
             intermGeogSrcIsSameAsIntermGeogDst
                 ? intermGeogSrc
                 : dstGeog->promoteTo3D(std::string(), dbContext);
-        const auto opsSrcToGeog = createOperations(
-            sourceCRS, sourceEpoch, intermGeogSrc, sourceEpoch, context);
-        const auto opsGeogToTarget = createOperations(
-            intermGeogDst, targetEpoch, targetCRS, targetEpoch, context);
+        const auto opsToFromGeog = createOperationsConcurrently(
+            {{sourceCRS, sourceEpoch, intermGeogSrc, sourceEpoch},
+             {intermGeogDst, targetEpoch, targetCRS, targetEpoch}},
+            context);
+        const auto &opsSrcToGeog = opsToFromGeog[0];
+        const auto &opsGeogToTarget = opsToFromGeog[1];
 
         // We preferably accept using an intermediate if the operations
         // to it do not include ballpark operations, but if they do include
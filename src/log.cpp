@@ -129,6 +129,7 @@ PJ_LOG_LEVEL proj_log_level(PJ_CONTEXT *ctx, PJ_LOG_LEVEL log_level) {
     if (PJ_LOG_TELL == log_level)
         return previous;
     ctx->debug_level = log_level;
+    ctx->settingsChanged();
     return previous;
 }
 
@@ -187,4 +188,5 @@ void proj_log_func(PJ_CONTEXT *ctx, void *app_data, PJ_LOG_FUNCTION logf) {
     ctx->logger_app_data = app_data;
     if (nullptr != logf)
         ctx->logger = logf;
+    ctx->settingsChanged();
 }
@@ -38,7 +38,10 @@
 #include <stdlib.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <limits>
+#include <map>
 #include <mutex>
 #include <string>
 
@@ -59,6 +62,9 @@
 #ifdef _WIN32
 #include <shlobj.h>
 #else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <unistd.h>
 #endif
@@ -98,6 +104,12 @@ static void sleep_ms(int ms) {
 constexpr size_t DOWNLOAD_CHUNK_SIZE = 16 * 1024;
 constexpr int MAX_CHUNKS = 64;
 
+// Default name of the cache of grid chunks, in the user writable directory.
+// PROJ < 9.6 used another name, for a file with a different structure, which
+// is left untouched so that those versions can keep using it.
+constexpr const char *CACHE_FILENAME = "cache_v2.db";
+constexpr const char *LEGACY_CACHE_FILENAME = "cache.db";
+
 struct FileProperties {
     unsigned long long size = 0;
     time_t lastChecked = 0;
@@ -105,11 +117,339 @@ struct FileProperties {
     std::string etag{};
 };
 
+// ---------------------------------------------------------------------------
+
+// Cache of network chunks shared by all processes of the host, through a
+// memory-mapped file located next to the disk cache. It sits between the
+// per-process memory cache of NetworkChunkCache and DiskChunkCache.
+//
+// The file is made of a header followed by fixed-size slots, each holding
+// one chunk. Slots are grouped in sets of SHARED_CACHE_WAYS, and the least
+// recently used slot of a set is recycled when a new chunk must be stored.
+// Each slot is protected by a sequence lock: a writer makes its sequence
+// number odd while updating it, and a reader discards what it has copied if
+// the sequence number has changed meanwhile. Writers give up if the slot is
+// already being updated, so that no process ever waits for another one.
+//
+// The number of slots is decided by the process creating the file.
+class SharedChunkCache {
+  public:
+    ~SharedChunkCache();
+
+    static SharedChunkCache *open(PJ_CONTEXT *ctx);
+
+    bool get(const std::string &url, unsigned long long chunkIdx,
+             std::vector<unsigned char> &data);
+
+    void insert(const std::string &url, unsigned long long chunkIdx,
+                const std::vector<unsigned char> &data);
+
+    // Make all cached chunks invalid
+    void invalidate();
+
+  private:
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t slotCount;
+        uint64_t slotSize;
+        std::atomic<uint64_t> generation;
+        std::atomic<uint64_t> clock;
+    };
+
+    struct Slot {
+        std::atomic<uint64_t> seq;
+        std::atomic<uint64_t> lastAccess;
+        std::atomic<uint64_t> generation;
+        std::atomic<uint64_t> keyHash1;
+        std::atomic<uint64_t> keyHash2;
+        std::atomic<uint64_t> chunkIdx;
+        std::atomic<uint64_t> dataSize;
+        // followed by DOWNLOAD_CHUNK_SIZE bytes of data
+    };
+
+    static constexpr uint64_t MAGIC = 0x50524F4A43484B53ULL; // "PROJCHKS"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr unsigned SHARED_CACHE_WAYS = 2;
+    static constexpr size_t SLOT_SIZE =
+        (sizeof(Slot) + DOWNLOAD_CHUNK_SIZE + 63) / 64 * 64;
+    static constexpr size_t HEADER_SIZE = (sizeof(Header) + 63) / 64 * 64;
+
+    void *mapping_ = nullptr;
+    size_t mappingSize_ = 0;
+    Header *header_ = nullptr;
+    uint32_t setCount_ = 0;
+
+    SharedChunkCache() = default;
+    SharedChunkCache(const SharedChunkCache &) = delete;
+    SharedChunkCache &operator=(const SharedChunkCache &) = delete;
+
+    Slot *slot(size_t idx) const {
+        return reinterpret_cast<Slot *>(static_cast<unsigned char *>(mapping_) +
+                                        HEADER_SIZE + idx * SLOT_SIZE);
+    }
+
+    static unsigned char *slotData(Slot *s) {
+        return reinterpret_cast<unsigned char *>(s) + sizeof(Slot);
+    }
+
+    static uint64_t hash(const std::string &url, uint64_t seed);
+
+    size_t firstSlotOfSet(uint64_t keyHash, unsigned long long chunkIdx) const;
+};
+
+// ---------------------------------------------------------------------------
+
+SharedChunkCache::~SharedChunkCache() {
+#ifndef _WIN32
+    if (mapping_)
+        munmap(mapping_, mappingSize_);
+#endif
+}
+
+// ---------------------------------------------------------------------------
+
+SharedChunkCache *SharedChunkCache::open(PJ_CONTEXT *ctx) {
+#ifdef _WIN32
+    (void)ctx;
+    return nullptr;
+#else
+    pj_load_ini(ctx);
+    const auto maxSize = ctx->gridChunkCache.shared_memory_max_size;
+    if (maxSize <= 0)
+        return nullptr;
+    const auto cachePath = pj_context_get_grid_cache_filename(ctx);
+    if (cachePath.empty())
+        return nullptr;
+    const std::string path(cachePath + ".mmap");
+
+    // Caches are never unmapped while the process runs, so that pointers to
+    // them remain valid. A null pointer records a failed attempt.
+    static std::mutex gMutex;
+    static std::map<std::string, std::unique_ptr<SharedChunkCache>> gCaches;
+    std::lock_guard<std::mutex> lock(gMutex);
+    auto iter = gCaches.find(path);
+    if (iter != gCaches.end())
+        return iter->second.get();
+    auto &cache = gCaches[path];
+
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        pj_log(ctx, PJ_LOG_DEBUG, "Cannot open %s", path.c_str());
+        return nullptr;
+    }
+    // The file is initialized under an exclusive lock, so that other
+    // processes only see it once it is complete.
+    if (flock(fd, LOCK_EX) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    std::unique_ptr<SharedChunkCache> newCache(new SharedChunkCache());
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    Header existing{};
+    bool initialized = false;
+    if (ok && static_cast<size_t>(st.st_size) >= HEADER_SIZE &&
+        pread(fd, &existing, sizeof(existing), 0) ==
+            static_cast<ssize_t>(sizeof(existing)) &&
+        existing.magic != 0) {
+        initialized = true;
+        if (existing.magic != MAGIC || existing.version != VERSION ||
+            existing.slotSize != SLOT_SIZE || existing.slotCount == 0 ||
+            static_cast<size_t>(st.st_size) <
+                HEADER_SIZE +
+                    static_cast<size_t>(existing.slotCount) * SLOT_SIZE) {
+            // Likely created by another version of PROJ. Do not touch it,
+            // as other processes might be using it.
+            pj_log(ctx, PJ_LOG_DEBUG, "%s has an unexpected layout",
+                   path.c_str());
+            ok = false;
+        } else {
+            newCache->mappingSize_ =
+                HEADER_SIZE +
+                static_cast<size_t>(existing.slotCount) * SLOT_SIZE;
+        }
+    }
+    uint32_t slotCount = 0;
+    if (ok && !initialized) {
+        const auto maxSlotCount =
+            static_cast<unsigned long long>(maxSize) / SLOT_SIZE;
+        slotCount = static_cast<uint32_t>(std::min<unsigned long long>(
+            std::max<unsigned long long>(maxSlotCount, SHARED_CACHE_WAYS),
+            std::numeric_limits<uint32_t>::max() / SHARED_CACHE_WAYS *
+                SHARED_CACHE_WAYS));
+        slotCount = slotCount / SHARED_CACHE_WAYS * SHARED_CACHE_WAYS;
+        newCache->mappingSize_ =
+            HEADER_SIZE + static_cast<size_t>(slotCount) * SLOT_SIZE;
+        // Truncating to zero first makes sure that all slots read as zero
+        ok = ftruncate(fd, 0) == 0 &&
+             ftruncate(fd, static_cast<off_t>(newCache->mappingSize_)) == 0;
+    }
+    if (ok) {
+        void *mapping = mmap(nullptr, newCache->mappingSize_,
+                             PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ok = false;
+        } else {
+            newCache->mapping_ = mapping;
+            newCache->header_ = static_cast<Header *>(mapping);
+            if (!newCache->header_->generation.is_lock_free()) {
+                ok = false;
+            } else if (!initialized) {
+                auto header = newCache->header_;
+                header->version = VERSION;
+                header->slotCount = slotCount;
+                header->slotSize = SLOT_SIZE;
+                // Slots have a zero generation, so they are all invalid
+                header->generation.store(1);
+                header->clock.store(0);
+                header->magic = MAGIC;
+                msync(mapping, HEADER_SIZE, MS_SYNC);
+            }
+        }
+    }
+    flock(fd, LOCK_UN);
+    ::close(fd);
+    if (!ok) {
+        pj_log(ctx, PJ_LOG_DEBUG, "Cannot use %s as a shared chunk cache",
+               path.c_str());
+        return nullptr;
+    }
+
+    newCache->setCount_ = newCache->header_->slotCount / SHARED_CACHE_WAYS;
+    cache = std::move(newCache);
+    return cache.get();
+#endif
+}
+
+// ---------------------------------------------------------------------------
+
+// 64-bit FNV-1a hash. Two different seeds give two independent hashes, whose
+// combination identifies an URL.
+uint64_t SharedChunkCache::hash(const std::string &url, uint64_t seed) {
+    uint64_t h = seed;
+    for (const char ch : url) {
+        h ^= static_cast<unsigned char>(ch);
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+// ---------------------------------------------------------------------------
+
+size_t SharedChunkCache::firstSlotOfSet(uint64_t keyHash,
+                                        unsigned long long chunkIdx) const {
+    uint64_t h = keyHash ^ (chunkIdx * 0x9E3779B97F4A7C15ULL);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h % setCount_) * SHARED_CACHE_WAYS;
+}
+
+// ---------------------------------------------------------------------------
+
+bool SharedChunkCache::get(const std::string &url, unsigned long long chunkIdx,
+                           std::vector<unsigned char> &data) {
+    const auto keyHash1 = hash(url, 0xCBF29CE484222325ULL);
+    const auto keyHash2 = hash(url, 0x84222325CBF29CE4ULL);
+    const auto generation = header_->generation.load(std::memory_order_acquire);
+    const auto first = firstSlotOfSet(keyHash1, chunkIdx);
+    for (size_t i = first; i < first + SHARED_CACHE_WAYS; ++i) {
+        Slot *s = slot(i);
+        const auto seq = s->seq.load(std::memory_order_acquire);
+        if ((seq & 1) != 0 ||
+            s->generation.load(std::memory_order_relaxed) != generation ||
+            s->keyHash1.load(std::memory_order_relaxed) != keyHash1 ||
+            s->keyHash2.load(std::memory_order_relaxed) != keyHash2 ||
+            s->chunkIdx.load(std::memory_order_relaxed) != chunkIdx) {
+            continue;
+        }
+        const auto dataSize = s->dataSize.load(std::memory_order_relaxed);
+        if (dataSize > DOWNLOAD_CHUNK_SIZE)
+            continue;
+        data.assign(slotData(s), slotData(s) + static_cast<size_t>(dataSize));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s->seq.load(std::memory_order_relaxed) != seq)
+            continue;
+        s->lastAccess.store(header_->clock.fetch_add(1) + 1,
+                            std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedChunkCache::insert(const std::string &url,
+                              unsigned long long chunkIdx,
+                              const std::vector<unsigned char> &data) {
+    if (data.size() > DOWNLOAD_CHUNK_SIZE)
+        return;
+    const auto keyHash1 = hash(url, 0xCBF29CE484222325ULL);
+    const auto keyHash2 = hash(url, 0x84222325CBF29CE4ULL);
+    const auto generation = header_->generation.load(std::memory_order_acquire);
+    const auto first = firstSlotOfSet(keyHash1, chunkIdx);
+
+    // Pick the slot already holding that chunk, or an invalid one, or the
+    // least recently used one.
+    Slot *target = nullptr;
+    uint64_t oldestAccess = std::numeric_limits<uint64_t>::max();
+    for (size_t i = first; i < first + SHARED_CACHE_WAYS; ++i) {
+        Slot *s = slot(i);
+        if (s->generation.load(std::memory_order_relaxed) != generation) {
+            target = s;
+            oldestAccess = 0;
+        } else if (s->keyHash1.load(std::memory_order_relaxed) == keyHash1 &&
+                   s->keyHash2.load(std::memory_order_relaxed) == keyHash2 &&
+                   s->chunkIdx.load(std::memory_order_relaxed) == chunkIdx) {
+            target = s;
+            break;
+        } else {
+            const auto lastAccess =
+                s->lastAccess.load(std::memory_order_relaxed);
+            if (lastAccess < oldestAccess) {
+                target = s;
+                oldestAccess = lastAccess;
+            }
+        }
+    }
+
+    auto seq = target->seq.load(std::memory_order_relaxed);
+    if ((seq & 1) != 0 ||
+        !target->seq.compare_exchange_strong(seq, seq + 1,
+                                             std::memory_order_relaxed)) {
+        // Another process is updating that slot
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    target->generation.store(generation, std::memory_order_relaxed);
+    target->keyHash1.store(keyHash1, std::memory_order_relaxed);
+    target->keyHash2.store(keyHash2, std::memory_order_relaxed);
+    target->chunkIdx.store(chunkIdx, std::memory_order_relaxed);
+    target->dataSize.store(data.size(), std::memory_order_relaxed);
+    if (!data.empty())
+        memcpy(slotData(target), data.data(), data.size());
+    target->lastAccess.store(header_->clock.fetch_add(1) + 1,
+                             std::memory_order_relaxed);
+    target->seq.store(seq + 2, std::memory_order_release);
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedChunkCache::invalidate() { header_->generation.fetch_add(1); }
+
 class NetworkChunkCache {
   public:
     void insert(PJ_CONTEXT *ctx, const std::string &url,
                 unsigned long long chunkIdx, std::vector<unsigned char> &&data);
 
+    // Insert consecutive chunks, starting at firstChunkIdx, writing them to
+    // the disk cache in a single transaction.
+    void insert(PJ_CONTEXT *ctx, const std::string &url,
+                unsigned long long firstChunkIdx,
+                std::vector<std::vector<unsigned char>> &&chunks);
+
     std::shared_ptr<std::vector<unsigned char>>
     get(PJ_CONTEXT *ctx, const std::string &url, unsigned long long chunkIdx);
 
@@ -180,34 +520,36 @@ class DiskChunkCache {
     std::string path_{};
     sqlite3 *hDB_ = nullptr;
     std::unique_ptr<SQLite3VFS> vfs_{};
+    std::string vfsName_{};
+    bool forUpdate_ = false;
+    // Number of rows in the chunks table, or -1 if not computed yet
+    sqlite3_int64 chunkCount_ = -1;
 
     explicit DiskChunkCache(PJ_CONTEXT *ctx, const std::string &path);
 
-    bool initialize();
+    bool initialize(bool forUpdate);
+    bool beginTransaction(bool forUpdate);
     void commitAndClose();
 
     bool createDBStructure();
+    void importDownloadedFileProperties(const std::string &legacyPath);
     bool checkConsistency();
-    bool get_links(sqlite3_int64 chunk_id, sqlite3_int64 &link_id,
-                   sqlite3_int64 &prev, sqlite3_int64 &next,
-                   sqlite3_int64 &head, sqlite3_int64 &tail);
-    bool update_links_of_prev_and_next_links(sqlite3_int64 prev,
-                                             sqlite3_int64 next);
-    bool update_linked_chunks(sqlite3_int64 link_id, sqlite3_int64 prev,
-                              sqlite3_int64 next);
-    bool update_linked_chunks_head_tail(sqlite3_int64 head, sqlite3_int64 tail);
 
     DiskChunkCache(const DiskChunkCache &) = delete;
     DiskChunkCache &operator=(const DiskChunkCache &) = delete;
 
   public:
-    static std::unique_ptr<DiskChunkCache> open(PJ_CONTEXT *ctx);
+    // Open the cache. Unless forUpdate is set, only a shared lock is taken,
+    // so that several readers can access the cache concurrently.
+    static std::unique_ptr<DiskChunkCache> open(PJ_CONTEXT *ctx,
+                                                bool forUpdate);
     ~DiskChunkCache();
 
     sqlite3 *handle() { return hDB_; }
     std::unique_ptr<SQLiteStatement> prepare(const char *sql);
-    bool move_to_head(sqlite3_int64 chunk_id);
-    bool move_to_tail(sqlite3_int64 chunk_id);
+    bool insertChunk(const std::string &url, unsigned long long chunkIdx,
+                     const std::vector<unsigned char> &data);
+    void touch(sqlite3_int64 chunk_id, sqlite3_int64 lastAccess);
     void closeAndUnlink();
 };
 
@@ -234,7 +576,8 @@ static int pj_context_get_grid_cache_ttl(PJ_CONTEXT *ctx) {
 
 // ---------------------------------------------------------------------------
 
-std::unique_ptr<DiskChunkCache> DiskChunkCache::open(PJ_CONTEXT *ctx) {
+std::unique_ptr<DiskChunkCache> DiskChunkCache::open(PJ_CONTEXT *ctx,
+                                                     bool forUpdate) {
     if (!pj_context_get_grid_cache_is_enabled(ctx)) {
         return nullptr;
     }
@@ -245,7 +588,7 @@ std::unique_ptr<DiskChunkCache> DiskChunkCache::open(PJ_CONTEXT *ctx) {
 
     auto diskCache =
         std::unique_ptr<DiskChunkCache>(new DiskChunkCache(ctx, cachePath));
-    if (!diskCache->initialize())
+    if (!diskCache->initialize(forUpdate))
         diskCache.reset();
     return diskCache;
 }
@@ -257,36 +600,34 @@ DiskChunkCache::DiskChunkCache(PJ_CONTEXT *ctx, const std::string &path)
 
 // ---------------------------------------------------------------------------
 
-bool DiskChunkCache::initialize() {
-    std::string vfsName;
-    if (ctx_->custom_sqlite3_vfs_name.empty()) {
-        vfs_ = SQLite3VFS::create(true, false, false);
-        if (vfs_ == nullptr) {
+// Maximum time, in milliseconds, spent waiting for a concurrent writer to
+// complete its commit.
+constexpr int BUSY_TIMEOUT_MS = 1000;
+
+bool DiskChunkCache::beginTransaction(bool forUpdate) {
+    if (!forUpdate) {
+        // A deferred transaction only takes a shared lock on the first read,
+        // which does not prevent other processes from reading the cache.
+        sqlite3_busy_timeout(hDB_, BUSY_TIMEOUT_MS);
+        if (sqlite3_exec(hDB_, "BEGIN", nullptr, nullptr, nullptr) !=
+            SQLITE_OK) {
+            pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
             return false;
         }
-        vfsName = vfs_->name();
-    } else {
-        vfsName = ctx_->custom_sqlite3_vfs_name;
-    }
-    sqlite3_open_v2(path_.c_str(), &hDB_,
-                    SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
-                    vfsName.c_str());
-    if (!hDB_) {
-        pj_log(ctx_, PJ_LOG_ERROR, "Cannot open %s", path_.c_str());
-        return false;
+        forUpdate_ = false;
+        return true;
     }
 
     // Cannot run more than 30 times / a bit more than one second.
+    sqlite3_busy_timeout(hDB_, 0);
     for (int i = 0;; i++) {
         int ret =
-            sqlite3_exec(hDB_, "BEGIN EXCLUSIVE", nullptr, nullptr, nullptr);
+            sqlite3_exec(hDB_, "BEGIN IMMEDIATE", nullptr, nullptr, nullptr);
         if (ret == SQLITE_OK) {
             break;
         }
         if (ret != SQLITE_BUSY) {
             pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
-            sqlite3_close(hDB_);
-            hDB_ = nullptr;
             return false;
         }
         const char *max_iters = getenv("PROJ_LOCK_MAX_ITERS");
@@ -294,8 +635,6 @@ bool DiskChunkCache::initialize() {
                                             : 30)) { // A bit more than 1 second
             pj_log(ctx_, PJ_LOG_ERROR, "Cannot take exclusive lock on %s",
                    path_.c_str());
-            sqlite3_close(hDB_);
-            hDB_ = nullptr;
             return false;
         }
         pj_log(ctx_, PJ_LOG_TRACE, "Lock taken on cache. Waiting a bit...");
@@ -303,19 +642,92 @@ bool DiskChunkCache::initialize() {
         // every 100 ms
         sleep_ms(i < 10 ? 5 : i < 20 ? 10 : 100);
     }
-    char **pasResult = nullptr;
-    int nRows = 0;
-    int nCols = 0;
-    sqlite3_get_table(hDB_,
-                      "SELECT 1 FROM sqlite_master WHERE name = 'properties'",
-                      &pasResult, &nRows, &nCols, nullptr);
-    sqlite3_free_table(pasResult);
-    if (nRows == 0) {
-        if (!createDBStructure()) {
-            sqlite3_close(hDB_);
-            hDB_ = nullptr;
+    // Readers may still hold a shared lock when committing.
+    sqlite3_busy_timeout(hDB_, BUSY_TIMEOUT_MS);
+    forUpdate_ = true;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+bool DiskChunkCache::initialize(bool forUpdate) {
+    if (ctx_->custom_sqlite3_vfs_name.empty()) {
+        vfs_ = SQLite3VFS::create(true, false, false);
+        if (vfs_ == nullptr) {
             return false;
         }
+        vfsName_ = vfs_->name();
+    } else {
+        vfsName_ = ctx_->custom_sqlite3_vfs_name;
+    }
+    sqlite3_open_v2(path_.c_str(), &hDB_,
+                    SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                    vfsName_.c_str());
+    if (!hDB_) {
+        pj_log(ctx_, PJ_LOG_ERROR, "Cannot open %s", path_.c_str());
+        return false;
+    }
+
+    const auto closeOnError = [this]() {
+        sqlite3_close(hDB_);
+        hDB_ = nullptr;
+        return false;
+    };
+
+    if (!beginTransaction(forUpdate)) {
+        return closeOnError();
+    }
+
+    while (true) {
+        auto stmt = prepare("SELECT name FROM sqlite_master WHERE name IN "
+                            "('properties', 'linked_chunks')");
+        if (!stmt) {
+            return closeOnError();
+        }
+        bool hasProperties = false;
+        bool hasLinkedChunks = false;
+        int ret;
+        while ((ret = stmt->execute()) == SQLITE_ROW) {
+            const char *name = stmt->getText();
+            if (strcmp(name, "properties") == 0)
+                hasProperties = true;
+            else
+                hasLinkedChunks = true;
+            stmt->resetResIndex();
+        }
+        if (ret != SQLITE_DONE) {
+            pj_log(ctx_, PJ_LOG_ERROR, "%s: %s", path_.c_str(),
+                   sqlite3_errmsg(hDB_));
+            return closeOnError();
+        }
+        stmt.reset();
+
+        if (hasLinkedChunks) {
+            // Cache with the structure of PROJ < 9.6, which may still be
+            // in use by such versions. Leave it untouched.
+            pj_log(ctx_, PJ_LOG_DEBUG,
+                   "%s has been created by an earlier PROJ version and "
+                   "cannot be used",
+                   path_.c_str());
+            return closeOnError();
+        }
+        if (hasProperties) {
+            break;
+        }
+        if (!forUpdate_) {
+            // Creating the structure requires a write lock. Check again
+            // afterwards, as another process might have done it in the
+            // meantime.
+            sqlite3_exec(hDB_, "COMMIT", nullptr, nullptr, nullptr);
+            if (!beginTransaction(true)) {
+                return closeOnError();
+            }
+            continue;
+        }
+        if (!createDBStructure()) {
+            return closeOnError();
+        }
+        break;
     }
 
     if (getenv("PROJ_CHECK_CACHE_CONSISTENCY")) {
@@ -351,27 +763,12 @@ static const char *cache_db_structure_sql =
     " offset    INTEGER NOT NULL,"
     " data_id   INTEGER NOT NULL,"
     " data_size INTEGER NOT NULL,"
+    " last_access INTEGER NOT NULL,"
     " CONSTRAINT fk_chunks_url FOREIGN KEY (url) REFERENCES properties(url),"
     " CONSTRAINT fk_chunks_data FOREIGN KEY (data_id) REFERENCES chunk_data(id)"
     ");"
     "CREATE INDEX idx_chunks ON chunks(url, offset);"
-    "CREATE TABLE linked_chunks("
-    " id        INTEGER PRIMARY KEY AUTOINCREMENT CHECK (id > 0),"
-    " chunk_id  INTEGER NOT NULL,"
-    " prev      INTEGER,"
-    " next      INTEGER,"
-    " CONSTRAINT fk_links_chunkid FOREIGN KEY (chunk_id) REFERENCES chunks(id),"
-    " CONSTRAINT fk_links_prev FOREIGN KEY (prev) REFERENCES linked_chunks(id),"
-    " CONSTRAINT fk_links_next FOREIGN KEY (next) REFERENCES linked_chunks(id)"
-    ");"
-    "CREATE INDEX idx_linked_chunks_chunk_id ON linked_chunks(chunk_id);"
-    "CREATE TABLE linked_chunks_head_tail("
-    "  head       INTEGER,"
-    "  tail       INTEGER,"
-    "  CONSTRAINT lht_head FOREIGN KEY (head) REFERENCES linked_chunks(id),"
-    "  CONSTRAINT lht_tail FOREIGN KEY (tail) REFERENCES linked_chunks(id)"
-    ");"
-    "INSERT INTO linked_chunks_head_tail VALUES (NULL, NULL);";
+    "CREATE INDEX idx_chunks_last_access ON chunks(last_access);";
 
 bool DiskChunkCache::createDBStructure() {
 
@@ -381,11 +778,64 @@ bool DiskChunkCache::createDBStructure() {
         pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
         return false;
     }
+
+    // Files downloaded by PROJ < 9.6 are recorded in the cache it uses in
+    // the same directory.
+    const std::string suffix = std::string("/") + CACHE_FILENAME;
+    if (path_.size() > suffix.size() &&
+        path_.compare(path_.size() - suffix.size(), suffix.size(), suffix) ==
+            0) {
+        importDownloadedFileProperties(
+            path_.substr(0, path_.size() - suffix.size() + 1) +
+            LEGACY_CACHE_FILENAME);
+    }
     return true;
 }
 
 // ---------------------------------------------------------------------------
 
+// Copy the properties of the downloaded files recorded in a cache of PROJ
+// < 9.6, which is only read, so that those files are not considered as
+// needing to be downloaded again. This is done on a best-effort basis.
+void DiskChunkCache::importDownloadedFileProperties(
+    const std::string &legacyPath) {
+    sqlite3 *hLegacyDB = nullptr;
+    if (sqlite3_open_v2(legacyPath.c_str(), &hLegacyDB, SQLITE_OPEN_READONLY,
+                        vfsName_.c_str()) != SQLITE_OK) {
+        sqlite3_close(hLegacyDB);
+        return;
+    }
+    sqlite3_busy_timeout(hLegacyDB, BUSY_TIMEOUT_MS);
+    sqlite3_stmt *hSelect = nullptr;
+    sqlite3_stmt *hInsert = nullptr;
+    if (sqlite3_prepare_v2(hLegacyDB,
+                           "SELECT url, lastChecked, fileSize, lastModified, "
+                           "etag FROM downloaded_file_properties",
+                           -1, &hSelect, nullptr) == SQLITE_OK &&
+        sqlite3_prepare_v2(hDB_,
+                           "INSERT OR IGNORE INTO downloaded_file_properties "
+                           "(url, lastChecked, fileSize, lastModified, etag) "
+                           "VALUES (?,?,?,?,?)",
+                           -1, &hInsert, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(hSelect) == SQLITE_ROW) {
+            sqlite3_reset(hInsert);
+            for (int i = 0; i < 5; i++) {
+                sqlite3_bind_value(hInsert, i + 1,
+                                   sqlite3_column_value(hSelect, i));
+            }
+            if (sqlite3_step(hInsert) != SQLITE_DONE) {
+                pj_log(ctx_, PJ_LOG_DEBUG, "%s", sqlite3_errmsg(hDB_));
+                break;
+            }
+        }
+    }
+    sqlite3_finalize(hInsert);
+    sqlite3_finalize(hSelect);
+    sqlite3_close(hLegacyDB);
+}
+
+// ---------------------------------------------------------------------------
+
 // Used by checkConsistency() and insert()
 #define INVALIDATED_SQL_LITERAL "'invalidated'"
 
@@ -401,13 +851,13 @@ bool DiskChunkCache::checkConsistency() {
         return false;
     }
 
-    stmt = prepare("SELECT * FROM chunks WHERE id NOT IN (SELECT chunk_id FROM "
-                   "linked_chunks)");
+    stmt = prepare("SELECT * FROM chunks WHERE data_id NOT IN (SELECT id FROM "
+                   "chunk_data)");
     if (!stmt) {
         return false;
     }
     if (stmt->execute() != SQLITE_DONE) {
-        fprintf(stderr, "Rows in chunks not referenced by linked_chunks.\n");
+        fprintf(stderr, "Rows in chunks referencing missing chunk_data.\n");
         return false;
     }
 
@@ -422,117 +872,6 @@ bool DiskChunkCache::checkConsistency() {
         return false;
     }
 
-    stmt = prepare("SELECT head, tail FROM linked_chunks_head_tail");
-    if (!stmt) {
-        return false;
-    }
-    if (stmt->execute() != SQLITE_ROW) {
-        fprintf(stderr, "linked_chunks_head_tail empty.\n");
-        return false;
-    }
-    const auto head = stmt->getInt64();
-    const auto tail = stmt->getInt64();
-    if (stmt->execute() != SQLITE_DONE) {
-        fprintf(stderr, "linked_chunks_head_tail has more than one row.\n");
-        return false;
-    }
-
-    stmt = prepare("SELECT COUNT(*) FROM linked_chunks");
-    if (!stmt) {
-        return false;
-    }
-    if (stmt->execute() != SQLITE_ROW) {
-        fprintf(stderr, "linked_chunks_head_tail empty.\n");
-        return false;
-    }
-    const auto count_linked_chunks = stmt->getInt64();
-
-    if (head) {
-        auto id = head;
-        std::set<sqlite3_int64> visitedIds;
-        stmt = prepare("SELECT next FROM linked_chunks WHERE id = ?");
-        if (!stmt) {
-            return false;
-        }
-        while (true) {
-            visitedIds.insert(id);
-            stmt->reset();
-            stmt->bindInt64(id);
-            if (stmt->execute() != SQLITE_ROW) {
-                fprintf(stderr, "cannot find linked_chunks.id = %d.\n",
-                        static_cast<int>(id));
-                return false;
-            }
-            auto next = stmt->getInt64();
-            if (next == 0) {
-                if (id != tail) {
-                    fprintf(stderr,
-                            "last item when following next is not tail.\n");
-                    return false;
-                }
-                break;
-            }
-            if (visitedIds.find(next) != visitedIds.end()) {
-                fprintf(stderr, "found cycle on linked_chunks.next = %d.\n",
-                        static_cast<int>(next));
-                return false;
-            }
-            id = next;
-        }
-        if (visitedIds.size() != static_cast<size_t>(count_linked_chunks)) {
-            fprintf(stderr,
-                    "ghost items in linked_chunks when following next.\n");
-            return false;
-        }
-    } else if (count_linked_chunks) {
-        fprintf(stderr, "linked_chunks_head_tail.head = NULL but linked_chunks "
-                        "not empty.\n");
-        return false;
-    }
-
-    if (tail) {
-        auto id = tail;
-        std::set<sqlite3_int64> visitedIds;
-        stmt = prepare("SELECT prev FROM linked_chunks WHERE id = ?");
-        if (!stmt) {
-            return false;
-        }
-        while (true) {
-            visitedIds.insert(id);
-            stmt->reset();
-            stmt->bindInt64(id);
-            if (stmt->execute() != SQLITE_ROW) {
-                fprintf(stderr, "cannot find linked_chunks.id = %d.\n",
-                        static_cast<int>(id));
-                return false;
-            }
-            auto prev = stmt->getInt64();
-            if (prev == 0) {
-                if (id != head) {
-                    fprintf(stderr,
-                            "last item when following prev is not head.\n");
-                    return false;
-                }
-                break;
-            }
-            if (visitedIds.find(prev) != visitedIds.end()) {
-                fprintf(stderr, "found cycle on linked_chunks.prev = %d.\n",
-                        static_cast<int>(prev));
-                return false;
-            }
-            id = prev;
-        }
-        if (visitedIds.size() != static_cast<size_t>(count_linked_chunks)) {
-            fprintf(stderr,
-                    "ghost items in linked_chunks when following prev.\n");
-            return false;
-        }
-    } else if (count_linked_chunks) {
-        fprintf(stderr, "linked_chunks_head_tail.tail = NULL but linked_chunks "
-                        "not empty.\n");
-        return false;
-    }
-
     fprintf(stderr, "check ok\n");
     return true;
 }
@@ -577,416 +916,208 @@ std::unique_ptr<SQLiteStatement> DiskChunkCache::prepare(const char *sql) {
 
 // ---------------------------------------------------------------------------
 
-bool DiskChunkCache::get_links(sqlite3_int64 chunk_id, sqlite3_int64 &link_id,
-                               sqlite3_int64 &prev, sqlite3_int64 &next,
-                               sqlite3_int64 &head, sqlite3_int64 &tail) {
-    auto stmt =
-        prepare("SELECT id, prev, next FROM linked_chunks WHERE chunk_id = ?");
-    if (!stmt)
-        return false;
-    stmt->bindInt64(chunk_id);
-    {
-        const auto ret = stmt->execute();
-        if (ret != SQLITE_ROW) {
-            pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
-            return false;
-        }
-    }
-    link_id = stmt->getInt64();
-    prev = stmt->getInt64();
-    next = stmt->getInt64();
-
-    stmt = prepare("SELECT head, tail FROM linked_chunks_head_tail");
-    {
-        const auto ret = stmt->execute();
-        if (ret != SQLITE_ROW) {
-            pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
-            return false;
-        }
-    }
-    head = stmt->getInt64();
-    tail = stmt->getInt64();
-    return true;
-}
-
-// ---------------------------------------------------------------------------
-
-bool DiskChunkCache::update_links_of_prev_and_next_links(sqlite3_int64 prev,
-                                                         sqlite3_int64 next) {
-    if (prev) {
-        auto stmt = prepare("UPDATE linked_chunks SET next = ? WHERE id = ?");
-        if (!stmt)
-            return false;
-        if (next)
-            stmt->bindInt64(next);
-        else
-            stmt->bindNull();
-        stmt->bindInt64(prev);
-        const auto ret = stmt->execute();
-        if (ret != SQLITE_DONE) {
-            pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
-            return false;
-        }
-    }
-
-    if (next) {
-        auto stmt = prepare("UPDATE linked_chunks SET prev = ? WHERE id = ?");
-        if (!stmt)
-            return false;
-        if (prev)
-            stmt->bindInt64(prev);
-        else
-            stmt->bindNull();
-        stmt->bindInt64(next);
-        const auto ret = stmt->execute();
-        if (ret != SQLITE_DONE) {
-            pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
-            return false;
-        }
-    }
-    return true;
-}
+// Access times of cached chunks are only refreshed when they are older than
+// that many seconds, so that reading the cache does not usually need to
+// write to it. This makes the least-recently-used eviction approximate.
+constexpr sqlite3_int64 ACCESS_TIME_RESOLUTION = 60;
 
-// ---------------------------------------------------------------------------
+// Access time of invalidated chunks, lower than the one of any chunk in use,
+// so that they are the first ones to be recycled.
+constexpr sqlite3_int64 INVALIDATED_ACCESS_TIME = -1;
 
-bool DiskChunkCache::update_linked_chunks(sqlite3_int64 link_id,
-                                          sqlite3_int64 prev,
-                                          sqlite3_int64 next) {
-    auto stmt =
-        prepare("UPDATE linked_chunks SET prev = ?, next = ? WHERE id = ?");
-    if (!stmt)
-        return false;
-    if (prev)
-        stmt->bindInt64(prev);
-    else
-        stmt->bindNull();
-    if (next)
-        stmt->bindInt64(next);
-    else
-        stmt->bindNull();
-    stmt->bindInt64(link_id);
-    const auto ret = stmt->execute();
-    if (ret != SQLITE_DONE) {
-        pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
-        return false;
-    }
-    return true;
+static sqlite3_int64 getCurrentAccessTime() {
+    return static_cast<sqlite3_int64>(time(nullptr));
 }
 
 // ---------------------------------------------------------------------------
 
-bool DiskChunkCache::update_linked_chunks_head_tail(sqlite3_int64 head,
-                                                    sqlite3_int64 tail) {
-    auto stmt =
-        prepare("UPDATE linked_chunks_head_tail SET head = ?, tail = ?");
+// Record that a chunk has been accessed. This is done on a best-effort basis
+// when the cache has been opened for reading only, as upgrading to a write
+// lock fails if another process holds it.
+void DiskChunkCache::touch(sqlite3_int64 chunk_id, sqlite3_int64 lastAccess) {
+    const auto now = getCurrentAccessTime();
+    if (lastAccess >= now - ACCESS_TIME_RESOLUTION && lastAccess <= now)
+        return;
+    auto stmt = prepare("UPDATE chunks SET last_access = ? WHERE id = ?");
     if (!stmt)
-        return false;
-    if (head)
-        stmt->bindInt64(head);
-    else
-        stmt->bindNull(); // shouldn't happen normally
-    if (tail)
-        stmt->bindInt64(tail);
-    else
-        stmt->bindNull(); // shouldn't happen normally
-    const auto ret = stmt->execute();
-    if (ret != SQLITE_DONE) {
-        pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
-        return false;
-    }
-    return true;
-}
-
-// ---------------------------------------------------------------------------
-
-bool DiskChunkCache::move_to_head(sqlite3_int64 chunk_id) {
-
-    sqlite3_int64 link_id = 0;
-    sqlite3_int64 prev = 0;
-    sqlite3_int64 next = 0;
-    sqlite3_int64 head = 0;
-    sqlite3_int64 tail = 0;
-    if (!get_links(chunk_id, link_id, prev, next, head, tail)) {
-        return false;
-    }
-
-    if (link_id == head) {
-        return true;
-    }
-
-    if (!update_links_of_prev_and_next_links(prev, next)) {
-        return false;
-    }
-
-    if (head) {
-        auto stmt = prepare("UPDATE linked_chunks SET prev = ? WHERE id = ?");
-        if (!stmt)
-            return false;
-        stmt->bindInt64(link_id);
-        stmt->bindInt64(head);
-        const auto ret = stmt->execute();
-        if (ret != SQLITE_DONE) {
-            pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
-            return false;
-        }
-    }
-
-    return update_linked_chunks(link_id, 0, head) &&
-           update_linked_chunks_head_tail(link_id,
-                                          (link_id == tail) ? prev : tail);
-}
-
-// ---------------------------------------------------------------------------
-
-bool DiskChunkCache::move_to_tail(sqlite3_int64 chunk_id) {
-    sqlite3_int64 link_id = 0;
-    sqlite3_int64 prev = 0;
-    sqlite3_int64 next = 0;
-    sqlite3_int64 head = 0;
-    sqlite3_int64 tail = 0;
-    if (!get_links(chunk_id, link_id, prev, next, head, tail)) {
-        return false;
-    }
-
-    if (link_id == tail) {
-        return true;
-    }
-
-    if (!update_links_of_prev_and_next_links(prev, next)) {
-        return false;
-    }
-
-    if (tail) {
-        auto stmt = prepare("UPDATE linked_chunks SET next = ? WHERE id = ?");
-        if (!stmt)
-            return false;
-        stmt->bindInt64(link_id);
-        stmt->bindInt64(tail);
-        const auto ret = stmt->execute();
-        if (ret != SQLITE_DONE) {
-            pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
-            return false;
-        }
+        return;
+    stmt->bindInt64(now);
+    stmt->bindInt64(chunk_id);
+    if (stmt->execute() != SQLITE_DONE) {
+        pj_log(ctx_, PJ_LOG_DEBUG, "Cannot update access time in %s: %s",
+               path_.c_str(), sqlite3_errmsg(hDB_));
     }
-
-    return update_linked_chunks(link_id, tail, 0) &&
-           update_linked_chunks_head_tail((link_id == head) ? next : head,
-                                          link_id);
 }
 
 // ---------------------------------------------------------------------------
 
-void NetworkChunkCache::insert(PJ_CONTEXT *ctx, const std::string &url,
-                               unsigned long long chunkIdx,
-                               std::vector<unsigned char> &&data) {
-    auto dataPtr(std::make_shared<std::vector<unsigned char>>(std::move(data)));
-    cache_.insert(Key(url, chunkIdx), dataPtr);
-
-    auto diskCache = DiskChunkCache::open(ctx);
-    if (!diskCache)
-        return;
-    auto hDB = diskCache->handle();
-
-    // Always insert DOWNLOAD_CHUNK_SIZE bytes to avoid fragmentation
-    std::vector<unsigned char> blob(*dataPtr);
-    assert(blob.size() <= DOWNLOAD_CHUNK_SIZE);
-    blob.resize(DOWNLOAD_CHUNK_SIZE);
-
-    // Check if there is an existing entry for that URL and offset
-    auto stmt = diskCache->prepare(
-        "SELECT id, data_id FROM chunks WHERE url = ? AND offset = ?");
-    if (!stmt)
-        return;
-    stmt->bindText(url.c_str());
-    stmt->bindInt64(chunkIdx * DOWNLOAD_CHUNK_SIZE);
-
-    const auto mainRet = stmt->execute();
-    if (mainRet == SQLITE_ROW) {
-        const auto chunk_id = stmt->getInt64();
-        const auto data_id = stmt->getInt64();
-        stmt =
-            diskCache->prepare("UPDATE chunk_data SET data = ? WHERE id = ?");
-        if (!stmt)
-            return;
-        stmt->bindBlob(blob.data(), blob.size());
-        stmt->bindInt64(data_id);
-        {
-            const auto ret = stmt->execute();
-            if (ret != SQLITE_DONE) {
-                pj_log(ctx, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB));
-                return;
-            }
-        }
-
-        diskCache->move_to_head(chunk_id);
-
-        return;
-    } else if (mainRet != SQLITE_DONE) {
-        pj_log(ctx, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB));
-        return;
-    }
-
-    // Lambda to recycle an existing entry that was either invalidated, or
-    // least recently used.
-    const auto reuseExistingEntry =
-        [ctx, &blob, &diskCache, hDB, &url, chunkIdx,
-         &dataPtr](std::unique_ptr<SQLiteStatement> &stmtIn) {
-            const auto chunk_id = stmtIn->getInt64();
-            const auto data_id = stmtIn->getInt64();
-            if (data_id <= 0) {
-                pj_log(ctx, PJ_LOG_ERROR, "data_id <= 0");
-                return;
-            }
+bool DiskChunkCache::insertChunk(const std::string &url,
+                                 unsigned long long chunkIdx,
+                                 const std::vector<unsigned char> &data) {
+    assert(forUpdate_);
+    const auto now = getCurrentAccessTime();
 
-            auto l_stmt = diskCache->prepare(
-                "UPDATE chunk_data SET data = ? WHERE id = ?");
-            if (!l_stmt)
-                return;
-            l_stmt->bindBlob(blob.data(), blob.size());
-            l_stmt->bindInt64(data_id);
-            {
-                const auto ret2 = l_stmt->execute();
-                if (ret2 != SQLITE_DONE) {
-                    pj_log(ctx, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB));
-                    return;
-                }
-            }
+    // Always insert DOWNLOAD_CHUNK_SIZE bytes to avoid fragmentation
+    std::vector<unsigned char> blob(data);
+    assert(blob.size() <= DOWNLOAD_CHUNK_SIZE);
+    blob.resize(DOWNLOAD_CHUNK_SIZE);
 
-            l_stmt =
-                diskCache->prepare("UPDATE chunks SET url = ?, "
-                                   "offset = ?, data_size = ?, data_id = ? "
-                                   "WHERE id = ?");
-            if (!l_stmt)
-                return;
-            l_stmt->bindText(url.c_str());
-            l_stmt->bindInt64(chunkIdx * DOWNLOAD_CHUNK_SIZE);
-            l_stmt->bindInt64(dataPtr->size());
-            l_stmt->bindInt64(data_id);
-            l_stmt->bindInt64(chunk_id);
-            {
-                const auto ret2 = l_stmt->execute();
-                if (ret2 != SQLITE_DONE) {
-                    pj_log(ctx, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB));
-                    return;
-                }
-            }
+    // Lambda to overwrite the content of an existing entry
+    const auto updateEntry = [this, &blob, &url, chunkIdx, &data,
+                              now](sqlite3_int64 chunk_id,
+                                   sqlite3_int64 data_id) {
+        auto stmt = prepare("UPDATE chunk_data SET data = ? WHERE id = ?");
+        if (!stmt)
+            return false;
+        stmt->bindBlob(blob.data(), blob.size());
+        stmt->bindInt64(data_id);
+        if (stmt->execute() != SQLITE_DONE) {
+            pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
+            return false;
+        }
 
-            diskCache->move_to_head(chunk_id);
-        };
+        stmt = prepare("UPDATE chunks SET url = ?, offset = ?, data_size = ?, "
+                       "last_access = ? WHERE id = ?");
+        if (!stmt)
+            return false;
+        stmt->bindText(url.c_str());
+        stmt->bindInt64(chunkIdx * DOWNLOAD_CHUNK_SIZE);
+        stmt->bindInt64(data.size());
+        stmt->bindInt64(now);
+        stmt->bindInt64(chunk_id);
+        if (stmt->execute() != SQLITE_DONE) {
+            pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
+            return false;
+        }
+        return true;
+    };
 
-    // Find if there is an invalidated chunk we can reuse
-    stmt = diskCache->prepare(
-        "SELECT id, data_id FROM chunks "
-        "WHERE id = (SELECT tail FROM linked_chunks_head_tail) AND "
-        "url = " INVALIDATED_SQL_LITERAL);
+    // Check if there is an existing entry for that URL and offset
+    auto stmt =
+        prepare("SELECT id, data_id FROM chunks WHERE url = ? AND offset = ?");
     if (!stmt)
-        return;
+        return false;
+    stmt->bindText(url.c_str());
+    stmt->bindInt64(chunkIdx * DOWNLOAD_CHUNK_SIZE);
     {
         const auto ret = stmt->execute();
         if (ret == SQLITE_ROW) {
-            reuseExistingEntry(stmt);
-            return;
+            const auto chunk_id = stmt->getInt64();
+            const auto data_id = stmt->getInt64();
+            return updateEntry(chunk_id, data_id);
         } else if (ret != SQLITE_DONE) {
-            pj_log(ctx, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB));
-            return;
+            pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
+            return false;
         }
     }
 
-    // Check if we have not reached the max size of the cache
-    stmt = diskCache->prepare("SELECT COUNT(*) FROM chunks");
+    if (chunkCount_ < 0) {
+        stmt = prepare("SELECT COUNT(*) FROM chunks");
+        if (!stmt)
+            return false;
+        if (stmt->execute() != SQLITE_ROW) {
+            pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
+            return false;
+        }
+        chunkCount_ = stmt->getInt64();
+    }
+
+    // Recycle the least recently used entry if it was invalidated, or if we
+    // have reached the max size of the cache. Invalidated entries come
+    // first.
+    const auto max_size = pj_context_get_grid_cache_max_size(ctx_);
+    const bool cacheFull =
+        max_size > 0 &&
+        static_cast<long long>(chunkCount_ * DOWNLOAD_CHUNK_SIZE) >= max_size;
+    stmt = prepare("SELECT id, data_id, url = " INVALIDATED_SQL_LITERAL
+                   " FROM chunks ORDER BY last_access, id LIMIT 1");
     if (!stmt)
-        return;
+        return false;
     {
         const auto ret = stmt->execute();
-        if (ret != SQLITE_ROW) {
-            pj_log(ctx, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB));
-            return;
-        }
-    }
-
-    const auto max_size = pj_context_get_grid_cache_max_size(ctx);
-    if (max_size > 0 &&
-        static_cast<long long>(stmt->getInt64() * DOWNLOAD_CHUNK_SIZE) >=
-            max_size) {
-        stmt = diskCache->prepare(
-            "SELECT id, data_id FROM chunks "
-            "WHERE id = (SELECT tail FROM linked_chunks_head_tail)");
-        if (!stmt)
-            return;
-
-        const auto ret = stmt->execute();
-        if (ret != SQLITE_ROW) {
-            pj_log(ctx, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB));
-            return;
+        if (ret == SQLITE_ROW) {
+            const auto chunk_id = stmt->getInt64();
+            const auto data_id = stmt->getInt64();
+            const bool invalidated = stmt->getInt64() != 0;
+            if (cacheFull || invalidated) {
+                if (data_id <= 0) {
+                    pj_log(ctx_, PJ_LOG_ERROR, "data_id <= 0");
+                    return false;
+                }
+                return updateEntry(chunk_id, data_id);
+            }
+        } else if (ret != SQLITE_DONE) {
+            pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
+            return false;
         }
-        reuseExistingEntry(stmt);
-        return;
     }
 
     // Otherwise just append a new entry
-    stmt = diskCache->prepare("INSERT INTO chunk_data(data) VALUES (?)");
+    stmt = prepare("INSERT INTO chunk_data(data) VALUES (?)");
     if (!stmt)
-        return;
+        return false;
     stmt->bindBlob(blob.data(), blob.size());
-    {
-        const auto ret = stmt->execute();
-        if (ret != SQLITE_DONE) {
-            pj_log(ctx, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB));
-            return;
-        }
+    if (stmt->execute() != SQLITE_DONE) {
+        pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
+        return false;
     }
 
-    const auto chunk_data_id = sqlite3_last_insert_rowid(hDB);
+    const auto chunk_data_id = sqlite3_last_insert_rowid(hDB_);
 
-    stmt = diskCache->prepare("INSERT INTO chunks(url, offset, data_id, "
-                              "data_size) VALUES (?,?,?,?)");
+    stmt = prepare("INSERT INTO chunks(url, offset, data_id, data_size, "
+                   "last_access) VALUES (?,?,?,?,?)");
     if (!stmt)
-        return;
+        return false;
     stmt->bindText(url.c_str());
     stmt->bindInt64(chunkIdx * DOWNLOAD_CHUNK_SIZE);
     stmt->bindInt64(chunk_data_id);
-    stmt->bindInt64(dataPtr->size());
-    {
-        const auto ret = stmt->execute();
-        if (ret != SQLITE_DONE) {
-            pj_log(ctx, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB));
-            return;
-        }
+    stmt->bindInt64(data.size());
+    stmt->bindInt64(now);
+    if (stmt->execute() != SQLITE_DONE) {
+        pj_log(ctx_, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB_));
+        return false;
     }
+    ++chunkCount_;
+    return true;
+}
 
-    const auto chunk_id = sqlite3_last_insert_rowid(hDB);
+// ---------------------------------------------------------------------------
 
-    stmt = diskCache->prepare(
-        "INSERT INTO linked_chunks(chunk_id, prev, next) VALUES (?,NULL,NULL)");
-    if (!stmt)
-        return;
-    stmt->bindInt64(chunk_id);
-    if (stmt->execute() != SQLITE_DONE) {
-        pj_log(ctx, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB));
-        return;
-    }
+void NetworkChunkCache::insert(PJ_CONTEXT *ctx, const std::string &url,
+                               unsigned long long chunkIdx,
+                               std::vector<unsigned char> &&data) {
+    std::vector<std::vector<unsigned char>> chunks;
+    chunks.emplace_back(std::move(data));
+    insert(ctx, url, chunkIdx, std::move(chunks));
+}
 
-    stmt = diskCache->prepare("SELECT head FROM linked_chunks_head_tail");
-    if (!stmt)
-        return;
-    if (stmt->execute() != SQLITE_ROW) {
-        pj_log(ctx, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB));
-        return;
+// ---------------------------------------------------------------------------
+
+void NetworkChunkCache::insert(
+    PJ_CONTEXT *ctx, const std::string &url, unsigned long long firstChunkIdx,
+    std::vector<std::vector<unsigned char>> &&chunks) {
+    std::vector<std::shared_ptr<std::vector<unsigned char>>> dataPtrs;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        dataPtrs.emplace_back(
+            std::make_shared<std::vector<unsigned char>>(std::move(chunks[i])));
+        cache_.insert(Key(url, firstChunkIdx + i), dataPtrs.back());
     }
-    if (stmt->getInt64() == 0) {
-        stmt = diskCache->prepare(
-            "UPDATE linked_chunks_head_tail SET head = ?, tail = ?");
-        if (!stmt)
-            return;
-        stmt->bindInt64(chunk_id);
-        stmt->bindInt64(chunk_id);
-        if (stmt->execute() != SQLITE_DONE) {
-            pj_log(ctx, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB));
-            return;
+
+    auto sharedCache = SharedChunkCache::open(ctx);
+    if (sharedCache) {
+        for (size_t i = 0; i < dataPtrs.size(); ++i) {
+            sharedCache->insert(url, firstChunkIdx + i, *dataPtrs[i]);
         }
     }
 
-    diskCache->move_to_head(chunk_id);
+    // All chunks are written in a single transaction
+    auto diskCache = DiskChunkCache::open(ctx, true);
+    if (!diskCache)
+        return;
+    for (size_t i = 0; i < dataPtrs.size(); ++i) {
+        if (!diskCache->insertChunk(url, firstChunkIdx + i, *dataPtrs[i]))
+            return;
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -999,14 +1130,25 @@ NetworkChunkCache::get(PJ_CONTEXT *ctx, const std::string &url,
         return ret;
     }
 
-    auto diskCache = DiskChunkCache::open(ctx);
+    auto sharedCache = SharedChunkCache::open(ctx);
+    if (sharedCache) {
+        ret.reset(new std::vector<unsigned char>());
+        if (sharedCache->get(url, chunkIdx, *ret)) {
+            cache_.insert(Key(url, chunkIdx), ret);
+            return ret;
+        }
+        ret.reset();
+    }
+
+    auto diskCache = DiskChunkCache::open(ctx, false);
     if (!diskCache)
         return ret;
     auto hDB = diskCache->handle();
 
     auto stmt = diskCache->prepare(
-        "SELECT chunks.id, chunks.data_size, chunk_data.data FROM chunks "
-        "JOIN chunk_data ON chunks.id = chunk_data.id "
+        "SELECT chunks.id, chunks.data_size, chunks.last_access, "
+        "chunk_data.data FROM chunks "
+        "JOIN chunk_data ON chunks.data_id = chunk_data.id "
         "WHERE chunks.url = ? AND chunks.offset = ?");
     if (!stmt)
         return ret;
@@ -1018,6 +1160,7 @@ NetworkChunkCache::get(PJ_CONTEXT *ctx, const std::string &url,
     if (mainRet == SQLITE_ROW) {
         const auto chunk_id = stmt->getInt64();
         const auto data_size = stmt->getInt64();
+        const auto last_access = stmt->getInt64();
         int blob_size = 0;
         const void *blob = stmt->getBlob(blob_size);
         if (blob_size < data_size) {
@@ -1035,9 +1178,11 @@ NetworkChunkCache::get(PJ_CONTEXT *ctx, const std::string &url,
                     reinterpret_cast<const unsigned char *>(blob) +
                         static_cast<size_t>(data_size));
         cache_.insert(Key(url, chunkIdx), ret);
+        if (sharedCache)
+            sharedCache->insert(url, chunkIdx, *ret);
 
-        if (!diskCache->move_to_head(chunk_id))
-            return ret;
+        stmt.reset();
+        diskCache->touch(chunk_id, last_access);
     } else if (mainRet != SQLITE_DONE) {
         pj_log(ctx, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB));
     }
@@ -1064,7 +1209,7 @@ void NetworkChunkCache::clearMemoryCache() { cache_.clear(); }
 // ---------------------------------------------------------------------------
 
 void NetworkChunkCache::clearDiskChunkCache(PJ_CONTEXT *ctx) {
-    auto diskCache = DiskChunkCache::open(ctx);
+    auto diskCache = DiskChunkCache::open(ctx, true);
     if (!diskCache)
         return;
     diskCache->closeAndUnlink();
@@ -1072,12 +1217,98 @@ void NetworkChunkCache::clearDiskChunkCache(PJ_CONTEXT *ctx) {
 
 // ---------------------------------------------------------------------------
 
+// File properties are stored in the shared chunk cache as a pseudo chunk
+constexpr unsigned long long PROPERTIES_CHUNK_IDX =
+    std::numeric_limits<unsigned long long>::max();
+
+static void appendString(std::vector<unsigned char> &data,
+                         const std::string &str) {
+    const auto len = static_cast<uint32_t>(str.size());
+    const auto pLen = reinterpret_cast<const unsigned char *>(&len);
+    data.insert(data.end(), pLen, pLen + sizeof(len));
+    data.insert(data.end(), str.begin(), str.end());
+}
+
+static std::vector<unsigned char>
+serializeProperties(const FileProperties &props) {
+    std::vector<unsigned char> data;
+    const auto lastChecked = static_cast<int64_t>(props.lastChecked);
+    const auto pLastChecked =
+        reinterpret_cast<const unsigned char *>(&lastChecked);
+    data.insert(data.end(), pLastChecked, pLastChecked + sizeof(lastChecked));
+    const auto pSize = reinterpret_cast<const unsigned char *>(&props.size);
+    data.insert(data.end(), pSize, pSize + sizeof(props.size));
+    appendString(data, props.lastModified);
+    appendString(data, props.etag);
+    return data;
+}
+
+static bool readString(const std::vector<unsigned char> &data, size_t &pos,
+                       std::string &str) {
+    uint32_t len = 0;
+    if (data.size() - pos < sizeof(len))
+        return false;
+    memcpy(&len, data.data() + pos, sizeof(len));
+    pos += sizeof(len);
+    if (data.size() - pos < len)
+        return false;
+    str.assign(reinterpret_cast<const char *>(data.data()) + pos, len);
+    pos += len;
+    return true;
+}
+
+static bool deserializeProperties(const std::vector<unsigned char> &data,
+                                  FileProperties &props) {
+    int64_t lastChecked = 0;
+    if (data.size() < sizeof(lastChecked) + sizeof(props.size))
+        return false;
+    memcpy(&lastChecked, data.data(), sizeof(lastChecked));
+    props.lastChecked = static_cast<time_t>(lastChecked);
+    memcpy(&props.size, data.data() + sizeof(lastChecked), sizeof(props.size));
+    size_t pos = sizeof(lastChecked) + sizeof(props.size);
+    return readString(data, pos, props.lastModified) &&
+           readString(data, pos, props.etag);
+}
+
+// ---------------------------------------------------------------------------
+
+static bool propertiesExpired(PJ_CONTEXT *ctx, const FileProperties &props) {
+    const auto ttl = pj_context_get_grid_cache_ttl(ctx);
+    if (ttl > 0) {
+        time_t curTime;
+        time(&curTime);
+        if (curTime > props.lastChecked + ttl) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+
 void NetworkFilePropertiesCache::insert(PJ_CONTEXT *ctx, const std::string &url,
                                         FileProperties &props) {
     time(&props.lastChecked);
     cache_.insert(url, props);
 
-    auto diskCache = DiskChunkCache::open(ctx);
+    auto sharedCache = SharedChunkCache::open(ctx);
+    if (sharedCache) {
+        std::vector<unsigned char> data;
+        FileProperties cachedProps;
+        if (sharedCache->get(url, PROPERTIES_CHUNK_IDX, data) &&
+            deserializeProperties(data, cachedProps) &&
+            (props.size != cachedProps.size ||
+             props.lastModified != cachedProps.lastModified ||
+             props.etag != cachedProps.etag)) {
+            // Shared chunks cannot be looked up by URL, so invalidate all
+            // of them.
+            sharedCache->invalidate();
+        }
+        sharedCache->insert(url, PROPERTIES_CHUNK_IDX,
+                            serializeProperties(props));
+    }
+
+    auto diskCache = DiskChunkCache::open(ctx, true);
     if (!diskCache)
         return;
     auto hDB = diskCache->handle();
@@ -1098,26 +1329,14 @@ void NetworkFilePropertiesCache::insert(PJ_CONTEXT *ctx, const std::string &url,
             props.etag != cachedProps.etag) {
 
             // If cached properties don't match recent fresh ones, invalidate
-            // cached chunks
-            stmt = diskCache->prepare("SELECT id FROM chunks WHERE url = ?");
-            if (!stmt)
-                return;
-            stmt->bindText(url.c_str());
-            std::vector<sqlite3_int64> ids;
-            while (stmt->execute() == SQLITE_ROW) {
-                ids.emplace_back(stmt->getInt64());
-                stmt->resetResIndex();
-            }
-
-            for (const auto id : ids) {
-                diskCache->move_to_tail(id);
-            }
-
+            // cached chunks. Resetting their access time makes them the
+            // first ones to be recycled.
             stmt = diskCache->prepare(
                 "UPDATE chunks SET url = " INVALIDATED_SQL_LITERAL ", "
-                "offset = -1, data_size = 0 WHERE url = ?");
+                "offset = -1, data_size = 0, last_access = ? WHERE url = ?");
             if (!stmt)
                 return;
+            stmt->bindInt64(INVALIDATED_ACCESS_TIME);
             stmt->bindText(url.c_str());
             if (stmt->execute() != SQLITE_DONE) {
                 pj_log(ctx, PJ_LOG_ERROR, "%s", sqlite3_errmsg(hDB));
@@ -1177,7 +1396,19 @@ bool NetworkFilePropertiesCache::tryGet(PJ_CONTEXT *ctx, const std::string &url,
         return true;
     }
 
-    auto diskCache = DiskChunkCache::open(ctx);
+    auto sharedCache = SharedChunkCache::open(ctx);
+    if (sharedCache) {
+        std::vector<unsigned char> data;
+        if (sharedCache->get(url, PROPERTIES_CHUNK_IDX, data) &&
+            deserializeProperties(data, props) &&
+            !propertiesExpired(ctx, props)) {
+            cache_.insert(url, props);
+            return true;
+        }
+        props = FileProperties();
+    }
+
+    auto diskCache = DiskChunkCache::open(ctx, false);
     if (!diskCache)
         return false;
     auto stmt =
@@ -1196,16 +1427,14 @@ bool NetworkFilePropertiesCache::tryGet(PJ_CONTEXT *ctx, const std::string &url,
     const char *etag = stmt->getText();
     props.etag = etag ? etag : std::string();
 
-    const auto ttl = pj_context_get_grid_cache_ttl(ctx);
-    if (ttl > 0) {
-        time_t curTime;
-        time(&curTime);
-        if (curTime > props.lastChecked + ttl) {
-            props = FileProperties();
-            return false;
-        }
+    if (propertiesExpired(ctx, props)) {
+        props = FileProperties();
+        return false;
     }
     cache_.insert(url, props);
+    if (sharedCache)
+        sharedCache->insert(url, PROPERTIES_CHUNK_IDX,
+                            serializeProperties(props));
     return true;
 }
 
@@ -1225,10 +1454,17 @@ class NetworkFile : public File {
     FileProperties m_props;
     proj_network_close_cbk_type m_closeCbk;
     bool m_hasChanged = false;
+    // Last chunk read from gNetworkChunkCache, kept to serve consecutive
+    // reads within the same chunk without looking up the cache again.
+    std::shared_ptr<std::vector<unsigned char>> m_lastChunk{};
+    unsigned long long m_lastChunkIdx = 0;
 
     NetworkFile(const NetworkFile &) = delete;
     NetworkFile &operator=(const NetworkFile &) = delete;
 
+    bool download(unsigned long long firstChunkIdx, size_t nChunks,
+                  std::vector<unsigned char> &region);
+
   protected:
     NetworkFile(PJ_CONTEXT *ctx, const std::string &url,
                 PROJ_NETWORK_HANDLE *handle,
@@ -1247,6 +1483,10 @@ class NetworkFile : public File {
     unsigned long long tell() override;
     void reassign_context(PJ_CONTEXT *ctx) override;
     bool hasChanged() const override { return m_hasChanged; }
+    std::string versionKey() const override;
+    bool supportsPrefetch() const override { return true; }
+    void prefetch(const std::vector<std::pair<unsigned long long, size_t>>
+                      &ranges) override;
 
     static std::unique_ptr<File> open(PJ_CONTEXT *ctx, const char *filename);
 
@@ -1328,6 +1568,72 @@ std::unique_ptr<File> pj_network_file_open(PJ_CONTEXT *ctx,
 
 // ---------------------------------------------------------------------------
 
+/** Download nChunks chunks starting at chunk index firstChunkIdx with a single
+ * range request, and insert them in the chunk cache.
+ * region is resized to the number of bytes actually read.
+ */
+bool NetworkFile::download(unsigned long long firstChunkIdx, size_t nChunks,
+                           std::vector<unsigned char> &region) {
+    const auto offsetToDownload = firstChunkIdx * DOWNLOAD_CHUNK_SIZE;
+    region.resize(nChunks * DOWNLOAD_CHUNK_SIZE);
+    size_t nRead = 0;
+    std::string errorBuffer;
+    errorBuffer.resize(1024);
+    if (!m_handle) {
+        m_handle = m_ctx->networking.open(
+            m_ctx, m_url.c_str(), offsetToDownload, region.size(), &region[0],
+            &nRead, errorBuffer.size(), &errorBuffer[0],
+            m_ctx->networking.user_data);
+        if (!m_handle) {
+            proj_context_errno_set(m_ctx, PROJ_ERR_OTHER_NETWORK_ERROR);
+            return false;
+        }
+    } else {
+        nRead = m_ctx->networking.read_range(
+            m_ctx, m_handle, offsetToDownload, region.size(), &region[0],
+            errorBuffer.size(), &errorBuffer[0], m_ctx->networking.user_data);
+    }
+    if (nRead == 0) {
+        errorBuffer.resize(strlen(errorBuffer.data()));
+        if (!errorBuffer.empty()) {
+            pj_log(m_ctx, PJ_LOG_ERROR, "Cannot read in %s: %s", m_url.c_str(),
+                   errorBuffer.c_str());
+        }
+        proj_context_errno_set(m_ctx, PROJ_ERR_OTHER_NETWORK_ERROR);
+        return false;
+    }
+
+    if (!m_hasChanged) {
+        FileProperties props;
+        if (get_props_from_headers(m_ctx, m_handle, props)) {
+            if (props.size != m_props.size ||
+                props.lastModified != m_props.lastModified ||
+                props.etag != m_props.etag) {
+                gNetworkFileProperties.insert(m_ctx, m_url, props);
+                gNetworkChunkCache.clearMemoryCache();
+                m_lastChunk.reset();
+                m_hasChanged = true;
+            }
+        }
+    }
+
+    region.resize(nRead);
+
+    const auto nChunksRead =
+        (region.size() + DOWNLOAD_CHUNK_SIZE - 1) / DOWNLOAD_CHUNK_SIZE;
+    std::vector<std::vector<unsigned char>> chunks;
+    for (size_t i = 0; i < nChunksRead; i++) {
+        chunks.emplace_back(
+            region.data() + i * DOWNLOAD_CHUNK_SIZE,
+            region.data() +
+                std::min((i + 1) * DOWNLOAD_CHUNK_SIZE, region.size()));
+    }
+    gNetworkChunkCache.insert(m_ctx, m_url, firstChunkIdx, std::move(chunks));
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
 size_t NetworkFile::read(void *buffer, size_t sizeBytes) {
 
     if (sizeBytes == 0)
@@ -1338,9 +1644,19 @@ size_t NetworkFile::read(void *buffer, size_t sizeBytes) {
         const auto chunkIdxToDownload = iterOffset / DOWNLOAD_CHUNK_SIZE;
         const auto offsetToDownload = chunkIdxToDownload * DOWNLOAD_CHUNK_SIZE;
         std::vector<unsigned char> region;
-        auto pChunk = gNetworkChunkCache.get(m_ctx, m_url, chunkIdxToDownload);
+        // Points either to a cached chunk, borrowed without copying it, or to
+        // the above region for freshly downloaded data.
+        const std::vector<unsigned char> *pRegion = &region;
+        std::shared_ptr<std::vector<unsigned char>> pChunk;
+        if (m_lastChunk && m_lastChunkIdx == chunkIdxToDownload) {
+            pChunk = m_lastChunk;
+        } else {
+            pChunk = gNetworkChunkCache.get(m_ctx, m_url, chunkIdxToDownload);
+        }
         if (pChunk != nullptr) {
-            region = *pChunk;
+            m_lastChunk = pChunk;
+            m_lastChunkIdx = chunkIdxToDownload;
+            pRegion = pChunk.get();
         } else {
             if (offsetToDownload == m_lastDownloadedOffset) {
                 // In case of consecutive reads (of small size), we use a
@@ -1379,72 +1695,19 @@ size_t NetworkFile::read(void *buffer, size_t sizeBytes) {
             if (m_nBlocksToDownload > MAX_CHUNKS)
                 m_nBlocksToDownload = MAX_CHUNKS;
 
-            region.resize(m_nBlocksToDownload * DOWNLOAD_CHUNK_SIZE);
-            size_t nRead = 0;
-            std::string errorBuffer;
-            errorBuffer.resize(1024);
-            if (!m_handle) {
-                m_handle = m_ctx->networking.open(
-                    m_ctx, m_url.c_str(), offsetToDownload,
-                    m_nBlocksToDownload * DOWNLOAD_CHUNK_SIZE, &region[0],
-                    &nRead, errorBuffer.size(), &errorBuffer[0],
-                    m_ctx->networking.user_data);
-                if (!m_handle) {
-                    proj_context_errno_set(m_ctx, PROJ_ERR_OTHER_NETWORK_ERROR);
-                    return 0;
-                }
-            } else {
-                nRead = m_ctx->networking.read_range(
-                    m_ctx, m_handle, offsetToDownload,
-                    m_nBlocksToDownload * DOWNLOAD_CHUNK_SIZE, &region[0],
-                    errorBuffer.size(), &errorBuffer[0],
-                    m_ctx->networking.user_data);
-            }
-            if (nRead == 0) {
-                errorBuffer.resize(strlen(errorBuffer.data()));
-                if (!errorBuffer.empty()) {
-                    pj_log(m_ctx, PJ_LOG_ERROR, "Cannot read in %s: %s",
-                           m_url.c_str(), errorBuffer.c_str());
-                }
-                proj_context_errno_set(m_ctx, PROJ_ERR_OTHER_NETWORK_ERROR);
+            if (!download(chunkIdxToDownload, m_nBlocksToDownload, region))
                 return 0;
-            }
-
-            if (!m_hasChanged) {
-                FileProperties props;
-                if (get_props_from_headers(m_ctx, m_handle, props)) {
-                    if (props.size != m_props.size ||
-                        props.lastModified != m_props.lastModified ||
-                        props.etag != m_props.etag) {
-                        gNetworkFileProperties.insert(m_ctx, m_url, props);
-                        gNetworkChunkCache.clearMemoryCache();
-                        m_hasChanged = true;
-                    }
-                }
-            }
-
-            region.resize(nRead);
-            m_lastDownloadedOffset = offsetToDownload + nRead;
-
-            const auto nChunks =
-                (region.size() + DOWNLOAD_CHUNK_SIZE - 1) / DOWNLOAD_CHUNK_SIZE;
-            for (size_t i = 0; i < nChunks; i++) {
-                std::vector<unsigned char> chunk(
-                    region.data() + i * DOWNLOAD_CHUNK_SIZE,
-                    region.data() +
-                        std::min((i + 1) * DOWNLOAD_CHUNK_SIZE, region.size()));
-                gNetworkChunkCache.insert(m_ctx, m_url, chunkIdxToDownload + i,
-                                          std::move(chunk));
-            }
+            m_lastDownloadedOffset = offsetToDownload + region.size();
         }
         const size_t nToCopy = static_cast<size_t>(
             std::min(static_cast<unsigned long long>(sizeBytes),
-                     region.size() - (iterOffset - offsetToDownload)));
-        memcpy(buffer, region.data() + iterOffset - offsetToDownload, nToCopy);
+                     pRegion->size() - (iterOffset - offsetToDownload)));
+        memcpy(buffer, pRegion->data() + iterOffset - offsetToDownload,
+               nToCopy);
         buffer = static_cast<char *>(buffer) + nToCopy;
         iterOffset += nToCopy;
         sizeBytes -= nToCopy;
-        if (region.size() < static_cast<size_t>(DOWNLOAD_CHUNK_SIZE) &&
+        if (pRegion->size() < static_cast<size_t>(DOWNLOAD_CHUNK_SIZE) &&
             sizeBytes != 0) {
             break;
         }
@@ -1457,6 +1720,77 @@ size_t NetworkFile::read(void *buffer, size_t sizeBytes) {
 
 // ---------------------------------------------------------------------------
 
+void NetworkFile::prefetch(
+    const std::vector<std::pair<unsigned long long, size_t>> &ranges) {
+    if (m_hasChanged)
+        return;
+
+    std::vector<unsigned long long> chunkIndices;
+    for (const auto &range : ranges) {
+        if (range.second == 0 || range.first >= m_props.size)
+            continue;
+        const auto first = range.first / DOWNLOAD_CHUNK_SIZE;
+        const auto last =
+            (range.first + range.second - 1) / DOWNLOAD_CHUNK_SIZE;
+        for (auto idx = first; idx <= last; ++idx) {
+            chunkIndices.push_back(idx);
+        }
+    }
+    std::sort(chunkIndices.begin(), chunkIndices.end());
+    chunkIndices.erase(std::unique(chunkIndices.begin(), chunkIndices.end()),
+                       chunkIndices.end());
+
+    // Only keep chunks that are not already cached, and do not fetch more
+    // than what the memory cache can hold.
+    std::vector<unsigned long long> missingChunks;
+    for (const auto idx : chunkIndices) {
+        if (!gNetworkChunkCache.get(m_ctx, m_url, idx)) {
+            missingChunks.push_back(idx);
+            if (missingChunks.size() == static_cast<size_t>(MAX_CHUNKS))
+                break;
+        }
+    }
+
+    // Coalesce missing chunks into runs, each fetched with a single range
+    // request. Small gaps between runs are downloaded too, as this is
+    // cheaper than an extra client/server roundtrip.
+    constexpr unsigned long long MAX_GAP_CHUNKS = 2;
+    const int lastErrno = proj_context_errno(m_ctx);
+    std::vector<unsigned char> region;
+    size_t i = 0;
+    while (i < missingChunks.size()) {
+        const auto firstChunkIdx = missingChunks[i];
+        auto lastChunkIdx = firstChunkIdx;
+        ++i;
+        while (i < missingChunks.size() &&
+               missingChunks[i] - lastChunkIdx <= MAX_GAP_CHUNKS + 1 &&
+               missingChunks[i] - firstChunkIdx <
+                   static_cast<unsigned long long>(MAX_CHUNKS)) {
+            lastChunkIdx = missingChunks[i];
+            ++i;
+        }
+        const auto nChunks =
+            static_cast<size_t>(lastChunkIdx - firstChunkIdx + 1);
+        if (!download(firstChunkIdx, nChunks, region) || m_hasChanged) {
+            // Errors will be reported by the actual read, if any.
+            proj_context_errno_set(m_ctx, lastErrno);
+            break;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+std::string NetworkFile::versionKey() const {
+    if (!m_props.etag.empty())
+        return m_props.etag;
+    if (!m_props.lastModified.empty())
+        return m_props.lastModified + '-' + std::to_string(m_props.size);
+    return std::string();
+}
+
+// ---------------------------------------------------------------------------
+
 bool NetworkFile::seek(unsigned long long offset, int whence) {
     if (whence == SEEK_SET) {
         m_pos = offset;
@@ -2019,6 +2353,7 @@ int proj_context_set_network_callbacks(
     ctx->networking.get_header_value = get_header_value_cbk;
     ctx->networking.read_range = read_range_cbk;
     ctx->networking.user_data = user_data;
+    ctx->settingsChanged();
     return true;
 }
 
@@ -2042,6 +2377,7 @@ int proj_context_set_enable_network(PJ_CONTEXT *ctx, int enable) {
     // Load ini file, now so as to override its network settings
     pj_load_ini(ctx);
     ctx->networking.enabled = enable != FALSE;
+    ctx->settingsChanged();
 #ifdef CURL_ENABLED
     return ctx->networking.enabled;
 #else
@@ -2084,6 +2420,7 @@ void proj_context_set_url_endpoint(PJ_CONTEXT *ctx, const char *url) {
     // Load ini file, now so as to override its network settings
     pj_load_ini(ctx);
     ctx->endpoint = url;
+    ctx->settingsChanged();
 }
 
 // ---------------------------------------------------------------------------
@@ -2103,6 +2440,7 @@ void proj_grid_cache_set_enable(PJ_CONTEXT *ctx, int enabled) {
     // Load ini file, now so as to override its settings
     pj_load_ini(ctx);
     ctx->gridChunkCache.enabled = enabled != FALSE;
+    ctx->settingsChanged();
 }
 
 // ---------------------------------------------------------------------------
@@ -2110,6 +2448,9 @@ void proj_grid_cache_set_enable(PJ_CONTEXT *ctx, int enabled) {
 /** Override, for the considered context, the path and file of the local
  * cache of grid chunks.
  *
+ * A file created by a PROJ version earlier than 9.6 has a different structure.
+ * It is not modified, and the cache is then disabled.
+ *
  * @param ctx PROJ context, or NULL
  * @param fullname Full name to the cache (encoded in UTF-8). If set to NULL,
  *                 caching will be disabled.
@@ -2122,6 +2463,7 @@ void proj_grid_cache_set_filename(PJ_CONTEXT *ctx, const char *fullname) {
     // Load ini file, now so as to override its settings
     pj_load_ini(ctx);
     ctx->gridChunkCache.filename = fullname ? fullname : std::string();
+    ctx->settingsChanged();
 }
 
 // ---------------------------------------------------------------------------
@@ -2150,6 +2492,7 @@ void proj_grid_cache_set_max_size(PJ_CONTEXT *ctx, int max_size_MB) {
             ctx->gridChunkCache.max_size = atoi(env_var);
         }
     }
+    ctx->settingsChanged();
 }
 
 // ---------------------------------------------------------------------------
@@ -2168,6 +2511,34 @@ void proj_grid_cache_set_ttl(PJ_CONTEXT *ctx, int ttl_seconds) {
     // Load ini file, now so as to override its settings
     pj_load_ini(ctx);
     ctx->gridChunkCache.ttl = ttl_seconds;
+    ctx->settingsChanged();
+}
+
+// ---------------------------------------------------------------------------
+
+/** Override, for the considered context, the maximum size of the cache of
+ * grid chunks shared by all processes of the host.
+ *
+ * This cache is stored in a memory-mapped file located next to the local
+ * cache of grid chunks (see proj_grid_cache_set_filename()), with a ".mmap"
+ * suffix. Its size is decided by the first process that creates it.
+ * It is only available on POSIX systems.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param max_size_MB Maximum size, in mega-bytes (1024*1024 bytes), or 0 to
+ *                    disable it (default).
+ * @since 9.6
+ */
+void proj_grid_cache_set_shared_memory_size(PJ_CONTEXT *ctx, int max_size_MB) {
+    if (ctx == nullptr) {
+        ctx = pj_get_default_ctx();
+    }
+    // Load ini file, now so as to override its settings
+    pj_load_ini(ctx);
+    ctx->gridChunkCache.shared_memory_max_size =
+        max_size_MB > 0 ? static_cast<long long>(max_size_MB) * 1024 * 1024
+                        : 0;
+    ctx->settingsChanged();
 }
 
 // ---------------------------------------------------------------------------
@@ -2181,6 +2552,9 @@ void proj_grid_cache_clear(PJ_CONTEXT *ctx) {
     if (ctx == nullptr) {
         ctx = pj_get_default_ctx();
     }
+    auto sharedCache = NS_PROJ::SharedChunkCache::open(ctx);
+    if (sharedCache)
+        sharedCache->invalidate();
     NS_PROJ::gNetworkChunkCache.clearDiskChunkCache(ctx);
 }
 
@@ -2238,7 +2612,7 @@ int proj_is_download_needed(PJ_CONTEXT *ctx, const char *url_or_filename,
     }
     f.reset();
 
-    auto diskCache = NS_PROJ::DiskChunkCache::open(ctx);
+    auto diskCache = NS_PROJ::DiskChunkCache::open(ctx, true);
     if (!diskCache)
         return false;
     auto stmt =
@@ -2482,7 +2856,7 @@ int proj_download_file(PJ_CONTEXT *ctx, const char *url_or_filename,
         return false;
     }
 
-    auto diskCache = NS_PROJ::DiskChunkCache::open(ctx);
+    auto diskCache = NS_PROJ::DiskChunkCache::open(ctx, true);
     if (!diskCache)
         return false;
     auto stmt =
@@ -2555,7 +2929,7 @@ std::string pj_context_get_grid_cache_filename(PJ_CONTEXT *ctx) {
         return ctx->gridChunkCache.filename;
     }
     const std::string path(proj_context_get_user_writable_directory(ctx, true));
-    ctx->gridChunkCache.filename = path + "/cache.db";
+    ctx->gridChunkCache.filename = path + '/' + NS_PROJ::CACHE_FILENAME;
     return ctx->gridChunkCache.filename;
 }
 
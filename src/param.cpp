@@ -9,6 +9,18 @@
 #include "proj.h"
 #include "proj_internal.h"
 
+/* FNV-1a hash of the first len characters of a parameter name. Each list
+ * entry stores the hash of its name, so that pj_param_exists() only has to
+ * compare the strings of the entries whose hash matches. */
+static unsigned int param_key_hash(const char *key, size_t len) {
+    unsigned int hash = 2166136261U;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= static_cast<unsigned char>(key[i]);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
 /* create parameter list entry */
 paralist *pj_mkparam(const char *str) {
     paralist *newitem;
@@ -20,6 +32,8 @@ paralist *pj_mkparam(const char *str) {
         if (*str == '+')
             ++str;
         (void)strcpy(newitem->param, str);
+        newitem->key_hash =
+            param_key_hash(newitem->param, strcspn(newitem->param, "="));
     }
     return newitem;
 }
@@ -64,6 +78,8 @@ paralist *pj_mkparam_ws(const char *str, const char **next_str) {
 
     newitem->used = 0;
     newitem->next = nullptr;
+    newitem->key_hash =
+        param_key_hash(newitem->param, strcspn(newitem->param, "="));
 
     return newitem;
 }
@@ -86,20 +102,21 @@ paralist *pj_param_exists(paralist *list, const char *parameter) {
     obviously not an issue).
     ***************************************************************************************/
     paralist *next = list;
-    const char *c = strchr(parameter, '=');
-    size_t len = strlen(parameter);
-    if (c)
-        len = c - parameter;
     if (list == nullptr)
         return nullptr;
 
+    const size_t len = strcspn(parameter, "=");
+    const unsigned int hash = param_key_hash(parameter, len);
+    const bool isStep = 0 == strcmp(parameter, "step");
+
     for (next = list; next; next = next->next) {
-        if (0 == strncmp(parameter, next->param, len) &&
+        if (next->key_hash == hash &&
+            0 == strncmp(parameter, next->param, len) &&
             (next->param[len] == '=' || next->param[len] == 0)) {
             next->used = 1;
             return next;
         }
-        if (0 == strcmp(parameter, "step"))
+        if (isStep)
             return nullptr;
     }
 
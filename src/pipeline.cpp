@@ -137,6 +137,9 @@ struct Pipeline {
     char **current_argv = nullptr;
     std::vector<Step> steps{};
     std::stack<double> stack[4];
+    // Used by push/pop when the pipeline runs over arrays of coordinates:
+    // each entry holds the saved value of all the points of the array.
+    std::stack<std::vector<double>> stack_n[4];
 };
 
 struct PushPop {
@@ -149,6 +152,8 @@ struct PushPop {
 
 static void pipeline_forward_4d(PJ_COORD &point, PJ *P);
 static void pipeline_reverse_4d(PJ_COORD &point, PJ *P);
+static void pipeline_forward_4d_n(PJ_COORD *coo, size_t n, PJ *P);
+static void pipeline_reverse_4d_n(PJ_COORD *coo, size_t n, PJ *P);
 static PJ_XYZ pipeline_forward_3d(PJ_LPZ lpz, PJ *P);
 static PJ_LPZ pipeline_reverse_3d(PJ_XYZ xyz, PJ *P);
 static PJ_XY pipeline_forward(PJ_LP lp, PJ *P);
@@ -160,6 +165,15 @@ static void pipeline_reassign_context(PJ *P, PJ_CONTEXT *ctx) {
         proj_assign_context(step.pj, ctx);
 }
 
+static void pipeline_prepare_for_area(PJ *P, double west, double south,
+                                      double east, double north) {
+    auto pipeline = static_cast<struct Pipeline *>(P->opaque);
+    for (auto &step : pipeline->steps) {
+        if (step.pj->prepare_for_area)
+            step.pj->prepare_for_area(step.pj, west, south, east, north);
+    }
+}
+
 static void pipeline_forward_4d(PJ_COORD &point, PJ *P) {
     auto pipeline = static_cast<struct Pipeline *>(P->opaque);
     for (auto &step : pipeline->steps) {
@@ -192,6 +206,34 @@ static void pipeline_reverse_4d(PJ_COORD &point, PJ *P) {
     }
 }
 
+/* Run the pipeline step by step over the whole array, rather than point by */
+/* point. Points that fail in a step are skipped by the following ones.     */
+static void pipeline_forward_4d_n(PJ_COORD *coo, size_t n, PJ *P) {
+    auto pipeline = static_cast<struct Pipeline *>(P->opaque);
+    for (auto &step : pipeline->steps) {
+        if (!step.omit_fwd) {
+            if (!step.pj->inverted)
+                pj_fwd4d_n(coo, n, step.pj);
+            else
+                pj_inv4d_n(coo, n, step.pj);
+        }
+    }
+}
+
+static void pipeline_reverse_4d_n(PJ_COORD *coo, size_t n, PJ *P) {
+    auto pipeline = static_cast<struct Pipeline *>(P->opaque);
+    for (auto iterStep = pipeline->steps.rbegin();
+         iterStep != pipeline->steps.rend(); ++iterStep) {
+        const auto &step = *iterStep;
+        if (!step.omit_inv) {
+            if (step.pj->inverted)
+                pj_fwd4d_n(coo, n, step.pj);
+            else
+                pj_inv4d_n(coo, n, step.pj);
+        }
+    }
+}
+
 static PJ_XYZ pipeline_forward_3d(PJ_LPZ lpz, PJ *P) {
     PJ_COORD point = {{0, 0, 0, 0}};
     point.lpz = lpz;
@@ -381,12 +423,15 @@ PJ *OPERATION(pipeline, 0) {
 
     P->fwd4d = pipeline_forward_4d;
     P->inv4d = pipeline_reverse_4d;
+    P->fwd4d_n = pipeline_forward_4d_n;
+    P->inv4d_n = pipeline_reverse_4d_n;
     P->fwd3d = pipeline_forward_3d;
     P->inv3d = pipeline_reverse_3d;
     P->fwd = pipeline_forward;
     P->inv = pipeline_reverse;
     P->destructor = destructor;
     P->reassign_context = pipeline_reassign_context;
+    P->prepare_for_area = pipeline_prepare_for_area;
 
     /* Currently, the pipeline driver is a raw bit mover, enabling other
      * operations */
@@ -564,6 +609,7 @@ PJ *OPERATION(pipeline, 0) {
             P->inv = nullptr;
             P->inv3d = nullptr;
             P->inv4d = nullptr;
+            P->inv4d_n = nullptr;
             break;
         }
     }
@@ -685,6 +731,46 @@ static void pop(PJ_COORD &point, PJ *P) {
     }
 }
 
+static void push_n(PJ_COORD *coo, size_t n, PJ *P) {
+    if (P->parent == nullptr)
+        return;
+
+    struct Pipeline *pipeline =
+        static_cast<struct Pipeline *>(P->parent->opaque);
+    struct PushPop *pushpop = static_cast<struct PushPop *>(P->opaque);
+
+    const bool v[4] = {pushpop->v1, pushpop->v2, pushpop->v3, pushpop->v4};
+    for (int k = 0; k < 4; k++) {
+        if (!v[k])
+            continue;
+        std::vector<double> values(n);
+        for (size_t i = 0; i < n; i++)
+            values[i] = coo[i].v[k];
+        pipeline->stack_n[k].push(std::move(values));
+    }
+}
+
+static void pop_n(PJ_COORD *coo, size_t n, PJ *P) {
+    if (P->parent == nullptr)
+        return;
+
+    struct Pipeline *pipeline =
+        static_cast<struct Pipeline *>(P->parent->opaque);
+    struct PushPop *pushpop = static_cast<struct PushPop *>(P->opaque);
+
+    const bool v[4] = {pushpop->v1, pushpop->v2, pushpop->v3, pushpop->v4};
+    for (int k = 0; k < 4; k++) {
+        if (!v[k] || pipeline->stack_n[k].empty())
+            continue;
+        const auto &values = pipeline->stack_n[k].top();
+        for (size_t i = 0; i < n && i < values.size(); i++) {
+            if (coo[i].v[0] != HUGE_VAL)
+                coo[i].v[k] = values[i];
+        }
+        pipeline->stack_n[k].pop();
+    }
+}
+
 static PJ *setup_pushpop(PJ *P) {
     auto pushpop =
         static_cast<struct PushPop *>(calloc(1, sizeof(struct PushPop)));
@@ -713,6 +799,8 @@ static PJ *setup_pushpop(PJ *P) {
 PJ *OPERATION(push, 0) {
     P->fwd4d = push;
     P->inv4d = pop;
+    P->fwd4d_n = push_n;
+    P->inv4d_n = pop_n;
 
     return setup_pushpop(P);
 }
@@ -720,6 +808,8 @@ PJ *OPERATION(push, 0) {
 PJ *OPERATION(pop, 0) {
     P->inv4d = push;
     P->fwd4d = pop;
+    P->inv4d_n = push_n;
+    P->fwd4d_n = pop_n;
 
     return setup_pushpop(P);
 }
@@ -576,8 +576,27 @@ void PROJ_DLL proj_grid_cache_set_max_size(PJ_CONTEXT *ctx, int max_size_MB);
 
 void PROJ_DLL proj_grid_cache_set_ttl(PJ_CONTEXT *ctx, int ttl_seconds);
 
+void PROJ_DLL proj_grid_cache_set_shared_memory_size(PJ_CONTEXT *ctx,
+                                                     int max_size_MB);
+
 void PROJ_DLL proj_grid_cache_clear(PJ_CONTEXT *ctx);
 
+void PROJ_DLL proj_context_set_tiff_block_cache_max_size(PJ_CONTEXT *ctx,
+                                                         int max_size_MB);
+
+void PROJ_DLL proj_context_get_tiff_block_cache_stats(
+    PJ_CONTEXT *ctx, unsigned long long *out_hits,
+    unsigned long long *out_misses);
+
+void PROJ_DLL proj_context_set_load_grids_in_memory(PJ_CONTEXT *ctx,
+                                                    int enabled);
+
+void PROJ_DLL proj_context_set_crs_to_crs_cache_enable(PJ_CONTEXT *ctx,
+                                                       int enabled);
+
+void PROJ_DLL proj_context_set_decoded_grid_cache_enable(PJ_CONTEXT *ctx,
+                                                         int enabled);
+
 int PROJ_DLL proj_is_download_needed(PJ_CONTEXT *ctx,
                                      const char *url_or_filename,
                                      int ignore_ttl_setting);
@@ -600,6 +619,10 @@ PJ PROJ_DLL *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx,
                                             const char *const *options);
 /*! @endcond */
 PJ PROJ_DLL *proj_normalize_for_visualization(PJ_CONTEXT *ctx, const PJ *obj);
+const char PROJ_DLL *proj_as_compiled(PJ_CONTEXT *ctx, const PJ *obj,
+                                      const char *const *options);
+PJ PROJ_DLL *proj_create_from_compiled(PJ_CONTEXT *ctx, const char *compiled,
+                                       const char *const *options);
 /*! @cond Doxygen_Suppress */
 void PROJ_DLL proj_assign_context(PJ *pj, PJ_CONTEXT *ctx);
 PJ PROJ_DLL *proj_destroy(PJ *P);
@@ -634,6 +657,16 @@ size_t PROJ_DLL proj_trans_generic(PJ *P, PJ_DIRECTION direction, double *x,
                                    size_t sx, size_t nx, double *y, size_t sy,
                                    size_t ny, double *z, size_t sz, size_t nz,
                                    double *t, size_t st, size_t nt);
+int PROJ_DLL proj_trans_array_parallel(PJ *P, PJ_DIRECTION direction, size_t n,
+                                       PJ_COORD *coord, int thread_count);
+size_t PROJ_DLL proj_trans_generic_parallel(
+    PJ *P, PJ_DIRECTION direction, double *x, size_t sx, size_t nx, double *y,
+    size_t sy, size_t ny, double *z, size_t sz, size_t nz, double *t, size_t st,
+    size_t nt, int thread_count);
+int PROJ_DLL proj_prepare_for_area(PJ *P, double west_lon_degree,
+                                   double south_lat_degree,
+                                   double east_lon_degree,
+                                   double north_lat_degree);
 /*! @endcond */
 int PROJ_DLL proj_trans_bounds(PJ_CONTEXT *context, PJ *P,
                                PJ_DIRECTION direction, double xmin, double ymin,
@@ -1155,6 +1188,14 @@ int PROJ_DLL proj_context_set_database_path(PJ_CONTEXT *ctx, const char *dbPath,
 
 const char PROJ_DLL *proj_context_get_database_path(PJ_CONTEXT *ctx);
 
+void PROJ_DLL proj_context_set_object_cache_size(PJ_CONTEXT *ctx, int size);
+
+void PROJ_DLL proj_context_set_shared_object_cache_size(PJ_CONTEXT *ctx,
+                                                        int size);
+
+int PROJ_DLL proj_context_set_database_open_mode(PJ_CONTEXT *ctx,
+                                                 const char *mode);
+
 const char PROJ_DLL *proj_context_get_database_metadata(PJ_CONTEXT *ctx,
                                                         const char *key);
 
@@ -1369,6 +1410,9 @@ void PROJ_DLL proj_operation_factory_context_set_discard_superseded(
 void PROJ_DLL proj_operation_factory_context_set_allow_ballpark_transformations(
     PJ_CONTEXT *ctx, PJ_OPERATION_FACTORY_CONTEXT *factory_ctx, int allow);
 
+void PROJ_DLL proj_operation_factory_context_set_thread_count(
+    PJ_CONTEXT *ctx, PJ_OPERATION_FACTORY_CONTEXT *factory_ctx, int count);
+
 /* ------------------------------------------------------------------------- */
 
 PJ_OBJ_LIST PROJ_DLL *
@@ -76,6 +76,7 @@
 #include "proj/common.hpp"
 #include "proj/coordinateoperation.hpp"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -214,6 +215,8 @@ proj_context_delete_cpp_context(struct projCppContext *cppContext);
 
 bool pj_fwd4d(PJ_COORD &coo, PJ *P);
 bool pj_inv4d(PJ_COORD &coo, PJ *P);
+void pj_fwd4d_n(PJ_COORD *coo, size_t n, PJ *P);
+void pj_inv4d_n(PJ_COORD *coo, size_t n, PJ *P);
 
 PJ_COORD PROJ_DLL pj_approx_2D_trans(PJ *P, PJ_DIRECTION direction,
                                      PJ_COORD coo);
@@ -302,10 +305,71 @@ PJ_OPERATOR:
     A function taking a reference to a PJ_COORD and a pointer-to-PJ as args,
 applying the PJ to the PJ_COORD, and modifying in-place the passed PJ_COORD.
 
+PJ_OPERATOR_N:
+
+    The array counterpart of PJ_OPERATOR: a function taking a pointer to n
+consecutive PJ_COORD, n and a pointer-to-PJ as args, and applying the PJ
+in-place to each of them. Coordinates whose x component is HUGE_VAL are
+failed points and must be left untouched. Other points must get the same
+result as with the corresponding scalar operator, and failures must be
+reported as with it, by setting the point to HUGE_VAL and the context errno.
+
 *****************************************************************************/
 typedef PJ *(*PJ_CONSTRUCTOR)(PJ *);
 typedef PJ *(*PJ_DESTRUCTOR)(PJ *, int);
 typedef void (*PJ_OPERATOR)(PJ_COORD &, PJ *);
+typedef void (*PJ_OPERATOR_N)(PJ_COORD *, size_t, PJ *);
+
+/* Build a PJ_OPERATOR_N out of the scalar operator of a PJ, with the scalar */
+/* operator inlined in the loop. The variant must match the operator that */
+/* pj_fwd4d() / pj_inv4d() would pick: 4D, 3D or 2D. */
+template <void (*op)(PJ_COORD &, PJ *)>
+void pj_operator_n_from_4d(PJ_COORD *coo, size_t n, PJ *P) {
+    for (size_t i = 0; i < n; i++) {
+        if (coo[i].xyzt.x != HUGE_VAL)
+            op(coo[i], P);
+    }
+}
+
+template <PJ_XYZ (*op)(PJ_LPZ, PJ *)>
+void pj_operator_n_from_fwd3d(PJ_COORD *coo, size_t n, PJ *P) {
+    for (size_t i = 0; i < n; i++) {
+        if (coo[i].xyzt.x != HUGE_VAL) {
+            const auto xyz = op(coo[i].lpz, P);
+            coo[i].xyz = xyz;
+        }
+    }
+}
+
+template <PJ_LPZ (*op)(PJ_XYZ, PJ *)>
+void pj_operator_n_from_inv3d(PJ_COORD *coo, size_t n, PJ *P) {
+    for (size_t i = 0; i < n; i++) {
+        if (coo[i].xyzt.x != HUGE_VAL) {
+            const auto lpz = op(coo[i].xyz, P);
+            coo[i].lpz = lpz;
+        }
+    }
+}
+
+template <PJ_XY (*op)(PJ_LP, PJ *)>
+void pj_operator_n_from_fwd(PJ_COORD *coo, size_t n, PJ *P) {
+    for (size_t i = 0; i < n; i++) {
+        if (coo[i].xyzt.x != HUGE_VAL) {
+            const auto xy = op(coo[i].lp, P);
+            coo[i].xy = xy;
+        }
+    }
+}
+
+template <PJ_LP (*op)(PJ_XY, PJ *)>
+void pj_operator_n_from_inv(PJ_COORD *coo, size_t n, PJ *P) {
+    for (size_t i = 0; i < n; i++) {
+        if (coo[i].xyzt.x != HUGE_VAL) {
+            const auto lp = op(coo[i].xy, P);
+            coo[i].lp = lp;
+        }
+    }
+}
 /****************************************************************************/
 
 /* datum_type values */
@@ -315,6 +379,23 @@ typedef void (*PJ_OPERATOR)(PJ_COORD &, PJ *);
 #define PJD_GRIDSHIFT 3
 #define PJD_WGS84 4 /* WGS84 (or anything considered equivalent) */
 
+struct PJCoordOperationIndex;
+
+/* Clones of a PJ, each one attached to its own context, used to transform
+ * coordinates in several threads by proj_trans_array_parallel() and
+ * proj_trans_generic_parallel() */
+struct PJParallelWorkers {
+    // pj_ctx::settingsGeneration of the context of the PJ when the clones
+    // were created
+    unsigned long long srcCtxGeneration = 0;
+    std::vector<std::pair<PJ_CONTEXT *, PJ *>> workers{};
+
+    PJParallelWorkers() = default;
+    PJParallelWorkers(const PJParallelWorkers &) = delete;
+    PJParallelWorkers &operator=(const PJParallelWorkers &) = delete;
+    ~PJParallelWorkers();
+};
+
 struct PJCoordOperation {
   public:
     int idxInOriginalList;
@@ -362,6 +443,11 @@ struct PJCoordOperation {
     // geographic ones in lon, lat order
     PJ *pjDstGeocentricToLonLat = nullptr;
 
+    // false if pj has been created with pj_obj_create_uninstantiated(), and
+    // thus only holds the ISO-19111 object of the operation. instantiate()
+    // must then be called before using it to transform coordinates.
+    bool isInstantiated = true;
+
     PJCoordOperation(int idxInOriginalListIn, double minxSrcIn,
                      double minySrcIn, double maxxSrcIn, double maxySrcIn,
                      double minxDstIn, double minyDstIn, double maxxDstIn,
@@ -372,29 +458,7 @@ struct PJCoordOperation {
 
     PJCoordOperation(const PJCoordOperation &) = delete;
 
-    PJCoordOperation(PJ_CONTEXT *ctx, const PJCoordOperation &other)
-        : idxInOriginalList(other.idxInOriginalList), minxSrc(other.minxSrc),
-          minySrc(other.minySrc), maxxSrc(other.maxxSrc),
-          maxySrc(other.maxySrc), minxDst(other.minxDst),
-          minyDst(other.minyDst), maxxDst(other.maxxDst),
-          maxyDst(other.maxyDst), pj(proj_clone(ctx, other.pj)),
-          name(std::move(other.name)), accuracy(other.accuracy),
-          pseudoArea(other.pseudoArea), areaName(other.areaName),
-          isOffshore(other.isOffshore),
-          isUnknownAreaName(other.isUnknownAreaName),
-          isPriorityOp(other.isPriorityOp),
-          srcIsLonLatDegree(other.srcIsLonLatDegree),
-          srcIsLatLonDegree(other.srcIsLatLonDegree),
-          dstIsLonLatDegree(other.dstIsLonLatDegree),
-          dstIsLatLonDegree(other.dstIsLatLonDegree),
-          pjSrcGeocentricToLonLat(
-              other.pjSrcGeocentricToLonLat
-                  ? proj_clone(ctx, other.pjSrcGeocentricToLonLat)
-                  : nullptr),
-          pjDstGeocentricToLonLat(
-              other.pjDstGeocentricToLonLat
-                  ? proj_clone(ctx, other.pjDstGeocentricToLonLat)
-                  : nullptr) {}
+    PJCoordOperation(PJ_CONTEXT *ctx, const PJCoordOperation &other);
 
     PJCoordOperation(PJCoordOperation &&other)
         : idxInOriginalList(other.idxInOriginalList), minxSrc(other.minxSrc),
@@ -409,7 +473,8 @@ struct PJCoordOperation {
           srcIsLonLatDegree(other.srcIsLonLatDegree),
           srcIsLatLonDegree(other.srcIsLatLonDegree),
           dstIsLonLatDegree(other.dstIsLonLatDegree),
-          dstIsLatLonDegree(other.dstIsLatLonDegree) {
+          dstIsLatLonDegree(other.dstIsLatLonDegree),
+          isInstantiated(other.isInstantiated) {
         pj = other.pj;
         other.pj = nullptr;
         pjSrcGeocentricToLonLat = other.pjSrcGeocentricToLonLat;
@@ -439,6 +504,9 @@ struct PJCoordOperation {
 
     bool isInstantiable() const;
 
+    // Instantiate pj if needed, and return it.
+    PJ *instantiate();
+
   private:
     static constexpr int INSTANTIABLE_STATUS_UNKNOWN =
         -1; // must be different from 0(=false) and 1(=true)
@@ -452,6 +520,13 @@ enum class TMercAlgo {
     PODER_ENGSAGER,
 };
 
+enum class DatabaseOpenMode {
+    DEFAULT,   // regular read-only file access
+    IMMUTABLE, // file assumed not to change: no locking nor change detection
+    MMAP,      // immutable, and pages accessed through a memory mapping
+    MEMORY,    // whole content loaded in memory
+};
+
 /* base projection data structure */
 struct PJconsts {
 
@@ -509,9 +584,19 @@ struct PJconsts {
     PJ_OPERATOR fwd4d = nullptr;
     PJ_OPERATOR inv4d = nullptr;
 
+    /* Optional array versions of the above, used by pj_fwd4d_n() and */
+    /* pj_inv4d_n(). When not set, those loop over the scalar versions. */
+    PJ_OPERATOR_N fwd4d_n = nullptr;
+    PJ_OPERATOR_N inv4d_n = nullptr;
+
     PJ_DESTRUCTOR destructor = nullptr;
     void (*reassign_context)(PJ *, PJ_CONTEXT *) = nullptr;
 
+    /* Optional, called by proj_prepare_for_area() to load the resources */
+    /* needed within the specified longitude/latitude extent, in radians */
+    void (*prepare_for_area)(PJ *, double west, double south, double east,
+                             double north) = nullptr;
+
     /*************************************************************************************
 
                           E L L I P S O I D     P A R A M E T E R S
@@ -654,11 +739,15 @@ struct PJconsts {
     bool iso_obj_is_coordinate_operation = false;
     double coordinateEpoch = 0;
     bool hasCoordinateEpoch = false;
+    // true if created from a compiled transformation, in which case
+    // lastCompiled holds it, and the object is cloned from it.
+    bool createdFromCompiled = false;
 
     // cached results
     mutable std::string lastWKT{};
     mutable std::string lastPROJString{};
     mutable std::string lastJSONString{};
+    mutable std::string lastCompiled{};
     mutable bool gridsNeededAsked = false;
     mutable std::vector<NS_PROJ::operation::GridDescription> gridsNeeded{};
 
@@ -669,7 +758,13 @@ struct PJconsts {
      proj_create_crs_to_crs() alternative coordinate operations
     **************************************************************************************/
     std::vector<PJCoordOperation> alternativeCoordinateOperations{};
+    // spatial index over the areas of use of alternativeCoordinateOperations
+    // (may be null for short lists)
+    std::shared_ptr<const PJCoordOperationIndex>
+        alternativeCoordinateOperationsIndex{};
     int iCurCoordOp = -1;
+    // lazily created by proj_trans_xxxx_parallel()
+    std::unique_ptr<PJParallelWorkers> parallelWorkers{};
     bool errorIfBestTransformationNotAvailable = false;
     bool warnIfBestTransformationNotAvailable =
         true; /* to remove in PROJ 10? */
@@ -689,6 +784,7 @@ struct PJconsts {
 /* Parameter list (a copy of the +proj=... etc. parameters) */
 struct ARG_list {
     paralist *next;
+    unsigned int key_hash; /* hash of the parameter name, before any '=' */
     char used;
 #if (defined(__GNUC__) && __GNUC__ >= 8) ||                                    \
     (defined(__clang__) && __clang_major__ >= 9)
@@ -748,6 +844,8 @@ struct projGridChunkCache {
     std::string filename{};
     long long max_size = 300 * 1024 * 1024;
     int ttl = 86400; // 1 day
+    // Maximum size of the cache shared between processes. 0 = disabled
+    long long shared_memory_max_size = 0;
 };
 
 struct projFileApiCallbackAndData {
@@ -805,6 +903,11 @@ struct pj_ctx {
 
     bool defer_grid_opening = false; // set transiently by pj_obj_create()
 
+    // Changed, to a value unique in the process, each time the context is
+    // created or one of its settings is modified through the API, so that
+    // objects derived from it can detect that they are out of date.
+    unsigned long long settingsGeneration = newSettingsGeneration();
+
     projFileApiCallbackAndData fileApi{};
     std::string custom_sqlite3_vfs_name{};
     std::string user_writable_directory{};
@@ -817,6 +920,14 @@ struct pj_ctx {
     projGridChunkCache gridChunkCache{};
     TMercAlgo defaultTmercAlgo =
         TMercAlgo::PODER_ENGSAGER; // can be overridden by content of proj.ini
+    bool loadGridsInMemory = false;
+    bool decodedGridCache = false;
+    // Number of objects of each type cached by a database context
+    int objectCacheSize = 128;
+    // Number of objects cached for the whole process. 0 = disabled
+    int sharedObjectCacheSize = 0;
+    bool crsToCrsCache = false;
+    DatabaseOpenMode databaseOpenMode = DatabaseOpenMode::DEFAULT;
     // END ini file settings
 
     int projStringParserCreateFromPROJStringRecursionCounter =
@@ -834,8 +945,10 @@ struct pj_ctx {
     projCppContext *get_cpp_context();
     void set_search_paths(const std::vector<std::string> &search_paths_in);
     void set_ca_bundle_path(const std::string &ca_bundle_path_in);
+    void settingsChanged() { settingsGeneration = newSettingsGeneration(); }
 
     static pj_ctx createDefault();
+    static unsigned long long newSettingsGeneration();
 };
 
 #ifndef DO_NOT_DEFINE_PROJ_HEAD
@@ -946,6 +1059,8 @@ PJ *pj_create_argv_internal(PJ_CONTEXT *ctx, int argc, char **argv);
 // For use by projinfo
 void pj_load_ini(PJ_CONTEXT *ctx);
 
+bool pj_parse_database_open_mode(const char *value, DatabaseOpenMode &mode);
+
 // Exported for testing purposes only
 std::string PROJ_DLL pj_context_get_grid_cache_filename(PJ_CONTEXT *ctx);
 
@@ -954,11 +1069,17 @@ std::string PROJ_DLL pj_get_relative_share_proj(PJ_CONTEXT *ctx);
 
 std::vector<PJCoordOperation>
 pj_create_prepared_operations(PJ_CONTEXT *ctx, const PJ *source_crs,
-                              const PJ *target_crs, PJ_OBJ_LIST *op_list);
+                              const PJ *target_crs, PJ_OBJ_LIST *op_list,
+                              bool lazyInstantiation = false);
+
+std::shared_ptr<const PJCoordOperationIndex>
+pj_create_coord_operation_index(const std::vector<PJCoordOperation> &opList);
 
 int pj_get_suggested_operation(PJ_CONTEXT *ctx,
                                const std::vector<PJCoordOperation> &opList,
-                               const int iExcluded[2], bool skipNonInstantiable,
+                               const PJCoordOperationIndex *opIndex,
+                               int iHint, const int iExcluded[2],
+                               bool skipNonInstantiable,
                                PJ_DIRECTION direction, PJ_COORD coord);
 
 const PJ_UNITS *pj_list_linear_units();
@@ -975,6 +1096,12 @@ PJ_LP pj_generic_inverse_2d(PJ_XY xy, PJ *P, PJ_LP lpInitial,
 
 PJ *pj_obj_create(PJ_CONTEXT *ctx, const NS_PROJ::util::BaseObjectNNPtr &objIn);
 
+PJ *pj_obj_create_uninstantiated(PJ_CONTEXT *ctx,
+                                 const NS_PROJ::util::BaseObjectNNPtr &objIn);
+
+PJ *pj_list_get_uninstantiated(PJ_CONTEXT *ctx, const PJ_OBJ_LIST *result,
+                               int index);
+
 /*****************************************************************************/
 /*                                                                           */
 /*                              proj_api.h                                   */
@@ -31,6 +31,7 @@
 #define proj_area_destroy internal_proj_area_destroy
 #define proj_area_set_bbox internal_proj_area_set_bbox
 #define proj_area_set_name internal_proj_area_set_name
+#define proj_as_compiled internal_proj_as_compiled
 #define proj_as_projjson internal_proj_as_projjson
 #define proj_as_proj_string internal_proj_as_proj_string
 #define proj_assign_context internal_proj_assign_context
@@ -52,6 +53,8 @@
 #define proj_context_get_database_path internal_proj_context_get_database_path
 #define proj_context_get_database_structure                                    \
     internal_proj_context_get_database_structure
+#define proj_context_get_tiff_block_cache_stats                                \
+    internal_proj_context_get_tiff_block_cache_stats
 #define proj_context_get_url_endpoint internal_proj_context_get_url_endpoint
 #define proj_context_get_use_proj4_init_rules                                  \
     internal_proj_context_get_use_proj4_init_rules
@@ -62,15 +65,29 @@
 #define proj_context_set_autoclose_database                                    \
     internal_proj_context_set_autoclose_database
 #define proj_context_set_ca_bundle_path internal_proj_context_set_ca_bundle_path
+#define proj_context_set_crs_to_crs_cache_enable                               \
+    internal_proj_context_set_crs_to_crs_cache_enable
+#define proj_context_set_database_open_mode                                    \
+    internal_proj_context_set_database_open_mode
 #define proj_context_set_database_path internal_proj_context_set_database_path
+#define proj_context_set_decoded_grid_cache_enable                             \
+    internal_proj_context_set_decoded_grid_cache_enable
 #define proj_context_set_enable_network internal_proj_context_set_enable_network
 #define proj_context_set_fileapi internal_proj_context_set_fileapi
 #define proj_context_set_file_finder internal_proj_context_set_file_finder
+#define proj_context_set_load_grids_in_memory                                  \
+    internal_proj_context_set_load_grids_in_memory
 #define proj_context_set_network_callbacks                                     \
     internal_proj_context_set_network_callbacks
+#define proj_context_set_object_cache_size                                     \
+    internal_proj_context_set_object_cache_size
 #define proj_context_set_search_paths internal_proj_context_set_search_paths
+#define proj_context_set_shared_object_cache_size                              \
+    internal_proj_context_set_shared_object_cache_size
 #define proj_context_set_sqlite3_vfs_name                                      \
     internal_proj_context_set_sqlite3_vfs_name
+#define proj_context_set_tiff_block_cache_max_size                             \
+    internal_proj_context_set_tiff_block_cache_max_size
 #define proj_context_set_url_endpoint internal_proj_context_set_url_endpoint
 #define proj_context_set_user_writable_directory                               \
     internal_proj_context_set_user_writable_directory
@@ -250,6 +267,7 @@
 #define proj_create_ellipsoidal_2D_cs internal_proj_create_ellipsoidal_2D_cs
 #define proj_create_ellipsoidal_3D_cs internal_proj_create_ellipsoidal_3D_cs
 #define proj_create_engineering_crs internal_proj_create_engineering_crs
+#define proj_create_from_compiled internal_proj_create_from_compiled
 #define proj_create_from_database internal_proj_create_from_database
 #define proj_create_from_name internal_proj_create_from_name
 #define proj_create_from_wkt internal_proj_create_from_wkt
@@ -351,6 +369,8 @@
 #define proj_grid_cache_set_enable internal_proj_grid_cache_set_enable
 #define proj_grid_cache_set_filename internal_proj_grid_cache_set_filename
 #define proj_grid_cache_set_max_size internal_proj_grid_cache_set_max_size
+#define proj_grid_cache_set_shared_memory_size                                 \
+    internal_proj_grid_cache_set_shared_memory_size
 #define proj_grid_cache_set_ttl internal_proj_grid_cache_set_ttl
 #define proj_grid_get_info_from_database                                       \
     internal_proj_grid_get_info_from_database
@@ -405,9 +425,12 @@
     internal_proj_operation_factory_context_set_grid_availability_use
 #define proj_operation_factory_context_set_spatial_criterion                   \
     internal_proj_operation_factory_context_set_spatial_criterion
+#define proj_operation_factory_context_set_thread_count                        \
+    internal_proj_operation_factory_context_set_thread_count
 #define proj_operation_factory_context_set_use_proj_alternative_grid_names     \
     internal_proj_operation_factory_context_set_use_proj_alternative_grid_names
 #define proj_pj_info internal_proj_pj_info
+#define proj_prepare_for_area internal_proj_prepare_for_area
 #define proj_prime_meridian_get_parameters                                     \
     internal_proj_prime_meridian_get_parameters
 #define proj_query_geodetic_crs_from_datum                                     \
@@ -422,8 +445,10 @@
 #define proj_torad internal_proj_torad
 #define proj_trans internal_proj_trans
 #define proj_trans_array internal_proj_trans_array
+#define proj_trans_array_parallel internal_proj_trans_array_parallel
 #define proj_trans_bounds internal_proj_trans_bounds
 #define proj_trans_generic internal_proj_trans_generic
+#define proj_trans_generic_parallel internal_proj_trans_generic_parallel
 #define proj_trans_get_last_used_operation                                     \
     internal_proj_trans_get_last_used_operation
 #define proj_unit_list_destroy internal_proj_unit_list_destroy
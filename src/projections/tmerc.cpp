@@ -484,6 +484,241 @@ static PJ_LP exact_e_inv(PJ_XY xy, PJ *P) {
     return lp;
 }
 
+/*
+ * Batch variants of the "exact" transverse mercator, operating on up to
+ * TMERC_BATCH_SIZE points at once. The transcendental functions are still
+ * evaluated point per point, but the Clenshaw summations, which dominate the
+ * cost, are evaluated with the loop over the points of the batch being the
+ * innermost one, which lets the compiler vectorize it. The operations are
+ * done in the same order as in the single point functions, so that results
+ * are strictly identical.
+ */
+#define TMERC_BATCH_SIZE 8
+
+static void gatg_batch(const double *p1, int count, double *B,
+                       const double *cos_2B, const double *sin_2B) {
+    double h[TMERC_BATCH_SIZE], h1[TMERC_BATCH_SIZE], h2[TMERC_BATCH_SIZE];
+    double two_cos_2B[TMERC_BATCH_SIZE];
+    for (int k = 0; k < count; k++) {
+        h[k] = 0;
+        h1[k] = p1[PROJ_ETMERC_ORDER - 1];
+        h2[k] = 0;
+        two_cos_2B[k] = 2 * cos_2B[k];
+    }
+    for (int j = PROJ_ETMERC_ORDER - 2; j >= 0; j--) {
+        const double p = p1[j];
+        for (int k = 0; k < count; k++) {
+            h[k] = -h2[k] + two_cos_2B[k] * h1[k] + p;
+            h2[k] = h1[k];
+            h1[k] = h[k];
+        }
+    }
+    for (int k = 0; k < count; k++)
+        B[k] = B[k] + h[k] * sin_2B[k];
+}
+
+static void clenS_batch(const double *a, int count, const double *sin_arg_r,
+                        const double *cos_arg_r, const double *sinh_arg_i,
+                        const double *cosh_arg_i, double *R, double *I) {
+    double r[TMERC_BATCH_SIZE], i[TMERC_BATCH_SIZE];
+    double hr[TMERC_BATCH_SIZE], hr1[TMERC_BATCH_SIZE], hr2[TMERC_BATCH_SIZE];
+    double hi[TMERC_BATCH_SIZE], hi1[TMERC_BATCH_SIZE], hi2[TMERC_BATCH_SIZE];
+    for (int k = 0; k < count; k++) {
+        r[k] = 2 * cos_arg_r[k] * cosh_arg_i[k];
+        i[k] = -2 * sin_arg_r[k] * sinh_arg_i[k];
+        hi1[k] = hr1[k] = hi[k] = 0;
+        hr[k] = a[PROJ_ETMERC_ORDER - 1];
+    }
+    for (int j = PROJ_ETMERC_ORDER - 2; j >= 0; j--) {
+        const double p = a[j];
+        for (int k = 0; k < count; k++) {
+            hr2[k] = hr1[k];
+            hi2[k] = hi1[k];
+            hr1[k] = hr[k];
+            hi1[k] = hi[k];
+            hr[k] = -hr2[k] + r[k] * hr1[k] - i[k] * hi1[k] + p;
+            hi[k] = -hi2[k] + i[k] * hr1[k] + r[k] * hi1[k];
+        }
+    }
+    for (int k = 0; k < count; k++) {
+        const double rk = sin_arg_r[k] * cosh_arg_i[k];
+        const double ik = cos_arg_r[k] * sinh_arg_i[k];
+        R[k] = rk * hr[k] - ik * hi[k];
+        I[k] = rk * hi[k] + ik * hr[k];
+    }
+}
+
+/* Ellipsoidal, forward, on the points of coo[] at indices idx[] */
+static void exact_e_fwd_batch(PJ_COORD *coo, const size_t *idx, int count,
+                              PJ *P) {
+    const auto *Q = &(static_cast<struct tmerc_data *>(P->opaque)->exact);
+    double Cn[TMERC_BATCH_SIZE] = {}, Ce[TMERC_BATCH_SIZE] = {};
+    double sin_arg_r[TMERC_BATCH_SIZE] = {}, cos_arg_r[TMERC_BATCH_SIZE] = {};
+    double sinh_arg_i[TMERC_BATCH_SIZE] = {}, cosh_arg_i[TMERC_BATCH_SIZE] = {};
+    double dCn[TMERC_BATCH_SIZE] = {}, dCe[TMERC_BATCH_SIZE] = {};
+
+    /* ell. LAT, LNG -> Gaussian LAT, LNG */
+    for (int k = 0; k < count; k++) {
+        const double phi = coo[idx[k]].lp.phi;
+        Cn[k] = phi;
+        cos_arg_r[k] = cos(2 * phi);
+        sin_arg_r[k] = sin(2 * phi);
+    }
+    gatg_batch(Q->cbg, count, Cn, cos_arg_r, sin_arg_r);
+
+    /* Gaussian LAT, LNG -> compl. sph. LAT, then ell. norm. N, E.
+     * See exact_e_fwd() for the details of the computations. */
+    for (int k = 0; k < count; k++) {
+        const double lam = coo[idx[k]].lp.lam;
+        const double sin_Cn = sin(Cn[k]);
+        const double cos_Cn = cos(Cn[k]);
+        const double sin_Ce = sin(lam);
+        const double cos_Ce = cos(lam);
+
+        const double cos_Cn_cos_Ce = cos_Cn * cos_Ce;
+        Cn[k] = atan2(sin_Cn, cos_Cn_cos_Ce);
+
+        const double inv_denom_tan_Ce = 1. / hypot(sin_Cn, cos_Cn_cos_Ce);
+        const double tan_Ce = sin_Ce * cos_Cn * inv_denom_tan_Ce;
+        Ce[k] = asinh(tan_Ce);
+
+        const double two_inv_denom_tan_Ce = 2 * inv_denom_tan_Ce;
+        const double two_inv_denom_tan_Ce_square =
+            two_inv_denom_tan_Ce * inv_denom_tan_Ce;
+        const double tmp_r = cos_Cn_cos_Ce * two_inv_denom_tan_Ce_square;
+        sin_arg_r[k] = sin_Cn * tmp_r;
+        cos_arg_r[k] = cos_Cn_cos_Ce * tmp_r - 1;
+        sinh_arg_i[k] = tan_Ce * two_inv_denom_tan_Ce;
+        cosh_arg_i[k] = two_inv_denom_tan_Ce_square - 1;
+    }
+
+    clenS_batch(Q->gtu, count, sin_arg_r, cos_arg_r, sinh_arg_i, cosh_arg_i,
+                dCn, dCe);
+
+    for (int k = 0; k < count; k++) {
+        auto &xy = coo[idx[k]].xy;
+        const double CnK = Cn[k] + dCn[k];
+        const double CeK = Ce[k] + dCe[k];
+        if (fabs(CeK) <= 2.623395162778) {
+            xy.y = Q->Qn * CnK + Q->Zb; /* Northing */
+            xy.x = Q->Qn * CeK;         /* Easting  */
+        } else {
+            proj_errno_set(P, PROJ_ERR_COORD_TRANSFM_OUTSIDE_PROJECTION_DOMAIN);
+            xy.x = xy.y = HUGE_VAL;
+        }
+    }
+}
+
+/* Ellipsoidal, inverse, on the points of coo[] at indices idx[], which must
+ * be within the domain of validity checked by exact_e_inv() */
+static void exact_e_inv_batch(PJ_COORD *coo, const size_t *idx, int count,
+                              PJ *P) {
+    const auto *Q = &(static_cast<struct tmerc_data *>(P->opaque)->exact);
+    double Cn[TMERC_BATCH_SIZE] = {}, Ce[TMERC_BATCH_SIZE] = {};
+    double sin_arg_r[TMERC_BATCH_SIZE] = {}, cos_arg_r[TMERC_BATCH_SIZE] = {};
+    double sinh_arg_i[TMERC_BATCH_SIZE] = {}, cosh_arg_i[TMERC_BATCH_SIZE] = {};
+    double dCn[TMERC_BATCH_SIZE] = {}, dCe[TMERC_BATCH_SIZE] = {};
+
+    /* normalize N, E, then norm. N, E -> compl. sph. LAT, LNG */
+    for (int k = 0; k < count; k++) {
+        const auto &xy = coo[idx[k]].xy;
+        Cn[k] = (xy.y - Q->Zb) / Q->Qn;
+        Ce[k] = xy.x / Q->Qn;
+        sin_arg_r[k] = sin(2 * Cn[k]);
+        cos_arg_r[k] = cos(2 * Cn[k]);
+        const double exp_2_Ce = exp(2 * Ce[k]);
+        const double half_inv_exp_2_Ce = 0.5 / exp_2_Ce;
+        sinh_arg_i[k] = 0.5 * exp_2_Ce - half_inv_exp_2_Ce;
+        cosh_arg_i[k] = 0.5 * exp_2_Ce + half_inv_exp_2_Ce;
+    }
+
+    clenS_batch(Q->utg, count, sin_arg_r, cos_arg_r, sinh_arg_i, cosh_arg_i,
+                dCn, dCe);
+
+    /* compl. sph. LAT -> Gaussian LAT, LNG.
+     * See exact_e_inv() for the details of the computations. */
+    for (int k = 0; k < count; k++) {
+        Cn[k] += dCn[k];
+        Ce[k] += dCe[k];
+        const double sin_Cn = sin(Cn[k]);
+        const double cos_Cn = cos(Cn[k]);
+        const double sinhCe = sinh(Ce[k]);
+        Ce[k] = atan2(sinhCe, cos_Cn);
+        const double modulus_Ce = hypot(sinhCe, cos_Cn);
+        Cn[k] = atan2(sin_Cn, modulus_Ce);
+
+        const double tmp = 2 * modulus_Ce / (sinhCe * sinhCe + 1);
+        sin_arg_r[k] = sin_Cn * tmp;
+        cos_arg_r[k] = tmp * modulus_Ce - 1.;
+    }
+
+    /* Gaussian LAT, LNG -> ell. LAT, LNG */
+    gatg_batch(Q->cgb, count, Cn, cos_arg_r, sin_arg_r);
+
+    for (int k = 0; k < count; k++) {
+        auto &lp = coo[idx[k]].lp;
+        lp.phi = Cn[k];
+        lp.lam = Ce[k];
+    }
+}
+
+/* Dispatch the points of coo[] to the batch forward function, or to the
+ * approximate algorithm for the points where it is accurate enough if
+ * isAuto is set (see auto_e_fwd()) */
+template <bool isAuto>
+static void exact_e_fwd_n(PJ_COORD *coo, size_t n, PJ *P) {
+    size_t idx[TMERC_BATCH_SIZE];
+    int count = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (coo[i].xyzt.x == HUGE_VAL)
+            continue;
+        if (isAuto && !(fabs(coo[i].lp.lam) > 3 * DEG_TO_RAD)) {
+            const auto xy = approx_e_fwd(coo[i].lp, P);
+            coo[i].xy = xy;
+            continue;
+        }
+        idx[count++] = i;
+        if (count == TMERC_BATCH_SIZE) {
+            exact_e_fwd_batch(coo, idx, count, P);
+            count = 0;
+        }
+    }
+    if (count > 0)
+        exact_e_fwd_batch(coo, idx, count, P);
+}
+
+/* Dispatch the points of coo[] to the batch inverse function, or to the
+ * approximate algorithm for the points where it is accurate enough if
+ * isAuto is set (see auto_e_inv()) */
+template <bool isAuto>
+static void exact_e_inv_n(PJ_COORD *coo, size_t n, PJ *P) {
+    const auto *Q = &(static_cast<struct tmerc_data *>(P->opaque)->exact);
+    size_t idx[TMERC_BATCH_SIZE];
+    int count = 0;
+    for (size_t i = 0; i < n; i++) {
+        const auto &xy = coo[i].xy;
+        if (xy.x == HUGE_VAL)
+            continue;
+        if (isAuto && !(fabs(xy.x) > 0.053 - 0.022 * xy.y * xy.y)) {
+            const auto lp = approx_e_inv(xy, P);
+            coo[i].lp = lp;
+            continue;
+        }
+        if (!(fabs(xy.x / Q->Qn) <= 2.623395162778)) { /* 150 degrees */
+            proj_errno_set(P, PROJ_ERR_COORD_TRANSFM_OUTSIDE_PROJECTION_DOMAIN);
+            coo[i].lp.phi = coo[i].lp.lam = HUGE_VAL;
+            continue;
+        }
+        idx[count++] = i;
+        if (count == TMERC_BATCH_SIZE) {
+            exact_e_inv_batch(coo, idx, count, P);
+            count = 0;
+        }
+    }
+    if (count > 0)
+        exact_e_inv_batch(coo, idx, count, P);
+}
+
 static PJ *setup_exact(PJ *P) {
     auto *Q = &(static_cast<struct tmerc_data *>(P->opaque)->exact);
 
@@ -633,9 +868,13 @@ static PJ *setup(PJ *P, TMercAlgo eAlg) {
         if (P->es == 0) {
             P->inv = tmerc_spherical_inv;
             P->fwd = tmerc_spherical_fwd;
+            P->inv4d_n = pj_operator_n_from_inv<tmerc_spherical_inv>;
+            P->fwd4d_n = pj_operator_n_from_fwd<tmerc_spherical_fwd>;
         } else {
             P->inv = approx_e_inv;
             P->fwd = approx_e_fwd;
+            P->inv4d_n = pj_operator_n_from_inv<approx_e_inv>;
+            P->fwd4d_n = pj_operator_n_from_fwd<approx_e_fwd>;
         }
         break;
     }
@@ -644,6 +883,8 @@ static PJ *setup(PJ *P, TMercAlgo eAlg) {
         setup_exact(P);
         P->inv = exact_e_inv;
         P->fwd = exact_e_fwd;
+        P->inv4d_n = exact_e_inv_n<false>;
+        P->fwd4d_n = exact_e_fwd_n<false>;
         break;
     }
 
@@ -655,6 +896,8 @@ static PJ *setup(PJ *P, TMercAlgo eAlg) {
 
         P->inv = auto_e_inv;
         P->fwd = auto_e_fwd;
+        P->inv4d_n = exact_e_inv_n<true>;
+        P->fwd4d_n = exact_e_fwd_n<true>;
         break;
     }
     }
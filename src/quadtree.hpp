@@ -123,6 +123,12 @@ template <class Feature> class QuadTree {
         search(root, x, y, features);
     }
 
+    /** Call visitor(feature) on all features whose bounds contains (x,y) */
+    template <class Visitor>
+    void visit(double x, double y, Visitor &visitor) const {
+        visit(root, x, y, visitor);
+    }
+
   private:
     void splitBounds(const RectObj &in, RectObj &out1, RectObj &out2) {
         // The output bounds will be very similar to the input bounds,
@@ -246,6 +252,22 @@ template <class Feature> class QuadTree {
             search(subnode, x, y, features);
         }
     }
+
+    template <class Visitor>
+    static void visit(const Node &node, double x, double y, Visitor &visitor) {
+        if (!node.rect.contains(x, y))
+            return;
+
+        for (const auto &pair : node.features) {
+            if (pair.second.contains(x, y)) {
+                visitor(pair.first);
+            }
+        }
+
+        for (const auto &subnode : node.subnodes) {
+            visit(subnode, x, y, visitor);
+        }
+    }
 };
 
 } // namespace QuadTree
@@ -894,11 +894,22 @@ static void pj_gridshift_reassign_context(PJ *P, PJ_CONTEXT *ctx) {
 
 // ---------------------------------------------------------------------------
 
+static void pj_gridshift_prepare_for_area(PJ *P, double west, double south,
+                                          double east, double north) {
+    auto Q = static_cast<gridshiftData *>(P->opaque);
+    if (Q->loadGridsIfNeeded(P)) {
+        pj_prepare_grids_for_area(Q->m_grids, west, south, east, north);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 PJ *PJ_TRANSFORMATION(gridshift, 0) {
     auto Q = new gridshiftData;
     P->opaque = (void *)Q;
     P->destructor = pj_gridshift_destructor;
     P->reassign_context = pj_gridshift_reassign_context;
+    P->prepare_for_area = pj_gridshift_prepare_for_area;
 
     P->fwd3d = pj_gridshift_forward_3d;
     P->inv3d = pj_gridshift_reverse_3d;
@@ -60,25 +60,36 @@ static PJ_LPZ helmert_reverse_3d(PJ_XYZ xyz, PJ *P);
 
 /***********************************************************************/
 namespace { // anonymous namespace
+struct helmert_params {
+    /************************************************************************
+        Transformation parameters at a given observation time
+    ************************************************************************/
+    PJ_XYZ xyz;
+    PJ_OPK opk;
+    double scale;
+    double theta;
+    double R[3][3];
+};
+
 struct pj_opaque_helmert {
     /************************************************************************
         Projection specific elements for the "helmert" PJ object
     ************************************************************************/
-    PJ_XYZ xyz;
     PJ_XYZ xyz_0;
     PJ_XYZ dxyz;
     PJ_XYZ refp;
-    PJ_OPK opk;
     PJ_OPK opk_0;
     PJ_OPK dopk;
-    double scale;
     double scale_0;
     double dscale;
-    double theta;
     double theta_0;
     double dtheta;
-    double R[3][3];
-    double t_epoch, t_obs;
+    double t_epoch;
+    /* Parameters at observation time t_obs, computed at setup. They are not
+     * modified afterwards, so that a PJ can be used concurrently: parameters
+     * at other observation times are computed in a caller's helmert_params */
+    double t_obs;
+    helmert_params params;
     int no_rotation, exact, fourparam;
     int is_position_vector; /* 1 = position_vector, 0 = coordinate_frame */
 };
@@ -86,20 +97,20 @@ struct pj_opaque_helmert {
 
 /* Make the maths of the rotation operations somewhat more readable and textbook
  * like */
-#define R00 (Q->R[0][0])
-#define R01 (Q->R[0][1])
-#define R02 (Q->R[0][2])
+#define R00 (H.R[0][0])
+#define R01 (H.R[0][1])
+#define R02 (H.R[0][2])
 
-#define R10 (Q->R[1][0])
-#define R11 (Q->R[1][1])
-#define R12 (Q->R[1][2])
+#define R10 (H.R[1][0])
+#define R11 (H.R[1][1])
+#define R12 (H.R[1][2])
 
-#define R20 (Q->R[2][0])
-#define R21 (Q->R[2][1])
-#define R22 (Q->R[2][2])
+#define R20 (H.R[2][0])
+#define R21 (H.R[2][1])
+#define R22 (H.R[2][2])
 
 /**************************************************************************/
-static void update_parameters(PJ *P) {
+static void update_parameters(PJ *P, double t_obs, helmert_params &H) {
     /***************************************************************************
 
         Update transformation parameters.
@@ -125,40 +136,41 @@ static void update_parameters(PJ *P) {
 
     *******************************************************************************/
 
-    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
-    double dt = Q->t_obs - Q->t_epoch;
+    const struct pj_opaque_helmert *Q =
+        (const struct pj_opaque_helmert *)P->opaque;
+    double dt = t_obs - Q->t_epoch;
 
-    Q->xyz.x = Q->xyz_0.x + Q->dxyz.x * dt;
-    Q->xyz.y = Q->xyz_0.y + Q->dxyz.y * dt;
-    Q->xyz.z = Q->xyz_0.z + Q->dxyz.z * dt;
+    H.xyz.x = Q->xyz_0.x + Q->dxyz.x * dt;
+    H.xyz.y = Q->xyz_0.y + Q->dxyz.y * dt;
+    H.xyz.z = Q->xyz_0.z + Q->dxyz.z * dt;
 
-    Q->opk.o = Q->opk_0.o + Q->dopk.o * dt;
-    Q->opk.p = Q->opk_0.p + Q->dopk.p * dt;
-    Q->opk.k = Q->opk_0.k + Q->dopk.k * dt;
+    H.opk.o = Q->opk_0.o + Q->dopk.o * dt;
+    H.opk.p = Q->opk_0.p + Q->dopk.p * dt;
+    H.opk.k = Q->opk_0.k + Q->dopk.k * dt;
 
-    Q->scale = Q->scale_0 + Q->dscale * dt;
+    H.scale = Q->scale_0 + Q->dscale * dt;
 
-    Q->theta = Q->theta_0 + Q->dtheta * dt;
+    H.theta = Q->theta_0 + Q->dtheta * dt;
 
     /* debugging output */
     if (proj_log_level(P->ctx, PJ_LOG_TELL) >= PJ_LOG_TRACE) {
         proj_log_trace(P,
                        "Transformation parameters for observation "
                        "t_obs=%g (t_epoch=%g):",
-                       Q->t_obs, Q->t_epoch);
-        proj_log_trace(P, "x: %g", Q->xyz.x);
-        proj_log_trace(P, "y: %g", Q->xyz.y);
-        proj_log_trace(P, "z: %g", Q->xyz.z);
-        proj_log_trace(P, "s: %g", Q->scale * 1e-6);
-        proj_log_trace(P, "rx: %g", Q->opk.o);
-        proj_log_trace(P, "ry: %g", Q->opk.p);
-        proj_log_trace(P, "rz: %g", Q->opk.k);
-        proj_log_trace(P, "theta: %g", Q->theta);
+                       t_obs, Q->t_epoch);
+        proj_log_trace(P, "x: %g", H.xyz.x);
+        proj_log_trace(P, "y: %g", H.xyz.y);
+        proj_log_trace(P, "z: %g", H.xyz.z);
+        proj_log_trace(P, "s: %g", H.scale * 1e-6);
+        proj_log_trace(P, "rx: %g", H.opk.o);
+        proj_log_trace(P, "ry: %g", H.opk.p);
+        proj_log_trace(P, "rz: %g", H.opk.k);
+        proj_log_trace(P, "theta: %g", H.theta);
     }
 }
 
 /**************************************************************************/
-static void build_rot_matrix(PJ *P) {
+static void build_rot_matrix(PJ *P, helmert_params &H) {
     /***************************************************************************
 
         Build rotation matrix.
@@ -225,16 +237,17 @@ static void build_rot_matrix(PJ *P) {
         between the conventions.
 
     ***************************************************************************/
-    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
+    const struct pj_opaque_helmert *Q =
+        (const struct pj_opaque_helmert *)P->opaque;
 
     double f, t, p;    /* phi/fi , theta, psi  */
     double cf, ct, cp; /* cos (fi, theta, psi) */
     double sf, st, sp; /* sin (fi, theta, psi) */
 
     /* rename   (omega, phi, kappa)   to   (fi, theta, psi)   */
-    f = Q->opk.o;
-    t = Q->opk.p;
-    p = Q->opk.k;
+    f = H.opk.o;
+    t = H.opk.p;
+    p = H.opk.k;
 
     /* Those equations are given assuming coordinate frame convention. */
     /* For the position vector convention, we transpose the matrix just after.
@@ -321,15 +334,15 @@ static void build_rot_matrix(PJ *P) {
 }
 
 /***********************************************************************/
-static PJ_XY helmert_forward(PJ_LP lp, PJ *P) {
+static PJ_XY helmert_forward_2d(PJ_LP lp, const pj_opaque_helmert *Q,
+                                const helmert_params &H) {
     /***********************************************************************/
-    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
     PJ_COORD point = {{0, 0, 0, 0}};
     double x, y, cr, sr;
     point.lp = lp;
 
-    cr = cos(Q->theta) * Q->scale;
-    sr = sin(Q->theta) * Q->scale;
+    cr = cos(H.theta) * H.scale;
+    sr = sin(H.theta) * H.scale;
     x = point.xy.x;
     y = point.xy.y;
 
@@ -340,15 +353,15 @@ static PJ_XY helmert_forward(PJ_LP lp, PJ *P) {
 }
 
 /***********************************************************************/
-static PJ_LP helmert_reverse(PJ_XY xy, PJ *P) {
+static PJ_LP helmert_reverse_2d(PJ_XY xy, const pj_opaque_helmert *Q,
+                                const helmert_params &H) {
     /***********************************************************************/
-    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
     PJ_COORD point = {{0, 0, 0, 0}};
     double x, y, sr, cr;
     point.xy = xy;
 
-    cr = cos(Q->theta) / Q->scale;
-    sr = sin(Q->theta) / Q->scale;
+    cr = cos(H.theta) / H.scale;
+    sr = sin(H.theta) / H.scale;
     x = point.xy.x - Q->xyz_0.x;
     y = point.xy.y - Q->xyz_0.y;
 
@@ -359,28 +372,28 @@ static PJ_LP helmert_reverse(PJ_XY xy, PJ *P) {
 }
 
 /***********************************************************************/
-static PJ_XYZ helmert_forward_3d(PJ_LPZ lpz, PJ *P) {
+static PJ_XYZ helmert_forward_3d(PJ_LPZ lpz, const pj_opaque_helmert *Q,
+                                 const helmert_params &H) {
     /***********************************************************************/
-    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
     PJ_COORD point = {{0, 0, 0, 0}};
     double X, Y, Z, scale;
 
     point.lpz = lpz;
 
     if (Q->fourparam) {
-        const auto xy = helmert_forward(point.lp, P);
+        const auto xy = helmert_forward_2d(point.lp, Q, H);
         point.xy = xy;
         return point.xyz;
     }
 
-    if (Q->no_rotation && Q->scale == 0) {
-        point.xyz.x = lpz.lam + Q->xyz.x;
-        point.xyz.y = lpz.phi + Q->xyz.y;
-        point.xyz.z = lpz.z + Q->xyz.z;
+    if (Q->no_rotation && H.scale == 0) {
+        point.xyz.x = lpz.lam + H.xyz.x;
+        point.xyz.y = lpz.phi + H.xyz.y;
+        point.xyz.z = lpz.z + H.xyz.z;
         return point.xyz;
     }
 
-    scale = 1 + Q->scale * 1e-6;
+    scale = 1 + H.scale * 1e-6;
 
     X = lpz.lam - Q->refp.x;
     Y = lpz.phi - Q->refp.y;
@@ -390,42 +403,42 @@ static PJ_XYZ helmert_forward_3d(PJ_LPZ lpz, PJ *P) {
     point.xyz.y = scale * (R10 * X + R11 * Y + R12 * Z);
     point.xyz.z = scale * (R20 * X + R21 * Y + R22 * Z);
 
-    point.xyz.x += Q->xyz.x; /* for Molodensky-Badekas, Q->xyz already
-                                incorporates the Q->refp offset */
-    point.xyz.y += Q->xyz.y;
-    point.xyz.z += Q->xyz.z;
+    point.xyz.x += H.xyz.x; /* for Molodensky-Badekas, H.xyz already
+                               incorporates the Q->refp offset */
+    point.xyz.y += H.xyz.y;
+    point.xyz.z += H.xyz.z;
 
     return point.xyz;
 }
 
 /***********************************************************************/
-static PJ_LPZ helmert_reverse_3d(PJ_XYZ xyz, PJ *P) {
+static PJ_LPZ helmert_reverse_3d(PJ_XYZ xyz, const pj_opaque_helmert *Q,
+                                 const helmert_params &H) {
     /***********************************************************************/
-    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
     PJ_COORD point = {{0, 0, 0, 0}};
     double X, Y, Z, scale;
 
     point.xyz = xyz;
 
     if (Q->fourparam) {
-        const auto lp = helmert_reverse(point.xy, P);
+        const auto lp = helmert_reverse_2d(point.xy, Q, H);
         point.lp = lp;
         return point.lpz;
     }
 
-    if (Q->no_rotation && Q->scale == 0) {
-        point.xyz.x = xyz.x - Q->xyz.x;
-        point.xyz.y = xyz.y - Q->xyz.y;
-        point.xyz.z = xyz.z - Q->xyz.z;
+    if (Q->no_rotation && H.scale == 0) {
+        point.xyz.x = xyz.x - H.xyz.x;
+        point.xyz.y = xyz.y - H.xyz.y;
+        point.xyz.z = xyz.z - H.xyz.z;
         return point.lpz;
     }
 
-    scale = 1 + Q->scale * 1e-6;
+    scale = 1 + H.scale * 1e-6;
 
     /* Unscale and deoffset */
-    X = (xyz.x - Q->xyz.x) / scale;
-    Y = (xyz.y - Q->xyz.y) / scale;
-    Z = (xyz.z - Q->xyz.z) / scale;
+    X = (xyz.x - H.xyz.x) / scale;
+    Y = (xyz.y - H.xyz.y) / scale;
+    Z = (xyz.z - H.xyz.z) / scale;
 
     /* Inverse rotation through transpose multiplication */
     point.xyz.x = (R00 * X + R10 * Y + R20 * Z) + Q->refp.x;
@@ -435,44 +448,118 @@ static PJ_LPZ helmert_reverse_3d(PJ_XYZ xyz, PJ *P) {
     return point.lpz;
 }
 
-static void helmert_forward_4d(PJ_COORD &point, PJ *P) {
-    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
+/***********************************************************************/
+static PJ_XY helmert_forward(PJ_LP lp, PJ *P) {
+    /***********************************************************************/
+    const auto *Q = (const struct pj_opaque_helmert *)P->opaque;
+    return helmert_forward_2d(lp, Q, Q->params);
+}
 
-    /* We only need to rebuild the rotation matrix if the
-     * observation time is different from the last call */
-    double t_obs = (point.xyzt.t == HUGE_VAL) ? Q->t_epoch : point.xyzt.t;
-    if (t_obs != Q->t_obs) {
-        Q->t_obs = t_obs;
-        update_parameters(P);
-        build_rot_matrix(P);
+/***********************************************************************/
+static PJ_LP helmert_reverse(PJ_XY xy, PJ *P) {
+    /***********************************************************************/
+    const auto *Q = (const struct pj_opaque_helmert *)P->opaque;
+    return helmert_reverse_2d(xy, Q, Q->params);
+}
+
+/***********************************************************************/
+static PJ_XYZ helmert_forward_3d(PJ_LPZ lpz, PJ *P) {
+    /***********************************************************************/
+    const auto *Q = (const struct pj_opaque_helmert *)P->opaque;
+    return helmert_forward_3d(lpz, Q, Q->params);
+}
+
+/***********************************************************************/
+static PJ_LPZ helmert_reverse_3d(PJ_XYZ xyz, PJ *P) {
+    /***********************************************************************/
+    const auto *Q = (const struct pj_opaque_helmert *)P->opaque;
+    return helmert_reverse_3d(xyz, Q, Q->params);
+}
+
+/* Return the parameters at the observation time of point. Those are the
+ * precomputed ones if the observation time is the one they have been computed
+ * for (or if the point has no observation time, and they have been computed
+ * for t_epoch), or otherwise the ones computed in H. lastTime and lastH
+ * allow callers transforming several points to only recompute the parameters
+ * when the observation time changes. */
+static const helmert_params &get_parameters(PJ *P, const PJ_COORD &point,
+                                            helmert_params &H,
+                                            double &lastTime,
+                                            const helmert_params *&lastH) {
+    const auto *Q = (const struct pj_opaque_helmert *)P->opaque;
+    const double t_obs =
+        (point.xyzt.t == HUGE_VAL) ? Q->t_epoch : point.xyzt.t;
+    if (lastH && t_obs == lastTime)
+        return *lastH;
+    lastTime = t_obs;
+    if (t_obs == Q->t_obs) {
+        lastH = &Q->params;
+    } else {
+        update_parameters(P, t_obs, H);
+        build_rot_matrix(P, H);
+        lastH = &H;
     }
+    return *lastH;
+}
+
+static void helmert_forward_4d(PJ_COORD &point, PJ *P) {
+    const auto *Q = (const struct pj_opaque_helmert *)P->opaque;
+    helmert_params H;
+    double lastTime = 0;
+    const helmert_params *lastH = nullptr;
 
     // Assigning in 2 steps avoids cppcheck warning
     // "Overlapping read/write of union is undefined behavior"
     // Cf https://github.com/OSGeo/PROJ/pull/3527#pullrequestreview-1233332710
-    const auto xyz = helmert_forward_3d(point.lpz, P);
+    const auto xyz = helmert_forward_3d(
+        point.lpz, Q, get_parameters(P, point, H, lastTime, lastH));
     point.xyz = xyz;
 }
 
 static void helmert_reverse_4d(PJ_COORD &point, PJ *P) {
-    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
-
-    /* We only need to rebuild the rotation matrix if the
-     * observation time is different from the last call */
-    double t_obs = (point.xyzt.t == HUGE_VAL) ? Q->t_epoch : point.xyzt.t;
-    if (t_obs != Q->t_obs) {
-        Q->t_obs = t_obs;
-        update_parameters(P);
-        build_rot_matrix(P);
-    }
+    const auto *Q = (const struct pj_opaque_helmert *)P->opaque;
+    helmert_params H;
+    double lastTime = 0;
+    const helmert_params *lastH = nullptr;
 
     // Assigning in 2 steps avoids cppcheck warning
     // "Overlapping read/write of union is undefined behavior"
     // Cf https://github.com/OSGeo/PROJ/pull/3527#pullrequestreview-1233332710
-    const auto lpz = helmert_reverse_3d(point.xyz, P);
+    const auto lpz = helmert_reverse_3d(
+        point.xyz, Q, get_parameters(P, point, H, lastTime, lastH));
     point.lpz = lpz;
 }
 
+static void helmert_forward_4d_n(PJ_COORD *coo, size_t n, PJ *P) {
+    const auto *Q = (const struct pj_opaque_helmert *)P->opaque;
+    helmert_params H;
+    double lastTime = 0;
+    const helmert_params *lastH = nullptr;
+    for (size_t i = 0; i < n; i++) {
+        PJ_COORD &point = coo[i];
+        if (point.xyzt.x == HUGE_VAL)
+            continue;
+        const auto xyz = helmert_forward_3d(
+            point.lpz, Q, get_parameters(P, point, H, lastTime, lastH));
+        point.xyz = xyz;
+    }
+}
+
+static void helmert_reverse_4d_n(PJ_COORD *coo, size_t n, PJ *P) {
+    const auto *Q = (const struct pj_opaque_helmert *)P->opaque;
+    helmert_params H;
+    double lastTime = 0;
+    const helmert_params *lastH = nullptr;
+    for (size_t i = 0; i < n; i++) {
+        PJ_COORD &point = coo[i];
+        if (point.xyzt.x == HUGE_VAL)
+            continue;
+        const auto lpz = helmert_reverse_3d(
+            point.xyz, Q, get_parameters(P, point, H, lastTime, lastH));
+        point.lpz = lpz;
+    }
+}
+
 /* Arcsecond to radians */
 #define ARCSEC_TO_RAD (DEG_TO_RAD / 3600.0)
 
@@ -574,6 +661,8 @@ PJ *PJ_TRANSFORMATION(helmert, 0) {
     P->inv4d = helmert_reverse_4d;
     P->fwd3d = helmert_forward_3d;
     P->inv3d = helmert_reverse_3d;
+    P->fwd4d_n = helmert_forward_4d_n;
+    P->inv4d_n = helmert_reverse_4d_n;
 
     Q = (struct pj_opaque_helmert *)P->opaque;
 
@@ -655,12 +744,7 @@ PJ *PJ_TRANSFORMATION(helmert, 0) {
     if (pj_param(P->ctx, P->params, "tt_epoch").i)
         Q->t_epoch = pj_param(P->ctx, P->params, "dt_epoch").f;
 
-    Q->xyz = Q->xyz_0;
-    Q->opk = Q->opk_0;
-    Q->scale = Q->scale_0;
-    Q->theta = Q->theta_0;
-
-    if ((Q->opk.o == 0) && (Q->opk.p == 0) && (Q->opk.k == 0) &&
+    if ((Q->opk_0.o == 0) && (Q->opk_0.p == 0) && (Q->opk_0.k == 0) &&
         (Q->dopk.o == 0) && (Q->dopk.p == 0) && (Q->dopk.k == 0)) {
         Q->no_rotation = 1;
     }
@@ -672,12 +756,12 @@ PJ *PJ_TRANSFORMATION(helmert, 0) {
     /* Let's help with debugging */
     if (proj_log_level(P->ctx, PJ_LOG_TELL) >= PJ_LOG_TRACE) {
         proj_log_trace(P, "Helmert parameters:");
-        proj_log_trace(P, "x=  %8.5f  y=  %8.5f  z=  %8.5f", Q->xyz.x, Q->xyz.y,
-                       Q->xyz.z);
+        proj_log_trace(P, "x=  %8.5f  y=  %8.5f  z=  %8.5f", Q->xyz_0.x,
+                       Q->xyz_0.y, Q->xyz_0.z);
         proj_log_trace(P, "rx= %8.5f  ry= %8.5f  rz= %8.5f",
-                       Q->opk.o / ARCSEC_TO_RAD, Q->opk.p / ARCSEC_TO_RAD,
-                       Q->opk.k / ARCSEC_TO_RAD);
-        proj_log_trace(P, "s=  %8.5f  exact=%d%s", Q->scale, Q->exact,
+                       Q->opk_0.o / ARCSEC_TO_RAD, Q->opk_0.p / ARCSEC_TO_RAD,
+                       Q->opk_0.k / ARCSEC_TO_RAD);
+        proj_log_trace(P, "s=  %8.5f  exact=%d%s", Q->scale_0, Q->exact,
                        Q->no_rotation ? ""
                        : Q->is_position_vector
                            ? "  convention=position_vector"
@@ -689,8 +773,9 @@ PJ *PJ_TRANSFORMATION(helmert, 0) {
         proj_log_trace(P, "ds= %8.5f  t_epoch=%8.5f", Q->dscale, Q->t_epoch);
     }
 
-    update_parameters(P);
-    build_rot_matrix(P);
+    Q->t_obs = Q->t_epoch;
+    update_parameters(P, Q->t_obs, Q->params);
+    build_rot_matrix(P, Q->params);
 
     return P;
 }
@@ -707,6 +792,8 @@ PJ *PJ_TRANSFORMATION(molobadekas, 0) {
 
     P->fwd3d = helmert_forward_3d;
     P->inv3d = helmert_reverse_3d;
+    P->fwd4d_n = pj_operator_n_from_fwd3d<helmert_forward_3d>;
+    P->inv4d_n = pj_operator_n_from_inv3d<helmert_reverse_3d>;
 
     Q = (struct pj_opaque_helmert *)P->opaque;
 
@@ -715,8 +802,8 @@ PJ *PJ_TRANSFORMATION(molobadekas, 0) {
         Q->scale_0 = pj_param(P->ctx, P->params, "ds").f;
     }
 
-    Q->opk = Q->opk_0;
-    Q->scale = Q->scale_0;
+    Q->params.opk = Q->opk_0;
+    Q->params.scale = Q->scale_0;
 
     if (!read_convention(P)) {
         return nullptr;
@@ -738,9 +825,9 @@ PJ *PJ_TRANSFORMATION(molobadekas, 0) {
         proj_log_trace(P, "x=  %8.5f  y=  %8.5f  z=  %8.5f", Q->xyz_0.x,
                        Q->xyz_0.y, Q->xyz_0.z);
         proj_log_trace(P, "rx= %8.5f  ry= %8.5f  rz= %8.5f",
-                       Q->opk.o / ARCSEC_TO_RAD, Q->opk.p / ARCSEC_TO_RAD,
-                       Q->opk.k / ARCSEC_TO_RAD);
-        proj_log_trace(P, "s=  %8.5f  exact=%d%s", Q->scale, Q->exact,
+                       Q->opk_0.o / ARCSEC_TO_RAD, Q->opk_0.p / ARCSEC_TO_RAD,
+                       Q->opk_0.k / ARCSEC_TO_RAD);
+        proj_log_trace(P, "s=  %8.5f  exact=%d%s", Q->scale_0, Q->exact,
                        Q->is_position_vector ? "  convention=position_vector"
                                              : "  convention=coordinate_frame");
         proj_log_trace(P, "px= %8.5f  py= %8.5f  pz= %8.5f", Q->refp.x,
@@ -752,9 +839,9 @@ PJ *PJ_TRANSFORMATION(molobadekas, 0) {
     Q->xyz_0.y += Q->refp.y;
     Q->xyz_0.z += Q->refp.z;
 
-    Q->xyz = Q->xyz_0;
+    Q->params.xyz = Q->xyz_0;
 
-    build_rot_matrix(P);
+    build_rot_matrix(P, Q->params);
 
     return P;
 }
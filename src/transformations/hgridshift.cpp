@@ -25,18 +25,28 @@ struct hgridshiftData {
 };
 } // anonymous namespace
 
-static PJ_XYZ pj_hgridshift_forward_3d(PJ_LPZ lpz, PJ *P) {
+// Open the grids, if their opening was deferred until first use.
+// Returns false in case of error.
+static bool open_deferred_grids(PJ *P) {
     auto Q = static_cast<hgridshiftData *>(P->opaque);
-    PJ_COORD point = {{0, 0, 0, 0}};
-    point.lpz = lpz;
-
     if (Q->defer_grid_opening) {
         Q->defer_grid_opening = false;
         Q->grids = pj_hgrid_init(P, "grids");
         if (proj_errno(P)) {
-            return proj_coord_error().xyz;
+            return false;
         }
     }
+    return true;
+}
+
+static PJ_XYZ pj_hgridshift_forward_3d(PJ_LPZ lpz, PJ *P) {
+    auto Q = static_cast<hgridshiftData *>(P->opaque);
+    PJ_COORD point = {{0, 0, 0, 0}};
+    point.lpz = lpz;
+
+    if (!open_deferred_grids(P)) {
+        return proj_coord_error().xyz;
+    }
 
     if (!Q->grids.empty()) {
         /* Only try the gridshift if at least one grid is loaded,
@@ -52,12 +62,8 @@ static PJ_LPZ pj_hgridshift_reverse_3d(PJ_XYZ xyz, PJ *P) {
     PJ_COORD point = {{0, 0, 0, 0}};
     point.xyz = xyz;
 
-    if (Q->defer_grid_opening) {
-        Q->defer_grid_opening = false;
-        Q->grids = pj_hgrid_init(P, "grids");
-        if (proj_errno(P)) {
-            return proj_coord_error().lpz;
-        }
+    if (!open_deferred_grids(P)) {
+        return proj_coord_error().lpz;
     }
 
     if (!Q->grids.empty()) {
@@ -119,6 +125,60 @@ static void pj_hgridshift_reverse_4d(PJ_COORD &coo, PJ *P) {
     }
 }
 
+static void pj_hgridshift_forward_4d_n(PJ_COORD *coo, size_t n, PJ *P) {
+    auto Q = static_cast<hgridshiftData *>(P->opaque);
+
+    /* Time restricted: go through the scalar path */
+    if (Q->t_final != 0 && Q->t_epoch != 0) {
+        pj_operator_n_from_4d<pj_hgridshift_forward_4d>(coo, n, P);
+        return;
+    }
+
+    /* Open the grids before the first batch, so that it benefits from */
+    /* grid prefetching. On error, fail all points, and leave the opening */
+    /* to the per-point path the caller falls back to, so that errors are */
+    /* reported as without the array operator. */
+    if (!open_deferred_grids(P)) {
+        Q->defer_grid_opening = true;
+        for (size_t i = 0; i < n; i++) {
+            if (coo[i].xyzt.x != HUGE_VAL)
+                coo[i].xyz = proj_coord_error().xyz;
+        }
+        return;
+    }
+
+    if (!Q->grids.empty()) {
+        pj_hgrid_apply_n(P->ctx, Q->grids, coo, n, PJ_FWD);
+    }
+}
+
+static void pj_hgridshift_reverse_4d_n(PJ_COORD *coo, size_t n, PJ *P) {
+    auto Q = static_cast<hgridshiftData *>(P->opaque);
+
+    /* Time restricted: go through the scalar path */
+    if (Q->t_final != 0 && Q->t_epoch != 0) {
+        pj_operator_n_from_4d<pj_hgridshift_reverse_4d>(coo, n, P);
+        return;
+    }
+
+    /* Open the grids before the first batch, so that it benefits from */
+    /* grid prefetching. On error, fail all points, and leave the opening */
+    /* to the per-point path the caller falls back to, so that errors are */
+    /* reported as without the array operator. */
+    if (!open_deferred_grids(P)) {
+        Q->defer_grid_opening = true;
+        for (size_t i = 0; i < n; i++) {
+            if (coo[i].xyzt.x != HUGE_VAL)
+                coo[i].xyz = proj_coord_error().xyz;
+        }
+        return;
+    }
+
+    if (!Q->grids.empty()) {
+        pj_hgrid_apply_n(P->ctx, Q->grids, coo, n, PJ_INV);
+    }
+}
+
 static PJ *pj_hgridshift_destructor(PJ *P, int errlev) {
     if (nullptr == P)
         return nullptr;
@@ -136,14 +196,25 @@ static void pj_hgridshift_reassign_context(PJ *P, PJ_CONTEXT *ctx) {
     }
 }
 
+static void pj_hgridshift_prepare_for_area(PJ *P, double west, double south,
+                                           double east, double north) {
+    auto Q = static_cast<hgridshiftData *>(P->opaque);
+    if (open_deferred_grids(P)) {
+        pj_prepare_grids_for_area(Q->grids, west, south, east, north);
+    }
+}
+
 PJ *PJ_TRANSFORMATION(hgridshift, 0) {
     auto Q = new hgridshiftData;
     P->opaque = (void *)Q;
     P->destructor = pj_hgridshift_destructor;
     P->reassign_context = pj_hgridshift_reassign_context;
+    P->prepare_for_area = pj_hgridshift_prepare_for_area;
 
     P->fwd4d = pj_hgridshift_forward_4d;
     P->inv4d = pj_hgridshift_reverse_4d;
+    P->fwd4d_n = pj_hgridshift_forward_4d_n;
+    P->inv4d_n = pj_hgridshift_reverse_4d_n;
     P->fwd3d = pj_hgridshift_forward_3d;
     P->inv3d = pj_hgridshift_reverse_3d;
     P->fwd = nullptr;
@@ -51,19 +51,29 @@ static void deal_with_vertcon_gtx_hack(PJ *P) {
     }
 }
 
-static PJ_XYZ pj_vgridshift_forward_3d(PJ_LPZ lpz, PJ *P) {
-    struct vgridshiftData *Q = (struct vgridshiftData *)P->opaque;
-    PJ_COORD point = {{0, 0, 0, 0}};
-    point.lpz = lpz;
-
+// Open the grids, if their opening was deferred until first use.
+// Returns false in case of error.
+static bool open_deferred_grids(PJ *P) {
+    auto Q = static_cast<vgridshiftData *>(P->opaque);
     if (Q->defer_grid_opening) {
         Q->defer_grid_opening = false;
         Q->grids = pj_vgrid_init(P, "grids");
         deal_with_vertcon_gtx_hack(P);
         if (proj_errno(P)) {
-            return proj_coord_error().xyz;
+            return false;
         }
     }
+    return true;
+}
+
+static PJ_XYZ pj_vgridshift_forward_3d(PJ_LPZ lpz, PJ *P) {
+    struct vgridshiftData *Q = (struct vgridshiftData *)P->opaque;
+    PJ_COORD point = {{0, 0, 0, 0}};
+    point.lpz = lpz;
+
+    if (!open_deferred_grids(P)) {
+        return proj_coord_error().xyz;
+    }
 
     if (!Q->grids.empty()) {
         /* Only try the gridshift if at least one grid is loaded,
@@ -80,13 +90,8 @@ static PJ_LPZ pj_vgridshift_reverse_3d(PJ_XYZ xyz, PJ *P) {
     PJ_COORD point = {{0, 0, 0, 0}};
     point.xyz = xyz;
 
-    if (Q->defer_grid_opening) {
-        Q->defer_grid_opening = false;
-        Q->grids = pj_vgrid_init(P, "grids");
-        deal_with_vertcon_gtx_hack(P);
-        if (proj_errno(P)) {
-            return proj_coord_error().lpz;
-        }
+    if (!open_deferred_grids(P)) {
+        return proj_coord_error().lpz;
     }
 
     if (!Q->grids.empty()) {
@@ -149,6 +154,60 @@ static void pj_vgridshift_reverse_4d(PJ_COORD &coo, PJ *P) {
     }
 }
 
+static void pj_vgridshift_forward_4d_n(PJ_COORD *coo, size_t n, PJ *P) {
+    auto Q = static_cast<vgridshiftData *>(P->opaque);
+
+    /* Time restricted: go through the scalar path */
+    if (Q->t_final != 0 && Q->t_epoch != 0) {
+        pj_operator_n_from_4d<pj_vgridshift_forward_4d>(coo, n, P);
+        return;
+    }
+
+    /* Open the grids before the first batch, so that it benefits from */
+    /* grid prefetching. On error, fail all points, and leave the opening */
+    /* to the per-point path the caller falls back to, so that errors are */
+    /* reported as without the array operator. */
+    if (!open_deferred_grids(P)) {
+        Q->defer_grid_opening = true;
+        for (size_t i = 0; i < n; i++) {
+            if (coo[i].xyzt.x != HUGE_VAL)
+                coo[i].xyz = proj_coord_error().xyz;
+        }
+        return;
+    }
+
+    if (!Q->grids.empty()) {
+        pj_vgrid_apply_n(P, Q->grids, coo, n, Q->forward_multiplier, PJ_FWD);
+    }
+}
+
+static void pj_vgridshift_reverse_4d_n(PJ_COORD *coo, size_t n, PJ *P) {
+    auto Q = static_cast<vgridshiftData *>(P->opaque);
+
+    /* Time restricted: go through the scalar path */
+    if (Q->t_final != 0 && Q->t_epoch != 0) {
+        pj_operator_n_from_4d<pj_vgridshift_reverse_4d>(coo, n, P);
+        return;
+    }
+
+    /* Open the grids before the first batch, so that it benefits from */
+    /* grid prefetching. On error, fail all points, and leave the opening */
+    /* to the per-point path the caller falls back to, so that errors are */
+    /* reported as without the array operator. */
+    if (!open_deferred_grids(P)) {
+        Q->defer_grid_opening = true;
+        for (size_t i = 0; i < n; i++) {
+            if (coo[i].xyzt.x != HUGE_VAL)
+                coo[i].xyz = proj_coord_error().xyz;
+        }
+        return;
+    }
+
+    if (!Q->grids.empty()) {
+        pj_vgrid_apply_n(P, Q->grids, coo, n, Q->forward_multiplier, PJ_INV);
+    }
+}
+
 static PJ *pj_vgridshift_destructor(PJ *P, int errlev) {
     if (nullptr == P)
         return nullptr;
@@ -166,11 +225,20 @@ static void pj_vgridshift_reassign_context(PJ *P, PJ_CONTEXT *ctx) {
     }
 }
 
+static void pj_vgridshift_prepare_for_area(PJ *P, double west, double south,
+                                           double east, double north) {
+    auto Q = static_cast<vgridshiftData *>(P->opaque);
+    if (open_deferred_grids(P)) {
+        pj_prepare_grids_for_area(Q->grids, west, south, east, north);
+    }
+}
+
 PJ *PJ_TRANSFORMATION(vgridshift, 0) {
     auto Q = new vgridshiftData;
     P->opaque = (void *)Q;
     P->destructor = pj_vgridshift_destructor;
     P->reassign_context = pj_vgridshift_reassign_context;
+    P->prepare_for_area = pj_vgridshift_prepare_for_area;
 
     if (!pj_param(P->ctx, P->params, "tgrids").i) {
         proj_log_error(P, _("+grids parameter missing."));
@@ -234,6 +302,8 @@ PJ *PJ_TRANSFORMATION(vgridshift, 0) {
 
     P->fwd4d = pj_vgridshift_forward_4d;
     P->inv4d = pj_vgridshift_reverse_4d;
+    P->fwd4d_n = pj_vgridshift_forward_4d_n;
+    P->inv4d_n = pj_vgridshift_reverse_4d_n;
     P->fwd3d = pj_vgridshift_forward_3d;
     P->inv3d = pj_vgridshift_reverse_3d;
     P->fwd = nullptr;
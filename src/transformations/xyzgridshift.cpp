@@ -51,8 +51,8 @@ struct xyzgridshiftData {
 
 // ---------------------------------------------------------------------------
 
-static bool get_grid_values(PJ *P, xyzgridshiftData *Q, const PJ_LP &lp,
-                            double &dx, double &dy, double &dz) {
+static bool open_deferred_grids(PJ *P) {
+    auto Q = static_cast<xyzgridshiftData *>(P->opaque);
     if (Q->defer_grid_opening) {
         Q->defer_grid_opening = false;
         Q->grids = pj_generic_grid_init(P, "grids");
@@ -60,6 +60,16 @@ static bool get_grid_values(PJ *P, xyzgridshiftData *Q, const PJ_LP &lp,
             return false;
         }
     }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+static bool get_grid_values(PJ *P, xyzgridshiftData *Q, const PJ_LP &lp,
+                            double &dx, double &dy, double &dz) {
+    if (!open_deferred_grids(P)) {
+        return false;
+    }
 
     GenericShiftGridSet *gridset = nullptr;
     auto grid = pj_find_generic_grid(Q->grids, lp, gridset);
@@ -216,11 +226,20 @@ static void pj_xyzgridshift_reassign_context(PJ *P, PJ_CONTEXT *ctx) {
     }
 }
 
+static void pj_xyzgridshift_prepare_for_area(PJ *P, double west, double south,
+                                             double east, double north) {
+    auto Q = static_cast<xyzgridshiftData *>(P->opaque);
+    if (open_deferred_grids(P)) {
+        pj_prepare_grids_for_area(Q->grids, west, south, east, north);
+    }
+}
+
 PJ *PJ_TRANSFORMATION(xyzgridshift, 0) {
     auto Q = new xyzgridshiftData;
     P->opaque = (void *)Q;
     P->destructor = pj_xyzgridshift_destructor;
     P->reassign_context = pj_xyzgridshift_reassign_context;
+    P->prepare_for_area = pj_xyzgridshift_prepare_for_area;
 
     P->fwd4d = nullptr;
     P->inv4d = nullptr;
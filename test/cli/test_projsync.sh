@@ -41,8 +41,8 @@ cat ${TMP_OUT} | grep "at_bev_README.txt,,at_bev" >/dev/null || (cat ${TMP_OUT};
 
 export PROJ_USER_WRITABLE_DIRECTORY=tmp_user_writable_directory
 
-if test ! -f ${PROJ_USER_WRITABLE_DIRECTORY}/cache.db; then
-    echo "*** ERROR: Can not find ${PROJ_USER_WRITABLE_DIRECTORY}/cache.db!"
+if test ! -f ${PROJ_USER_WRITABLE_DIRECTORY}/cache_v2.db; then
+    echo "*** ERROR: Can not find ${PROJ_USER_WRITABLE_DIRECTORY}/cache_v2.db!"
     exit 100
 fi
 if test ! -f ${PROJ_USER_WRITABLE_DIRECTORY}/files.geojson; then
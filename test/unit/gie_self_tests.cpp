@@ -35,8 +35,15 @@
 #include "proj_internal.h"
 // clang-format on
 
+#include <atomic>
 #include <cmath>
 #include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <unistd.h>
+#endif
 
 namespace {
 
@@ -1090,6 +1097,1121 @@ TEST(gie, proj_create_crs_to_crs_PULKOVO42_ETRS89) {
 
 // ---------------------------------------------------------------------------
 
+TEST(gie, proj_trans_array_generic_with_alternative_operations) {
+    auto P = proj_create_crs_to_crs(PJ_DEFAULT_CTX, "EPSG:4179", "EPSG:4258",
+                                    nullptr);
+    ASSERT_TRUE(P != nullptr);
+
+    // Interleave runs of points in Romania, Poland, and outside of the area
+    // of use of all operations, so that several operations are selected
+    // within the same batch.
+    std::vector<PJ_COORD> input;
+    for (int i = 0; i < 600; i++) {
+        const int group = (i / 7) % 3;
+        const double lat = group == 0 ? 45 : group == 1 ? 52 : 0;
+        const double lon = group == 0 ? 25 : group == 1 ? 20 : -100;
+        input.push_back(proj_coord(lat + i * 1e-3, lon, 0, HUGE_VAL));
+    }
+
+    std::vector<PJ_COORD> expected;
+    for (const auto &c : input)
+        expected.push_back(proj_trans(P, PJ_FWD, c));
+
+    auto coords = input;
+    EXPECT_EQ(proj_trans_array(P, PJ_FWD, coords.size(), coords.data()), 0);
+    for (size_t i = 0; i < coords.size(); i++) {
+        EXPECT_EQ(coords[i].xy.x, expected[i].xy.x) << i;
+        EXPECT_EQ(coords[i].xy.y, expected[i].xy.y) << i;
+    }
+
+    coords = input;
+    EXPECT_EQ(proj_trans_generic(P, PJ_FWD, &(coords[0].xyz.x),
+                                 sizeof(PJ_COORD), coords.size(),
+                                 &(coords[0].xyz.y), sizeof(PJ_COORD),
+                                 coords.size(), &(coords[0].xyz.z),
+                                 sizeof(PJ_COORD), coords.size(), nullptr, 0,
+                                 0),
+              coords.size());
+    for (size_t i = 0; i < coords.size(); i++) {
+        EXPECT_EQ(coords[i].xy.x, expected[i].xy.x) << i;
+        EXPECT_EQ(coords[i].xy.y, expected[i].xy.y) << i;
+    }
+
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_trans_array_pipeline_with_failing_points) {
+    // A pipeline whose steps have array operators, with push/pop, and
+    // points failing in different steps. Points are processed by spans of
+    // 256: the first two spans only have valid points, and go through the
+    // array operators, whereas the next ones have failing points, and go
+    // through the per-point path.
+    const auto fails = [](int i) {
+        return i >= 512 && (i % 97 == 0 || i % 89 == 0);
+    };
+    auto P = proj_create(
+        PJ_DEFAULT_CTX,
+        "+proj=pipeline +step +proj=axisswap +order=2,1 "
+        "+step +proj=unitconvert +xy_in=deg +xy_out=rad +z_in=m +z_out=m "
+        "+step +proj=push +v_3 +step +proj=cart +ellps=intl "
+        "+step +proj=helmert +x=-87 +y=-98 +z=-121 "
+        "+step +inv +proj=cart +ellps=WGS84 +step +proj=pop +v_3 "
+        "+step +proj=utm +zone=32 +ellps=WGS84");
+    ASSERT_TRUE(P != nullptr);
+
+    std::vector<PJ_COORD> input;
+    for (int i = 0; i < 1000; i++) {
+        double lat = 40 + (i % 20);
+        double lon = 5 + (i % 10);
+        if (fails(i)) {
+            if (i % 97 == 0) {
+                lat = 95; // invalid latitude
+            } else {
+                // in the equatorial axis, at 90° of the central meridian
+                lat = 0;
+                lon = 9 + 90;
+            }
+        }
+        input.push_back(proj_coord(lat, lon, i, 0));
+    }
+
+    std::vector<PJ_COORD> expected;
+    std::vector<int> expectedErrno;
+    for (const auto &c : input) {
+        proj_errno_reset(P);
+        expected.push_back(proj_trans(P, PJ_FWD, c));
+        expectedErrno.push_back(proj_errno(P));
+    }
+
+    auto coords = input;
+    EXPECT_EQ(proj_trans_array(P, PJ_FWD, coords.size(), coords.data()),
+              PROJ_ERR_COORD_TRANSFM);
+    for (size_t i = 0; i < coords.size(); i++) {
+        EXPECT_EQ(coords[i].xyz.x, expected[i].xyz.x) << i;
+        EXPECT_EQ(coords[i].xyz.y, expected[i].xyz.y) << i;
+        EXPECT_EQ(coords[i].xyz.z, expected[i].xyz.z) << i;
+        if (fails(static_cast<int>(i))) {
+            EXPECT_EQ(coords[i].xyz.x, HUGE_VAL) << i;
+            EXPECT_NE(expectedErrno[i], 0) << i;
+        } else {
+            EXPECT_EQ(coords[i].xyz.z, static_cast<double>(i)) << i;
+            EXPECT_EQ(expectedErrno[i], 0) << i;
+        }
+    }
+
+    // And back. Points that failed in the forward direction are left as
+    // HUGE_VAL, which must be reported the same way as proj_trans() does.
+    int expectedInvErrno = 0;
+    for (auto &c : expected) {
+        proj_errno_reset(P);
+        c = proj_trans(P, PJ_INV, c);
+        const int err = proj_errno(P);
+        if (err != 0) {
+            if (expectedInvErrno == 0)
+                expectedInvErrno = err;
+            else if (expectedInvErrno != err)
+                expectedInvErrno = PROJ_ERR_COORD_TRANSFM;
+        }
+    }
+    EXPECT_EQ(proj_trans_array(P, PJ_INV, coords.size(), coords.data()),
+              expectedInvErrno);
+    for (size_t i = 0; i < coords.size(); i++) {
+        EXPECT_EQ(coords[i].xyz.x, expected[i].xyz.x) << i;
+        EXPECT_EQ(coords[i].xyz.y, expected[i].xyz.y) << i;
+        EXPECT_EQ(coords[i].xyz.z, expected[i].xyz.z) << i;
+    }
+
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_trans_array_grid_shifts) {
+    // hgridshift and vgridshift array operators, with points falling
+    // outside of the horizontal grid.
+    auto P = proj_create(
+        PJ_DEFAULT_CTX,
+        "+proj=pipeline "
+        "+step +proj=unitconvert +xy_in=deg +xy_out=rad +z_in=m +z_out=m "
+        "+step +proj=hgridshift +grids=ntf_r93.gsb "
+        "+step +proj=vgridshift +grids=egm96_15.gtx +multiplier=1 "
+        "+step +proj=unitconvert +xy_in=rad +xy_out=deg +z_in=m +z_out=m");
+    ASSERT_TRUE(P != nullptr);
+
+    std::vector<PJ_COORD> input;
+    for (int i = 0; i < 1000; i++) {
+        double lon = -4 + 0.0123 * i;
+        double lat = 43 + 0.0071 * i;
+        if (i % 97 == 0)
+            lon = 20; // outside of ntf_r93.gsb
+        input.push_back(proj_coord(lon, lat, i, 0));
+    }
+
+    for (auto direction : {PJ_FWD, PJ_INV}) {
+        std::vector<PJ_COORD> expected;
+        for (const auto &c : input) {
+            expected.push_back(proj_trans(P, direction, c));
+        }
+
+        auto coords = input;
+        EXPECT_EQ(proj_trans_array(P, direction, coords.size(), coords.data()),
+                  PROJ_ERR_COORD_TRANSFM_OUTSIDE_GRID);
+        for (size_t i = 0; i < coords.size(); i++) {
+            EXPECT_EQ(coords[i].xyz.x, expected[i].xyz.x) << i;
+            EXPECT_EQ(coords[i].xyz.y, expected[i].xyz.y) << i;
+            EXPECT_EQ(coords[i].xyz.z, expected[i].xyz.z) << i;
+            if (i % 97 == 0) {
+                EXPECT_EQ(coords[i].xyz.x, HUGE_VAL) << i;
+            } else {
+                EXPECT_NE(coords[i].xyz.x, input[i].xyz.x) << i;
+                EXPECT_NE(coords[i].xyz.z, input[i].xyz.z) << i;
+            }
+        }
+    }
+
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+static bool copyFile(const std::string &src, const std::string &dst) {
+    FILE *in = fopen(src.c_str(), "rb");
+    if (!in)
+        return false;
+    FILE *out = fopen(dst.c_str(), "wb");
+    if (!out) {
+        fclose(in);
+        return false;
+    }
+    char buffer[65536];
+    size_t nRead;
+    bool ok = true;
+    while ((nRead = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        if (fwrite(buffer, 1, nRead, out) != nRead) {
+            ok = false;
+            break;
+        }
+    }
+    fclose(in);
+    fclose(out);
+    return ok;
+}
+
+TEST(gie, proj_trans_array_grid_shifts_deferred_opening_failure) {
+    // hgridshift and vgridshift array operators, when the opening of grids
+    // deferred to the first transformed point fails: the results must be
+    // the same as with proj_trans().
+    const char *proj_data = getenv("PROJ_DATA");
+    ASSERT_TRUE(proj_data != nullptr);
+    const char *tempDir = getenv("TEMP");
+    if (!tempDir)
+        tempDir = getenv("TMP");
+    if (!tempDir)
+        tempDir = "/tmp";
+
+    const struct {
+        const char *refGrid;
+        const char *grid;
+        const char *def;
+    } tests[] = {
+        {"ntf_r93.gsb", "gie_deferred_opening_failure.gsb",
+         "+proj=hgridshift +grids=gie_deferred_opening_failure.gsb"},
+        {"egm96_15.gtx", "gie_deferred_opening_failure.gtx",
+         "+proj=vgridshift +grids=gie_deferred_opening_failure.gtx "
+         "+multiplier=1"},
+    };
+    for (const auto &test : tests) {
+        const std::string gridFilename =
+            std::string(tempDir) + '/' + test.grid;
+        ASSERT_TRUE(copyFile(std::string(proj_data) + '/' + test.refGrid,
+                             gridFilename));
+
+        auto ctx = proj_context_create();
+        proj_context_set_search_paths(ctx, 1, &tempDir);
+        // Registers the grid as known, so that later operations using it
+        // defer its opening to the first transformed point.
+        auto Pinit = proj_create(ctx, test.def);
+        ASSERT_TRUE(Pinit != nullptr);
+        proj_destroy(Pinit);
+        remove(gridFilename.c_str());
+
+        auto Pscalar = proj_create(ctx, test.def);
+        ASSERT_TRUE(Pscalar != nullptr);
+        auto Parray = proj_create(ctx, test.def);
+        ASSERT_TRUE(Parray != nullptr);
+
+        std::vector<PJ_COORD> coords;
+        for (int i = 0; i < 512; i++) {
+            coords.push_back(proj_coord((2 + 0.001 * i) / 180 * M_PI,
+                                        (47 + 0.001 * i) / 180 * M_PI, 0, 0));
+        }
+        std::vector<PJ_COORD> expected;
+        for (const auto &c : coords) {
+            expected.push_back(proj_trans(Pscalar, PJ_FWD, c));
+        }
+        EXPECT_EQ(expected[0].xyz.x, HUGE_VAL);
+
+        EXPECT_NE(proj_trans_array(Parray, PJ_FWD, coords.size(),
+                                   coords.data()),
+                  0);
+        for (size_t i = 0; i < coords.size(); i++) {
+            EXPECT_EQ(coords[i].xyz.x, expected[i].xyz.x) << i;
+            EXPECT_EQ(coords[i].xyz.y, expected[i].xyz.y) << i;
+            EXPECT_EQ(coords[i].xyz.z, expected[i].xyz.z) << i;
+        }
+
+        proj_destroy(Parray);
+        proj_destroy(Pscalar);
+        proj_context_destroy(ctx);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, helmert_time_dependent_does_not_depend_on_previous_calls) {
+    // Parameters at the observation time of a coordinate are computed without
+    // altering the PJ object, so that results do not depend on the
+    // observation time of previous coordinates.
+    auto P = proj_create(
+        PJ_DEFAULT_CTX,
+        "+proj=helmert +x=0.0127 +y=0.0065 +z=-0.0209 +s=0.00195 "
+        "+rx=-0.00039 +ry=0.0008 +rz=-0.00114 +dx=-0.0029 +dy=-0.0002 "
+        "+dz=-0.0006 +ds=0.00001 +drx=-0.00011 +dry=-0.00019 +drz=0.00007 "
+        "+t_epoch=1988.0 +convention=coordinate_frame +exact");
+    ASSERT_TRUE(P != nullptr);
+
+    std::vector<PJ_COORD> input;
+    for (int i = 0; i < 100; i++) {
+        // Runs of coordinates with the same observation time, some of them
+        // without observation time, or at the epoch of the parameters
+        const double t = (i % 10 == 0)   ? HUGE_VAL
+                         : (i % 10 == 1) ? 1988.0
+                                         : 2000.0 + (i / 3);
+        input.push_back(
+            proj_coord(3565285.0 + i, 855949.0 - i, 5201383.0 + i, t));
+    }
+
+    for (auto direction : {PJ_FWD, PJ_INV}) {
+        // Reference: each coordinate transformed by a fresh PJ object
+        std::vector<PJ_COORD> expected;
+        for (const auto &c : input) {
+            auto P2 = proj_clone(PJ_DEFAULT_CTX, P);
+            ASSERT_TRUE(P2 != nullptr);
+            expected.push_back(proj_trans(P2, direction, c));
+            proj_destroy(P2);
+        }
+
+        for (size_t i = 0; i < input.size(); i++) {
+            const auto res = proj_trans(P, direction, input[i]);
+            EXPECT_EQ(res.xyz.x, expected[i].xyz.x) << i;
+            EXPECT_EQ(res.xyz.y, expected[i].xyz.y) << i;
+            EXPECT_EQ(res.xyz.z, expected[i].xyz.z) << i;
+        }
+
+        auto coords = input;
+        EXPECT_EQ(proj_trans_array(P, direction, coords.size(), coords.data()),
+                  0);
+        for (size_t i = 0; i < coords.size(); i++) {
+            EXPECT_EQ(coords[i].xyz.x, expected[i].xyz.x) << i;
+            EXPECT_EQ(coords[i].xyz.y, expected[i].xyz.y) << i;
+            EXPECT_EQ(coords[i].xyz.z, expected[i].xyz.z) << i;
+        }
+    }
+
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_trans_array_tmerc) {
+    // Batch implementation of the exact and auto transverse mercator must
+    // give the same results as the single point one, including for points
+    // outside of the projection domain. Points are processed by spans of
+    // 256: the first two spans only have valid points, and go through the
+    // batch implementation, whereas the next ones have points outside of
+    // the domain, and go through the per-point path.
+    const auto fails = [](size_t i) { return i >= 512 && i % 97 == 0; };
+    for (const char *algo : {"poder_engsager", "auto"}) {
+        auto P = proj_create(
+            PJ_DEFAULT_CTX,
+            (std::string("+proj=pipeline "
+                         "+step +proj=unitconvert +xy_in=deg +xy_out=rad "
+                         "+step +proj=tmerc +lon_0=3 +k=0.9996 "
+                         "+x_0=500000 +ellps=GRS80 +algo=") +
+             algo)
+                .c_str());
+        ASSERT_TRUE(P != nullptr);
+
+        std::vector<PJ_COORD> input;
+        for (size_t i = 0; i < 1000; i++) {
+            double lon = -89 + 0.179 * i;
+            double lat = -85 + 0.17 * i;
+            if (i < 512) {
+                // Both close to and far from the central meridian, so that
+                // "auto" uses both algorithms in the same span
+                lon = 3 + ((i % 2) ? 0.01 * i : -0.1 * i);
+                lat = -80 + 0.3 * i;
+            } else if (fails(i)) {
+                // outside of the projection domain
+                lon = 3 + 89;
+                lat = 0;
+            }
+            input.push_back(proj_coord(lon, lat, 0, 0));
+        }
+
+        std::vector<PJ_COORD> expectedFwd;
+        for (const auto &c : input) {
+            expectedFwd.push_back(proj_trans(P, PJ_FWD, c));
+        }
+        auto coords = input;
+        proj_trans_array(P, PJ_FWD, coords.size(), coords.data());
+        for (size_t i = 0; i < coords.size(); i++) {
+            EXPECT_EQ(coords[i].xy.x, expectedFwd[i].xy.x) << algo << " " << i;
+            EXPECT_EQ(coords[i].xy.y, expectedFwd[i].xy.y) << algo << " " << i;
+            if (fails(i)) {
+                EXPECT_EQ(coords[i].xy.x, HUGE_VAL) << algo << " " << i;
+            }
+        }
+
+        // Add points outside of the domain of the inverse transformation
+        for (size_t i = 0; i < coords.size(); i++) {
+            if (fails(i))
+                coords[i] = proj_coord(500000 + 1e8, 0, 0, 0);
+        }
+        std::vector<PJ_COORD> expectedInv;
+        for (const auto &c : coords) {
+            expectedInv.push_back(proj_trans(P, PJ_INV, c));
+        }
+        proj_trans_array(P, PJ_INV, coords.size(), coords.data());
+        for (size_t i = 0; i < coords.size(); i++) {
+            EXPECT_EQ(coords[i].lp.lam, expectedInv[i].lp.lam)
+                << algo << " " << i;
+            EXPECT_EQ(coords[i].lp.phi, expectedInv[i].lp.phi)
+                << algo << " " << i;
+            if (fails(i)) {
+                EXPECT_EQ(coords[i].lp.lam, HUGE_VAL) << algo << " " << i;
+            } else {
+                EXPECT_NEAR(coords[i].lp.lam, input[i].lp.lam, 1e-8)
+                    << algo << " " << i;
+                EXPECT_NEAR(coords[i].lp.phi, input[i].lp.phi, 1e-8)
+                    << algo << " " << i;
+            }
+        }
+
+        proj_destroy(P);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_trans_array_parallel) {
+    auto P = proj_create_crs_to_crs(PJ_DEFAULT_CTX, "EPSG:4230", "EPSG:4326",
+                                    nullptr);
+    ASSERT_TRUE(P != nullptr);
+
+    std::vector<PJ_COORD> input;
+    for (int i = 0; i < 20000; i++) {
+        double lat = 35 + 0.002 * i;
+        double lon = -10 + 0.003 * i;
+        input.push_back(proj_coord(lat, lon, 10, 0));
+    }
+
+    std::vector<PJ_COORD> expected;
+    for (const auto &c : input) {
+        expected.push_back(proj_trans(P, PJ_FWD, c));
+    }
+    auto serial = input;
+    const int serialRet = proj_trans_array(P, PJ_FWD, serial.size(),
+                                           serial.data());
+
+    for (int threadCount : {0, 1, 4}) {
+        auto coords = input;
+        EXPECT_EQ(proj_trans_array_parallel(P, PJ_FWD, coords.size(),
+                                            coords.data(), threadCount),
+                  serialRet);
+        EXPECT_EQ(proj_errno(P), serialRet);
+        for (size_t i = 0; i < coords.size(); i++) {
+            EXPECT_EQ(coords[i].xy.x, expected[i].xy.x) << i;
+            EXPECT_EQ(coords[i].xy.y, expected[i].xy.y) << i;
+        }
+    }
+
+    // Strided arrays of x and y, and a constant z.
+    std::vector<double> x, y;
+    for (const auto &c : input) {
+        x.push_back(c.xy.x);
+        y.push_back(c.xy.y);
+    }
+    double z = 10;
+    EXPECT_EQ(proj_trans_generic_parallel(
+                  P, PJ_FWD, x.data(), sizeof(double), x.size(), y.data(),
+                  sizeof(double), y.size(), &z, sizeof(double), 1, nullptr, 0,
+                  0, 4),
+              input.size());
+    for (size_t i = 0; i < x.size(); i++) {
+        EXPECT_EQ(x[i], expected[i].xy.x) << i;
+        EXPECT_EQ(y[i], expected[i].xy.y) << i;
+    }
+    // The constant z gets the value of the last transformed point
+    double zSerial = 10;
+    proj_trans_generic(P, PJ_FWD, &input.back().xyz.x, sizeof(PJ_COORD), 1,
+                       &input.back().xyz.y, sizeof(PJ_COORD), 1, &zSerial,
+                       sizeof(double), 1, nullptr, 0, 0);
+    EXPECT_EQ(z, zSerial);
+
+    auto lastOp = proj_trans_get_last_used_operation(P);
+    EXPECT_NE(lastOp, nullptr);
+    proj_destroy(lastOp);
+
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_trans_generic_parallel_errno) {
+    auto P = proj_create(PJ_DEFAULT_CTX, "+proj=tmerc +approx +ellps=GRS80");
+    ASSERT_TRUE(P != nullptr);
+
+    // 4 parts of 1024 coordinates with 4 threads
+    const size_t n = 4096;
+    const auto transform = [P](std::vector<double> &x, std::vector<double> &y) {
+        return proj_trans_generic_parallel(
+            P, PJ_FWD, x.data(), sizeof(double), x.size(), y.data(),
+            sizeof(double), y.size(), nullptr, 0, 0, nullptr, 0, 0, 4);
+    };
+
+    // An error from a previous call must not be kept by a successful one
+    proj_errno_set(P, PROJ_ERR_COORD_TRANSFM_INVALID_COORD);
+    std::vector<double> x(n, 0.1);
+    std::vector<double> y(n, 0.5);
+    EXPECT_EQ(transform(x, y), n);
+    EXPECT_EQ(proj_errno(P), 0);
+
+    // The error is the one of the first part in error, in the order of the
+    // coordinates
+    x[1500] = 1.6; // outside of the projection domain
+    y[3500] = 2;   // invalid latitude
+    EXPECT_EQ(transform(x, y), n);
+    EXPECT_EQ(proj_errno(P), PROJ_ERR_COORD_TRANSFM_OUTSIDE_PROJECTION_DOMAIN);
+
+    x.assign(n, 0.1);
+    y.assign(n, 0.5);
+    x[3500] = 1.6;
+    y[1500] = 2;
+    EXPECT_EQ(transform(x, y), n);
+    EXPECT_EQ(proj_errno(P), PROJ_ERR_COORD_TRANSFM_INVALID_COORD);
+
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_trans_array_parallel_force_over) {
+    // The threads must use the +over setting of the operations
+    const char *const options[] = {"FORCE_OVER=YES", nullptr};
+    auto src = proj_create(PJ_DEFAULT_CTX, "EPSG:4326");
+    auto dst = proj_create(PJ_DEFAULT_CTX, "EPSG:3857");
+    auto P = proj_create_crs_to_crs_from_pj(PJ_DEFAULT_CTX, src, dst, nullptr,
+                                            options);
+    proj_destroy(src);
+    proj_destroy(dst);
+    ASSERT_TRUE(P != nullptr);
+
+    std::vector<PJ_COORD> input(8192, proj_coord(0, 200, 0, 0));
+    auto serial = input;
+    EXPECT_EQ(proj_trans_array(P, PJ_FWD, serial.size(), serial.data()), 0);
+    EXPECT_NEAR(serial[0].xy.x, 22263898, 1);
+
+    auto coords = input;
+    EXPECT_EQ(proj_trans_array_parallel(P, PJ_FWD, coords.size(),
+                                        coords.data(), 4),
+              0);
+    for (size_t i = 0; i < coords.size(); i++) {
+        EXPECT_EQ(coords[i].xy.x, serial[i].xy.x) << i;
+        EXPECT_EQ(coords[i].xy.y, serial[i].xy.y) << i;
+    }
+
+    // Same with a single operation
+    auto P2 = proj_create(PJ_DEFAULT_CTX,
+                          "+proj=pipeline +step +proj=axisswap +order=2,1 "
+                          "+step +proj=unitconvert +xy_in=deg +xy_out=rad "
+                          "+step +proj=webmerc +ellps=WGS84 +over");
+    ASSERT_TRUE(P2 != nullptr);
+    coords = input;
+    EXPECT_EQ(proj_trans_array_parallel(P2, PJ_FWD, coords.size(),
+                                        coords.data(), 4),
+              0);
+    for (size_t i = 0; i < coords.size(); i++) {
+        EXPECT_NEAR(coords[i].xy.x, serial[i].xy.x, 1e-6) << i;
+    }
+
+    proj_destroy(P2);
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+static void countingLogger(void *user_data, int, const char *) {
+    ++*static_cast<std::atomic<int> *>(user_data);
+}
+
+TEST(gie, proj_trans_array_parallel_context_change) {
+    // Changes of the settings of the context must reach the threads
+    PJ_CONTEXT *ctx = proj_context_create();
+    proj_log_level(ctx, PJ_LOG_NONE);
+    auto P = proj_create(ctx, "+proj=merc +ellps=WGS84");
+    ASSERT_TRUE(P != nullptr);
+
+    // Invalid latitude, reported as an error by every point
+    std::vector<PJ_COORD> input(8192, proj_coord(0, 2, 0, 0));
+    auto coords = input;
+    EXPECT_NE(proj_trans_array_parallel(P, PJ_FWD, coords.size(),
+                                        coords.data(), 4),
+              0);
+
+    std::atomic<int> count{0};
+    proj_log_func(ctx, &count, countingLogger);
+    proj_log_level(ctx, PJ_LOG_ERROR);
+    coords = input;
+    EXPECT_NE(proj_trans_array_parallel(P, PJ_FWD, coords.size(),
+                                        coords.data(), 4),
+              0);
+    const int countParallel = count;
+    count = 0;
+    coords = input;
+    EXPECT_NE(proj_trans_array(P, PJ_FWD, coords.size(), coords.data()), 0);
+    EXPECT_GT(count, 0);
+    EXPECT_EQ(countParallel, count);
+
+    proj_destroy(P);
+    proj_context_destroy(ctx);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_prepare_for_area) {
+    EXPECT_EQ(proj_prepare_for_area(nullptr, 0, 0, 1, 1), 0);
+
+    auto P = proj_create(PJ_DEFAULT_CTX,
+                         "+proj=pipeline +step +proj=unitconvert "
+                         "+xy_in=deg +xy_out=rad +step +proj=hgridshift "
+                         "+grids=tests/test_hgrid_tiled.tif +step "
+                         "+proj=unitconvert +xy_in=rad +xy_out=deg");
+    ASSERT_TRUE(P != nullptr);
+
+    // Invalid extents
+    EXPECT_EQ(proj_prepare_for_area(P, 0, 1, 1, 0), 0);
+    EXPECT_EQ(proj_prepare_for_area(P, 0, 0, 1, 91), 0);
+    proj_errno_reset(P);
+
+    unsigned long long hitsBefore = 0;
+    unsigned long long missesBefore = 0;
+    proj_context_get_tiff_block_cache_stats(PJ_DEFAULT_CTX, &hitsBefore,
+                                            &missesBefore);
+    EXPECT_EQ(proj_prepare_for_area(P, 4, 52, 5, 53), 1);
+    unsigned long long hits = 0;
+    unsigned long long misses = 0;
+    proj_context_get_tiff_block_cache_stats(PJ_DEFAULT_CTX, &hits, &misses);
+    EXPECT_GT(misses, missesBefore);
+
+    // The blocks needed by coordinates within the extent are already decoded
+    missesBefore = misses;
+    const auto c = proj_trans(P, PJ_FWD, proj_coord(4.5, 52.5, 0, 0));
+    EXPECT_NEAR(c.xy.x, 5.875, 1e-8);
+    EXPECT_NEAR(c.xy.y, 55.375, 1e-8);
+    proj_context_get_tiff_block_cache_stats(PJ_DEFAULT_CTX, &hits, &misses);
+    EXPECT_EQ(misses, missesBefore);
+
+    proj_destroy(P);
+
+    // Alternative operations of proj_create_crs_to_crs(). NTF to RGF93 v1
+    // uses fr_ign_ntf_r93.tif, replaced here by a tiled GeoTIFF grid, so that
+    // the loading of its blocks can be observed.
+    const char *proj_data = getenv("PROJ_DATA");
+    ASSERT_TRUE(proj_data != nullptr);
+    const char *tempDir = getenv("TEMP");
+    if (!tempDir)
+        tempDir = getenv("TMP");
+    if (!tempDir)
+        tempDir = "/tmp";
+    const std::string gridFilename =
+        std::string(tempDir) + "/fr_ign_ntf_r93.tif";
+    ASSERT_TRUE(copyFile(std::string(proj_data) + "/tests/test_hgrid_tiled.tif",
+                         gridFilename));
+    auto ctx = proj_context_create();
+    const char *searchPaths[] = {tempDir, proj_data};
+    proj_context_set_search_paths(ctx, 2, searchPaths);
+
+    P = proj_create_crs_to_crs(ctx, "EPSG:4275", "EPSG:4171", nullptr);
+    ASSERT_TRUE(P != nullptr);
+    EXPECT_EQ(P->alternativeCoordinateOperations.size(), 2U);
+
+    // Extent crossing the antimeridian, outside of the area of use of the
+    // grid based operation
+    proj_context_get_tiff_block_cache_stats(ctx, &hitsBefore, &missesBefore);
+    EXPECT_EQ(proj_prepare_for_area(P, 170, -10, -170, 10), 1);
+    proj_context_get_tiff_block_cache_stats(ctx, &hits, &misses);
+    EXPECT_EQ(misses, missesBefore);
+
+    EXPECT_EQ(proj_prepare_for_area(P, 1, 45, 3, 47), 1);
+    EXPECT_EQ(proj_errno(P), 0);
+    proj_context_get_tiff_block_cache_stats(ctx, &hits, &misses);
+    EXPECT_GT(misses, missesBefore);
+
+    missesBefore = misses;
+    const auto c2 = proj_trans(P, PJ_FWD, proj_coord(46, 2, 0, 0));
+    EXPECT_NE(c2.xy.x, HUGE_VAL);
+    proj_context_get_tiff_block_cache_stats(ctx, &hits, &misses);
+    EXPECT_EQ(misses, missesBefore);
+
+    proj_destroy(P);
+    proj_context_destroy(ctx);
+    remove(gridFilename.c_str());
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_create_crs_to_crs_many_alternative_operations) {
+    // ED50 to WGS 84 has enough alternative operations for their areas of
+    // use to be spatially indexed. Check that the operation selected by
+    // proj_trans() is consistent across longitude wrap-around, cloning and
+    // axis order normalization.
+    auto P = proj_create_crs_to_crs(PJ_DEFAULT_CTX, "EPSG:4230", "EPSG:4326",
+                                    nullptr);
+    ASSERT_TRUE(P != nullptr);
+    auto Pclone = proj_clone(PJ_DEFAULT_CTX, P);
+    ASSERT_TRUE(Pclone != nullptr);
+    auto Pnormalized = proj_normalize_for_visualization(PJ_DEFAULT_CTX, P);
+    ASSERT_TRUE(Pnormalized != nullptr);
+
+    for (double lat = 25.5; lat < 80; lat += 2) {
+        for (double lon = -20.5; lon < 50; lon += 2) {
+            const auto expected =
+                proj_trans(P, PJ_FWD, proj_coord(lat, lon, 0, 0));
+            if (expected.xy.x == HUGE_VAL)
+                continue;
+
+            auto res = proj_trans(P, PJ_FWD, proj_coord(lat, lon + 360, 0, 0));
+            EXPECT_NEAR(res.xy.x, expected.xy.x, 1e-12) << lat << " " << lon;
+            // Longitude may or may not be normalized depending on the
+            // operation
+            EXPECT_NEAR(fmod(res.xy.y - expected.xy.y + 540, 360) - 180, 0,
+                        1e-9)
+                << lat << " " << lon;
+
+            res = proj_trans(Pclone, PJ_FWD, proj_coord(lat, lon, 0, 0));
+            EXPECT_EQ(res.xy.x, expected.xy.x) << lat << " " << lon;
+            EXPECT_EQ(res.xy.y, expected.xy.y) << lat << " " << lon;
+
+            res = proj_trans(Pnormalized, PJ_FWD, proj_coord(lon, lat, 0, 0));
+            EXPECT_EQ(res.xy.x, expected.xy.y) << lat << " " << lon;
+            EXPECT_EQ(res.xy.y, expected.xy.x) << lat << " " << lon;
+        }
+    }
+
+    proj_destroy(Pnormalized);
+    proj_destroy(Pclone);
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_create_crs_to_crs_lazy_instantiation) {
+    auto P = proj_create_crs_to_crs(PJ_DEFAULT_CTX, "EPSG:4230", "EPSG:4326",
+                                    nullptr);
+    ASSERT_TRUE(P != nullptr);
+
+    auto src = proj_create(PJ_DEFAULT_CTX, "EPSG:4230");
+    auto dst = proj_create(PJ_DEFAULT_CTX, "EPSG:4326");
+    {
+        const char *const options[] = {"LAZY_INSTANTIATION=maybe", nullptr};
+        EXPECT_EQ(proj_create_crs_to_crs_from_pj(PJ_DEFAULT_CTX, src, dst,
+                                                 nullptr, options),
+                  nullptr);
+    }
+    const char *const options[] = {"LAZY_INSTANTIATION=YES", nullptr};
+    auto Plazy = proj_create_crs_to_crs_from_pj(PJ_DEFAULT_CTX, src, dst,
+                                                nullptr, options);
+    proj_destroy(src);
+    proj_destroy(dst);
+    ASSERT_TRUE(Plazy != nullptr);
+
+    const auto countInstantiated = [](const PJ *obj) {
+        size_t count = 0;
+        for (const auto &alt : obj->alternativeCoordinateOperations) {
+            if (alt.isInstantiated) {
+                EXPECT_NE(alt.pj->fwd4d, nullptr);
+                count++;
+            } else {
+                EXPECT_EQ(alt.pj->fwd4d, nullptr);
+            }
+        }
+        return count;
+    };
+
+    const size_t nOps = Plazy->alternativeCoordinateOperations.size();
+    ASSERT_EQ(nOps, P->alternativeCoordinateOperations.size());
+    EXPECT_EQ(countInstantiated(P), nOps);
+    EXPECT_EQ(countInstantiated(Plazy), 0U);
+    // Operations can be selected without being instantiated
+    EXPECT_EQ(std::string(proj_pj_info(Plazy).definition),
+              "unavailable until proj_trans is called");
+
+    // Clones remain lazy
+    auto PlazyClone = proj_clone(PJ_DEFAULT_CTX, Plazy);
+    ASSERT_TRUE(PlazyClone != nullptr);
+    EXPECT_EQ(countInstantiated(PlazyClone), 0U);
+
+    // And so do normalized objects
+    auto PlazyNormalized =
+        proj_normalize_for_visualization(PJ_DEFAULT_CTX, Plazy);
+    ASSERT_TRUE(PlazyNormalized != nullptr);
+    EXPECT_EQ(countInstantiated(PlazyNormalized), 0U);
+    auto Pnormalized = proj_normalize_for_visualization(PJ_DEFAULT_CTX, P);
+    ASSERT_TRUE(Pnormalized != nullptr);
+
+    // Spain and Denmark
+    for (const auto &coord :
+         {proj_coord(40.5, -3.5, 0, 0), proj_coord(55.5, 10.5, 0, 0)}) {
+        const auto expected = proj_trans(P, PJ_FWD, coord);
+        auto res = proj_trans(Plazy, PJ_FWD, coord);
+        EXPECT_EQ(res.xy.x, expected.xy.x);
+        EXPECT_EQ(res.xy.y, expected.xy.y);
+        res = proj_trans(PlazyClone, PJ_FWD, coord);
+        EXPECT_EQ(res.xy.x, expected.xy.x);
+        EXPECT_EQ(res.xy.y, expected.xy.y);
+
+        const auto coordNormalized =
+            proj_coord(coord.xy.y, coord.xy.x, 0, 0);
+        const auto expectedNormalized =
+            proj_trans(Pnormalized, PJ_FWD, coordNormalized);
+        res = proj_trans(PlazyNormalized, PJ_FWD, coordNormalized);
+        EXPECT_EQ(res.xy.x, expectedNormalized.xy.x);
+        EXPECT_EQ(res.xy.y, expectedNormalized.xy.y);
+
+        auto lastOp = proj_trans_get_last_used_operation(P);
+        auto lastOpLazy = proj_trans_get_last_used_operation(Plazy);
+        ASSERT_TRUE(lastOp != nullptr);
+        ASSERT_TRUE(lastOpLazy != nullptr);
+        EXPECT_EQ(std::string(proj_pj_info(lastOpLazy).definition),
+                  std::string(proj_pj_info(lastOp).definition));
+        proj_destroy(lastOp);
+        proj_destroy(lastOpLazy);
+    }
+
+    // Only the selected operations have been instantiated
+    const size_t nInstantiated = countInstantiated(Plazy);
+    EXPECT_GE(nInstantiated, 2U);
+    EXPECT_LT(nInstantiated, nOps);
+    EXPECT_LT(countInstantiated(PlazyNormalized), nOps);
+
+    proj_destroy(Pnormalized);
+    proj_destroy(PlazyNormalized);
+    proj_destroy(PlazyClone);
+    proj_destroy(Plazy);
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+#ifndef _WIN32
+TEST(gie, proj_create_crs_to_crs_persistent_cache) {
+    const char *tempDir = getenv("TEMP");
+    if (!tempDir)
+        tempDir = getenv("TMP");
+    if (!tempDir)
+        tempDir = "/tmp";
+    const std::string userDir(std::string(tempDir) + "/gie_crs_to_crs_cache_" +
+                              std::to_string(getpid()));
+    const std::string cacheDir(userDir + "/crs_to_crs_cache");
+
+    auto ctx = proj_context_create();
+    proj_context_set_user_writable_directory(ctx, userDir.c_str(), true);
+
+    const auto create = [ctx](const char *srcCRS, const char *dstCRS,
+                              bool lazy) {
+        auto src = proj_create(ctx, srcCRS);
+        auto dst = proj_create(ctx, dstCRS);
+        const char *const options[] = {lazy ? "LAZY_INSTANTIATION=YES"
+                                            : "LAZY_INSTANTIATION=NO",
+                                       nullptr};
+        auto P = proj_create_crs_to_crs_from_pj(ctx, src, dst, nullptr,
+                                                options);
+        proj_destroy(src);
+        proj_destroy(dst);
+        return P;
+    };
+
+    const auto idCode = [](const PJ *obj) {
+        const char *code = proj_get_id_code(obj, 0);
+        return std::string(code ? code : "");
+    };
+
+    // Check that the ISO-19111 objects of a result restored from the cache
+    // are the ones of the reference result
+    const auto checkISOObjects = [ctx](PJ *obj, PJ *ref) {
+        for (const auto getCRS : {proj_get_source_crs, proj_get_target_crs}) {
+            auto crs = getCRS(ctx, obj);
+            auto crsRef = getCRS(ctx, ref);
+            ASSERT_TRUE(crs != nullptr);
+            ASSERT_TRUE(crsRef != nullptr);
+            EXPECT_TRUE(
+                proj_is_equivalent_to(crs, crsRef, PJ_COMP_EQUIVALENT));
+            EXPECT_STREQ(proj_get_id_code(crs, 0), proj_get_id_code(crsRef, 0));
+            proj_destroy(crs);
+            proj_destroy(crsRef);
+        }
+
+        // Spain, in longitude, latitude order
+        auto objNormalized = proj_normalize_for_visualization(ctx, obj);
+        auto refNormalized = proj_normalize_for_visualization(ctx, ref);
+        ASSERT_TRUE(objNormalized != nullptr);
+        ASSERT_TRUE(refNormalized != nullptr);
+        const auto coord = proj_coord(-3.5, 40.5, 0, 0);
+        const auto res = proj_trans(objNormalized, PJ_FWD, coord);
+        const auto expected = proj_trans(refNormalized, PJ_FWD, coord);
+        EXPECT_EQ(res.xy.x, expected.xy.x);
+        EXPECT_EQ(res.xy.y, expected.xy.y);
+        proj_destroy(objNormalized);
+        proj_destroy(refNormalized);
+
+        double bounds[4];
+        double boundsRef[4];
+        ASSERT_TRUE(proj_trans_bounds(ctx, obj, PJ_FWD, 40, -4, 41, -3,
+                                      &bounds[0], &bounds[1], &bounds[2],
+                                      &bounds[3], 21));
+        ASSERT_TRUE(proj_trans_bounds(ctx, ref, PJ_FWD, 40, -4, 41, -3,
+                                      &boundsRef[0], &boundsRef[1],
+                                      &boundsRef[2], &boundsRef[3], 21));
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_EQ(bounds[i], boundsRef[i]);
+        }
+    };
+
+    int opsWithId = 0;
+    for (const char *dstCRS : {"EPSG:4326", "EPSG:25830"}) {
+        proj_context_set_crs_to_crs_cache_enable(ctx, false);
+        auto Pref = create("EPSG:4230", dstCRS, false);
+        ASSERT_TRUE(Pref != nullptr);
+
+        proj_context_set_crs_to_crs_cache_enable(ctx, true);
+        // Fills the cache
+        proj_destroy(create("EPSG:4230", dstCRS, false));
+        // Restored from the cache
+        auto P = create("EPSG:4230", dstCRS, false);
+        ASSERT_TRUE(P != nullptr);
+        auto Plazy = create("EPSG:4230", dstCRS, true);
+        ASSERT_TRUE(Plazy != nullptr);
+
+        const auto &refOps = Pref->alternativeCoordinateOperations;
+        ASSERT_GT(refOps.size(), 1U);
+        for (const auto *obj : {P, Plazy}) {
+            const auto &ops = obj->alternativeCoordinateOperations;
+            ASSERT_EQ(ops.size(), refOps.size());
+            for (size_t i = 0; i < ops.size(); ++i) {
+                EXPECT_EQ(ops[i].name, refOps[i].name);
+                EXPECT_EQ(ops[i].accuracy, refOps[i].accuracy);
+                EXPECT_EQ(ops[i].minxSrc, refOps[i].minxSrc);
+                EXPECT_EQ(ops[i].maxySrc, refOps[i].maxySrc);
+                EXPECT_EQ(ops[i].isInstantiated, obj == P);
+                EXPECT_TRUE(ops[i].pj->iso_obj != nullptr);
+                EXPECT_EQ(idCode(ops[i].pj), idCode(refOps[i].pj));
+                if (!idCode(refOps[i].pj).empty())
+                    opsWithId++;
+            }
+        }
+        checkISOObjects(P, Pref);
+        checkISOObjects(Plazy, Pref);
+
+        // Spain and Denmark
+        for (const auto &coord :
+             {proj_coord(40.5, -3.5, 0, 0), proj_coord(55.5, 10.5, 0, 0)}) {
+            const auto expected = proj_trans(Pref, PJ_FWD, coord);
+            for (auto *obj : {P, Plazy}) {
+                const auto res = proj_trans(obj, PJ_FWD, coord);
+                EXPECT_EQ(res.xy.x, expected.xy.x);
+                EXPECT_EQ(res.xy.y, expected.xy.y);
+            }
+        }
+
+        proj_destroy(Plazy);
+        proj_destroy(P);
+        proj_destroy(Pref);
+    }
+
+    EXPECT_GT(opsWithId, 0);
+
+    // Single operation
+    proj_context_set_crs_to_crs_cache_enable(ctx, false);
+    auto Pref = create("EPSG:4171", "EPSG:4326", false);
+    ASSERT_TRUE(Pref != nullptr);
+    proj_context_set_crs_to_crs_cache_enable(ctx, true);
+    proj_destroy(create("EPSG:4171", "EPSG:4326", false));
+    auto P = create("EPSG:4171", "EPSG:4326", false);
+    ASSERT_TRUE(P != nullptr);
+    EXPECT_TRUE(P->alternativeCoordinateOperations.empty());
+    EXPECT_EQ(idCode(P), idCode(Pref));
+    EXPECT_FALSE(idCode(P).empty());
+    checkISOObjects(P, Pref);
+    proj_destroy(P);
+    proj_destroy(Pref);
+
+    // Conversions are not cached, since their PROJJSON does not hold their
+    // source and target CRS
+    proj_destroy(create("EPSG:4326", "EPSG:32631", false));
+    P = create("EPSG:4326", "EPSG:32631", false);
+    ASSERT_TRUE(P != nullptr);
+    auto crs = proj_get_target_crs(ctx, P);
+    EXPECT_TRUE(crs != nullptr);
+    proj_destroy(crs);
+    const auto res = proj_trans(P, PJ_FWD, proj_coord(49, 3, 0, 0));
+    EXPECT_NEAR(res.xy.x, 500000, 1e-3);
+    proj_destroy(P);
+
+    proj_context_destroy(ctx);
+
+    DIR *dir = opendir(cacheDir.c_str());
+    ASSERT_TRUE(dir != nullptr);
+    int count = 0;
+    while (const struct dirent *entry = readdir(dir)) {
+        const std::string name(entry->d_name);
+        if (name != "." && name != "..") {
+            remove((cacheDir + '/' + name).c_str());
+            count++;
+        }
+    }
+    closedir(dir);
+    EXPECT_EQ(count, 3);
+    rmdir(cacheDir.c_str());
+    rmdir(userDir.c_str());
+}
+#endif
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_create_from_compiled) {
+    auto ctx = proj_context_create();
+
+    EXPECT_EQ(proj_create_from_compiled(ctx, "invalid", nullptr), nullptr);
+    EXPECT_EQ(proj_context_errno(ctx), PROJ_ERR_INVALID_OP_WRONG_SYNTAX);
+    {
+        auto crs = proj_create(ctx, "EPSG:4326");
+        ASSERT_TRUE(crs != nullptr);
+        EXPECT_EQ(proj_as_compiled(ctx, crs, nullptr), nullptr);
+        proj_destroy(crs);
+    }
+
+    // Several candidate operations
+    auto P = proj_create_crs_to_crs(ctx, "EPSG:4230", "EPSG:4326", nullptr);
+    ASSERT_TRUE(P != nullptr);
+    const char *compiled = proj_as_compiled(ctx, P, nullptr);
+    ASSERT_TRUE(compiled != nullptr);
+    auto Pcompiled = proj_create_from_compiled(ctx, compiled, nullptr);
+    ASSERT_TRUE(Pcompiled != nullptr);
+    EXPECT_EQ(std::string(proj_as_compiled(ctx, Pcompiled, nullptr)),
+              std::string(compiled));
+
+    const auto &ops = Pcompiled->alternativeCoordinateOperations;
+    const auto &opsRef = P->alternativeCoordinateOperations;
+    ASSERT_EQ(ops.size(), opsRef.size());
+    ASSERT_GT(ops.size(), 1U);
+    for (size_t i = 0; i < ops.size(); ++i) {
+        EXPECT_EQ(ops[i].name, opsRef[i].name);
+        EXPECT_EQ(ops[i].accuracy, opsRef[i].accuracy);
+        EXPECT_EQ(ops[i].minxSrc, opsRef[i].minxSrc);
+        EXPECT_EQ(ops[i].maxySrc, opsRef[i].maxySrc);
+    }
+    auto Pclone = proj_clone(ctx, Pcompiled);
+    ASSERT_TRUE(Pclone != nullptr);
+    for (const auto &coord :
+         {proj_coord(40, -3, 0, 0), proj_coord(56, 10, 0, 0)}) {
+        const auto expected = proj_trans(P, PJ_FWD, coord);
+        auto res = proj_trans(Pcompiled, PJ_FWD, coord);
+        EXPECT_EQ(res.xy.x, expected.xy.x);
+        EXPECT_EQ(res.xy.y, expected.xy.y);
+        res = proj_trans(Pclone, PJ_FWD, coord);
+        EXPECT_EQ(res.xy.x, expected.xy.x);
+        EXPECT_EQ(res.xy.y, expected.xy.y);
+    }
+    proj_destroy(Pclone);
+    proj_destroy(Pcompiled);
+
+    // Clones of the original object, once compiled, keep their ISO-19111
+    // objects
+    Pclone = proj_clone(ctx, P);
+    ASSERT_TRUE(Pclone != nullptr);
+    ASSERT_EQ(Pclone->alternativeCoordinateOperations.size(), opsRef.size());
+    for (const auto &op : Pclone->alternativeCoordinateOperations) {
+        EXPECT_TRUE(op.pj->iso_obj != nullptr);
+    }
+    auto crs = proj_get_source_crs(ctx, Pclone);
+    EXPECT_TRUE(crs != nullptr);
+    proj_destroy(crs);
+    proj_destroy(Pclone);
+    proj_destroy(P);
+
+    // Single operation, loaded without access to the database
+    P = proj_create_crs_to_crs(ctx, "EPSG:4326", "EPSG:32631", nullptr);
+    ASSERT_TRUE(P != nullptr);
+    compiled = proj_as_compiled(ctx, P, nullptr);
+    ASSERT_TRUE(compiled != nullptr);
+
+    auto ctxNoDb = proj_context_create();
+    const char *searchPath = "/i_do_not/exist";
+    proj_context_set_search_paths(ctxNoDb, 1, &searchPath);
+    const char *const options[] = {"FORCE_OVER=YES", nullptr};
+    Pcompiled = proj_create_from_compiled(ctxNoDb, compiled, options);
+    ASSERT_TRUE(Pcompiled != nullptr);
+    EXPECT_TRUE(Pcompiled->over);
+    const auto res = proj_trans(Pcompiled, PJ_FWD, proj_coord(49, 3, 0, 0));
+    EXPECT_NEAR(res.xy.x, 500000, 1e-3);
+    EXPECT_EQ(proj_context_get_database_path(ctxNoDb), nullptr);
+    proj_destroy(Pcompiled);
+    proj_context_destroy(ctxNoDb);
+    proj_destroy(P);
+
+    proj_context_destroy(ctx);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_trans_spatially_coherent_points) {
+    // proj_trans() first tries the neighbourhood of the last used operation.
+    // Check that it selects the same operation as a fresh object would, on a
+    // track crossing several areas of use, onshore and offshore.
+    auto P = proj_create_crs_to_crs(PJ_DEFAULT_CTX, "EPSG:4230", "EPSG:4326",
+                                    nullptr);
+    ASSERT_TRUE(P != nullptr);
+
+    for (int i = 0; i <= 100; i++) {
+        const double lat = 36.5 + i * 0.3;
+        const double lon = -8.5 + i * 0.2;
+        const auto coord = proj_coord(lat, lon, 0, 0);
+
+        auto Pfresh = proj_clone(PJ_DEFAULT_CTX, P);
+        ASSERT_TRUE(Pfresh != nullptr);
+        auto expected = proj_trans(Pfresh, PJ_FWD, coord);
+        auto res = proj_trans(P, PJ_FWD, coord);
+        EXPECT_EQ(res.xy.x, expected.xy.x) << i;
+        EXPECT_EQ(res.xy.y, expected.xy.y) << i;
+        proj_destroy(Pfresh);
+
+        Pfresh = proj_clone(PJ_DEFAULT_CTX, P);
+        ASSERT_TRUE(Pfresh != nullptr);
+        expected = proj_trans(Pfresh, PJ_INV, coord);
+        res = proj_trans(P, PJ_INV, coord);
+        EXPECT_EQ(res.xy.x, expected.xy.x) << i;
+        EXPECT_EQ(res.xy.y, expected.xy.y) << i;
+        proj_destroy(Pfresh);
+    }
+
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(gie, proj_create_crs_to_crs_WGS84_EGM08_to_WGS84) {
     auto P = proj_create_crs_to_crs(PJ_DEFAULT_CTX, "EPSG:4326+3855",
                                     "EPSG:4979", nullptr);
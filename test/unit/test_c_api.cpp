@@ -2280,6 +2280,132 @@ TEST_F(CApi, proj_context_set_database_path_error_2) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(CApi, proj_context_set_shared_object_cache_size) {
+
+    auto ctx1 = proj_context_create();
+    PjContextKeeper keeper_ctx1(ctx1);
+    proj_context_set_shared_object_cache_size(ctx1, 1000);
+
+    auto ctx2 = proj_context_clone(ctx1);
+    PjContextKeeper keeper_ctx2(ctx2);
+
+    auto ctx3 = proj_context_create();
+    PjContextKeeper keeper_ctx3(ctx3);
+    proj_context_set_object_cache_size(ctx3, 10);
+
+    const auto createCRS = [](PJ_CONTEXT *ctx) {
+        auto factory = AuthorityFactory::create(
+            DatabaseContext::create(std::string(), {}, ctx), "EPSG");
+        return factory->createCoordinateReferenceSystem("4326");
+    };
+    const auto createOps = [](PJ_CONTEXT *ctx) {
+        auto factory = AuthorityFactory::create(
+            DatabaseContext::create(std::string(), {}, ctx), "EPSG");
+        return factory->createFromCoordinateReferenceSystemCodes("4230",
+                                                                 "4326");
+    };
+
+    // Objects built by a context are reused by the other ones sharing the
+    // cache
+    const auto crs1 = createCRS(ctx1);
+    EXPECT_EQ(createCRS(ctx2).get(), crs1.get());
+    EXPECT_NE(createCRS(ctx3).get(), crs1.get());
+
+    const auto ops1 = createOps(ctx1);
+    ASSERT_FALSE(ops1.empty());
+    const auto ops2 = createOps(ctx2);
+    ASSERT_EQ(ops2.size(), ops1.size());
+    EXPECT_EQ(ops2.front().get(), ops1.front().get());
+    const auto ops3 = createOps(ctx3);
+    ASSERT_EQ(ops3.size(), ops1.size());
+    EXPECT_NE(ops3.front().get(), ops1.front().get());
+
+    // Objects built during an insertion session are not shared
+    {
+        auto dbContext = DatabaseContext::create(std::string(), {}, ctx2);
+        dbContext->startInsertStatementsSession();
+        auto factory = AuthorityFactory::create(dbContext, "EPSG");
+        EXPECT_NE(factory->createCoordinateReferenceSystem("4326").get(),
+                  crs1.get());
+        dbContext->stopInsertStatementsSession();
+    }
+    EXPECT_EQ(createCRS(ctx2).get(), crs1.get());
+
+    proj_context_set_object_cache_size(ctx3, 0);
+    EXPECT_EQ(proj_context_errno(ctx3), PROJ_ERR_OTHER_API_MISUSE);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST_F(CApi, proj_context_set_database_open_mode) {
+
+    EXPECT_FALSE(proj_context_set_database_open_mode(m_ctxt, "invalid"));
+    EXPECT_EQ(proj_context_errno(m_ctxt), PROJ_ERR_OTHER_API_MISUSE);
+    EXPECT_FALSE(proj_context_set_database_open_mode(m_ctxt, nullptr));
+
+    const char *tempdir = getenv("TEMP");
+    if (!tempdir) {
+        tempdir = getenv("TMP");
+    }
+    if (!tempdir) {
+        tempdir = "/tmp";
+    }
+    const std::string auxDbName(std::string(tempdir) +
+                                "/test_proj_context_set_database_open_mode.db");
+    std::remove(auxDbName.c_str());
+
+    sqlite3 *dbAux = nullptr;
+    sqlite3_open_v2(auxDbName.c_str(), &dbAux,
+                    SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr);
+    ASSERT_TRUE(dbAux != nullptr);
+    ASSERT_TRUE(sqlite3_exec(dbAux, "BEGIN", nullptr, nullptr, nullptr) ==
+                SQLITE_OK);
+    {
+        auto ctxt = DatabaseContext::create();
+        const auto dbStructure = ctxt->getDatabaseStructure();
+        for (const auto &sql : dbStructure) {
+            ASSERT_TRUE(sqlite3_exec(dbAux, sql.c_str(), nullptr, nullptr,
+                                     nullptr) == SQLITE_OK);
+        }
+    }
+    ASSERT_TRUE(sqlite3_exec(
+                    dbAux,
+                    "INSERT INTO geodetic_crs VALUES('OTHER','OTHER_4326','WGS "
+                    "84',NULL,'geographic 2D','EPSG','6422','EPSG','6326',"
+                    "NULL,0);",
+                    nullptr, nullptr, nullptr) == SQLITE_OK);
+    ASSERT_TRUE(sqlite3_exec(dbAux, "COMMIT", nullptr, nullptr, nullptr) ==
+                SQLITE_OK);
+    sqlite3_close(dbAux);
+
+    for (const char *mode : {"IMMUTABLE", "mmap", "Memory", "DEFAULT"}) {
+        auto ctx = proj_context_create();
+        PjContextKeeper keeper_ctx(ctx);
+        EXPECT_TRUE(proj_context_set_database_open_mode(ctx, mode)) << mode;
+
+        auto P = proj_create_crs_to_crs(ctx, "EPSG:4230", "EPSG:4326",
+                                        nullptr);
+        ASSERT_NE(P, nullptr) << mode;
+        ObjectKeeper keeper_P(P);
+
+        const char *const aux_db_list[] = {auxDbName.c_str(), nullptr};
+        EXPECT_TRUE(proj_context_set_database_path(ctx, nullptr, aux_db_list,
+                                                   nullptr))
+            << mode;
+        for (const char *code : {"4326", "OTHER_4326"}) {
+            auto crs = proj_create_from_database(
+                ctx, code[0] == 'O' ? "OTHER" : "EPSG", code, PJ_CATEGORY_CRS,
+                false, nullptr);
+            ASSERT_NE(crs, nullptr) << mode << " " << code;
+            ObjectKeeper keeper_crs(crs);
+        }
+    }
+
+    std::remove(auxDbName.c_str());
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(CApi, proj_context_guess_wkt_dialect) {
 
     EXPECT_EQ(proj_context_guess_wkt_dialect(nullptr, "LOCAL_CS[\"foo\"]"),
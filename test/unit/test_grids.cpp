@@ -32,6 +32,13 @@
 
 #include "proj_internal.h" // M_PI
 
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
 namespace {
 
 // ---------------------------------------------------------------------------
@@ -96,6 +103,283 @@ TEST_F(GridTest, VerticalShiftGridSet_gtx) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(GridTest, VerticalShiftGridSet_gtx_load_in_memory) {
+    proj_context_set_load_grids_in_memory(m_ctxt2, true);
+    for (const char *filename :
+         {"tests/test_nodata.gtx", "tests/egm96_15_downsampled.gtx"}) {
+        auto gridSet = NS_PROJ::VerticalShiftGridSet::open(m_ctxt, filename);
+        ASSERT_NE(gridSet, nullptr);
+        auto gridSetInMemory =
+            NS_PROJ::VerticalShiftGridSet::open(m_ctxt2, filename);
+        ASSERT_NE(gridSetInMemory, nullptr);
+        ASSERT_EQ(gridSet->grids().size(), 1U);
+        ASSERT_EQ(gridSetInMemory->grids().size(), 1U);
+        const auto &grid = gridSet->grids()[0];
+        const auto &gridInMemory = gridSetInMemory->grids()[0];
+        ASSERT_EQ(grid->width(), gridInMemory->width());
+        ASSERT_EQ(grid->height(), gridInMemory->height());
+        for (int y = 0; y < grid->height(); ++y) {
+            for (int x = 0; x < grid->width(); ++x) {
+                float out = -1.0f;
+                float outInMemory = -2.0f;
+                ASSERT_TRUE(grid->valueAt(x, y, out));
+                ASSERT_TRUE(gridInMemory->valueAt(x, y, outInMemory));
+                ASSERT_EQ(out, outInMemory) << filename << " " << x << " " << y;
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+static void
+compareHorizontalShiftGrids(const NS_PROJ::HorizontalShiftGrid *grid,
+                            const NS_PROJ::HorizontalShiftGrid *gridInMemory) {
+    ASSERT_EQ(grid->width(), gridInMemory->width());
+    ASSERT_EQ(grid->height(), gridInMemory->height());
+    for (int y = 0; y < grid->height(); ++y) {
+        for (int x = 0; x < grid->width(); ++x) {
+            for (bool compensateNTConvention : {false, true}) {
+                float out1 = -1.0f;
+                float out2 = -1.0f;
+                float out1InMemory = -2.0f;
+                float out2InMemory = -2.0f;
+                ASSERT_TRUE(
+                    grid->valueAt(x, y, compensateNTConvention, out1, out2));
+                ASSERT_TRUE(gridInMemory->valueAt(
+                    x, y, compensateNTConvention, out1InMemory, out2InMemory));
+                ASSERT_EQ(out1, out1InMemory) << x << " " << y;
+                ASSERT_EQ(out2, out2InMemory) << x << " " << y;
+            }
+        }
+    }
+}
+
+TEST_F(GridTest, HorizontalShiftGridSet_load_in_memory) {
+    proj_context_set_load_grids_in_memory(m_ctxt2, true);
+    for (const char *filename :
+         {"tests/ntv2_0_downsampled.gsb", "tests/test_hgrid_big_endian.gsb",
+          "tests/nkgrf03vel_realigned_xy_extract.ct2"}) {
+        auto gridSet = NS_PROJ::HorizontalShiftGridSet::open(m_ctxt, filename);
+        ASSERT_NE(gridSet, nullptr) << filename;
+        auto gridSetInMemory =
+            NS_PROJ::HorizontalShiftGridSet::open(m_ctxt2, filename);
+        ASSERT_NE(gridSetInMemory, nullptr) << filename;
+        ASSERT_EQ(gridSet->grids().size(), gridSetInMemory->grids().size());
+        for (size_t i = 0; i < gridSet->grids().size(); ++i) {
+            compareHorizontalShiftGrids(gridSet->grids()[i].get(),
+                                        gridSetInMemory->grids()[i].get());
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+static void
+checkVerticalShiftGridValuesAt(const NS_PROJ::VerticalShiftGrid *grid) {
+    constexpr int COUNT_X = 3;
+    constexpr int COUNT_Y = 2;
+    float values[COUNT_X * COUNT_Y];
+    const int x_start = grid->width() - COUNT_X;
+    const int y_start = grid->height() / 2;
+    ASSERT_TRUE(grid->valuesAt(x_start, y_start, COUNT_X, COUNT_Y, values));
+    for (int y = 0; y < COUNT_Y; ++y) {
+        for (int x = 0; x < COUNT_X; ++x) {
+            float out = -1.0f;
+            ASSERT_TRUE(grid->valueAt(x_start + x, y_start + y, out));
+            EXPECT_EQ(values[y * COUNT_X + x], out) << x << " " << y;
+        }
+    }
+}
+
+static void
+checkHorizontalShiftGridValuesAt(const NS_PROJ::HorizontalShiftGrid *grid) {
+    constexpr int COUNT_X = 3;
+    constexpr int COUNT_Y = 2;
+    float longShifts[COUNT_X * COUNT_Y];
+    float latShifts[COUNT_X * COUNT_Y];
+    const int x_start = grid->width() - COUNT_X;
+    const int y_start = grid->height() / 2;
+    for (bool compensateNTConvention : {false, true}) {
+        ASSERT_TRUE(grid->valuesAt(x_start, y_start, COUNT_X, COUNT_Y,
+                                   compensateNTConvention, longShifts,
+                                   latShifts));
+        for (int y = 0; y < COUNT_Y; ++y) {
+            for (int x = 0; x < COUNT_X; ++x) {
+                float longShift = -1.0f;
+                float latShift = -1.0f;
+                ASSERT_TRUE(grid->valueAt(x_start + x, y_start + y,
+                                          compensateNTConvention, longShift,
+                                          latShift));
+                EXPECT_EQ(longShifts[y * COUNT_X + x], longShift)
+                    << x << " " << y;
+                EXPECT_EQ(latShifts[y * COUNT_X + x], latShift)
+                    << x << " " << y;
+            }
+        }
+    }
+}
+
+TEST_F(GridTest, ShiftGridSet_valuesAt) {
+    for (PJ_CONTEXT *ctx : {m_ctxt, m_ctxt2}) {
+        if (ctx == m_ctxt2)
+            proj_context_set_load_grids_in_memory(ctx, true);
+
+        auto vgridSet = NS_PROJ::VerticalShiftGridSet::open(
+            ctx, "tests/egm96_15_downsampled.gtx");
+        ASSERT_NE(vgridSet, nullptr);
+        checkVerticalShiftGridValuesAt(vgridSet->grids()[0].get());
+
+        for (const char *filename :
+             {"tests/ntv2_0_downsampled.gsb",
+              "tests/nkgrf03vel_realigned_xy_extract.ct2"}) {
+            auto hgridSet =
+                NS_PROJ::HorizontalShiftGridSet::open(ctx, filename);
+            ASSERT_NE(hgridSet, nullptr) << filename;
+            checkHorizontalShiftGridValuesAt(hgridSet->grids()[0].get());
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+// Write a NTv2 file with the specified subgrids, each one being defined by
+// its name, parent name, and extent in degrees (west, south, east, north),
+// with a resolution of 0.5 degree.
+struct NTv2Subgrid {
+    const char *name;
+    const char *parent;
+    double west, south, east, north;
+};
+
+static bool writeNTv2File(const std::string &filename,
+                          const std::vector<NTv2Subgrid> &subgrids) {
+    FILE *f = fopen(filename.c_str(), "wb");
+    if (!f)
+        return false;
+    const auto writeRecord = [f](const char *key, const void *value,
+                                 size_t size) {
+        char record[16] = {};
+        memcpy(record, key, strlen(key));
+        memcpy(record + 8, value, size);
+        fwrite(record, 1, sizeof(record), f);
+    };
+    const auto writeIntRecord = [&writeRecord](const char *key, int value) {
+        writeRecord(key, &value, sizeof(value));
+    };
+    const auto writeDoubleRecord = [&writeRecord](const char *key,
+                                                  double value) {
+        writeRecord(key, &value, sizeof(value));
+    };
+    writeIntRecord("NUM_OREC", 11);
+    writeIntRecord("NUM_SREC", 11);
+    writeIntRecord("NUM_FILE", static_cast<int>(subgrids.size()));
+    writeRecord("GS_TYPE", "SECONDS ", 8);
+    writeRecord("VERSION", "NTv2.0  ", 8);
+    writeRecord("SYSTEM_F", "SRC     ", 8);
+    writeRecord("SYSTEM_T", "DST     ", 8);
+    writeDoubleRecord("MAJOR_F", 6378137.0);
+    writeDoubleRecord("MINOR_F", 6356752.314);
+    writeDoubleRecord("MAJOR_T", 6378137.0);
+    writeDoubleRecord("MINOR_T", 6356752.314);
+    constexpr double RES = 0.5;
+    for (const auto &subgrid : subgrids) {
+        char name[9];
+        snprintf(name, sizeof(name), "%-8s", subgrid.name);
+        writeRecord("SUB_NAME", name, 8);
+        snprintf(name, sizeof(name), "%-8s", subgrid.parent);
+        writeRecord("PARENT", name, 8);
+        writeRecord("CREATED", "        ", 8);
+        writeRecord("UPDATED", "        ", 8);
+        // Longitudes are positive west, and everything is in arc-seconds
+        writeDoubleRecord("S_LAT", subgrid.south * 3600);
+        writeDoubleRecord("N_LAT", subgrid.north * 3600);
+        writeDoubleRecord("E_LONG", -subgrid.east * 3600);
+        writeDoubleRecord("W_LONG", -subgrid.west * 3600);
+        writeDoubleRecord("LAT_INC", RES * 3600);
+        writeDoubleRecord("LONG_INC", RES * 3600);
+        const int columns =
+            static_cast<int>((subgrid.east - subgrid.west) / RES + 0.5) + 1;
+        const int rows =
+            static_cast<int>((subgrid.north - subgrid.south) / RES + 0.5) + 1;
+        writeIntRecord("GS_COUNT", columns * rows);
+        const std::vector<float> values(4 * columns * rows, 0.0f);
+        fwrite(values.data(), sizeof(float), values.size(), f);
+    }
+    fclose(f);
+    return true;
+}
+
+TEST_F(GridTest, HorizontalShiftGridSet_gridAt_many_subgrids) {
+    // 10 top-level grids side by side, the first one having 10 children
+    // side by side, so that both levels are spatially indexed.
+    std::vector<NTv2Subgrid> subgrids;
+    std::vector<std::string> names;
+    for (int i = 0; i < 10; i++) {
+        names.push_back("TOP" + std::to_string(i));
+    }
+    for (int i = 0; i < 10; i++) {
+        names.push_back("CHILD" + std::to_string(i));
+    }
+    for (int i = 0; i < 10; i++) {
+        subgrids.push_back({names[i].c_str(), "NONE", 10.0 * i, 0.0,
+                            10.0 * (i + 1), 10.0});
+    }
+    for (int i = 0; i < 10; i++) {
+        subgrids.push_back({names[10 + i].c_str(), "TOP0", 1.0 * i, 1.0,
+                            1.0 * (i + 1), 2.0});
+    }
+
+    const char *tempDir = getenv("TEMP");
+    if (!tempDir)
+        tempDir = getenv("TMP");
+    if (!tempDir)
+        tempDir = "/tmp";
+    const std::string filename(std::string(tempDir) +
+                               "/test_grids_many_subgrids.gsb");
+    ASSERT_TRUE(writeNTv2File(filename, subgrids));
+
+    auto gridSet = NS_PROJ::HorizontalShiftGridSet::open(m_ctxt, filename);
+    ASSERT_NE(gridSet, nullptr);
+    ASSERT_EQ(gridSet->grids().size(), 10U);
+
+    const auto gridNameAt = [&gridSet](double longitude, double lat) {
+        auto grid =
+            gridSet->gridAt(longitude / 180 * M_PI, lat / 180 * M_PI);
+        if (!grid)
+            return std::string("(none)");
+        // Return the subgrid name, without the file name and the padding
+        const auto &name = grid->name();
+        const auto pos = name.rfind(", ");
+        const auto end = name.find(' ', pos + 2);
+        return name.substr(pos + 2, end == std::string::npos
+                                        ? std::string::npos
+                                        : end - (pos + 2));
+    };
+
+    EXPECT_EQ(gridNameAt(55.0, 5.0), "TOP5");
+    EXPECT_EQ(gridNameAt(99.9, 9.9), "TOP9");
+    // In TOP0, but outside of its children
+    EXPECT_EQ(gridNameAt(5.0, 5.0), "TOP0");
+    EXPECT_EQ(gridNameAt(3.5, 1.5), "CHILD3");
+    // On the common edge of two grids: the first one wins
+    EXPECT_EQ(gridNameAt(30.0, 5.0), "TOP2");
+    EXPECT_EQ(gridNameAt(4.0, 1.5), "CHILD3");
+    // Longitudes are considered modulo 360 degrees
+    EXPECT_EQ(gridNameAt(55.0 - 360.0, 5.0), "TOP5");
+    EXPECT_EQ(gridNameAt(3.5 + 360.0, 1.5), "CHILD3");
+    // Outside of all grids
+    EXPECT_EQ(gridNameAt(150.0, 5.0), "(none)");
+    EXPECT_EQ(gridNameAt(55.0, 20.0), "(none)");
+    EXPECT_EQ(gridNameAt(std::numeric_limits<double>::quiet_NaN(), 5.0),
+              "(none)");
+
+    gridSet.reset();
+    unlink(filename.c_str());
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(GridTest, HorizontalShiftGridSet_null) {
     auto gridSet = NS_PROJ::HorizontalShiftGridSet::open(m_ctxt, "null");
     ASSERT_NE(gridSet, nullptr);
@@ -172,6 +456,404 @@ TEST_F(GridTest, HorizontalShiftGridSet_gtiff) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(GridTest, HorizontalShiftGridSet_gtiff_block_cache) {
+    auto gridSet = NS_PROJ::HorizontalShiftGridSet::open(
+        m_ctxt, "tests/test_hgrid_tiled.tif");
+    ASSERT_NE(gridSet, nullptr);
+    auto grid = gridSet->gridAt(0.5 / 180 * M_PI, 0.5 / 180 * M_PI);
+    ASSERT_NE(grid, nullptr);
+    ASSERT_EQ(grid->width(), 360);
+
+    unsigned long long hitsBefore = 0;
+    unsigned long long missesBefore = 0;
+    proj_context_get_tiff_block_cache_stats(m_ctxt, &hitsBefore,
+                                            &missesBefore);
+
+    // Alternate between two blocks: the first access to each of them is a
+    // miss, the following ones are served from the cache.
+    float out1 = -1.0f;
+    float out2 = -1.0f;
+    float out1Ref = -1.0f;
+    float out2Ref = -1.0f;
+    EXPECT_TRUE(grid->valueAt(0, 0, false, out1Ref, out2Ref));
+    for (int i = 0; i < 3; i++) {
+        EXPECT_TRUE(grid->valueAt(grid->width() - 1, grid->height() - 1,
+                                  false, out1, out2));
+        EXPECT_TRUE(grid->valueAt(0, 0, false, out1, out2));
+        EXPECT_EQ(out1, out1Ref);
+        EXPECT_EQ(out2, out2Ref);
+    }
+
+    unsigned long long hits = 0;
+    unsigned long long misses = 0;
+    proj_context_get_tiff_block_cache_stats(m_ctxt, &hits, &misses);
+    EXPECT_EQ(misses - missesBefore, 2U);
+    EXPECT_EQ(hits - hitsBefore, 5U);
+
+    // With the cache disabled, every change of block is a miss
+    proj_context_set_tiff_block_cache_max_size(m_ctxt, 0);
+    hitsBefore = hits;
+    missesBefore = misses;
+    for (int i = 0; i < 3; i++) {
+        EXPECT_TRUE(grid->valueAt(grid->width() - 1, grid->height() - 1,
+                                  false, out1, out2));
+        EXPECT_TRUE(grid->valueAt(0, 0, false, out1, out2));
+        EXPECT_EQ(out1, out1Ref);
+        EXPECT_EQ(out2, out2Ref);
+    }
+    proj_context_get_tiff_block_cache_stats(m_ctxt, &hits, &misses);
+    EXPECT_EQ(misses - missesBefore, 6U);
+    EXPECT_EQ(hits - hitsBefore, 0U);
+
+    // Restore default size
+    proj_context_set_tiff_block_cache_max_size(m_ctxt, -1);
+}
+
+// ---------------------------------------------------------------------------
+
+#ifndef _WIN32
+TEST_F(GridTest, HorizontalShiftGridSet_gtiff_block_cache_size_from_ini) {
+    const char *tempDir = getenv("TEMP");
+    if (!tempDir)
+        tempDir = getenv("TMP");
+    if (!tempDir)
+        tempDir = "/tmp";
+    const std::string iniDir(std::string(tempDir) +
+                             "/test_grids_block_cache_ini");
+    const std::string iniFilename(iniDir + "/proj.ini");
+    mkdir(iniDir.c_str(), 0755);
+
+    // Load a proj.ini with the given tiff_block_cache_size_MB setting, and
+    // then call proj_context_set_tiff_block_cache_max_size(max_size_MB)
+    const auto setSize = [&iniDir, &iniFilename](int iniSizeMB,
+                                                 int max_size_MB) {
+        FILE *f = fopen(iniFilename.c_str(), "wb");
+        if (!f)
+            return false;
+        fprintf(f, "[general]\ntiff_block_cache_size_MB = %d\n", iniSizeMB);
+        fclose(f);
+        PJ_CONTEXT *ctx = proj_context_create();
+        const char *const paths[] = {iniDir.c_str()};
+        proj_context_set_search_paths(ctx, 1, paths);
+        proj_context_set_tiff_block_cache_max_size(ctx, max_size_MB);
+        proj_context_destroy(ctx);
+        return true;
+    };
+
+    auto gridSet = NS_PROJ::HorizontalShiftGridSet::open(
+        m_ctxt, "tests/test_hgrid_tiled.tif");
+    ASSERT_NE(gridSet, nullptr);
+    auto grid = gridSet->gridAt(0.5 / 180 * M_PI, 0.5 / 180 * M_PI);
+    ASSERT_NE(grid, nullptr);
+
+    // Return the number of misses when alternating between two blocks
+    const auto countMisses = [this, &grid]() {
+        unsigned long long hitsBefore = 0;
+        unsigned long long missesBefore = 0;
+        proj_context_get_tiff_block_cache_stats(m_ctxt, &hitsBefore,
+                                                &missesBefore);
+        float out1 = -1.0f;
+        float out2 = -1.0f;
+        for (int i = 0; i < 3; i++) {
+            EXPECT_TRUE(grid->valueAt(grid->width() - 1, grid->height() - 1,
+                                      false, out1, out2));
+            EXPECT_TRUE(grid->valueAt(0, 0, false, out1, out2));
+        }
+        unsigned long long hits = 0;
+        unsigned long long misses = 0;
+        proj_context_get_tiff_block_cache_stats(m_ctxt, &hits, &misses);
+        return misses - missesBefore;
+    };
+
+    // The setting done through the API has precedence over proj.ini
+    ASSERT_TRUE(setSize(0, 16));
+    EXPECT_LE(countMisses(), 2U);
+
+    // A negative value restores the proj.ini setting, here disabling the
+    // cache
+    ASSERT_TRUE(setSize(0, -1));
+    EXPECT_EQ(countMisses(), 6U);
+
+    // Restore default size
+    ASSERT_TRUE(setSize(64, -1));
+    EXPECT_LE(countMisses(), 2U);
+
+    unlink(iniFilename.c_str());
+    rmdir(iniDir.c_str());
+}
+#endif
+
+// ---------------------------------------------------------------------------
+
+TEST_F(GridTest, HorizontalShiftGridSet_gtiff_shared_between_openings) {
+    auto gridSet1 = NS_PROJ::HorizontalShiftGridSet::open(
+        m_ctxt, "tests/test_hgrid_tiled.tif");
+    ASSERT_NE(gridSet1, nullptr);
+    auto grid1 = gridSet1->gridAt(0.5 / 180 * M_PI, 0.5 / 180 * M_PI);
+    ASSERT_NE(grid1, nullptr);
+
+    // Same grid opened in another context, as done by another PJ
+    auto gridSet2 = NS_PROJ::HorizontalShiftGridSet::open(
+        m_ctxt2, "tests/test_hgrid_tiled.tif");
+    ASSERT_NE(gridSet2, nullptr);
+    auto grid2 = gridSet2->gridAt(0.5 / 180 * M_PI, 0.5 / 180 * M_PI);
+    ASSERT_NE(grid2, nullptr);
+
+    unsigned long long hitsBefore = 0;
+    unsigned long long missesBefore = 0;
+    proj_context_get_tiff_block_cache_stats(m_ctxt, &hitsBefore,
+                                            &missesBefore);
+
+    float out1Ref = -1.0f;
+    float out2Ref = -1.0f;
+    EXPECT_TRUE(grid1->valueAt(0, 0, false, out1Ref, out2Ref));
+
+    // The block decoded through the first opening is reused
+    float out1 = -1.0f;
+    float out2 = -1.0f;
+    EXPECT_TRUE(grid2->valueAt(0, 0, false, out1, out2));
+    EXPECT_EQ(out1, out1Ref);
+    EXPECT_EQ(out2, out2Ref);
+
+    unsigned long long hits = 0;
+    unsigned long long misses = 0;
+    proj_context_get_tiff_block_cache_stats(m_ctxt, &hits, &misses);
+    EXPECT_EQ(misses - missesBefore, 1U);
+    EXPECT_EQ(hits - hitsBefore, 1U);
+
+    // And remains available once the first opening is closed
+    gridSet1.reset();
+    EXPECT_TRUE(grid2->valueAt(grid2->width() - 1, grid2->height() - 1,
+                               false, out1, out2));
+    EXPECT_TRUE(grid2->valueAt(0, 0, false, out1, out2));
+    EXPECT_EQ(out1, out1Ref);
+    EXPECT_EQ(out2, out2Ref);
+    proj_context_get_tiff_block_cache_stats(m_ctxt, &hits, &misses);
+    EXPECT_EQ(misses - missesBefore, 2U);
+    EXPECT_EQ(hits - hitsBefore, 2U);
+}
+
+// ---------------------------------------------------------------------------
+
+#ifndef _WIN32
+// Return the files of a directory, removing them if asked
+static std::vector<std::string> listFiles(const std::string &dirName,
+                                          bool remove) {
+    std::vector<std::string> files;
+    DIR *dir = opendir(dirName.c_str());
+    if (!dir)
+        return files;
+    while (const struct dirent *entry = readdir(dir)) {
+        const std::string name(entry->d_name);
+        if (name == "." || name == "..")
+            continue;
+        files.push_back(dirName + '/' + name);
+        if (remove)
+            unlink(files.back().c_str());
+    }
+    closedir(dir);
+    return files;
+}
+
+TEST_F(GridTest, HorizontalShiftGridSet_gtiff_decoded_grid_cache) {
+    const char *tempDir = getenv("TEMP");
+    if (!tempDir)
+        tempDir = getenv("TMP");
+    if (!tempDir)
+        tempDir = "/tmp";
+    const std::string userDir(std::string(tempDir) +
+                              "/test_grids_decoded_grid_cache");
+    const std::string decodedDir(userDir + "/decoded_grids");
+
+    const auto listDecodedFiles = [&decodedDir](bool remove) {
+        return listFiles(decodedDir, remove);
+    };
+
+    // Return the number of blocks flagged as present in a sidecar file
+    const auto countDecodedBlocks = [](const std::string &filename) {
+        FILE *f = fopen(filename.c_str(), "rb");
+        if (!f)
+            return -1;
+        uint32_t blockCount = 0;
+        int count = 0;
+        if (fseek(f, 12, SEEK_SET) == 0 &&
+            fread(&blockCount, sizeof(blockCount), 1, f) == 1 &&
+            fseek(f, 64, SEEK_SET) == 0) {
+            for (uint32_t i = 0; i < blockCount; i++) {
+                if (fgetc(f) > 0)
+                    count++;
+            }
+        }
+        fclose(f);
+        return count;
+    };
+
+    listDecodedFiles(true);
+    proj_context_set_user_writable_directory(m_ctxt, userDir.c_str(), true);
+    proj_context_set_decoded_grid_cache_enable(m_ctxt, true);
+    // So that every access to a block goes through the decoded block file
+    proj_context_set_tiff_block_cache_max_size(m_ctxt, 0);
+
+    float out1Ref = -1.0f;
+    float out2Ref = -1.0f;
+    float out3Ref = -1.0f;
+    float out4Ref = -1.0f;
+    {
+        auto gridSet = NS_PROJ::HorizontalShiftGridSet::open(
+            m_ctxt, "tests/test_hgrid_tiled.tif");
+        ASSERT_NE(gridSet, nullptr);
+        auto grid = gridSet->gridAt(0.5 / 180 * M_PI, 0.5 / 180 * M_PI);
+        ASSERT_NE(grid, nullptr);
+        EXPECT_TRUE(grid->valueAt(0, 0, false, out1Ref, out2Ref));
+        EXPECT_TRUE(grid->valueAt(grid->width() - 1, grid->height() - 1,
+                                  false, out3Ref, out4Ref));
+    }
+
+    // The two decoded blocks are stored in a single file
+    const auto files = listDecodedFiles(false);
+    ASSERT_EQ(files.size(), 1U);
+    EXPECT_TRUE(files[0].find("test_hgrid_tiled.tif.") != std::string::npos);
+    EXPECT_EQ(countDecodedBlocks(files[0]), 2);
+
+    // A new opening of the grid reads them back from that file
+    {
+        auto gridSet = NS_PROJ::HorizontalShiftGridSet::open(
+            m_ctxt, "tests/test_hgrid_tiled.tif");
+        ASSERT_NE(gridSet, nullptr);
+        auto grid = gridSet->gridAt(0.5 / 180 * M_PI, 0.5 / 180 * M_PI);
+        ASSERT_NE(grid, nullptr);
+        for (int i = 0; i < 2; i++) {
+            float out1 = -1.0f;
+            float out2 = -1.0f;
+            EXPECT_TRUE(grid->valueAt(0, 0, false, out1, out2));
+            EXPECT_EQ(out1, out1Ref);
+            EXPECT_EQ(out2, out2Ref);
+            EXPECT_TRUE(grid->valueAt(grid->width() - 1, grid->height() - 1,
+                                      false, out1, out2));
+            EXPECT_EQ(out1, out3Ref);
+            EXPECT_EQ(out2, out4Ref);
+        }
+    }
+    EXPECT_EQ(listDecodedFiles(false).size(), 1U);
+    EXPECT_EQ(countDecodedBlocks(files[0]), 2);
+
+    // Uncompressed grids do not need it
+    {
+        auto gridSet = NS_PROJ::HorizontalShiftGridSet::open(
+            m_ctxt, "tests/test_hgrid.tif");
+        ASSERT_NE(gridSet, nullptr);
+        auto grid = gridSet->gridAt(5.5 / 180 * M_PI, 53.5 / 180 * M_PI);
+        ASSERT_NE(grid, nullptr);
+        float out1 = -1.0f;
+        float out2 = -1.0f;
+        EXPECT_TRUE(grid->valueAt(0, 0, false, out1, out2));
+    }
+    EXPECT_EQ(listDecodedFiles(false).size(), 1U);
+
+    // Restore default settings
+    proj_context_set_tiff_block_cache_max_size(m_ctxt, -1);
+    proj_context_set_decoded_grid_cache_enable(m_ctxt, false);
+    listDecodedFiles(true);
+    rmdir(decodedDir.c_str());
+    rmdir(userDir.c_str());
+}
+#endif
+
+// ---------------------------------------------------------------------------
+
+#ifndef _WIN32
+TEST_F(GridTest, HorizontalShiftGridSet_gtiff_decoded_grid_cache_stale_files) {
+    const char *tempDir = getenv("TEMP");
+    if (!tempDir)
+        tempDir = getenv("TMP");
+    if (!tempDir)
+        tempDir = "/tmp";
+    const std::string userDir(std::string(tempDir) +
+                              "/test_grids_decoded_grid_cache_stale_files");
+    const std::string decodedDir(userDir + "/decoded_grids");
+    const std::string gridName(userDir + "/test_hgrid_tiled.tif");
+
+    listFiles(decodedDir, true);
+    rmdir(decodedDir.c_str());
+    listFiles(userDir, true);
+    mkdir(userDir.c_str(), 0755);
+    proj_context_set_user_writable_directory(m_ctxt, userDir.c_str(), true);
+    proj_context_set_decoded_grid_cache_enable(m_ctxt, true);
+    proj_context_set_tiff_block_cache_max_size(m_ctxt, 0);
+
+    // Work on a copy of the grid, whose modification time can be changed
+    {
+        const char *projData = getenv("PROJ_DATA");
+        ASSERT_NE(projData, nullptr);
+        FILE *in = fopen(
+            (std::string(projData) + "/tests/test_hgrid_tiled.tif").c_str(),
+            "rb");
+        ASSERT_NE(in, nullptr);
+        FILE *out = fopen(gridName.c_str(), "wb");
+        ASSERT_NE(out, nullptr);
+        char buffer[4096];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0)
+            fwrite(buffer, 1, n, out);
+        fclose(in);
+        fclose(out);
+    }
+
+    const auto readGrid = [this, &gridName]() {
+        auto gridSet =
+            NS_PROJ::HorizontalShiftGridSet::open(m_ctxt, gridName);
+        ASSERT_NE(gridSet, nullptr);
+        auto grid = gridSet->gridAt(0.5 / 180 * M_PI, 0.5 / 180 * M_PI);
+        ASSERT_NE(grid, nullptr);
+        float out1 = -1.0f;
+        float out2 = -1.0f;
+        EXPECT_TRUE(grid->valueAt(0, 0, false, out1, out2));
+    };
+
+    readGrid();
+    const auto filesBefore = listFiles(decodedDir, false);
+    ASSERT_EQ(filesBefore.size(), 1U);
+
+    // A new version of the grid replaces the file of the previous one
+    struct utimbuf times;
+    times.actime = 1000000000;
+    times.modtime = 1000000000;
+    ASSERT_EQ(utime(gridName.c_str(), &times), 0);
+    readGrid();
+    const auto filesAfter = listFiles(decodedDir, false);
+    ASSERT_EQ(filesAfter.size(), 1U);
+    EXPECT_NE(filesAfter[0], filesBefore[0]);
+
+    // Restore default settings
+    proj_context_set_tiff_block_cache_max_size(m_ctxt, -1);
+    proj_context_set_decoded_grid_cache_enable(m_ctxt, false);
+    listFiles(decodedDir, true);
+    rmdir(decodedDir.c_str());
+    listFiles(userDir, true);
+    rmdir(userDir.c_str());
+}
+#endif
+
+// ---------------------------------------------------------------------------
+
+TEST_F(GridTest, ShiftGridSet_gtiff_valuesAt) {
+    auto vgridSet = NS_PROJ::VerticalShiftGridSet::open(
+        m_ctxt, "tests/test_vgrid_pixelispoint.tif");
+    ASSERT_NE(vgridSet, nullptr);
+    checkVerticalShiftGridValuesAt(vgridSet->grids()[0].get());
+
+    for (const char *filename :
+         {"tests/test_hgrid.tif", "tests/test_hgrid_tiled.tif",
+          "tests/test_hgrid_lon_shift_first.tif",
+          "tests/test_hgrid_positive_west.tif"}) {
+        auto hgridSet = NS_PROJ::HorizontalShiftGridSet::open(m_ctxt, filename);
+        ASSERT_NE(hgridSet, nullptr) << filename;
+        checkHorizontalShiftGridValuesAt(hgridSet->grids()[0].get());
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(GridTest, GenericShiftGridSet_gtiff) {
     ASSERT_EQ(NS_PROJ::GenericShiftGridSet::open(m_ctxt, "foobar"), nullptr);
     auto gridSet = NS_PROJ::GenericShiftGridSet::open(
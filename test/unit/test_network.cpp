@@ -28,6 +28,7 @@
 
 #include "gtest_include.h"
 
+#include <algorithm>
 #include <memory>
 #include <stdio.h>
 #include <stdlib.h>
@@ -1098,6 +1099,498 @@ TEST(networking, simul_file_change_while_opened) {
 
 // ---------------------------------------------------------------------------
 
+// Simulates a remote 10 MB file, whose first bytes are the header of
+// egm96_15_uncompressed_truncated.tif, and the rest is filled with 1.25 floats.
+struct SimulatedRemoteGrid {
+    std::string header{};
+    int openCount = 0;
+    int readRangeCount = 0;
+    unsigned long long downloadedBytes = 0;
+    std::string headerValue{};
+};
+
+static const unsigned long long SIMULATED_REMOTE_GRID_SIZE = 10000000;
+
+static size_t simulated_remote_grid_read(SimulatedRemoteGrid *grid,
+                                         unsigned long long offset,
+                                         size_t size_to_read, void *buffer) {
+    if (offset >= SIMULATED_REMOTE_GRID_SIZE)
+        return 0;
+    size_to_read = static_cast<size_t>(std::min(
+        static_cast<unsigned long long>(size_to_read),
+        SIMULATED_REMOTE_GRID_SIZE - offset));
+    float f = 1.25;
+    if (!IS_LSB) {
+        swap_words(&f, sizeof(f), 1);
+    }
+    unsigned char *out = static_cast<unsigned char *>(buffer);
+    for (size_t i = 0; i < size_to_read; i++) {
+        const auto pos = offset + i;
+        if (pos < grid->header.size()) {
+            out[i] = static_cast<unsigned char>(grid->header[pos]);
+        } else {
+            out[i] = reinterpret_cast<const unsigned char *>(
+                &f)[(pos - grid->header.size()) % sizeof(f)];
+        }
+    }
+    return size_to_read;
+}
+
+static PROJ_NETWORK_HANDLE *
+simulated_remote_grid_open_cbk(PJ_CONTEXT *, const char *,
+                               unsigned long long offset, size_t size_to_read,
+                               void *buffer, size_t *out_size_read, size_t,
+                               char *, void *user_data) {
+    auto grid = static_cast<SimulatedRemoteGrid *>(user_data);
+    grid->openCount++;
+    grid->downloadedBytes += size_to_read;
+    *out_size_read =
+        simulated_remote_grid_read(grid, offset, size_to_read, buffer);
+    return reinterpret_cast<PROJ_NETWORK_HANDLE *>(grid);
+}
+
+static void simulated_remote_grid_close_cbk(PJ_CONTEXT *,
+                                            PROJ_NETWORK_HANDLE *, void *) {}
+
+static const char *
+simulated_remote_grid_get_header_value_cbk(PJ_CONTEXT *, PROJ_NETWORK_HANDLE *,
+                                           const char *header_name,
+                                           void *user_data) {
+    auto grid = static_cast<SimulatedRemoteGrid *>(user_data);
+    if (strcmp(header_name, "Content-Range") == 0) {
+        grid->headerValue =
+            "bytes=0-16383/" + std::to_string(SIMULATED_REMOTE_GRID_SIZE);
+    } else if (strcmp(header_name, "Last-Modified") == 0) {
+        grid->headerValue = "some_date";
+    } else if (strcmp(header_name, "ETag") == 0) {
+        grid->headerValue = "some_etag";
+    } else {
+        return nullptr;
+    }
+    return grid->headerValue.c_str();
+}
+
+static size_t simulated_remote_grid_read_range_cbk(
+    PJ_CONTEXT *, PROJ_NETWORK_HANDLE *, unsigned long long offset,
+    size_t size_to_read, void *buffer, size_t, char *, void *user_data) {
+    auto grid = static_cast<SimulatedRemoteGrid *>(user_data);
+    grid->readRangeCount++;
+    grid->downloadedBytes += size_to_read;
+    return simulated_remote_grid_read(grid, offset, size_to_read, buffer);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(networking, prefetch_blocks_of_batch) {
+    const char *proj_source_data = getenv("PROJ_SOURCE_DATA");
+    ASSERT_TRUE(proj_source_data != nullptr);
+    std::string filename(proj_source_data);
+    filename += "/tests/egm96_15_uncompressed_truncated.tif";
+    FILE *f = fopen(filename.c_str(), "rb");
+    ASSERT_TRUE(f != nullptr);
+    std::string header;
+    header.resize(956);
+    ASSERT_EQ(fread(&header[0], 1, header.size(), f), header.size());
+    fclose(f);
+
+    // Points on both sides of the boundary between two horizontally adjacent
+    // 256x256 tiles (at longitude 12 degrees), alternating from one tile to
+    // the other.
+    std::vector<PJ_COORD> coords;
+    for (int i = 0; i < 8; i++) {
+        const double longitude = (i % 2 == 0) ? 11.0 : 13.0;
+        const double lat = 45.0 + 0.25 * i;
+        coords.push_back(proj_coord(longitude / 180. * M_PI,
+                                    lat / 180. * M_PI, 0, 0));
+    }
+
+    const auto run = [&header, &coords](const char *url, bool batch,
+                                        int &requestCount) {
+        SimulatedRemoteGrid grid;
+        grid.header = header;
+        auto ctx = proj_context_create();
+        proj_grid_cache_set_enable(ctx, false);
+        proj_context_set_enable_network(ctx, true);
+        EXPECT_TRUE(proj_context_set_network_callbacks(
+            ctx, simulated_remote_grid_open_cbk,
+            simulated_remote_grid_close_cbk,
+            simulated_remote_grid_get_header_value_cbk,
+            simulated_remote_grid_read_range_cbk, &grid));
+        auto P = proj_create(
+            ctx, (std::string("+proj=vgridshift +multiplier=1 +grids=") + url)
+                     .c_str());
+        EXPECT_NE(P, nullptr);
+        auto res = coords;
+        if (P) {
+            if (batch) {
+                EXPECT_EQ(proj_trans_array(P, PJ_FWD, res.size(), res.data()),
+                          0);
+            } else {
+                for (auto &coord : res) {
+                    coord = proj_trans(P, PJ_FWD, coord);
+                }
+            }
+        }
+        proj_destroy(P);
+        proj_context_destroy(ctx);
+        requestCount = grid.openCount + grid.readRangeCount;
+        return res;
+    };
+
+    int requestCountSingle = 0;
+    const auto resSingle =
+        run("https://foo/prefetch_single.tif", false, requestCountSingle);
+    int requestCountBatch = 0;
+    const auto resBatch =
+        run("https://foo/prefetch_batch.tif", true, requestCountBatch);
+
+    for (size_t i = 0; i < coords.size(); i++) {
+        EXPECT_EQ(resSingle[i].xyz.z, 1.25);
+        EXPECT_EQ(resBatch[i].xyz.z, resSingle[i].xyz.z);
+    }
+    // One request for the header, and then one per tile, unless both tiles
+    // are prefetched with a single range request.
+    EXPECT_EQ(requestCountSingle, 3);
+    EXPECT_EQ(requestCountBatch, 2);
+}
+
+TEST(networking, prefetch_blocks_of_scattered_batch) {
+    const char *proj_source_data = getenv("PROJ_SOURCE_DATA");
+    ASSERT_TRUE(proj_source_data != nullptr);
+    std::string filename(proj_source_data);
+    filename += "/tests/egm96_15_uncompressed_truncated.tif";
+    FILE *f = fopen(filename.c_str(), "rb");
+    ASSERT_TRUE(f != nullptr);
+    std::string header;
+    header.resize(956);
+    ASSERT_EQ(fread(&header[0], 1, header.size(), f), header.size());
+    fclose(f);
+
+    // Points alternating between both sides of the antimeridian, so in the
+    // first and last tiles of a row of 256x256 tiles. Only those two tiles
+    // must be fetched, and not the whole row.
+    std::vector<PJ_COORD> coords;
+    for (int i = 0; i < 8; i++) {
+        const double longitude = (i % 2 == 0) ? -179.0 : 179.0;
+        const double lat = 45.0 + 0.25 * i;
+        coords.push_back(proj_coord(longitude / 180. * M_PI,
+                                    lat / 180. * M_PI, 0, 0));
+    }
+
+    SimulatedRemoteGrid grid;
+    grid.header = header;
+    auto ctx = proj_context_create();
+    proj_grid_cache_set_enable(ctx, false);
+    proj_context_set_enable_network(ctx, true);
+    ASSERT_TRUE(proj_context_set_network_callbacks(
+        ctx, simulated_remote_grid_open_cbk, simulated_remote_grid_close_cbk,
+        simulated_remote_grid_get_header_value_cbk,
+        simulated_remote_grid_read_range_cbk, &grid));
+    auto P = proj_create(ctx, "+proj=vgridshift +multiplier=1 "
+                              "+grids=https://foo/prefetch_scattered.tif");
+    ASSERT_NE(P, nullptr);
+    EXPECT_EQ(proj_trans_array(P, PJ_FWD, coords.size(), coords.data()), 0);
+    for (const auto &coord : coords) {
+        EXPECT_EQ(coord.xyz.z, 1.25);
+    }
+    proj_destroy(P);
+    proj_context_destroy(ctx);
+
+    // The header, and the two tiles rounded to the 16 kB download chunks
+    const unsigned long long tileSize = 256 * 256 * sizeof(float);
+    EXPECT_LE(grid.downloadedBytes, 16384 + 2 * (tileSize + 16384));
+}
+
+// ---------------------------------------------------------------------------
+
+static sqlite3_int64 get_single_int64_value(sqlite3 *hDB, const char *sql) {
+    sqlite3_stmt *hStmt = nullptr;
+    sqlite3_prepare_v2(hDB, sql, -1, &hStmt, nullptr);
+    EXPECT_NE(hStmt, nullptr);
+    if (!hStmt)
+        return -1;
+    sqlite3_int64 ret = -1;
+    if (sqlite3_step(hStmt) == SQLITE_ROW)
+        ret = sqlite3_column_int64(hStmt, 0);
+    sqlite3_finalize(hStmt);
+    return ret;
+}
+
+// ---------------------------------------------------------------------------
+
+// Create a cache with the structure used by PROJ < 9.6, with the least
+// recently used order stored as a linked list.
+static void create_legacy_cache(const char *cacheFilename) {
+    sqlite3 *hDB = nullptr;
+    ASSERT_EQ(sqlite3_open(cacheFilename, &hDB), SQLITE_OK);
+    ASSERT_EQ(
+        sqlite3_exec(
+            hDB,
+            "CREATE TABLE properties(url TEXT PRIMARY KEY NOT NULL, "
+            "lastChecked TIMESTAMP NOT NULL, fileSize INTEGER NOT NULL, "
+            "lastModified TEXT, etag TEXT);"
+            "CREATE TABLE downloaded_file_properties(url TEXT PRIMARY "
+            "KEY NOT NULL, lastChecked TIMESTAMP NOT NULL, fileSize "
+            "INTEGER NOT NULL, lastModified TEXT, etag TEXT);"
+            "CREATE TABLE chunk_data(id INTEGER PRIMARY KEY "
+            "AUTOINCREMENT CHECK (id > 0), data BLOB NOT NULL);"
+            "CREATE TABLE chunks(id INTEGER PRIMARY KEY AUTOINCREMENT "
+            "CHECK (id > 0), url TEXT NOT NULL, offset INTEGER NOT NULL, "
+            "data_id INTEGER NOT NULL, data_size INTEGER NOT NULL);"
+            "CREATE INDEX idx_chunks ON chunks(url, offset);"
+            "CREATE TABLE linked_chunks(id INTEGER PRIMARY KEY "
+            "AUTOINCREMENT CHECK (id > 0), chunk_id INTEGER NOT NULL, "
+            "prev INTEGER, next INTEGER);"
+            "CREATE INDEX idx_linked_chunks_chunk_id ON "
+            "linked_chunks(chunk_id);"
+            "CREATE TABLE linked_chunks_head_tail(head INTEGER, tail "
+            "INTEGER);"
+            "INSERT INTO linked_chunks_head_tail VALUES (NULL, NULL);"
+            "INSERT INTO downloaded_file_properties VALUES "
+            "('https://foo/legacy.tif', 1, 10, NULL, 'legacy_etag');",
+            nullptr, nullptr, nullptr),
+        SQLITE_OK);
+    sqlite3_close(hDB);
+}
+
+// ---------------------------------------------------------------------------
+
+static void check_legacy_cache_untouched(const char *cacheFilename) {
+    sqlite3 *hDB = nullptr;
+    ASSERT_EQ(
+        sqlite3_open_v2(cacheFilename, &hDB, SQLITE_OPEN_READONLY, nullptr),
+        SQLITE_OK);
+    EXPECT_EQ(get_single_int64_value(
+                  hDB, "SELECT COUNT(*) FROM sqlite_master WHERE name IN "
+                       "('linked_chunks', 'linked_chunks_head_tail')"),
+              2);
+    EXPECT_EQ(get_single_int64_value(hDB, "SELECT COUNT(*) FROM chunks"), 0);
+    EXPECT_EQ(get_single_int64_value(hDB, "SELECT COUNT(*) FROM sqlite_master "
+                                          "WHERE sql LIKE '%last_access%'"),
+              0);
+    sqlite3_close(hDB);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(networking, disk_cache_access_time_and_legacy_cache) {
+    const char *proj_source_data = getenv("PROJ_SOURCE_DATA");
+    ASSERT_TRUE(proj_source_data != nullptr);
+    std::string filename(proj_source_data);
+    filename += "/tests/egm96_15_uncompressed_truncated.tif";
+    FILE *f = fopen(filename.c_str(), "rb");
+    ASSERT_TRUE(f != nullptr);
+    SimulatedRemoteGrid grid;
+    grid.header.resize(956);
+    ASSERT_EQ(fread(&grid.header[0], 1, grid.header.size(), f),
+              grid.header.size());
+    fclose(f);
+
+    const char *legacyCacheFilename = "tmp_proj_db_cache_legacy.db";
+    const char *cacheFilename = "tmp_proj_db_cache_access_time.db";
+    const char *pipeline = "+proj=vgridshift +multiplier=1 "
+                           "+grids=https://foo/disk_cache_access_time.tif";
+
+    proj_cleanup();
+    auto ctx = proj_context_create();
+    proj_context_set_enable_network(ctx, true);
+    ASSERT_TRUE(proj_context_set_network_callbacks(
+        ctx, simulated_remote_grid_open_cbk, simulated_remote_grid_close_cbk,
+        simulated_remote_grid_get_header_value_cbk,
+        simulated_remote_grid_read_range_cbk, &grid));
+
+    // A cache created by a previous PROJ version, which may still use it,
+    // is neither modified nor used.
+    unlink(legacyCacheFilename);
+    create_legacy_cache(legacyCacheFilename);
+    proj_grid_cache_set_filename(ctx, legacyCacheFilename);
+    auto P = proj_create(ctx, pipeline);
+    ASSERT_NE(P, nullptr);
+    proj_destroy(P);
+    EXPECT_EQ(grid.openCount, 1);
+    check_legacy_cache_untouched(legacyCacheFilename);
+    unlink(legacyCacheFilename);
+
+    proj_cleanup();
+    proj_grid_cache_set_filename(ctx, cacheFilename);
+    proj_grid_cache_clear(ctx);
+
+    P = proj_create(ctx, pipeline);
+    ASSERT_NE(P, nullptr);
+    proj_destroy(P);
+    EXPECT_EQ(grid.openCount, 2);
+
+    {
+        sqlite3 *hDB = nullptr;
+        ASSERT_EQ(sqlite3_open_v2(cacheFilename, &hDB, SQLITE_OPEN_READWRITE,
+                                  nullptr),
+                  SQLITE_OK);
+        EXPECT_EQ(get_single_int64_value(hDB, "SELECT COUNT(*) FROM chunks "
+                                              "WHERE offset = 0"),
+                  1);
+        EXPECT_GT(get_single_int64_value(hDB, "SELECT MIN(last_access) "
+                                              "FROM chunks"),
+                  0);
+        // Make the chunk look like it has not been used for a long time
+        ASSERT_EQ(sqlite3_exec(hDB, "UPDATE chunks SET last_access = 1",
+                               nullptr, nullptr, nullptr),
+                  SQLITE_OK);
+        sqlite3_close(hDB);
+    }
+
+    proj_cleanup();
+
+    // Data is read back from the disk cache without network access, and its
+    // access time is refreshed
+    P = proj_create(ctx, pipeline);
+    ASSERT_NE(P, nullptr);
+    proj_destroy(P);
+    EXPECT_EQ(grid.openCount, 2);
+    EXPECT_EQ(grid.readRangeCount, 0);
+
+    {
+        sqlite3 *hDB = nullptr;
+        ASSERT_EQ(sqlite3_open_v2(cacheFilename, &hDB, SQLITE_OPEN_READONLY,
+                                  nullptr),
+                  SQLITE_OK);
+        EXPECT_GT(get_single_int64_value(hDB, "SELECT last_access FROM "
+                                              "chunks WHERE offset = 0"),
+                  1);
+        sqlite3_close(hDB);
+    }
+
+    proj_grid_cache_clear(ctx);
+    proj_context_destroy(ctx);
+    proj_cleanup();
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(networking, disk_cache_imports_legacy_downloaded_file_properties) {
+    const char *proj_source_data = getenv("PROJ_SOURCE_DATA");
+    ASSERT_TRUE(proj_source_data != nullptr);
+    std::string filename(proj_source_data);
+    filename += "/tests/egm96_15_uncompressed_truncated.tif";
+    FILE *f = fopen(filename.c_str(), "rb");
+    ASSERT_TRUE(f != nullptr);
+    SimulatedRemoteGrid grid;
+    grid.header.resize(956);
+    ASSERT_EQ(fread(&grid.header[0], 1, grid.header.size(), f),
+              grid.header.size());
+    fclose(f);
+
+    const char *userDir = "./tmp_proj_legacy_cache_dir";
+    const std::string legacyCacheFilename = std::string(userDir) + "/cache.db";
+    const std::string cacheFilename = std::string(userDir) + "/cache_v2.db";
+
+    proj_cleanup();
+    auto ctx = proj_context_create();
+    proj_context_set_user_writable_directory(ctx, userDir, true);
+    unlink(cacheFilename.c_str());
+    unlink(legacyCacheFilename.c_str());
+    create_legacy_cache(legacyCacheFilename.c_str());
+
+    proj_context_set_enable_network(ctx, true);
+    ASSERT_TRUE(proj_context_set_network_callbacks(
+        ctx, simulated_remote_grid_open_cbk, simulated_remote_grid_close_cbk,
+        simulated_remote_grid_get_header_value_cbk,
+        simulated_remote_grid_read_range_cbk, &grid));
+    auto P = proj_create(ctx, "+proj=vgridshift +multiplier=1 "
+                              "+grids=https://foo/legacy_import.tif");
+    ASSERT_NE(P, nullptr);
+    proj_destroy(P);
+
+    // The cache of the previous PROJ version is left untouched, and the
+    // properties of the files it downloaded are imported in the new one.
+    check_legacy_cache_untouched(legacyCacheFilename.c_str());
+    {
+        sqlite3 *hDB = nullptr;
+        ASSERT_EQ(sqlite3_open_v2(cacheFilename.c_str(), &hDB,
+                                  SQLITE_OPEN_READONLY, nullptr),
+                  SQLITE_OK);
+        EXPECT_EQ(get_single_int64_value(
+                      hDB, "SELECT fileSize FROM downloaded_file_properties "
+                           "WHERE url = 'https://foo/legacy.tif' AND "
+                           "etag = 'legacy_etag'"),
+                  10);
+        EXPECT_EQ(get_single_int64_value(hDB, "SELECT COUNT(*) FROM chunks "
+                                              "WHERE offset = 0"),
+                  1);
+        sqlite3_close(hDB);
+    }
+
+    proj_context_destroy(ctx);
+    proj_cleanup();
+    unlink(cacheFilename.c_str());
+    unlink(legacyCacheFilename.c_str());
+    rmdir(userDir);
+}
+
+// ---------------------------------------------------------------------------
+
+#ifndef _WIN32
+
+TEST(networking, shared_memory_chunk_cache) {
+    const char *proj_source_data = getenv("PROJ_SOURCE_DATA");
+    ASSERT_TRUE(proj_source_data != nullptr);
+    std::string filename(proj_source_data);
+    filename += "/tests/egm96_15_uncompressed_truncated.tif";
+    FILE *f = fopen(filename.c_str(), "rb");
+    ASSERT_TRUE(f != nullptr);
+    SimulatedRemoteGrid grid;
+    grid.header.resize(956);
+    ASSERT_EQ(fread(&grid.header[0], 1, grid.header.size(), f),
+              grid.header.size());
+    fclose(f);
+
+    const char *pipeline = "+proj=vgridshift +multiplier=1 "
+                           "+grids=https://foo/shared_memory_chunk_cache.tif";
+    const auto coord = proj_coord(12. / 180. * M_PI, 45. / 180. * M_PI, 0, 0);
+    remove("tmp_proj_db_cache_shared.db.mmap");
+
+    proj_cleanup();
+    auto ctx = proj_context_create();
+    proj_context_set_enable_network(ctx, true);
+    // Only the shared cache is enabled
+    proj_grid_cache_set_enable(ctx, false);
+    proj_grid_cache_set_filename(ctx, "tmp_proj_db_cache_shared.db");
+    proj_grid_cache_set_shared_memory_size(ctx, 1);
+    ASSERT_TRUE(proj_context_set_network_callbacks(
+        ctx, simulated_remote_grid_open_cbk, simulated_remote_grid_close_cbk,
+        simulated_remote_grid_get_header_value_cbk,
+        simulated_remote_grid_read_range_cbk, &grid));
+
+    const auto run = [ctx, pipeline, coord, &grid]() {
+        auto P = proj_create(ctx, pipeline);
+        EXPECT_NE(P, nullptr);
+        if (P) {
+            EXPECT_EQ(proj_trans(P, PJ_FWD, coord).xyz.z, 1.25);
+        }
+        proj_destroy(P);
+        // Clear the memory caches of the process
+        proj_cleanup();
+        return grid.openCount + grid.readRangeCount;
+    };
+
+    const int requestCount = run();
+    EXPECT_GE(requestCount, 1);
+
+    // File properties and chunks are read back from the shared cache,
+    // as another process would do.
+    EXPECT_EQ(run(), requestCount);
+
+    // Clearing the cache makes everything downloaded again
+    proj_grid_cache_clear(ctx);
+    EXPECT_EQ(run(), 2 * requestCount);
+
+    proj_context_destroy(ctx);
+    remove("tmp_proj_db_cache_shared.db.mmap");
+}
+
+#endif
+
+// ---------------------------------------------------------------------------
+
 #ifdef CURL_ENABLED
 
 TEST(networking, curl_hgridshift) {
@@ -1317,9 +1810,7 @@ TEST(networking, cache_basic) {
     ASSERT_NE(hDB, nullptr);
     sqlite3_stmt *hStmt = nullptr;
     sqlite3_prepare_v2(hDB,
-                       "SELECT url, offset FROM chunks WHERE id = ("
-                       "SELECT chunk_id FROM linked_chunks WHERE id = ("
-                       "SELECT head FROM linked_chunks_head_tail))",
+                       "SELECT url, offset FROM chunks WHERE offset = 0",
                        -1, &hStmt, nullptr);
     ASSERT_NE(hStmt, nullptr);
     ASSERT_EQ(sqlite3_step(hStmt), SQLITE_ROW);
@@ -1442,16 +1933,13 @@ TEST(networking, cache_saturation) {
     sqlite3_stmt *hStmt = nullptr;
     sqlite3_prepare_v2(hDB,
                        "SELECT COUNT(*) FROM chunk_data UNION ALL "
-                       "SELECT COUNT(*) FROM chunks UNION ALL "
-                       "SELECT COUNT(*) FROM linked_chunks",
+                       "SELECT COUNT(*) FROM chunks",
                        -1, &hStmt, nullptr);
     ASSERT_NE(hStmt, nullptr);
     ASSERT_EQ(sqlite3_step(hStmt), SQLITE_ROW);
     ASSERT_EQ(sqlite3_column_int64(hStmt, 0), 2);
     ASSERT_EQ(sqlite3_step(hStmt), SQLITE_ROW);
     ASSERT_EQ(sqlite3_column_int64(hStmt, 0), 2);
-    ASSERT_EQ(sqlite3_step(hStmt), SQLITE_ROW);
-    ASSERT_EQ(sqlite3_column_int64(hStmt, 0), 2);
     sqlite3_finalize(hStmt);
     sqlite3_close(hDB);
 
@@ -1638,7 +2126,7 @@ TEST(networking, download_whole_files) {
     }
 
     proj_cleanup();
-    unlink("proj_test_tmp/cache.db");
+    unlink("proj_test_tmp/cache_v2.db");
     unlink("proj_test_tmp/dk_sdfe_dvr90.tif");
     rmdir("proj_test_tmp");
 
@@ -1690,8 +2178,8 @@ TEST(networking, download_whole_files) {
 
     {
         sqlite3 *hDB = nullptr;
-        sqlite3_open_v2("proj_test_tmp/cache.db", &hDB, SQLITE_OPEN_READWRITE,
-                        nullptr);
+        sqlite3_open_v2("proj_test_tmp/cache_v2.db", &hDB,
+                        SQLITE_OPEN_READWRITE, nullptr);
         ASSERT_NE(hDB, nullptr);
         // Force lastChecked to the Epoch so that data is expired.
         sqlite3_stmt *hStmt = nullptr;
@@ -1709,8 +2197,8 @@ TEST(networking, download_whole_files) {
 
     {
         sqlite3 *hDB = nullptr;
-        sqlite3_open_v2("proj_test_tmp/cache.db", &hDB, SQLITE_OPEN_READWRITE,
-                        nullptr);
+        sqlite3_open_v2("proj_test_tmp/cache_v2.db", &hDB,
+                        SQLITE_OPEN_READWRITE, nullptr);
         ASSERT_NE(hDB, nullptr);
         // Check that the lastChecked timestamp is still 0
         sqlite3_stmt *hStmt = nullptr;
@@ -1729,8 +2217,8 @@ TEST(networking, download_whole_files) {
 
     {
         sqlite3 *hDB = nullptr;
-        sqlite3_open_v2("proj_test_tmp/cache.db", &hDB, SQLITE_OPEN_READWRITE,
-                        nullptr);
+        sqlite3_open_v2("proj_test_tmp/cache_v2.db", &hDB,
+                        SQLITE_OPEN_READWRITE, nullptr);
         ASSERT_NE(hDB, nullptr);
         sqlite3_stmt *hStmt = nullptr;
         // Check that the lastChecked timestamp has been updated
@@ -1778,7 +2266,7 @@ TEST(networking, download_whole_files) {
     putenv(const_cast<char *>("PROJ_SKIP_READ_USER_WRITABLE_DIRECTORY=YES"));
     putenv(const_cast<char *>("PROJ_USER_WRITABLE_DIRECTORY="));
     putenv(const_cast<char *>("PROJ_FULL_FILE_CHUNK_SIZE="));
-    unlink("proj_test_tmp/cache.db");
+    unlink("proj_test_tmp/cache_v2.db");
     unlink("proj_test_tmp/dk_sdfe_dvr90.tif");
     rmdir("proj_test_tmp");
 }
@@ -1791,7 +2279,7 @@ TEST(networking, file_api) {
     }
 
     proj_cleanup();
-    unlink("proj_test_tmp/cache.db");
+    unlink("proj_test_tmp/cache_v2.db");
     unlink("proj_test_tmp/dk_sdfe_dvr90.tif");
     rmdir("proj_test_tmp");
 
@@ -1922,7 +2410,7 @@ TEST(networking, file_api) {
     putenv(const_cast<char *>("PROJ_SKIP_READ_USER_WRITABLE_DIRECTORY=YES"));
     putenv(const_cast<char *>("PROJ_USER_WRITABLE_DIRECTORY="));
     putenv(const_cast<char *>("PROJ_FULL_FILE_CHUNK_SIZE="));
-    unlink("proj_test_tmp/cache.db");
+    unlink("proj_test_tmp/cache_v2.db");
     unlink("proj_test_tmp/dk_sdfe_dvr90.tif");
     rmdir("proj_test_tmp");
 }
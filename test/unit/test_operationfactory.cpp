@@ -394,6 +394,90 @@ TEST(operation, geogCRS_to_geogCRS_context_NAD27_to_WGS84) {
 
 // ---------------------------------------------------------------------------
 
+TEST(operation, geogCRS_to_geogCRS_context_NAD27_to_WGS84_thread_count) {
+    auto authFactory =
+        AuthorityFactory::create(DatabaseContext::create(), "EPSG");
+    auto src = authFactory->createCoordinateReferenceSystem("4267"); // NAD27
+    auto dst = authFactory->createCoordinateReferenceSystem("4326"); // WGS84
+    const auto run = [&authFactory, &src, &dst](int threadCount) {
+        auto ctxt =
+            CoordinateOperationContext::create(authFactory, nullptr, 0.0);
+        ctxt->setSpatialCriterion(
+            CoordinateOperationContext::SpatialCriterion::PARTIAL_INTERSECTION);
+        ctxt->setGridAvailabilityUse(
+            CoordinateOperationContext::GridAvailabilityUse::
+                IGNORE_GRID_AVAILABILITY);
+        ctxt->setThreadCount(threadCount);
+        EXPECT_EQ(ctxt->getThreadCount(), threadCount);
+        auto list =
+            CoordinateOperationFactory::create()->createOperations(src, dst,
+                                                                   ctxt);
+        std::vector<std::string> names;
+        for (const auto &op : list) {
+            names.push_back(op->nameStr());
+        }
+        return names;
+    };
+
+    const auto ref = run(1);
+    ASSERT_EQ(ref.size(), 79U);
+    EXPECT_EQ(run(4), ref);
+    EXPECT_EQ(run(0), ref);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(operation, createOperations_thread_count_with_pivots) {
+    auto authFactory =
+        AuthorityFactory::create(DatabaseContext::create(), "EPSG");
+    const auto run = [&authFactory](const std::string &srcCode,
+                                    const std::string &dstCode,
+                                    int threadCount) {
+        auto ctxt =
+            CoordinateOperationContext::create(authFactory, nullptr, 0.0);
+        ctxt->setSpatialCriterion(
+            CoordinateOperationContext::SpatialCriterion::PARTIAL_INTERSECTION);
+        ctxt->setGridAvailabilityUse(
+            CoordinateOperationContext::GridAvailabilityUse::
+                IGNORE_GRID_AVAILABILITY);
+        ctxt->setAllowUseIntermediateCRS(
+            CoordinateOperationContext::IntermediateCRSUse::ALWAYS);
+        ctxt->setThreadCount(threadCount);
+        std::vector<std::string> res;
+        // Run twice to reuse the database contexts of the other threads
+        for (int i = 0; i < 2; ++i) {
+            auto list = CoordinateOperationFactory::create()->createOperations(
+                authFactory->createCoordinateReferenceSystem(srcCode),
+                authFactory->createCoordinateReferenceSystem(dstCode), ctxt);
+            res.clear();
+            for (const auto &op : list) {
+                std::string projString;
+                try {
+                    projString = op->exportToPROJString(
+                        PROJStringFormatter::create().get());
+                } catch (const std::exception &) {
+                }
+                res.push_back(op->nameStr() + " " + projString);
+            }
+        }
+        return res;
+    };
+
+    for (const auto &codes : std::vector<std::pair<std::string, std::string>>{
+             // ED50 to WGS 72, through pivot CRS
+             {"4230", "4322"},
+             // NAD27 to WGS 84
+             {"4267", "4326"},
+             // NAD27 + NGVD29 height (ftUS) to NAD83(NSRS2007) + NAVD88 height
+             {"7406", "5500"}}) {
+        const auto ref = run(codes.first, codes.second, 1);
+        EXPECT_GT(ref.size(), 1U);
+        EXPECT_EQ(run(codes.first, codes.second, 4), ref) << codes.first;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(operation, geogCRS_to_geogCRS_context_NAD27_to_WGS84_G1762) {
     auto authFactory =
         AuthorityFactory::create(DatabaseContext::create(), std::string());